@@ -76,7 +76,9 @@ bool Application::initialize() {
         settings << R"({
     "audio": {
         "volume": 0.7,
-        "crossfade": 0
+        "crossfade": 0,
+        "gapless_preroll": 5.0,
+        "target_latency_ms": 50
     },
     "visualizer": {
         "fps": 60,
@@ -42,6 +42,35 @@ void Config::load() {
     if (root.contains("audio")) {
         const auto a = root.value("audio").toObject();
         if (a.contains("volume")) m_audio.volume = a.value("volume").toDouble(0.7);
+        if (a.contains("gapless_preroll")) m_audio.gaplessPrerollSeconds = a.value("gapless_preroll").toDouble(5.0);
+        if (a.contains("crossfade")) m_audio.crossfadeSeconds = a.value("crossfade").toDouble(0.0);
+        if (a.contains("target_latency_ms")) m_audio.targetLatencyMs = a.value("target_latency_ms").toInt(50);
+        if (a.contains("decoder")) m_audio.decoder = a.value("decoder").toString("qt").toStdString();
+        if (a.contains("analysis_cache")) m_audio.analysisCache = a.value("analysis_cache").toBool(true);
+        if (a.contains("loudness_scan")) m_audio.loudnessScan = a.value("loudness_scan").toBool(true);
+        if (a.contains("normalize_visualizer")) m_audio.normalizeVisualizer = a.value("normalize_visualizer").toBool(true);
+        if (a.contains("normalize_output")) m_audio.normalizeOutput = a.value("normalize_output").toBool(false);
+        if (a.contains("target_lufs")) m_audio.targetLufs = a.value("target_lufs").toDouble(-18.0);
+        if (a.contains("visualizer_input")) m_audio.visualizerInput = a.value("visualizer_input").toString("playback").toStdString();
+        if (a.contains("capture_source")) m_audio.captureSource = a.value("capture_source").toString().toStdString();
+        if (a.contains("capture_fragment_ms")) m_audio.captureFragmentMs = a.value("capture_fragment_ms").toInt(5);
+        if (a.contains("equalizer")) m_audio.equalizer = a.value("equalizer").toBool(false);
+        if (a.contains("eq_bands")) {
+            m_audio.eqBands.clear();
+            for (const auto& value : a.value("eq_bands").toArray()) {
+                const auto b = value.toObject();
+                EqBandConfig band;
+                band.type = b.value("type").toString("peak").toStdString();
+                band.frequencyHz = b.value("frequency").toDouble(1000.0);
+                band.gainDb = b.value("gain_db").toDouble(0.0);
+                band.q = b.value("q").toDouble(0.707);
+                m_audio.eqBands.push_back(band);
+            }
+        }
+        if (a.contains("limiter")) m_audio.limiter = a.value("limiter").toBool(true);
+        if (a.contains("spectrum_fft_size")) m_audio.spectrumFftSize = a.value("spectrum_fft_size").toInt(2048);
+        if (a.contains("spectrum_hop")) m_audio.spectrumHopFrames = a.value("spectrum_hop").toInt(512);
+        if (a.contains("spectrum_bands")) m_audio.spectrumBands = a.value("spectrum_bands").toInt(32);
     }
 
     // Visualizer
@@ -61,6 +90,10 @@ void Config::load() {
         if (v.contains("texture_directory")) m_visualizer.textureDirectory = v.value("texture_directory").toString().toStdString();
         if (v.contains("debug_inject_test_signal")) m_visualizer.debugInjectTestSignal = v.value("debug_inject_test_signal").toBool(false);
         if (v.contains("load_random_on_startup")) m_visualizer.loadRandomPresetOnStartup = v.value("load_random_on_startup").toBool(false);
+        if (v.contains("audio_sync_offset_ms")) m_visualizer.audioSyncOffsetMs = v.value("audio_sync_offset_ms").toInt(0);
+        if (v.contains("analysis_sample_rate")) m_visualizer.analysisSampleRate = v.value("analysis_sample_rate").toInt(44100);
+        if (v.contains("vsync")) m_visualizer.vsync = v.value("vsync").toBool(true);
+        if (v.contains("adaptive_quality")) m_visualizer.adaptiveQuality = v.value("adaptive_quality").toBool(true);
     }
 }
 
@@ -70,6 +103,33 @@ void Config::save() const {
     // Audio
     QJsonObject a;
     a.insert("volume", m_audio.volume);
+    a.insert("gapless_preroll", m_audio.gaplessPrerollSeconds);
+    a.insert("crossfade", m_audio.crossfadeSeconds);
+    a.insert("target_latency_ms", m_audio.targetLatencyMs);
+    a.insert("decoder", QString::fromStdString(m_audio.decoder));
+    a.insert("analysis_cache", m_audio.analysisCache);
+    a.insert("loudness_scan", m_audio.loudnessScan);
+    a.insert("normalize_visualizer", m_audio.normalizeVisualizer);
+    a.insert("normalize_output", m_audio.normalizeOutput);
+    a.insert("target_lufs", m_audio.targetLufs);
+    a.insert("visualizer_input", QString::fromStdString(m_audio.visualizerInput));
+    a.insert("capture_source", QString::fromStdString(m_audio.captureSource));
+    a.insert("capture_fragment_ms", m_audio.captureFragmentMs);
+    a.insert("equalizer", m_audio.equalizer);
+    QJsonArray bands;
+    for (const auto& band : m_audio.eqBands) {
+        QJsonObject b;
+        b.insert("type", QString::fromStdString(band.type));
+        b.insert("frequency", band.frequencyHz);
+        b.insert("gain_db", band.gainDb);
+        b.insert("q", band.q);
+        bands.append(b);
+    }
+    a.insert("eq_bands", bands);
+    a.insert("limiter", m_audio.limiter);
+    a.insert("spectrum_fft_size", m_audio.spectrumFftSize);
+    a.insert("spectrum_hop", m_audio.spectrumHopFrames);
+    a.insert("spectrum_bands", m_audio.spectrumBands);
     root.insert("audio", a);
 
     // Visualizer
@@ -88,6 +148,10 @@ void Config::save() const {
     v.insert("texture_directory", QString::fromStdString(m_visualizer.textureDirectory));
     v.insert("debug_inject_test_signal", m_visualizer.debugInjectTestSignal);
     v.insert("load_random_on_startup", m_visualizer.loadRandomPresetOnStartup);
+    v.insert("audio_sync_offset_ms", m_visualizer.audioSyncOffsetMs);
+    v.insert("analysis_sample_rate", m_visualizer.analysisSampleRate);
+    v.insert("vsync", m_visualizer.vsync);
+    v.insert("adaptive_quality", m_visualizer.adaptiveQuality);
     root.insert("visualizer", v);
 
     const auto path = settingsFilePath();
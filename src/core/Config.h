@@ -3,6 +3,7 @@
 #include <string>
 #include <filesystem>
 #include <optional>
+#include <vector>
 
 namespace NeonWave::Core {
 
@@ -21,10 +22,45 @@ struct VisualizerConfig {
     std::string textureDirectory;  // empty => use defaults
     bool debugInjectTestSignal = false; // developer toggle to verify rendering path
     bool loadRandomPresetOnStartup = false;
+    int audioSyncOffsetMs = 0;     // added to the measured output latency; positive delays the visuals
+    int analysisSampleRate = 44100; // rate projectM is fed at; 0 = the stream rate
+    bool vsync = true;             // swap interval 1 (applied at startup) and frame clock phase-locked to swaps
+    bool adaptiveQuality = true;   // scale mesh and render resolution down when frames exceed the FPS budget
+};
+
+struct EqBandConfig {
+    std::string type = "peak";          // "peak", "low_shelf" or "high_shelf"
+    double frequencyHz = 1000.0;
+    double gainDb = 0.0;
+    double q = 0.707;
 };
 
 struct AudioConfig {
     double volume = 0.7;
+    double gaplessPrerollSeconds = 5.0; // open the next track this long before the current one ends
+    double crossfadeSeconds = 0.0;      // equal-power overlap between consecutive tracks; 0 = gapless
+    int targetLatencyMs = 50;           // decoded audio queued in front of the sink (10-200)
+    std::string decoder = "qt";         // playback decoder: "qt" or "libav"
+    bool analysisCache = true;          // analyse added tracks in the background and keep the features on disk
+    bool loudnessScan = true;           // measure EBU R128 loudness of added tracks in the background
+    bool normalizeVisualizer = true;    // feed the visualizer every measured track at the target loudness
+    bool normalizeOutput = false;       // also normalise what is played (peak-limited to -1 dBTP)
+    double targetLufs = -18.0;          // normalisation target, LUFS
+    std::string visualizerInput = "playback"; // what the visualizer follows: "playback" or "capture" (PulseAudio source)
+    std::string captureSource;          // PulseAudio source to capture; empty = default output's monitor
+    int captureFragmentMs = 5;          // capture fragment size; smaller = lower latency, more wakeups
+    bool equalizer = false;             // parametric EQ on the output
+    std::vector<EqBandConfig> eqBands{  // up to 8 bands; flat bands cost nothing
+        { "low_shelf", 80.0, 0.0, 0.707 },
+        { "peak", 250.0, 0.0, 1.0 },
+        { "peak", 1000.0, 0.0, 1.0 },
+        { "peak", 4000.0, 0.0, 1.0 },
+        { "high_shelf", 10000.0, 0.0, 0.707 },
+    };
+    bool limiter = true;                // lookahead limiter holding the output under -1 dBFS
+    int spectrumFftSize = 2048;         // shared spectrum analysis: FFT size, power of two (256-8192)
+    int spectrumHopFrames = 512;        // frames between spectra
+    int spectrumBands = 32;             // log-spaced bands, 30 Hz to 16 kHz (at most 64)
 };
 
 class Config {
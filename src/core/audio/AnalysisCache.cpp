@@ -0,0 +1,181 @@
+#include "AnalysisCache.h"
+#include "FeatureExtractor.h"
+#include "OfflineAudioEngine.h"
+
+#include <QMetaObject>
+#include <algorithm>
+#include <cstring>
+
+namespace NeonWave::Core::Audio {
+
+namespace {
+
+constexpr DiskCache::Format kFormat = { "AnalysisCache", { 'N', 'W', 'A', 'N', 'A', 'L', 'Y', 'Z' }, 2, ".nwa" };
+
+/// On-disk header; hop values follow immediately, as native-endian float32.
+struct CacheHeader {
+    DiskCache::FileHeader common;
+    std::uint32_t extractorVersion;
+    std::uint32_t sampleRate;
+    std::uint32_t hopFrames;
+    std::uint32_t bandCount;
+    std::uint32_t valuesPerHop;
+    std::uint32_t reserved;
+    std::uint64_t hopCount;
+};
+static_assert(sizeof(CacheHeader) == 80, "CacheHeader layout is part of the file format");
+
+} // namespace
+
+// ---- TrackAnalysis ----------------------------------------------------------
+
+std::shared_ptr<const TrackAnalysis> TrackAnalysis::map(const QString& file, const QByteArray& contentHash) {
+    auto mapped = DiskCache::map(file, kFormat, contentHash, sizeof(CacheHeader));
+    if (!mapped) return nullptr;
+
+    CacheHeader header;
+    std::memcpy(&header, mapped->data, sizeof(header));
+    const bool current = header.extractorVersion == FeatureExtractor::kVersion
+        && header.sampleRate > 0 && header.hopFrames > 0
+        && header.valuesPerHop > 0 && header.valuesPerHop == header.bandCount + 2;
+    if (!current) return nullptr;
+
+    // Divide rather than multiply: a corrupt hopCount must not wrap around into a plausible size
+    const std::uint64_t hopBytes = static_cast<std::uint64_t>(header.valuesPerHop) * sizeof(float);
+    const std::uint64_t valueBytes = mapped->size - sizeof(CacheHeader);
+    if (valueBytes % hopBytes != 0 || header.hopCount != valueBytes / hopBytes) return nullptr;
+
+    std::shared_ptr<TrackAnalysis> analysis(new TrackAnalysis());
+    analysis->m_values = reinterpret_cast<const float*>(mapped->data + sizeof(CacheHeader));
+    analysis->m_hopCount = static_cast<std::size_t>(header.hopCount);
+    analysis->m_sampleRate = static_cast<int>(header.sampleRate);
+    analysis->m_hopFrames = static_cast<int>(header.hopFrames);
+    analysis->m_bandCount = static_cast<int>(header.bandCount);
+    analysis->m_valuesPerHop = static_cast<int>(header.valuesPerHop);
+    analysis->m_mapped = std::move(mapped);
+    return analysis;
+}
+
+std::size_t TrackAnalysis::hopAt(double seconds) const {
+    if (m_hopCount == 0 || seconds <= 0.0) return 0;
+    const auto index = static_cast<std::size_t>(seconds * m_sampleRate / m_hopFrames);
+    return std::min(index, m_hopCount - 1);
+}
+
+// ---- AnalysisCache ----------------------------------------------------------
+
+AnalysisCache::AnalysisCache(std::filesystem::path directory, QObject* parent)
+    : QObject(parent)
+    , m_disk(std::move(directory), kFormat)
+{
+    m_disk.start([this](const QString& path) { process(path); },
+        [this](const QString& path, const QByteArray& key) {
+            if (key.isEmpty() || !TrackAnalysis::map(m_disk.fileFor(key), key)) return;
+            QMetaObject::invokeMethod(this, [this, path]() { emit trackReady(path, true); }, Qt::QueuedConnection);
+        });
+}
+
+AnalysisCache::~AnalysisCache() {
+    m_disk.stop();
+}
+
+void AnalysisCache::enqueue(const QStringList& files) {
+    for (const auto& file : files) m_disk.enqueue(file);
+}
+
+void AnalysisCache::cancelPending() {
+    m_disk.cancelPending();
+}
+
+std::shared_ptr<const TrackAnalysis> AnalysisCache::lookup(const QString& path) {
+    const QByteArray key = DiskCache::knownKey(path);
+    if (!key.isEmpty()) return TrackAnalysis::map(m_disk.fileFor(key), key);
+    m_disk.requestKey(path);
+    return nullptr;
+}
+
+std::shared_ptr<const TrackAnalysis> AnalysisCache::analyze(const QString& path, const std::atomic<bool>* cancel) {
+    bool fromCache = false;
+    QString error;
+    return analyzeInternal(path, cancel, &fromCache, &error);
+}
+
+AnalysisCache::Stats AnalysisCache::stats() const {
+    Stats s;
+    {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        s = m_stats;
+    }
+    s.pending = m_disk.pending();
+    return s;
+}
+
+void AnalysisCache::process(const QString& path) {
+    bool fromCache = false;
+    QString error;
+    const bool ok = analyzeInternal(path, m_disk.cancelFlag(), &fromCache, &error) != nullptr;
+    const bool drained = m_disk.pending() == 0;
+    QMetaObject::invokeMethod(this, [this, path, ok, fromCache, error, drained]() {
+        if (ok) emit trackReady(path, fromCache);
+        else emit trackFailed(path, error);
+        if (drained) emit idle();
+    }, Qt::QueuedConnection);
+}
+
+std::shared_ptr<const TrackAnalysis> AnalysisCache::analyzeInternal(const QString& path, const std::atomic<bool>* cancel,
+                                                                    bool* fromCache, QString* error) {
+    {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        ++m_stats.requests;
+    }
+    auto fail = [this, error](const QString& what) -> std::shared_ptr<const TrackAnalysis> {
+        *error = what;
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        ++m_stats.failures;
+        return nullptr;
+    };
+
+    const QByteArray key = DiskCache::keyFor(path);
+    if (key.isEmpty()) return fail("cannot read file");
+    const QString cacheFile = m_disk.fileFor(key);
+    if (auto hit = TrackAnalysis::map(cacheFile, key)) {
+        *fromCache = true;
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        ++m_stats.hits;
+        return hit;
+    }
+
+    FeatureExtractor extractor;
+    const DecodeStats decoded = OfflineAudioEngine::decodeFile(path,
+        [&extractor](const float* stereo, std::size_t frames, std::uint32_t sampleRate, std::uint64_t) {
+            extractor.push(stereo, frames, static_cast<int>(sampleRate));
+            return true;
+        }, 4096, cancel);
+    if (!decoded.ok) return fail(decoded.cancelled ? QStringLiteral("cancelled") : decoded.error);
+    extractor.finish();
+
+    CacheHeader header{};
+    header.common = DiskCache::header(kFormat, key);
+    header.extractorVersion = FeatureExtractor::kVersion;
+    header.sampleRate = FeatureExtractor::kSampleRate;
+    header.hopFrames = FeatureExtractor::kHopFrames;
+    header.bandCount = FeatureExtractor::kBandCount;
+    header.valuesPerHop = FeatureExtractor::kValuesPerHop;
+    header.hopCount = extractor.hopCount();
+
+    QString writeError;
+    if (!DiskCache::write(cacheFile, kFormat, &header, sizeof(header),
+                          extractor.values().data(), extractor.values().size() * sizeof(float), &writeError)) {
+        return fail(writeError);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        ++m_stats.analysed;
+        m_stats.audioSeconds += decoded.audioSeconds;
+        m_stats.wallSeconds += decoded.wallSeconds;
+    }
+    return TrackAnalysis::map(cacheFile, key);
+}
+
+}
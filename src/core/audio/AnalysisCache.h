@@ -0,0 +1,121 @@
+#pragma once
+
+#include <QByteArray>
+#include <QObject>
+#include <QStringList>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include "DiskCache.h"
+
+namespace NeonWave::Core::Audio {
+
+/**
+ * @brief Read-only view of one track's cached features, memory-mapped.
+ *
+ * Layout is FeatureExtractor's: hop-major, valuesPerHop() floats per hop
+ * (band energies in dB, onset strength, RMS). Nothing is copied; the pages
+ * are shared with every other process mapping the same cache file.
+ */
+class TrackAnalysis {
+public:
+    /// Map @p file; null if it is missing, truncated or was written for another hash/version.
+    static std::shared_ptr<const TrackAnalysis> map(const QString& file, const QByteArray& contentHash);
+
+    std::size_t hopCount() const { return m_hopCount; }
+    int sampleRate() const { return m_sampleRate; }
+    int hopFrames() const { return m_hopFrames; }
+    int bandCount() const { return m_bandCount; }
+    int valuesPerHop() const { return m_valuesPerHop; }
+    double hopSeconds() const { return static_cast<double>(m_hopFrames) / m_sampleRate; }
+    double durationSeconds() const { return m_hopCount * hopSeconds(); }
+
+    /// Hop containing @p seconds, clamped to the track.
+    std::size_t hopAt(double seconds) const;
+    const float* hop(std::size_t index) const { return m_values + index * m_valuesPerHop; }
+    float band(std::size_t index, int b) const { return hop(index)[b]; }
+    float onset(std::size_t index) const { return hop(index)[m_bandCount]; }
+    float rms(std::size_t index) const { return hop(index)[m_bandCount + 1]; }
+
+private:
+    TrackAnalysis() = default;
+
+    std::shared_ptr<const DiskCache::MappedFile> m_mapped;
+    const float* m_values = nullptr;
+    std::size_t m_hopCount = 0;
+    int m_sampleRate = 0;
+    int m_hopFrames = 0;
+    int m_bandCount = 0;
+    int m_valuesPerHop = 0;
+};
+
+/**
+ * @brief Per-track feature cache on disk, filled by a background job.
+ *
+ * Files live in one directory (normally Application::getDataPath()/analysis)
+ * and are keyed and written through DiskCache. The header also records the
+ * feature extractor version; a mismatch counts as a miss and the track is
+ * analysed again.
+ *
+ * enqueue() hands tracks to the DiskCache worker, which decodes them flat
+ * out through OfflineAudioEngine::decodeFile(); lookup() only ever maps what
+ * is already there. Everything here is safe to call from any thread.
+ */
+class AnalysisCache : public QObject {
+    Q_OBJECT
+public:
+    struct Stats {
+        std::uint64_t requests = 0;
+        std::uint64_t hits = 0;
+        std::uint64_t analysed = 0; ///< Misses analysed and written this session
+        std::uint64_t failures = 0;
+        std::size_t pending = 0;
+        double audioSeconds = 0.0;  ///< Audio analysed on misses
+        double wallSeconds = 0.0;   ///< Time spent on misses, decode included
+
+        double hitRate() const { return requests ? static_cast<double>(hits) / requests : 0.0; }
+        /// Analysed seconds of audio per wall-clock second.
+        double speed() const { return wallSeconds > 0.0 ? audioSeconds / wallSeconds : 0.0; }
+    };
+
+    explicit AnalysisCache(std::filesystem::path directory, QObject* parent = nullptr);
+    ~AnalysisCache();
+
+    /// Queue tracks for the background job; ones already queued are skipped.
+    void enqueue(const QStringList& files);
+    /// Drop everything not yet started.
+    void cancelPending();
+
+    /// Mapped features for @p path if they are cached and current; never analyses or hashes.
+    /// Null until the worker knows the file's current hash: a miss queues the hash ahead of
+    /// any analysis, and trackReady(path, true) follows if the features are already on disk.
+    std::shared_ptr<const TrackAnalysis> lookup(const QString& path);
+    /// Mapped features for @p path, analysing on the calling thread on a miss.
+    std::shared_ptr<const TrackAnalysis> analyze(const QString& path, const std::atomic<bool>* cancel = nullptr);
+
+    Stats stats() const;
+    const std::filesystem::path& directory() const { return m_disk.directory(); }
+
+signals:
+    /// A queued track is available through lookup(); emitted on this object's thread.
+    void trackReady(const QString& path, bool fromCache);
+    /// A queued track could not be analysed.
+    void trackFailed(const QString& path, const QString& error);
+    /// The queue ran dry.
+    void idle();
+
+private:
+    /// Worker job for a queued track.
+    void process(const QString& path);
+    std::shared_ptr<const TrackAnalysis> analyzeInternal(const QString& path, const std::atomic<bool>* cancel,
+                                                         bool* fromCache, QString* error);
+
+    mutable std::mutex m_statsMutex;     // guards m_stats
+    Stats m_stats;
+
+    DiskCache m_disk;                    // last: its worker uses everything above
+};
+
+}
@@ -0,0 +1,453 @@
+#include "AudioBenchmark.h"
+#include "CrossfadeMixer.h"
+#include "DspChain.h"
+#include "FileDecoder.h"
+#include "OfflineAudioEngine.h"
+#include "PolyphaseResampler.h"
+#include "PulseCapture.h"
+#include "SpectrumAnalyzer.h"
+#include "TempoTracker.h"
+#include "SampleConverter.h"
+
+#include <QFileInfo>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <regex>
+#include <thread>
+
+namespace NeonWave::Core::Audio {
+
+namespace {
+
+void benchmarkSampleConversion() {
+    std::cout << "[Benchmark] Sample conversion to float stereo (detected ISA: "
+              << toString(detectIsa()) << ")" << std::endl;
+    std::printf("  %-8s %-6s %-4s %14s\n", "isa", "format", "ch", "Msamples/s");
+    for (const auto& r : SampleConverter::benchmark()) {
+        std::printf("  %-8s %-6s %-4d %14.1f\n", toString(r.isa), toString(r.type), r.channels,
+                    r.samplesPerSecond / 1e6);
+    }
+}
+
+void benchmarkResampler() {
+    std::cout << "[Benchmark] Polyphase resampler, interleaved stereo" << std::endl;
+    std::printf("  %-8s %-16s %-5s %14s\n", "isa", "rates", "taps", "ns/out frame");
+    for (const auto& r : PolyphaseResampler::benchmark()) {
+        const std::string rates = std::to_string(r.inputRate) + "->" + std::to_string(r.outputRate);
+        std::printf("  %-8s %-16s %-5d %14.1f\n", toString(r.isa), rates.c_str(), r.tapsPerPhase, r.nsPerOutputFrame);
+    }
+
+    // Quality at a glance; tests/ResamplerTest holds the same measurements to fixed bounds
+    std::printf("  %-16s %-5s %12s %14s\n", "rates", "taps", "1 kHz SNR dB", "alias rej. dB");
+    constexpr int kPairs[][2] = { { 48000, 44100 }, { 96000, 44100 }, { 192000, 44100 }, { 44100, 48000 }, { 22050, 44100 } };
+    for (const auto& pair : kPairs) {
+        const auto q = PolyphaseResampler::measureQuality(pair[0], pair[1]);
+        const std::string rates = std::to_string(q.inputRate) + "->" + std::to_string(q.outputRate);
+        if (std::isnan(q.aliasRejectionDb)) {
+            std::printf("  %-16s %-5d %12.1f %14s\n", rates.c_str(), q.tapsPerPhase, q.sineSnrDb, "-");
+        } else {
+            std::printf("  %-16s %-5d %12.1f %14.1f\n", rates.c_str(), q.tapsPerPhase, q.sineSnrDb, q.aliasRejectionDb);
+        }
+    }
+}
+
+void benchmarkCrossfade() {
+    std::cout << "[Benchmark] Equal-power crossfade mixer, interleaved stereo" << std::endl;
+    std::printf("  %-8s %14s\n", "isa", "ns/frame");
+    for (const auto& r : CrossfadeMixer::benchmark()) {
+        std::printf("  %-8s %14.2f\n", toString(r.isa), r.nsPerFrame);
+    }
+    std::printf("  gain curve error vs exact cos/sin: %.1f dB\n", CrossfadeMixer::measureGainErrorDb());
+}
+
+void benchmarkDsp() {
+    constexpr int kRate = 192000;
+    const double budgetNs = 1e9 * DspChain::kBlockFrames / kRate;
+    std::cout << "[Benchmark] Output DSP chain at " << kRate / 1000 << " kHz, " << DspChain::kBlockFrames
+              << "-frame blocks (" << budgetNs / 1000.0 << " us of audio each)" << std::endl;
+    std::printf("  %-10s %-8s %14s %10s %14s\n", "node", "isa", "ns/block", "% budget", "max |diff|");
+    for (const auto& r : DspChain::benchmark(kRate)) {
+        std::printf("  %-10s %-8s %14.1f %9.3f%% %14.2e\n", r.stage, toString(r.isa), r.nsPerBlock,
+                    100.0 * r.nsPerBlock / budgetNs, r.maxDeviation);
+    }
+    std::printf("  limiter peak vs ceiling with 12 dB overdrive: %+.6f dB\n", DspChain::measureLimiterOvershootDb());
+}
+
+void benchmarkSpectrum() {
+    std::cout << "[Benchmark] Shared spectrum analysis, Hann-windowed FFT of real input" << std::endl;
+    std::printf("  %-6s %14s %14s %8s %14s %12s\n", "size", "complex FFT/s", "real FFT/s", "speedup", "hops/s", "max |diff|");
+    for (const auto& r : SpectrumAnalyzer::benchmark()) {
+        std::printf("  %-6d %14.0f %14.0f %7.2fx %14.0f %12.2e\n", r.fftSize, r.complexPerSecond, r.realPerSecond,
+                    r.realPerSecond / r.complexPerSecond, r.hopsPerSecond, r.maxError);
+    }
+}
+
+void benchmarkDecode(const std::vector<std::string>& files) {
+    std::cout << "[Benchmark] Full-speed decode to float stereo" << std::endl;
+    if (!hasFileDecoder()) {
+        std::cout << "  skipped: built without a FileDecoder backend (NEONWAVE_WITH_LIBAV=OFF)" << std::endl;
+        return;
+    }
+    if (files.empty()) {
+        std::cout << "  skipped: pass audio files after --benchmark-audio" << std::endl;
+        return;
+    }
+
+    struct Totals { int files = 0; double audioSeconds = 0.0; double wallSeconds = 0.0; };
+    std::map<std::string, Totals> byFormat;
+
+    std::printf("  %-40s %10s %10s %12s\n", "file", "audio s", "wall s", "x realtime");
+    for (const auto& file : files) {
+        const QString path = QString::fromStdString(file);
+        const DecodeStats stats = OfflineAudioEngine::decodeFile(path, nullptr);
+        const std::string name = QFileInfo(path).fileName().toStdString();
+        if (!stats.ok) {
+            std::printf("  %-40s failed: %s\n", name.c_str(), stats.error.toStdString().c_str());
+            continue;
+        }
+        std::printf("  %-40s %10.1f %10.3f %12.1f\n", name.c_str(), stats.audioSeconds, stats.wallSeconds, stats.speed());
+        auto& t = byFormat[QFileInfo(path).suffix().toLower().toStdString()];
+        ++t.files;
+        t.audioSeconds += stats.audioSeconds;
+        t.wallSeconds += stats.wallSeconds;
+    }
+
+    std::printf("  %-8s %-6s %12s\n", "format", "files", "x realtime");
+    for (const auto& [format, t] : byFormat) {
+        std::printf("  %-8s %-6d %12.1f\n", format.c_str(), t.files,
+                    t.wallSeconds > 0.0 ? t.audioSeconds / t.wallSeconds : 0.0);
+    }
+}
+
+struct TempoCase {
+    std::string name;
+    double trueBpm = 0.0;
+    int sampleRate = 0;
+    std::vector<float> stereo;
+};
+
+/// Minimal RIFF/WAVE reader: integer PCM (8/16/24/32 bit) and float32, any channel count.
+bool readWav(const std::filesystem::path& path, TempoCase& out, std::string& error) {
+    std::ifstream in(path, std::ios::binary);
+    char riff[12];
+    if (!in.read(riff, 12) || std::memcmp(riff, "RIFF", 4) != 0 || std::memcmp(riff + 8, "WAVE", 4) != 0) {
+        error = "not a RIFF/WAVE file";
+        return false;
+    }
+    auto le = [](const unsigned char* p, int bytes) {
+        std::uint32_t v = 0;
+        for (int i = 0; i < bytes; ++i) v |= static_cast<std::uint32_t>(p[i]) << (8 * i);
+        return v;
+    };
+
+    int format = 0, channels = 0, bits = 0;
+    std::vector<unsigned char> data;
+    char header[8];
+    while (in.read(header, 8)) {
+        const std::uint32_t size = le(reinterpret_cast<unsigned char*>(header + 4), 4);
+        std::vector<unsigned char> chunk(size);
+        if (!in.read(reinterpret_cast<char*>(chunk.data()), size)) break;
+        if (size & 1u) in.ignore(1);
+        if (std::memcmp(header, "fmt ", 4) == 0 && size >= 16) {
+            format = static_cast<int>(le(chunk.data(), 2));
+            channels = static_cast<int>(le(chunk.data() + 2, 2));
+            out.sampleRate = static_cast<int>(le(chunk.data() + 4, 4));
+            bits = static_cast<int>(le(chunk.data() + 14, 2));
+            if (format == 0xFFFE && size >= 26) format = static_cast<int>(le(chunk.data() + 24, 2)); // extensible
+        } else if (std::memcmp(header, "data", 4) == 0) {
+            data = std::move(chunk);
+        }
+    }
+    const bool supported = (format == 1 && (bits == 8 || bits == 16 || bits == 24 || bits == 32))
+        || (format == 3 && bits == 32);
+    if (!supported || channels <= 0 || out.sampleRate <= 0 || data.empty()) {
+        error = "unsupported WAV encoding";
+        return false;
+    }
+
+    const int bytes = bits / 8;
+    const std::size_t frames = data.size() / (static_cast<std::size_t>(bytes) * channels);
+    out.stereo.resize(frames * 2);
+    for (std::size_t f = 0; f < frames; ++f) {
+        for (int c = 0; c < 2; ++c) {
+            const unsigned char* p = data.data() + (f * channels + std::min(c, channels - 1)) * bytes;
+            float v = 0.0f;
+            if (format == 3) {
+                std::uint32_t u = le(p, 4);
+                std::memcpy(&v, &u, 4);
+            } else if (bits == 8) {
+                v = (static_cast<int>(p[0]) - 128) / 128.0f;
+            } else {
+                // Sign-extend from the top byte
+                const std::uint32_t u = le(p, bytes) << (32 - bits);
+                v = static_cast<float>(static_cast<std::int32_t>(u)) / 2147483648.0f;
+            }
+            out.stereo[2 * f + c] = v;
+        }
+    }
+    return true;
+}
+
+/// Kick on the beat, hat on the off-beat, a little noise: a known answer when no folder is given.
+TempoCase syntheticTempoCase(double bpm) {
+    TempoCase c;
+    c.name = "synthetic " + std::to_string(static_cast<int>(bpm)) + " bpm";
+    c.trueBpm = bpm;
+    c.sampleRate = 44100;
+    const std::size_t frames = static_cast<std::size_t>(c.sampleRate) * 30;
+    c.stereo.resize(frames * 2);
+    std::mt19937 rng(static_cast<unsigned>(bpm));
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    const double period = 60.0 * c.sampleRate / bpm;
+    const double rate = c.sampleRate;
+    for (std::size_t i = 0; i < frames; ++i) {
+        const double kick = std::fmod(static_cast<double>(i), period);
+        const double hat = std::fmod(static_cast<double>(i) + period / 2, period);
+        const float v = static_cast<float>(
+            0.8 * std::exp(-kick / (0.03 * rate)) * std::sin(2.0 * 3.14159265358979 * 60.0 * kick / rate)
+            + 0.5 * std::exp(-kick / (0.005 * rate)) * noise(rng)
+            + 0.15 * std::exp(-hat / (0.01 * rate)) * noise(rng)
+            + 0.05 * noise(rng));
+        c.stereo[2 * i] = v;
+        c.stereo[2 * i + 1] = v;
+    }
+    return c;
+}
+
+} // namespace
+
+int runTempoBenchmark(const std::string& folder) {
+    std::vector<TempoCase> cases;
+    if (folder.empty()) {
+        std::cout << "[Benchmark] Tempo tracker on synthetic click tracks (pass a folder of *<bpm>bpm*.wav for real material)" << std::endl;
+        for (const double bpm : { 70.0, 90.0, 100.0, 120.0, 128.0, 140.0, 174.0 }) cases.push_back(syntheticTempoCase(bpm));
+    } else {
+        std::cout << "[Benchmark] Tempo tracker on " << folder << std::endl;
+        std::vector<std::filesystem::path> files;
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator(folder, ec)) {
+            std::string ext = entry.path().extension().string();
+            std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char ch) { return std::tolower(ch); });
+            if (entry.is_regular_file() && ext == ".wav") files.push_back(entry.path());
+        }
+        if (ec) {
+            std::cerr << "[Benchmark] Cannot read " << folder << ": " << ec.message() << std::endl;
+            return 1;
+        }
+        std::sort(files.begin(), files.end());
+
+        // Ground truth comes from the file name, e.g. "track_128bpm.wav" or "Song (92.5 BPM).wav"
+        const std::regex bpmPattern(R"((\d+(?:\.\d+)?)\s*bpm)", std::regex::icase);
+        for (const auto& file : files) {
+            TempoCase c;
+            c.name = file.filename().string();
+            std::smatch match;
+            if (std::regex_search(c.name, match, bpmPattern)) c.trueBpm = std::stod(match[1].str());
+            std::string error;
+            if (!readWav(file, c, error)) {
+                std::printf("  %-40s skipped: %s\n", c.name.c_str(), error.c_str());
+                continue;
+            }
+            cases.push_back(std::move(c));
+        }
+    }
+
+    constexpr std::size_t kBlockFrames = 1024;
+    constexpr double kTolerance = 0.04;
+    int scored = 0, acc1 = 0, acc2 = 0;
+    double totalCpu = 0.0, totalAudio = 0.0, worstLoad = 0.0;
+    double budget = 0.0;
+
+    std::printf("  %-40s %8s %8s %6s %6s %9s\n", "file", "true", "tracked", "conf", "ok", "cpu %");
+    for (const auto& c : cases) {
+        TempoTracker tracker;
+        budget = tracker.cpuBudget();
+        const std::size_t frames = c.stereo.size() / 2;
+        for (std::size_t f = 0; f < frames; f += kBlockFrames) {
+            tracker.push(c.stereo.data() + 2 * f, std::min(kBlockFrames, frames - f), c.sampleRate, f);
+        }
+        const auto estimate = tracker.estimate();
+        const auto cost = tracker.cost();
+        totalCpu += cost.cpuSeconds;
+        totalAudio += cost.audioSeconds;
+        worstLoad = std::max(worstLoad, cost.load());
+
+        // Acc1: within 4%; Acc2: also accepts double/half/triple/third tempo (MIREX convention)
+        const char* verdict = "-";
+        if (c.trueBpm > 0.0) {
+            ++scored;
+            const double ratio = estimate.bpm / c.trueBpm;
+            const bool exact = std::abs(ratio - 1.0) <= kTolerance;
+            bool octave = exact;
+            for (const double m : { 2.0, 0.5, 3.0, 1.0 / 3.0 }) octave = octave || std::abs(ratio / m - 1.0) <= kTolerance;
+            acc1 += exact;
+            acc2 += octave;
+            verdict = exact ? "yes" : octave ? "oct" : "no";
+        }
+        std::printf("  %-40s %8.1f %8.1f %6.2f %6s %9.3f\n", c.name.c_str(), c.trueBpm, estimate.bpm,
+                    estimate.confidence, verdict, cost.load() * 100.0);
+    }
+
+    if (scored > 0) {
+        std::printf("  accuracy: Acc1 %.1f%%, Acc2 %.1f%% over %d tracks\n",
+                    100.0 * acc1 / scored, 100.0 * acc2 / scored, scored);
+    }
+    if (totalAudio > 0.0) {
+        std::printf("  cost: %.3f%% of a core on average, worst track %.3f%% (budget %.3f%%)\n",
+                    100.0 * totalCpu / totalAudio, 100.0 * worstLoad, 100.0 * budget);
+    }
+    return 0;
+}
+
+int runSeekBenchmark(const std::vector<std::string>& files, int seeks) {
+    std::cout << "[Benchmark] Seeking: container seek vs seek index, checked against a straight decode" << std::endl;
+    if (!hasFileDecoder()) {
+        std::cout << "  skipped: built without a FileDecoder backend (NEONWAVE_WITH_LIBAV=OFF)" << std::endl;
+        return 1;
+    }
+    if (files.empty()) {
+        std::cout << "  skipped: pass audio files after --benchmark-seek" << std::endl;
+        return 1;
+    }
+
+    constexpr std::size_t kCheckFrames = 4096;
+    constexpr double kMaxReferenceSeconds = 600.0; // keeps the reference decode in memory bounds
+    bool allExact = true;
+    std::printf("  %-32s %-10s %8s %10s %10s %8s %12s\n", "file", "mode", "points", "mean ms", "max ms", "exact", "max |err|");
+    for (const auto& name : files) {
+        const QString path = QString::fromStdString(name);
+        const std::string shortName = QFileInfo(path).fileName().left(32).toStdString();
+
+        // Reference: every frame from the top, no seeking involved
+        auto decoder = createFileDecoder();
+        if (!decoder->open(path)) {
+            std::printf("  %-32s cannot open: %s\n", shortName.c_str(), decoder->errorString().toStdString().c_str());
+            continue;
+        }
+        const auto maxFrames = static_cast<std::size_t>(kMaxReferenceSeconds * decoder->sampleRate());
+        std::vector<float> reference;
+        std::vector<float> chunk(kCheckFrames * 2);
+        while (reference.size() / 2 < maxFrames) {
+            const std::size_t got = decoder->decode(chunk.data(), kCheckFrames);
+            if (got == 0) break;
+            reference.insert(reference.end(), chunk.begin(), chunk.begin() + static_cast<std::ptrdiff_t>(got * 2));
+        }
+        const std::size_t referenceFrames = reference.size() / 2;
+        if (referenceFrames < kCheckFrames * 2) {
+            std::printf("  %-32s too short\n", shortName.c_str());
+            continue;
+        }
+
+        const auto scanStart = std::chrono::steady_clock::now();
+        const SeekScanResult scan = scanSeekIndex(path);
+        const double scanMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - scanStart).count();
+
+        for (const bool indexed : { false, true }) {
+            if (indexed && !scan.index) {
+                std::printf("  %-32s %-10s %s\n", shortName.c_str(), "index",
+                            scan.needed ? scan.error.toStdString().c_str() : "not needed, container seeks exactly");
+                continue;
+            }
+            decoder->open(path);
+            decoder->setSeekIndex(indexed ? scan.index : nullptr);
+            std::mt19937 rng(1234);
+            std::uniform_int_distribution<std::size_t> pick(0, referenceFrames - kCheckFrames);
+            double totalMs = 0.0, maxMs = 0.0, maxError = 0.0;
+            int exact = 0;
+            for (int s = 0; s < seeks; ++s) {
+                const std::size_t target = pick(rng);
+                const auto start = std::chrono::steady_clock::now();
+                decoder->seek(static_cast<qint64>(target));
+                const std::size_t got = decoder->decode(chunk.data(), kCheckFrames);
+                const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+                totalMs += ms;
+                maxMs = std::max(maxMs, ms);
+
+                double error = got == kCheckFrames ? 0.0 : 1.0;
+                for (std::size_t i = 0; i < got * 2; ++i) {
+                    error = std::max(error, static_cast<double>(std::abs(chunk[i] - reference[target * 2 + i])));
+                }
+                maxError = std::max(maxError, error);
+                if (error == 0.0) ++exact;
+            }
+            if (indexed && exact < seeks) allExact = false;
+            const std::string points = indexed ? std::to_string(scan.index->points().size()) : "-";
+            std::printf("  %-32s %-10s %8s %10.2f %10.2f %4d/%-3d %12.2e\n", shortName.c_str(),
+                        indexed ? "index" : "container", points.c_str(), totalMs / seeks, maxMs, exact, seeks, maxError);
+        }
+        if (scan.index) std::printf("  %-32s index scan took %.1f ms\n", shortName.c_str(), scanMs);
+    }
+    return allExact ? 0 : 1;
+}
+
+int runCaptureBenchmark(const std::string& source, double seconds) {
+    PulseCapture capture;
+    if (!capture.start(source)) {
+        std::cerr << "[Benchmark] " << capture.errorString() << std::endl;
+        return 1;
+    }
+    auto feed = capture.audioBus()->subscribe("benchmark");
+    const auto clock = capture.clock();
+    std::cout << "[Benchmark] Capturing for " << seconds << " s" << std::endl;
+
+    // Latency of each block as a consumer polling every millisecond sees it:
+    // from its last frame entering the source to the moment it is popped
+    std::vector<double> latencyMs;
+    std::uint64_t silentBlocks = 0;
+    const auto start = std::chrono::steady_clock::now();
+    while (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() < seconds) {
+        AudioBlockRef block;
+        while (feed->pop(block)) {
+            const auto s = clock->sample();
+            if (s.sampleRate == 0) continue;
+            const double end = static_cast<double>(block->streamFrame + block->frames);
+            const double capturedNs = s.stampNs - (static_cast<double>(s.frame) - end) * 1e9 / s.sampleRate;
+            latencyMs.push_back((PlaybackClock::nowNs() - capturedNs) * 1e-6);
+            bool silent = true;
+            for (std::uint32_t i = 0; i < block->frames * 2 && silent; ++i) silent = block->samples[i] == 0.0f;
+            silentBlocks += silent;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const CaptureStats stats = capture.stats();
+    capture.stop();
+
+    std::printf("  source %s at %u Hz, fragment %.2f ms, last source latency %.2f ms\n",
+                stats.source.c_str(), stats.sampleRate, stats.fragmentMs, stats.sourceLatencyMs);
+    std::printf("  %llu frames in %llu reads, %llu lost to overruns, %llu of %zu blocks silent\n",
+                static_cast<unsigned long long>(stats.frames), static_cast<unsigned long long>(stats.reads),
+                static_cast<unsigned long long>(stats.holeFrames), static_cast<unsigned long long>(silentBlocks),
+                latencyMs.size());
+    if (latencyMs.empty()) {
+        std::printf("  no audio arrived; is anything playing into the source?\n");
+        return 1;
+    }
+    std::sort(latencyMs.begin(), latencyMs.end());
+    auto percentile = [&latencyMs](double p) {
+        return latencyMs[std::min(latencyMs.size() - 1, static_cast<std::size_t>(p * latencyMs.size()))];
+    };
+    std::printf("  capture-to-consumer latency: p50 %.2f ms, p95 %.2f ms, p99 %.2f ms, max %.2f ms\n",
+                percentile(0.50), percentile(0.95), percentile(0.99), latencyMs.back());
+    return 0;
+}
+
+int runAudioBenchmarks(const std::vector<std::string>& files) {
+    benchmarkSampleConversion();
+    benchmarkResampler();
+    benchmarkCrossfade();
+    benchmarkDsp();
+    benchmarkSpectrum();
+    benchmarkDecode(files);
+    return 0;
+}
+
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace NeonWave::Core::Audio {
+
+/**
+ * @brief Run the audio-path microbenchmarks and print results to stdout
+ * @param files Audio files to time full-speed decoding on (any of mp3/flac/ogg/m4a/...)
+ * @return Process exit code
+ *
+ * Invoked by `neonwave --benchmark-audio [files...]`; needs no audio device or display.
+ */
+int runAudioBenchmarks(const std::vector<std::string>& files = {});
+
+/**
+ * @brief Run the tempo tracker over a folder of WAVs and report accuracy and cost
+ * @param folder Directory of .wav files whose names carry the true tempo ("..._128bpm.wav");
+ *               empty runs a synthetic click-track set instead
+ * @return Process exit code
+ *
+ * Invoked by `neonwave --benchmark-tempo [folder]`.
+ */
+int runTempoBenchmark(const std::string& folder = {});
+
+/**
+ * @brief Seek at random into each file and check the audio against a straight decode
+ * @param files Audio files; VBR mp3 is the interesting case
+ * @param seeks Seeks per file and mode
+ * @return Process exit code; non-zero if any seek through a seek index was not sample-exact
+ *
+ * Invoked by `neonwave --benchmark-seek files...`. Each file is timed once
+ * with the container's own seeking and once through a freshly scanned SeekIndex.
+ */
+int runSeekBenchmark(const std::vector<std::string>& files, int seeks = 50);
+
+/**
+ * @brief Capture a PulseAudio source and report capture-to-consumer latency
+ * @param source Source to record; empty for the default output's monitor
+ * @param seconds How long to capture
+ * @return Process exit code; non-zero if the server or source is unavailable
+ *
+ * Invoked by `neonwave --benchmark-capture [source] [seconds]`. Works against a
+ * throwaway user daemon with a null sink, e.g.
+ * `pulseaudio --system=false -n --load=module-native-protocol-unix
+ *  --load="module-null-sink sink_name=nw_test" --exit-idle-time=-1 --daemonize`
+ * then `paplay -d nw_test track.wav` and `--benchmark-capture nw_test.monitor`.
+ */
+int runCaptureBenchmark(const std::string& source = {}, double seconds = 10.0);
+
+}
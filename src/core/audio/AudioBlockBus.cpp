@@ -0,0 +1,216 @@
+#include "AudioBlockBus.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace NeonWave::Core::Audio {
+
+// ---- AudioBlockRef ---------------------------------------------------------
+
+AudioBlockRef::AudioBlockRef(const AudioBlockRef& other) : m_block(other.m_block) {
+    if (m_block) m_block->refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+AudioBlockRef::AudioBlockRef(AudioBlockRef&& other) noexcept : m_block(other.m_block) {
+    other.m_block = nullptr;
+}
+
+AudioBlockRef& AudioBlockRef::operator=(const AudioBlockRef& other) {
+    if (this != &other) {
+        reset();
+        m_block = other.m_block;
+        if (m_block) m_block->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+    return *this;
+}
+
+AudioBlockRef& AudioBlockRef::operator=(AudioBlockRef&& other) noexcept {
+    if (this != &other) {
+        reset();
+        m_block = other.m_block;
+        other.m_block = nullptr;
+    }
+    return *this;
+}
+
+void AudioBlockRef::reset() {
+    if (m_block) {
+        m_block->owner->releaseBlock(m_block);
+        m_block = nullptr;
+    }
+}
+
+// ---- Subscription ----------------------------------------------------------
+
+AudioBlockBus::Subscription::Subscription(std::shared_ptr<AudioBlockBus> bus, std::string name, std::size_t depth)
+    : m_bus(std::move(bus))
+    , m_name(std::move(name))
+    , m_queue(depth) {}
+
+AudioBlockBus::Subscription::~Subscription() {
+    m_bus->unsubscribe(this);
+    clear(); // nothing can push any more
+}
+
+bool AudioBlockBus::Subscription::pop(AudioBlockRef& out) {
+    AudioBlock* block = nullptr;
+    if (!m_queue.pop(block)) return false;
+    out = AudioBlockRef(block); // adopts the reference taken in publish()
+    return true;
+}
+
+void AudioBlockBus::Subscription::clear() {
+    AudioBlock* block = nullptr;
+    while (m_queue.pop(block)) {
+        m_bus->releaseBlock(block);
+    }
+}
+
+// ---- AudioBlockBus ---------------------------------------------------------
+
+AudioBlockBus::AudioBlockBus(std::size_t poolSize)
+    : m_pool(std::make_unique<AudioBlock[]>(std::max<std::size_t>(poolSize, 1)))
+    , m_poolSize(std::max<std::size_t>(poolSize, 1)) {
+    for (std::size_t i = 0; i < m_poolSize; ++i) {
+        m_pool[i].owner = this;
+    }
+}
+
+AudioBlockBus::~AudioBlockBus() = default;
+
+std::shared_ptr<AudioBlockBus::Subscription> AudioBlockBus::subscribe(std::string name, std::size_t queueDepth) {
+    std::shared_ptr<Subscription> sub(new Subscription(shared_from_this(), std::move(name), queueDepth));
+    std::lock_guard<std::mutex> lock(m_subscribersMutex);
+    auto next = std::make_unique<SubscriberList>();
+    if (m_subscriberList) next->entries = m_subscriberList->entries;
+    next->entries.push_back(sub.get());
+    replaceSubscribers(std::move(next));
+    return sub;
+}
+
+void AudioBlockBus::unsubscribe(Subscription* subscription) {
+    std::lock_guard<std::mutex> lock(m_subscribersMutex);
+    auto next = std::make_unique<SubscriberList>();
+    if (m_subscriberList) {
+        for (Subscription* entry : m_subscriberList->entries) {
+            if (entry != subscription) next->entries.push_back(entry);
+        }
+    }
+    replaceSubscribers(std::move(next));
+}
+
+void AudioBlockBus::replaceSubscribers(std::unique_ptr<SubscriberList> next) {
+    m_subscribers.store(next.get(), std::memory_order_seq_cst);
+    const std::unique_ptr<SubscriberList> old = std::move(m_subscriberList);
+    m_subscriberList = std::move(next);
+    // The producer re-checks m_subscribers after setting its hazard, so once this reads
+    // anything but the old list, publish() cannot be iterating it; one fan-out at most
+    while (old && m_producerHazard.load(std::memory_order_seq_cst) == old.get()) {
+        std::this_thread::yield();
+    }
+}
+
+AudioBlock* AudioBlockBus::acquire() {
+    // Only the producer moves a block from 0 to 1 reference, so a plain scan is race-free.
+    for (std::size_t n = 0; n < m_poolSize; ++n) {
+        AudioBlock& block = m_pool[m_cursor];
+        m_cursor = (m_cursor + 1) % m_poolSize;
+        if (block.refs.load(std::memory_order_acquire) == 0) {
+            block.refs.store(1, std::memory_order_relaxed);
+            const std::size_t inUse = m_inUse.fetch_add(1, std::memory_order_relaxed) + 1;
+            if (inUse > m_peakInUse.load(std::memory_order_relaxed)) {
+                m_peakInUse.store(inUse, std::memory_order_relaxed);
+            }
+            block.frames = 0;
+            return &block;
+        }
+    }
+    m_poolExhausted.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+}
+
+void AudioBlockBus::publish(AudioBlock* block) {
+    if (!block) return;
+    // Announce the snapshot before using it, then make sure it was still current
+    const SubscriberList* list = m_subscribers.load(std::memory_order_acquire);
+    for (;;) {
+        m_producerHazard.store(list, std::memory_order_seq_cst);
+        const SubscriberList* current = m_subscribers.load(std::memory_order_seq_cst);
+        if (current == list) break;
+        list = current;
+    }
+    if (list) {
+        for (Subscription* sub : list->entries) {
+            block->refs.fetch_add(1, std::memory_order_relaxed);
+            if (sub->m_queue.push(block)) {
+                sub->m_delivered.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                block->refs.fetch_sub(1, std::memory_order_relaxed);
+                sub->m_dropped.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+    m_producerHazard.store(nullptr, std::memory_order_release);
+    m_published.fetch_add(1, std::memory_order_relaxed);
+    releaseBlock(block); // drop the producer's reference from acquire()
+}
+
+std::size_t AudioBlockBus::publish(const float* data, std::size_t frames, int channelCount,
+                                   std::uint32_t sampleRate, std::uint64_t streamFrame) {
+    if (!data || channelCount <= 0) return 0;
+
+    std::size_t done = 0;
+    while (done < frames) {
+        AudioBlock* block = acquire();
+        if (!block) break;
+
+        const std::size_t n = std::min(frames - done, AudioBlock::kMaxFrames);
+        const float* src = data + done * static_cast<std::size_t>(channelCount);
+        if (channelCount == 2) {
+            std::copy_n(src, n * 2, block->samples);
+        } else {
+            for (std::size_t i = 0; i < n; ++i) {
+                const float* frame = src + i * static_cast<std::size_t>(channelCount);
+                block->samples[2 * i] = frame[0];
+                block->samples[2 * i + 1] = channelCount > 1 ? frame[1] : frame[0];
+            }
+        }
+        block->frames = static_cast<std::uint32_t>(n);
+        block->sampleRate = sampleRate;
+        block->streamFrame = streamFrame + done;
+        publish(block);
+        done += n;
+    }
+    return done;
+}
+
+void AudioBlockBus::releaseBlock(AudioBlock* block) {
+    if (block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        m_inUse.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+AudioBlockBus::Stats AudioBlockBus::stats() const {
+    Stats s;
+    s.poolSize = m_poolSize;
+    s.blocksInUse = m_inUse.load(std::memory_order_relaxed);
+    s.peakBlocksInUse = m_peakInUse.load(std::memory_order_relaxed);
+    s.published = m_published.load(std::memory_order_relaxed);
+    s.poolExhausted = m_poolExhausted.load(std::memory_order_relaxed);
+
+    // A subscription being destroyed waits in unsubscribe() for this lock, so every entry is alive here
+    std::lock_guard<std::mutex> lock(m_subscribersMutex);
+    if (m_subscriberList) {
+        for (const Subscription* sub : m_subscriberList->entries) {
+            SubscriberStats ss;
+            ss.name = sub->m_name;
+            ss.pending = sub->pending();
+            ss.delivered = sub->delivered();
+            ss.dropped = sub->dropped();
+            s.subscribers.push_back(std::move(ss));
+        }
+    }
+    return s;
+}
+
+}
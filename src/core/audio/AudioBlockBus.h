@@ -0,0 +1,195 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "SpscRingBuffer.h"
+
+namespace NeonWave::Core::Audio {
+
+class AudioBlockBus;
+
+/**
+ * @brief Fixed-size block of interleaved stereo float PCM owned by a bus pool.
+ *
+ * Blocks are never allocated on the audio path: the bus hands out pooled
+ * blocks and takes them back once the last reference is released.
+ */
+struct AudioBlock {
+    static constexpr std::size_t kMaxFrames = 1024;
+
+    alignas(kCacheLineSize) float samples[kMaxFrames * 2];
+    std::uint32_t frames = 0;
+    std::uint32_t sampleRate = 0;
+    std::uint64_t streamFrame = 0; ///< Index of the first frame in the output stream
+
+private:
+    friend class AudioBlockBus;
+    friend class AudioBlockRef;
+    std::atomic<std::uint32_t> refs{0};
+    AudioBlockBus* owner = nullptr;
+};
+
+/**
+ * @brief Shared, read-only handle to a pooled block.
+ *
+ * Copying adds a reference; the block returns to the pool when the last
+ * handle is destroyed or reset(). Handles must not outlive the bus.
+ */
+class AudioBlockRef {
+public:
+    AudioBlockRef() = default;
+    AudioBlockRef(const AudioBlockRef& other);
+    AudioBlockRef(AudioBlockRef&& other) noexcept;
+    AudioBlockRef& operator=(const AudioBlockRef& other);
+    AudioBlockRef& operator=(AudioBlockRef&& other) noexcept;
+    ~AudioBlockRef() { reset(); }
+
+    void reset();
+
+    const AudioBlock* get() const { return m_block; }
+    const AudioBlock* operator->() const { return m_block; }
+    const AudioBlock& operator*() const { return *m_block; }
+    explicit operator bool() const { return m_block != nullptr; }
+
+private:
+    friend class AudioBlockBus;
+    /// Adopts a reference the caller already holds.
+    explicit AudioBlockRef(AudioBlock* adopted) : m_block(adopted) {}
+
+    AudioBlock* m_block = nullptr;
+};
+
+/**
+ * @brief Zero-copy fan-out of decoded PCM to any number of consumers.
+ *
+ * The decoder thread is the single producer. Each subscriber owns a private
+ * SPSC queue of block pointers and reads at its own pace; a slow subscriber
+ * only loses its own blocks (counted in dropped()) and never stalls the
+ * producer or the other subscribers.
+ *
+ * The producer never locks: it reads the subscriber list from an immutable
+ * snapshot that subscribe() and unsubscribing replace under a writer-only
+ * mutex. A writer frees the old snapshot once the producer has let go of it
+ * (a single hazard pointer), so stats() and subscription changes on the GUI
+ * thread cannot hold up publish().
+ *
+ * Create with std::make_shared; subscriptions keep the bus alive.
+ */
+class AudioBlockBus : public std::enable_shared_from_this<AudioBlockBus> {
+public:
+    static constexpr std::size_t kDefaultPoolSize = 256;
+    static constexpr std::size_t kDefaultQueueDepth = 64;
+
+    class Subscription {
+    public:
+        ~Subscription();
+
+        /// Consumer side: takes the oldest pending block, if any.
+        bool pop(AudioBlockRef& out);
+
+        /// Consumer side: releases every pending block.
+        void clear();
+
+        const std::string& name() const { return m_name; }
+        std::size_t pending() const { return m_queue.size(); }
+        std::uint64_t delivered() const { return m_delivered.load(std::memory_order_relaxed); }
+        std::uint64_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    private:
+        friend class AudioBlockBus;
+        Subscription(std::shared_ptr<AudioBlockBus> bus, std::string name, std::size_t depth);
+
+        std::shared_ptr<AudioBlockBus> m_bus;
+        std::string m_name;
+        SpscRingBuffer<AudioBlock*> m_queue;
+        std::atomic<std::uint64_t> m_delivered{0};
+        std::atomic<std::uint64_t> m_dropped{0};
+    };
+
+    struct SubscriberStats {
+        std::string name;
+        std::size_t pending = 0;
+        std::uint64_t delivered = 0;
+        std::uint64_t dropped = 0;
+    };
+
+    struct Stats {
+        std::size_t poolSize = 0;
+        std::size_t blocksInUse = 0;
+        std::size_t peakBlocksInUse = 0;
+        std::uint64_t published = 0;
+        std::uint64_t poolExhausted = 0; ///< Blocks lost because every pool block was still referenced
+        std::vector<SubscriberStats> subscribers;
+    };
+
+    explicit AudioBlockBus(std::size_t poolSize = kDefaultPoolSize);
+    ~AudioBlockBus();
+
+    AudioBlockBus(const AudioBlockBus&) = delete;
+    AudioBlockBus& operator=(const AudioBlockBus&) = delete;
+
+    /**
+     * @brief Register a consumer
+     * @param name Label used in stats
+     * @param queueDepth Blocks the consumer may fall behind before dropping
+     *
+     * Dropping the returned pointer unsubscribes and releases pending blocks.
+     */
+    std::shared_ptr<Subscription> subscribe(std::string name, std::size_t queueDepth = kDefaultQueueDepth);
+
+    /**
+     * @brief Producer side: copy interleaved PCM into pooled blocks and fan out
+     * @param data Interleaved samples
+     * @param frames Frame count
+     * @param channelCount 1 (duplicated to stereo) or 2+ (front pair kept)
+     * @param sampleRate Rate stamped on each block
+     * @param streamFrame Output-stream index of the first frame
+     * @return Frames published (less than @p frames only if the pool ran dry)
+     */
+    std::size_t publish(const float* data, std::size_t frames, int channelCount,
+                        std::uint32_t sampleRate, std::uint64_t streamFrame);
+
+    /// Producer side: take a free block to fill in place; nullptr if exhausted.
+    AudioBlock* acquire();
+
+    /// Producer side: hand a block obtained from acquire() to every subscriber.
+    void publish(AudioBlock* block);
+
+    Stats stats() const;
+
+private:
+    friend class AudioBlockRef;
+    void releaseBlock(AudioBlock* block);
+
+    /// Immutable once published; replaced wholesale by writers.
+    struct SubscriberList {
+        std::vector<Subscription*> entries;
+    };
+
+    /// Writer side, with m_subscribersMutex held: publish @p next and free the old list once the producer is off it.
+    void replaceSubscribers(std::unique_ptr<SubscriberList> next);
+    /// Called by ~Subscription(); after it returns publish() no longer sees @p subscription.
+    void unsubscribe(Subscription* subscription);
+
+    std::unique_ptr<AudioBlock[]> m_pool;
+    const std::size_t m_poolSize;
+    std::size_t m_cursor = 0; // producer-local scan position
+
+    std::atomic<std::size_t> m_inUse{0};
+    std::atomic<std::size_t> m_peakInUse{0};
+    std::atomic<std::uint64_t> m_published{0};
+    std::atomic<std::uint64_t> m_poolExhausted{0};
+
+    // Writers only (subscribe, unsubscribe, stats); publish() never takes it.
+    mutable std::mutex m_subscribersMutex;
+    std::unique_ptr<SubscriberList> m_subscriberList;            // owned copy of the current snapshot
+    std::atomic<const SubscriberList*> m_subscribers{nullptr};   // what publish() reads
+    std::atomic<const SubscriberList*> m_producerHazard{nullptr}; // the snapshot publish() is iterating
+};
+
+}
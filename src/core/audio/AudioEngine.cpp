@@ -1,112 +1,110 @@
 #include "AudioEngine.h"
-#include <QAudioBuffer>
-#include <QAudioFormat>
-#include <QDebug>
+#include <algorithm>
 
 namespace NeonWave::Core::Audio {
 
 AudioEngine::AudioEngine(QObject* parent)
     : QObject(parent)
-    , m_player(std::make_unique<QMediaPlayer>())
-    , m_audio_output(std::make_unique<QAudioBufferOutput>(this))
-    , m_audio_sink(nullptr)
-    , m_sink_device(nullptr)
+    , m_bus(std::make_shared<AudioBlockBus>())
+    , m_clock(std::make_shared<PlaybackClock>())
 {
-    m_player->setAudioBufferOutput(m_audio_output.get());
+    m_worker = new AudioWorker(m_bus, m_clock);
+    m_worker->moveToThread(&m_thread);
 
-    connect(m_audio_output.get(), &QAudioBufferOutput::audioBufferReceived,
-            this, &AudioEngine::onAudioBufferReceived);
+    connect(m_worker, &AudioWorker::positionChanged, this, &AudioEngine::positionChanged);
+    connect(m_worker, &AudioWorker::stateChanged, this, &AudioEngine::stateChanged);
+    connect(m_worker, &AudioWorker::trackChanged, this, &AudioEngine::trackChanged);
 
-    connect(m_player.get(), &QMediaPlayer::positionChanged,
-            this, &AudioEngine::onPositionChanged);
-    connect(m_player.get(), &QMediaPlayer::mediaStatusChanged,
-            this, &AudioEngine::onMediaStatusChanged);
-    connect(m_player.get(), &QMediaPlayer::playbackStateChanged,
-            this, &AudioEngine::stateChanged);
+    m_thread.setObjectName("NeonWave Audio");
+    m_thread.start(QThread::TimeCriticalPriority);
+
+    // Multimedia objects must be created on the thread that will drive them
+    post([w = m_worker]() { w->initialize(); });
 }
 
 AudioEngine::~AudioEngine() {
-    if (m_audio_sink) {
-        m_audio_sink->stop();
-    }
+    QMetaObject::invokeMethod(m_worker, [w = m_worker]() {
+        w->shutdown();
+        delete w;
+    }, Qt::BlockingQueuedConnection);
+    m_worker = nullptr;
+    m_thread.quit();
+    m_thread.wait();
+}
+
+template <typename Fn>
+void AudioEngine::post(Fn&& fn) {
+    QMetaObject::invokeMethod(m_worker, std::forward<Fn>(fn), Qt::QueuedConnection);
 }
 
 void AudioEngine::setPlaylist(const QStringList& files) {
-    m_files = files;
-    m_index = m_files.isEmpty() ? -1 : 0;
-    loadCurrent();
+    post([w = m_worker, files]() { w->setPlaylist(files); });
 }
 
 void AudioEngine::play() {
-    m_player->play();
+    post([w = m_worker]() { w->play(); });
 }
 
 void AudioEngine::pause() {
-    m_player->pause();
+    post([w = m_worker]() { w->pause(); });
 }
 
 void AudioEngine::stop() {
-    m_player->stop();
-    if (m_audio_sink) {
-        m_audio_sink->stop();
-        m_audio_sink.reset();
-        m_sink_device = nullptr;
-    }
+    post([w = m_worker]() { w->stop(); });
 }
 
 void AudioEngine::next() {
-    if (m_files.isEmpty()) return;
-    m_index = (m_index + 1) % m_files.size();
-    loadCurrent();
-    play();
+    post([w = m_worker]() { w->next(); });
 }
 
 void AudioEngine::previous() {
-    if (m_files.isEmpty()) return;
-    m_index = (m_index - 1 + m_files.size()) % m_files.size();
-    loadCurrent();
-    play();
+    post([w = m_worker]() { w->previous(); });
+}
+
+void AudioEngine::seek(qint64 positionMs) {
+    // A drag posts a seek per mouse move; fold them into the one still waiting in the queue
+    if (m_pendingSeekMs.exchange(std::max<qint64>(positionMs, 0)) >= 0) return;
+    post([this, w = m_worker]() { w->seek(m_pendingSeekMs.exchange(-1)); });
+}
+
+void AudioEngine::setPrerollSeconds(double seconds) {
+    post([w = m_worker, seconds]() { w->setPrerollSeconds(seconds); });
 }
 
+void AudioEngine::setTargetLatencyMs(int ms) {
+    post([w = m_worker, ms]() { w->setTargetLatencyMs(ms); });
+}
 
+void AudioEngine::setDecoderBackend(DecoderBackend backend) {
+    post([w = m_worker, backend]() { w->setDecoderBackend(backend); });
+}
 
-void AudioEngine::onPositionChanged(qint64 pos) {
-    emit positionChanged(pos, m_player->duration());
+void AudioEngine::setLoudnessStore(std::shared_ptr<const LoudnessStore> store) {
+    post([w = m_worker, store = std::move(store)]() { w->setLoudnessStore(store); });
 }
 
-void AudioEngine::onMediaStatusChanged(QMediaPlayer::MediaStatus status) {
-    if (status == QMediaPlayer::EndOfMedia) {
-        next();
-    }
+void AudioEngine::setNormalization(bool output, bool visualizer, double targetLufs) {
+    post([w = m_worker, output, visualizer, targetLufs]() { w->setNormalization(output, visualizer, targetLufs); });
 }
 
-void AudioEngine::onAudioBufferReceived(const QAudioBuffer& buffer) {
-    if (!buffer.isValid()) {
-        return;
-    }
+void AudioEngine::setSeekIndexCache(std::shared_ptr<SeekIndexCache> cache) {
+    post([w = m_worker, cache = std::move(cache)]() { w->setSeekIndexCache(cache); });
+}
 
-    // Initialize sink on first valid buffer
-    if (!m_audio_sink) {
-        m_audio_sink = std::make_unique<QAudioSink>(buffer.format(), this);
-        m_sink_device = m_audio_sink->start();
-    }
+void AudioEngine::setCrossfadeSeconds(double seconds) {
+    post([w = m_worker, seconds]() { w->setCrossfadeSeconds(seconds); });
+}
 
-    // Write to playback device
-    if (m_sink_device) {
-        m_sink_device->write(buffer.constData<char>(), buffer.byteCount());
-    }
+void AudioEngine::setVolume(double volume) {
+    post([w = m_worker, volume]() { w->setVolume(volume); });
+}
 
-    // Send to visualizer via signal
-    const QAudioFormat format = buffer.format();
-    if (format.sampleFormat() == QAudioFormat::Float) {
-        QByteArray data(buffer.constData<char>(), buffer.byteCount());
-        emit pcmDataAvailable(data, buffer.sampleCount(), format.channelCount());
-    }
+void AudioEngine::setEqualizer(bool enabled, const std::vector<EqBand>& bands) {
+    post([w = m_worker, enabled, bands]() { w->setEqualizer(enabled, bands); });
 }
 
-void AudioEngine::loadCurrent() {
-    if (m_index < 0 || m_index >= m_files.size()) return;
-    m_player->setSource(QUrl::fromLocalFile(m_files[m_index]));
+void AudioEngine::setLimiterEnabled(bool enabled) {
+    post([w = m_worker, enabled]() { w->setLimiterEnabled(enabled); });
 }
 
 }
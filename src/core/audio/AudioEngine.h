@@ -2,16 +2,25 @@
 
 #include <QObject>
 #include <QMediaPlayer>
-#include <QAudioBufferOutput>
-#include <QAudioSink>
 #include <QStringList>
+#include <QThread>
+#include <atomic>
 #include <memory>
-#include <functional>
-
-class QAudioBuffer;
+#include <vector>
+#include "AudioBlockBus.h"
+#include "AudioWorker.h"
+#include "PlaybackClock.h"
 
 namespace NeonWave::Core::Audio {
 
+/**
+ * @brief GUI-facing handle to playback.
+ *
+ * Decode and sink output run on a dedicated high-priority audio thread owned
+ * by the engine, so GUI work (resizes, dialogs) cannot delay them. Every
+ * command below is queued onto that thread and returns immediately; it is
+ * safe to call from any thread.
+ */
 class AudioEngine : public QObject {
     Q_OBJECT
 public:
@@ -24,26 +33,78 @@ public:
     void stop();
     void next();
     void previous();
+    /// Jump within the current track; while a slider is dragged only the latest target is acted on.
+    void seek(qint64 positionMs);
+
+    /// Open the next playlist entry this many seconds before the current one ends.
+    void setPrerollSeconds(double seconds);
+
+    /// Decoded audio kept queued in front of the sink, clamped to 10-200 ms.
+    void setTargetLatencyMs(int ms);
+
+    /// Switch playback decoding between Qt Multimedia and libav (when built in).
+    void setDecoderBackend(DecoderBackend backend);
+
+    /// Loudness measurements to normalise from (see LoudnessScanner::store()).
+    void setLoudnessStore(std::shared_ptr<const LoudnessStore> store);
+
+    /// Normalise measured tracks to @p targetLufs on the speakers and/or the visualizer feed.
+    void setNormalization(bool output, bool visualizer, double targetLufs);
+
+    /// Overlap consecutive tracks by this many seconds (equal-power); 0 keeps them gapless.
+    void setCrossfadeSeconds(double seconds);
+
+    /// Per-file seek tables, built when a track first plays (libav decoding only).
+    void setSeekIndexCache(std::shared_ptr<SeekIndexCache> cache);
+
+    /// Playback volume as a 0-1 slider position (cubic taper); the PCM bus is unaffected.
+    void setVolume(double volume);
+
+    /// Parametric EQ on what the sink plays.
+    void setEqualizer(bool enabled, const std::vector<EqBand>& bands);
+
+    /// Lookahead limiter holding the sink under -1 dBFS; adds 2 ms of latency while on.
+    void setLimiterEnabled(bool enabled);
+
+    /// Decoded PCM fan-out; subscribe to receive every block without copying.
+    std::shared_ptr<AudioBlockBus> audioBus() const { return m_bus; }
+
+    /// Audible position on the bus's streamFrame axis, for delaying consumers to match the speakers.
+    std::shared_ptr<const PlaybackClock> playbackClock() const { return m_clock; }
+
+    /// Ingest conversion throughput, per decoder sample format.
+    SampleConverter::FormatStats conversionStats(SampleType type) const { return m_worker->conversionStats(type); }
+
+    /// Per-pass output pump time measured on the audio thread.
+    CallbackStats callbackStats() const { return m_worker->callbackStats(); }
+
+    /// Silence measured at track boundaries.
+    GaplessStats gaplessStats() const { return m_worker->gaplessStats(); }
+
+    /// Sink jitter buffer fill, period and under/overrun counters.
+    JitterStats jitterStats() const { return m_worker->jitterStats(); }
+
+    /// Normalisation gain of the track most recently started.
+    NormalizationStats normalizationStats() const { return m_worker->normalizationStats(); }
+
+    /// Seek count and time to first audio after a seek.
+    SeekStats seekStats() const { return m_worker->seekStats(); }
 
 signals:
-    void pcmDataAvailable(const QByteArray& data, int sampleCount, int channelCount);
     void positionChanged(qint64 positionMs, qint64 durationMs);
     void stateChanged(QMediaPlayer::PlaybackState state);
-
-private slots:
-    void onPositionChanged(qint64);
-    void onMediaStatusChanged(QMediaPlayer::MediaStatus);
-    void onAudioBufferReceived(const QAudioBuffer& buffer);
+    /// Playlist entry now feeding the sink, including automatic advances.
+    void trackChanged(int index);
 
 private:
-    void loadCurrent();
-
-    std::unique_ptr<QMediaPlayer> m_player;
-    std::unique_ptr<QAudioBufferOutput> m_audio_output;
-    std::unique_ptr<QAudioSink> m_audio_sink;
-    QIODevice* m_sink_device = nullptr;
-    QStringList m_files;
-    int m_index{ -1 };
+    template <typename Fn>
+    void post(Fn&& fn);
+
+    std::shared_ptr<AudioBlockBus> m_bus;
+    std::shared_ptr<PlaybackClock> m_clock;
+    QThread m_thread;
+    AudioWorker* m_worker = nullptr; // lives on m_thread
+    std::atomic<qint64> m_pendingSeekMs{-1}; // target of the seek still queued to the worker, -1 if none
 };
 
 }
@@ -0,0 +1,722 @@
+#include "AudioWorker.h"
+#include "FileDecoder.h"
+#include "LoudnessScanner.h"
+#include "QtTrackDecoder.h"
+#include "SeekIndexCache.h"
+#include "ThreadedTrackDecoder.h"
+#include <QAudioDevice>
+#include <QMediaDevices>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+namespace NeonWave::Core::Audio {
+
+namespace {
+
+constexpr int kPumpIntervalMs = 5;
+constexpr qint64 kDecodeAheadMs = 2000;
+constexpr std::size_t kDecodeAheadFrames = 1 << 17; // ~2.7 s at 48 kHz
+constexpr std::size_t kMaxPumpFrames = 8192;
+constexpr qint64 kPositionIntervalMs = 100;
+constexpr double kMaxNormalizeDb = 18.0;
+constexpr double kOutputPeakCeilingDbtp = -1.0; // EBU R128 ceiling, so boosting never clips the sink
+constexpr double kMaxCrossfadeSeconds = 30.0;
+constexpr double kCrossfadeLeadSeconds = 1.0; // incoming track opens this long before its fade starts
+
+float dbToGain(double db) {
+    return static_cast<float>(std::pow(10.0, db / 20.0));
+}
+
+} // namespace
+
+AudioWorker::AudioWorker(std::shared_ptr<AudioBlockBus> bus, std::shared_ptr<PlaybackClock> clock)
+    : QObject(nullptr)
+    , m_bus(std::move(bus))
+    , m_clock(std::move(clock))
+{
+}
+
+AudioWorker::~AudioWorker() {
+    shutdown();
+}
+
+void AudioWorker::initialize() {
+    for (auto& slot : m_slots) {
+        slot = makeDecoder();
+    }
+    // Sized for the largest pump pass up front so crossfading never allocates on the audio thread
+    m_stereoScratch.resize(kMaxPumpFrames * 2);
+    m_incomingScratch.resize(kMaxPumpFrames * 2);
+
+    m_pumpTimer = std::make_unique<QTimer>();
+    m_pumpTimer->setTimerType(Qt::PreciseTimer);
+    m_pumpTimer->setInterval(kPumpIntervalMs);
+    connect(m_pumpTimer.get(), &QTimer::timeout, this, &AudioWorker::pump);
+}
+
+void AudioWorker::shutdown() {
+    if (m_pumpTimer) {
+        m_pumpTimer->stop();
+        m_pumpTimer.reset();
+    }
+    closeSink();
+    for (auto& slot : m_slots) {
+        slot.reset();
+    }
+    m_slotIndex = { -1, -1 };
+}
+
+void AudioWorker::setPlaylist(const QStringList& files) {
+    m_pumpTimer->stop();
+    m_files = files;
+    m_index = m_files.isEmpty() ? -1 : 0;
+    loadCurrent();
+    setState(QMediaPlayer::StoppedState);
+}
+
+void AudioWorker::play() {
+    if (m_index < 0) return;
+    if (m_state == QMediaPlayer::PausedState && m_audio_sink) {
+        m_audio_sink->resume();
+    }
+    m_pumpTimer->start();
+    setState(QMediaPlayer::PlayingState);
+}
+
+void AudioWorker::pause() {
+    if (m_state != QMediaPlayer::PlayingState) return;
+    m_pumpTimer->stop();
+    m_pumpClock.invalidate();
+    if (m_audio_sink) {
+        m_audio_sink->suspend();
+    }
+    stampClock(false);
+    setState(QMediaPlayer::PausedState);
+}
+
+void AudioWorker::seek(qint64 positionMs) {
+    if (m_index < 0) return;
+    const int rate = current().sampleRate();
+    if (rate <= 0) return;
+    const qint64 frame = std::max<qint64>(positionMs, 0) * rate / 1000;
+    cancelCrossfade();
+    m_seekTimer.start();
+    m_seekPending = true;
+    m_seeks.fetch_add(1, std::memory_order_relaxed);
+    if (m_seekIndexes) {
+        auto index = m_seekIndexes->lookup(current().path());
+        if (index) m_indexedSeeks.fetch_add(1, std::memory_order_relaxed);
+        current().setSeekIndex(std::move(index));
+    }
+    current().seek(frame);
+    m_trackFrame = static_cast<std::uint64_t>(frame);
+    m_awaitingNextTrack = false;
+    // Drop what is still queued from the old position, visualizer included; the pump reopens the sink
+    m_flushedFrame = m_streamFrame;
+    closeSink();
+    m_jitter.reset(0);
+    m_busGainChanges.clear();
+    m_trackGainPending = true;
+}
+
+void AudioWorker::stop() {
+    m_pumpTimer->stop();
+    m_pumpClock.invalidate();
+    loadCurrent();
+    setState(QMediaPlayer::StoppedState);
+    emit positionChanged(0, m_index >= 0 ? current().durationMs() : 0);
+}
+
+void AudioWorker::next() {
+    if (m_files.isEmpty()) return;
+    m_index = (m_index + 1) % m_files.size();
+    loadCurrent();
+    play();
+}
+
+void AudioWorker::previous() {
+    if (m_files.isEmpty()) return;
+    m_index = (m_index - 1 + m_files.size()) % m_files.size();
+    loadCurrent();
+    play();
+}
+
+void AudioWorker::setPrerollSeconds(double seconds) {
+    m_prerollSeconds = std::max(seconds, 0.0);
+}
+
+void AudioWorker::setTargetLatencyMs(int ms) {
+    m_jitter.setTargetLatencyMs(ms);
+}
+
+void AudioWorker::setLoudnessStore(std::shared_ptr<const LoudnessStore> store) {
+    m_loudness = std::move(store);
+    m_trackGainPending = true;
+}
+
+void AudioWorker::setNormalization(bool output, bool visualizer, double targetLufs) {
+    m_normalizeOutput = output;
+    m_normalizeVisuals = visualizer;
+    m_targetLufs = targetLufs;
+    // Takes effect from the next decoded block, i.e. one jitter buffer later
+    m_trackGainPending = true;
+}
+
+void AudioWorker::setCrossfadeSeconds(double seconds) {
+    // A fade already under way finishes at its original length
+    m_crossfadeSeconds = std::clamp(seconds, 0.0, kMaxCrossfadeSeconds);
+}
+
+void AudioWorker::setSeekIndexCache(std::shared_ptr<SeekIndexCache> cache) {
+    m_seekIndexes = std::move(cache);
+    requestSeekIndex();
+}
+
+void AudioWorker::setVolume(double volume) {
+    // Cubic taper: roughly even loudness steps across the slider, and silence at zero
+    const double v = std::clamp(volume, 0.0, 1.0);
+    m_dsp.setGain(static_cast<float>(v * v * v));
+}
+
+void AudioWorker::setEqualizer(bool enabled, const std::vector<EqBand>& bands) {
+    m_dsp.setEqBands(bands);
+    m_dsp.setEnabled(DspChain::Node::Equalizer, enabled);
+}
+
+void AudioWorker::setLimiterEnabled(bool enabled) {
+    m_dsp.setEnabled(DspChain::Node::Limiter, enabled);
+}
+
+void AudioWorker::setDecoderBackend(DecoderBackend backend) {
+    if (backend == DecoderBackend::Libav && !hasFileDecoder()) {
+        std::cerr << "[AudioWorker] Built without libav; staying on Qt Multimedia decoding" << std::endl;
+        backend = DecoderBackend::QtMultimedia;
+    }
+    if (backend == m_backend) return;
+    m_backend = backend;
+    if (!m_slots[0]) return; // initialize() picks it up
+
+    for (auto& slot : m_slots) {
+        slot = makeDecoder();
+    }
+    m_slotIndex = { -1, -1 };
+    loadCurrent();
+}
+
+std::unique_ptr<TrackDecoder> AudioWorker::makeDecoder() {
+    if (m_backend == DecoderBackend::Libav) {
+        if (auto file = createFileDecoder()) {
+            return std::make_unique<ThreadedTrackDecoder>(std::move(file), kDecodeAheadFrames);
+        }
+    }
+    return std::make_unique<QtTrackDecoder>(m_converter, kDecodeAheadMs);
+}
+
+void AudioWorker::loadCurrent() {
+    cancelCrossfade();
+    m_flushedFrame = m_streamFrame;
+    m_seekPending = false;
+    closeSink();
+    m_jitter.reset(0);
+    m_busGainChanges.clear();
+    m_trackGainPending = true;
+    m_awaitingNextTrack = false;
+    m_trackFrame = 0;
+    m_lastPositionEmitMs = 0;
+
+    const int other = m_current ^ 1;
+    if (m_index < 0 || m_index >= m_files.size()) {
+        current().close();
+        upcoming().close();
+        m_slotIndex = { -1, -1 };
+        return;
+    }
+
+    if (m_slotIndex[other] == m_index && !upcoming().hasError()) {
+        // Skipping to the entry that is already pre-rolled: start from its decoded head
+        current().close();
+        m_slotIndex[m_current] = -1;
+        m_current = other;
+    } else {
+        upcoming().close();
+        m_slotIndex[other] = -1;
+        current().open(m_files[m_index]);
+        m_slotIndex[m_current] = m_index;
+    }
+    requestSeekIndex();
+    emit trackChanged(m_index);
+}
+
+void AudioWorker::prerollNext() {
+    if (m_files.isEmpty() || m_index < 0) return;
+    const int nextIndex = (m_index + 1) % m_files.size();
+    if (m_slotIndex[m_current ^ 1] == nextIndex) return;
+
+    // Wait until the current track is decoding so its rate and duration are known
+    const int rate = current().sampleRate();
+    if (rate <= 0) return;
+    const qint64 durationMs = current().durationMs();
+    if (durationMs > 0) {
+        const qint64 playedMs = static_cast<qint64>(m_trackFrame * 1000 / static_cast<std::uint64_t>(rate));
+        // A crossfade needs the next track decoding before the fade starts, not before the end
+        const double window = m_crossfadeSeconds > 0.0
+            ? std::max(m_prerollSeconds, m_crossfadeSeconds + kCrossfadeLeadSeconds) : m_prerollSeconds;
+        if (durationMs - playedMs > static_cast<qint64>(window * 1000.0)) return;
+    }
+
+    upcoming().open(m_files[nextIndex]);
+    m_slotIndex[m_current ^ 1] = nextIndex;
+}
+
+bool AudioWorker::advance() {
+    if (m_files.isEmpty()) return false;
+    const int nextIndex = (m_index + 1) % m_files.size();
+    if (m_slotIndex[m_current ^ 1] != nextIndex) {
+        // Track shorter than the preroll window ran out before it was scheduled
+        upcoming().open(m_files[nextIndex]);
+        m_slotIndex[m_current ^ 1] = nextIndex;
+    }
+    current().close();
+    m_slotIndex[m_current] = -1;
+    m_current ^= 1;
+    m_index = nextIndex;
+    m_trackFrame = 0;
+    m_lastPositionEmitMs = 0;
+    m_trackGainPending = true;
+    requestSeekIndex();
+    emit trackChanged(m_index);
+    return true;
+}
+
+void AudioWorker::pump() {
+    if (m_state != QMediaPlayer::PlayingState || m_index < 0) return;
+    const auto start = std::chrono::steady_clock::now();
+    if (m_pumpClock.isValid()) {
+        m_jitter.notePumpInterval(static_cast<std::uint64_t>(m_pumpClock.nsecsElapsed()));
+    }
+    m_pumpClock.start();
+
+    prerollNext();
+    fillJitter();
+    const std::size_t written = drainJitter();
+
+    const std::size_t buffered = sinkBufferedFrames();
+    m_sinkBufferedFrames.store(buffered, std::memory_order_relaxed);
+    stampClock(true);
+
+    if (written > 0) {
+        const auto elapsed = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count());
+        recordPass(elapsed, written * 1000000000ull / static_cast<std::uint64_t>(m_sinkFormat.sampleRate()));
+    }
+
+    // Position of what is audible now, not of what was just decoded
+    if (m_audio_sink) {
+        const std::uint64_t pending = buffered + m_jitter.bufferedFrames() + m_dsp.latencyFrames();
+        const std::uint64_t played = m_trackFrame > pending ? m_trackFrame - pending : 0;
+        const qint64 positionMs = static_cast<qint64>(played * 1000 / static_cast<std::uint64_t>(m_sinkFormat.sampleRate()));
+        if (std::abs(positionMs - m_lastPositionEmitMs) >= kPositionIntervalMs) {
+            m_lastPositionEmitMs = positionMs;
+            emit positionChanged(positionMs, current().durationMs());
+        }
+    }
+}
+
+void AudioWorker::fillJitter() {
+    int advances = 0;
+    while (advances <= m_files.size()) {
+        const int rate = current().sampleRate();
+        if (rate <= 0) {
+            // Nothing decoded yet; skip entries that fail outright
+            if (current().atEnd() && advance()) { ++advances; continue; }
+            break;
+        }
+
+        if (rate != m_jitter.sampleRate()) {
+            // Rate change at a boundary: let everything queued at the old rate play out first
+            if (m_jitter.bufferedFrames() > 0 || sinkBufferedFrames() > 0) break;
+            closeSink();
+            m_jitter.reset(rate);
+        }
+
+        std::size_t want = std::min(m_jitter.fillRoom(), kMaxPumpFrames);
+        if (want == 0) break;
+        if (m_stereoScratch.size() < want * 2) m_stereoScratch.resize(want * 2);
+
+        if (m_crossfade.active()) {
+            if (mixCrossfade(want) > 0) continue;
+            if (m_crossfade.active()) break; // a decoder has not caught up yet; the jitter buffer covers it
+            continue;                        // both tracks ran out early; the fade was cut short
+        }
+        if (m_crossfadeSeconds > 0.0) {
+            // Stop reading exactly where the fade is due to start, then start it if the next track is ready
+            const auto fadeFrames = static_cast<std::uint64_t>(std::llround(m_crossfadeSeconds * rate));
+            const std::uint64_t left = remainingTrackFrames(rate);
+            if (left > fadeFrames) {
+                want = static_cast<std::size_t>(std::min<std::uint64_t>(want, left - fadeFrames));
+            } else if (startCrossfade(rate, left)) {
+                continue;
+            }
+        }
+
+        const std::size_t frames = current().read(m_stereoScratch.data(), want);
+        if (frames > 0) {
+            if (m_awaitingNextTrack) {
+                // Whatever wall time the queued audio could not cover was heard as silence
+                const double elapsedFrames = m_trackEndTimer.nsecsElapsed() * 1e-9 * rate;
+                const double gap = std::max(0.0, elapsedFrames - static_cast<double>(m_bufferedAtTrackEnd));
+                const auto gapFrames = static_cast<std::uint64_t>(std::llround(gap));
+                m_transitions.fetch_add(1, std::memory_order_relaxed);
+                m_lastGapFrames.store(gapFrames, std::memory_order_relaxed);
+                if (gapFrames > m_maxGapFrames.load(std::memory_order_relaxed)) {
+                    m_maxGapFrames.store(gapFrames, std::memory_order_relaxed);
+                }
+                if (gapFrames > 0) m_gappedTransitions.fetch_add(1, std::memory_order_relaxed);
+                m_awaitingNextTrack = false;
+            }
+            if (m_trackGainPending) updateTrackGain();
+            if (m_outputGain != 1.0f) {
+                for (std::size_t i = 0; i < frames * 2; ++i) m_stereoScratch[i] *= m_outputGain;
+            }
+            if (m_seekPending) {
+                m_seekPending = false;
+                const auto ns = static_cast<std::uint64_t>(m_seekTimer.nsecsElapsed());
+                m_lastSeekNs.store(ns, std::memory_order_relaxed);
+                if (ns > m_maxSeekNs.load(std::memory_order_relaxed)) m_maxSeekNs.store(ns, std::memory_order_relaxed);
+            }
+            m_jitter.push(m_stereoScratch.data(), frames);
+            m_trackFrame += frames;
+            continue;
+        }
+
+        if (current().atEnd()) {
+            if (!m_awaitingNextTrack) {
+                m_awaitingNextTrack = true;
+                m_bufferedAtTrackEnd = m_jitter.bufferedFrames() + sinkBufferedFrames();
+                m_trackEndTimer.start();
+            }
+            if (!advance()) break;
+            ++advances;
+            continue;
+        }
+        break; // decoder has not caught up yet; the jitter buffer covers it
+    }
+}
+
+std::size_t AudioWorker::drainJitter() {
+    if (!m_audio_sink) {
+        if (m_jitter.sampleRate() <= 0 || m_jitter.bufferedFrames() == 0) return 0;
+        if (!openSink(m_jitter.sampleRate())) return 0;
+    }
+    const auto room = static_cast<std::size_t>(m_audio_sink->bytesFree() / m_sinkFormat.bytesPerFrame());
+    return m_jitter.drainTo(room, sinkBufferedFrames(), [this](const float* stereo, std::size_t frames) {
+        return writeOut(stereo, frames);
+    });
+}
+
+bool AudioWorker::openSink(int sampleRate) {
+    QAudioFormat format;
+    format.setSampleRate(sampleRate);
+    format.setChannelCount(2);
+    format.setChannelConfig(QAudioFormat::ChannelConfigStereo);
+    format.setSampleFormat(QAudioFormat::Float);
+
+    const QAudioDevice device = QMediaDevices::defaultAudioOutput();
+    if (!device.isFormatSupported(format)) {
+        format.setSampleFormat(QAudioFormat::Int16);
+    }
+
+    m_audio_sink = std::make_unique<QAudioSink>(device, format);
+    m_audio_sink->setBufferSize(format.bytesForDuration(qint64(m_jitter.targetLatencyMs()) * 1000));
+    connect(m_audio_sink.get(), &QAudioSink::stateChanged, this, [this](QAudio::State state) {
+        if (state == QAudio::IdleState && m_state == QMediaPlayer::PlayingState
+            && m_audio_sink && m_audio_sink->error() == QAudio::UnderrunError) {
+            m_jitter.noteUnderrun();
+        }
+    });
+    m_sink_device = m_audio_sink->start();
+    if (!m_sink_device) {
+        std::cerr << "[AudioWorker] Failed to open audio sink at " << sampleRate << " Hz" << std::endl;
+        closeSink();
+        return false;
+    }
+    m_sinkFormat = format;
+    m_sinkStartFrame = m_streamFrame;
+    m_dsp.prepare(sampleRate);
+    m_dspPending = 0;
+    std::cout << "[AudioWorker] Sink opened: " << sampleRate << " Hz, "
+              << (format.sampleFormat() == QAudioFormat::Float ? "float" : "int16") << ", "
+              << m_audio_sink->bufferSize() / format.bytesPerFrame() << " frame buffer" << std::endl;
+    return true;
+}
+
+void AudioWorker::closeSink() {
+    if (m_audio_sink) {
+        // Whatever the sink still held is discarded, so treat it as already heard
+        m_clock->update({ m_streamFrame, PlaybackClock::nowNs(),
+                          static_cast<std::uint32_t>(m_sinkFormat.sampleRate()), false, m_streamFrame, m_flushedFrame });
+        m_audio_sink->disconnect(this);
+        m_audio_sink->stop();
+        m_audio_sink.reset();
+    }
+    m_sink_device = nullptr;
+    m_dspPending = 0;
+    m_sinkBufferedFrames.store(0, std::memory_order_relaxed);
+}
+
+std::size_t AudioWorker::sinkBufferedFrames() const {
+    if (!m_audio_sink) return 0;
+    const qsizetype buffered = m_audio_sink->bufferSize() - m_audio_sink->bytesFree();
+    return buffered > 0 ? static_cast<std::size_t>(buffered / m_sinkFormat.bytesPerFrame()) : 0;
+}
+
+std::size_t AudioWorker::writeOut(const float* stereo, std::size_t frames) {
+    const std::size_t samples = frames * 2;
+    // The head of what is offered may already have been through the DSP chain on an earlier, partial write
+    if (frames > m_dspPending) {
+        if (m_dspOut.size() < samples) m_dspOut.resize(samples);
+        std::copy(stereo + m_dspPending * 2, stereo + samples, m_dspOut.begin() + static_cast<std::ptrdiff_t>(m_dspPending * 2));
+        m_dsp.process(m_dspOut.data() + m_dspPending * 2, frames - m_dspPending);
+        m_dspPending = frames;
+    }
+    const float* out = m_dspOut.data();
+
+    qint64 accepted = 0;
+    if (m_sinkFormat.sampleFormat() == QAudioFormat::Float) {
+        accepted = m_sink_device->write(reinterpret_cast<const char*>(out), static_cast<qint64>(samples * sizeof(float)));
+    } else {
+        if (m_int16Scratch.size() < samples) m_int16Scratch.resize(samples);
+        for (std::size_t i = 0; i < samples; ++i) {
+            const float s = std::clamp(out[i], -1.0f, 1.0f);
+            m_int16Scratch[i] = static_cast<qint16>(std::lrint(s * 32767.0f));
+        }
+        accepted = m_sink_device->write(reinterpret_cast<const char*>(m_int16Scratch.data()),
+                                        static_cast<qint64>(samples * sizeof(qint16)));
+    }
+    const std::size_t acceptedFrames = accepted > 0 ? static_cast<std::size_t>(accepted / m_sinkFormat.bytesPerFrame()) : 0;
+    if (acceptedFrames == 0) return 0;
+    m_dspPending -= acceptedFrames;
+    std::copy(m_dspOut.begin() + static_cast<std::ptrdiff_t>(acceptedFrames * 2),
+              m_dspOut.begin() + static_cast<std::ptrdiff_t>((acceptedFrames + m_dspPending) * 2), m_dspOut.begin());
+
+    // Fan exactly what the sink took out to the visualizer and other subscribers; never blocks on them
+    const float* busPcm = stereo;
+    if (m_busGain != 1.0f || !m_busGainChanges.empty()) {
+        if (m_busScratch.size() < samples) m_busScratch.resize(samples);
+        std::size_t i = 0;
+        while (i < acceptedFrames) {
+            while (!m_busGainChanges.empty() && m_busGainChanges.front().streamFrame <= m_streamFrame + i) {
+                m_busGain = m_busGainChanges.front().gain;
+                m_busGainChanges.pop_front();
+            }
+            std::size_t end = acceptedFrames;
+            if (!m_busGainChanges.empty()) {
+                end = std::min<std::size_t>(end, m_busGainChanges.front().streamFrame - m_streamFrame);
+            }
+            for (std::size_t j = i * 2; j < end * 2; ++j) m_busScratch[j] = stereo[j] * m_busGain;
+            i = end;
+        }
+        busPcm = m_busScratch.data();
+    }
+    m_bus->publish(busPcm, acceptedFrames, 2, static_cast<std::uint32_t>(m_sinkFormat.sampleRate()), m_streamFrame);
+    m_streamFrame += acceptedFrames;
+    return acceptedFrames;
+}
+
+void AudioWorker::setState(QMediaPlayer::PlaybackState state) {
+    if (state == m_state) return;
+    m_state = state;
+    emit stateChanged(state);
+}
+
+std::uint64_t AudioWorker::remainingTrackFrames(int rate) const {
+    const qint64 durationMs = m_slots[m_current]->durationMs();
+    if (durationMs <= 0) return std::numeric_limits<std::uint64_t>::max();
+    const auto total = static_cast<std::uint64_t>(durationMs) * static_cast<std::uint64_t>(rate) / 1000;
+    return total > m_trackFrame ? total - m_trackFrame : 0;
+}
+
+bool AudioWorker::startCrossfade(int rate, std::uint64_t frames) {
+    if (frames < CrossfadeMixer::kSegmentFrames || m_files.isEmpty()) return false;
+    const int nextIndex = (m_index + 1) % m_files.size();
+    TrackDecoder& next = upcoming();
+    if (m_slotIndex[m_current ^ 1] != nextIndex || next.hasError()) return false;
+    // Only same-rate neighbours overlap; a rate change still goes through the gapless switch
+    if (next.sampleRate() != rate || next.bufferedFrames() == 0) return false;
+
+    if (m_trackGainPending) updateTrackGain();
+    m_incomingGains = gainsFor(nextIndex);
+    m_crossfade.start(static_cast<std::size_t>(frames), m_outputGain, m_incomingGains.output);
+    m_incomingFrame = 0;
+    // The visualizer switches to the incoming track's gain halfway, where both are equally loud
+    m_busGainChanges.push_back({ m_streamFrame + m_jitter.bufferedFrames() + frames / 2, m_incomingGains.bus });
+    return true;
+}
+
+std::size_t AudioWorker::mixCrossfade(std::size_t want) {
+    // A side that has run out is mixed as silence; a side that is merely behind holds the fade
+    TrackDecoder& outgoing = current();
+    TrackDecoder& incoming = upcoming();
+    const bool outgoingDone = outgoing.atEnd();
+    const bool incomingDone = incoming.atEnd() || incoming.hasError();
+    if (outgoingDone && incomingDone) {
+        finishCrossfade();
+        return 0;
+    }
+    std::size_t frames = std::min(want, m_crossfade.remaining());
+    if (!outgoingDone) frames = std::min(frames, outgoing.bufferedFrames());
+    if (!incomingDone) frames = std::min(frames, incoming.bufferedFrames());
+    if (frames == 0) return 0;
+
+    float* out = m_stereoScratch.data();
+    float* in = m_incomingScratch.data();
+    const std::size_t gotOut = outgoingDone ? 0 : outgoing.read(out, frames);
+    const std::size_t gotIn = incomingDone ? 0 : incoming.read(in, frames);
+    std::fill(out + gotOut * 2, out + frames * 2, 0.0f);
+    std::fill(in + gotIn * 2, in + frames * 2, 0.0f);
+
+    // Both tracks' output gains are folded into the fade curves
+    m_crossfade.mix(out, in, out, frames);
+    m_jitter.push(out, frames);
+    m_trackFrame += gotOut;
+    m_incomingFrame += gotIn;
+    if (!m_crossfade.active()) finishCrossfade();
+    return frames;
+}
+
+void AudioWorker::finishCrossfade() {
+    m_crossfade.cancel();
+    const std::uint64_t incomingFrame = m_incomingFrame;
+    const bool settingsChanged = m_trackGainPending;
+    if (!advance()) return;
+    m_trackFrame = incomingFrame;
+    if (!settingsChanged) {
+        // The incoming gains were applied for the whole fade; keep using them
+        m_trackGainPending = false;
+        noteTrackGains(m_incomingGains);
+    }
+    m_awaitingNextTrack = false;
+    m_transitions.fetch_add(1, std::memory_order_relaxed);
+    m_crossfades.fetch_add(1, std::memory_order_relaxed);
+    m_lastGapFrames.store(0, std::memory_order_relaxed);
+}
+
+void AudioWorker::cancelCrossfade() {
+    if (!m_crossfade.active()) return;
+    m_crossfade.cancel();
+    // The incoming track's head has been mixed away; reopen it from the start when it is due again
+    upcoming().close();
+    m_slotIndex[m_current ^ 1] = -1;
+}
+
+AudioWorker::TrackGains AudioWorker::gainsFor(int index) const {
+    std::optional<TrackLoudness> loudness;
+    if (m_loudness && index >= 0 && index < m_files.size()) loudness = m_loudness->lookup(m_files[index]);
+
+    TrackGains gains;
+    if (loudness) {
+        gains.measured = true;
+        if (m_normalizeOutput) gains.outputDb = loudness->gainDb(m_targetLufs, kMaxNormalizeDb, kOutputPeakCeilingDbtp);
+        gains.visualDb = m_normalizeVisuals ? loudness->gainDb(m_targetLufs, kMaxNormalizeDb) : gains.outputDb;
+    }
+    gains.output = dbToGain(gains.outputDb);
+    // The bus carries the sink's PCM, which already has the output gain in it
+    gains.bus = dbToGain(gains.visualDb - gains.outputDb);
+    return gains;
+}
+
+void AudioWorker::noteTrackGains(const TrackGains& gains) {
+    m_outputGain = gains.output;
+    m_trackMeasured.store(gains.measured, std::memory_order_relaxed);
+    m_outputGainDb.store(static_cast<float>(gains.outputDb), std::memory_order_relaxed);
+    m_visualGainDb.store(static_cast<float>(gains.visualDb), std::memory_order_relaxed);
+}
+
+void AudioWorker::updateTrackGain() {
+    m_trackGainPending = false;
+    const TrackGains gains = gainsFor(m_index);
+    noteTrackGains(gains);
+    m_busGainChanges.push_back({ m_streamFrame + m_jitter.bufferedFrames(), gains.bus });
+}
+
+void AudioWorker::requestSeekIndex() {
+    // Qt Multimedia decoding restarts the file to seek and has no use for one
+    if (!m_seekIndexes || m_backend != DecoderBackend::Libav) return;
+    if (m_index >= 0 && m_index < m_files.size()) m_seekIndexes->request(m_files[m_index]);
+}
+
+void AudioWorker::stampClock(bool running) {
+    if (!m_audio_sink) return;
+    const auto rate = static_cast<std::uint32_t>(m_sinkFormat.sampleRate());
+    const std::uint64_t processed = static_cast<std::uint64_t>(
+        std::max<qint64>(m_audio_sink->processedUSecs(), 0)) * rate / 1000000;
+    // The limiter's lookahead delays the stream on top of the device's own latency
+    const std::uint64_t latency = m_dsp.latencyFrames();
+    const std::uint64_t played = processed > latency ? processed - latency : 0;
+    const std::uint64_t audible = std::min(m_sinkStartFrame + played, m_streamFrame);
+    m_clock->update({ audible, PlaybackClock::nowNs(), rate, running, m_streamFrame, m_flushedFrame });
+}
+
+void AudioWorker::recordPass(std::uint64_t elapsedNs, std::uint64_t budgetNs) {
+    m_callbacks.fetch_add(1, std::memory_order_relaxed);
+    m_callbackTotalNs.fetch_add(elapsedNs, std::memory_order_relaxed);
+    m_callbackLastNs.store(elapsedNs, std::memory_order_relaxed);
+    m_lastBufferNs.store(budgetNs, std::memory_order_relaxed);
+    if (elapsedNs > m_callbackMaxNs.load(std::memory_order_relaxed)) {
+        m_callbackMaxNs.store(elapsedNs, std::memory_order_relaxed);
+    }
+    if (budgetNs > 0 && elapsedNs > budgetNs) {
+        m_overBudget.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+CallbackStats AudioWorker::callbackStats() const {
+    CallbackStats s;
+    s.callbacks = m_callbacks.load(std::memory_order_relaxed);
+    s.lastUs = m_callbackLastNs.load(std::memory_order_relaxed) / 1000.0;
+    s.maxUs = m_callbackMaxNs.load(std::memory_order_relaxed) / 1000.0;
+    s.meanUs = s.callbacks ? m_callbackTotalNs.load(std::memory_order_relaxed) / 1000.0 / s.callbacks : 0.0;
+    s.lastBufferUs = m_lastBufferNs.load(std::memory_order_relaxed) / 1000.0;
+    s.overBudget = m_overBudget.load(std::memory_order_relaxed);
+    return s;
+}
+
+JitterStats AudioWorker::jitterStats() const {
+    JitterStats s = m_jitter.stats();
+    if (s.sampleRate > 0) {
+        s.sinkBufferedMs = m_sinkBufferedFrames.load(std::memory_order_relaxed) * 1000.0 / s.sampleRate;
+    }
+    return s;
+}
+
+GaplessStats AudioWorker::gaplessStats() const {
+    GaplessStats s;
+    s.transitions = m_transitions.load(std::memory_order_relaxed);
+    s.lastGapFrames = m_lastGapFrames.load(std::memory_order_relaxed);
+    s.maxGapFrames = m_maxGapFrames.load(std::memory_order_relaxed);
+    s.gappedTransitions = m_gappedTransitions.load(std::memory_order_relaxed);
+    s.crossfades = m_crossfades.load(std::memory_order_relaxed);
+    return s;
+}
+
+NormalizationStats AudioWorker::normalizationStats() const {
+    NormalizationStats s;
+    s.measured = m_trackMeasured.load(std::memory_order_relaxed);
+    s.outputGainDb = m_outputGainDb.load(std::memory_order_relaxed);
+    s.visualGainDb = m_visualGainDb.load(std::memory_order_relaxed);
+    return s;
+}
+
+SeekStats AudioWorker::seekStats() const {
+    SeekStats s;
+    s.seeks = m_seeks.load(std::memory_order_relaxed);
+    s.indexed = m_indexedSeeks.load(std::memory_order_relaxed);
+    s.lastMs = m_lastSeekNs.load(std::memory_order_relaxed) / 1e6;
+    s.maxMs = m_maxSeekNs.load(std::memory_order_relaxed) / 1e6;
+    return s;
+}
+
+}
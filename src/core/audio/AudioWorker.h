@@ -0,0 +1,264 @@
+#pragma once
+
+#include <QObject>
+#include <QMediaPlayer>
+#include <QAudioFormat>
+#include <QAudioSink>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QTimer>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+#include "AudioBlockBus.h"
+#include "CrossfadeMixer.h"
+#include "DspChain.h"
+#include "JitterBuffer.h"
+#include "PlaybackClock.h"
+#include "SampleConverter.h"
+#include "TrackDecoder.h"
+
+namespace NeonWave::Core::Audio {
+
+/// Snapshot of how long each output pump pass took on the audio thread.
+struct CallbackStats {
+    std::uint64_t callbacks = 0;
+    double lastUs = 0.0;
+    double meanUs = 0.0;
+    double maxUs = 0.0;
+    double lastBufferUs = 0.0;   ///< Audio duration written by the last pass, i.e. the deadline
+    std::uint64_t overBudget = 0; ///< Passes that took longer than the audio they wrote
+};
+
+/// Which decoder feeds the two playback slots.
+enum class DecoderBackend {
+    QtMultimedia, ///< QAudioDecoder, stepped by the audio thread's event loop
+    Libav         ///< libavformat/libavcodec on a decode thread per slot (NEONWAVE_WITH_LIBAV builds)
+};
+
+/// Silence measured at track boundaries, in output sample frames.
+struct GaplessStats {
+    std::uint64_t transitions = 0;
+    std::uint64_t lastGapFrames = 0;
+    std::uint64_t maxGapFrames = 0;
+    std::uint64_t gappedTransitions = 0; ///< Transitions where the sink ran dry
+    std::uint64_t crossfades = 0;        ///< Transitions overlapped by the crossfade instead
+};
+
+/// Loudness normalisation applied to the track now being queued.
+struct NormalizationStats {
+    bool measured = false;      ///< The track's loudness was known when it started
+    double outputGainDb = 0.0;  ///< Gain on what the sink plays
+    double visualGainDb = 0.0;  ///< Gain on what the PCM bus carries
+};
+
+/// How long seeks took to produce audio again.
+struct SeekStats {
+    std::uint64_t seeks = 0;
+    std::uint64_t indexed = 0;   ///< Seeks that had a SeekIndex for the track
+    double lastMs = 0.0;         ///< From the seek command to the first frame at the new position
+    double maxMs = 0.0;
+};
+
+class LoudnessStore;
+class SeekIndexCache;
+
+/**
+ * @brief Owns decode and sink output; lives on the dedicated audio thread.
+ *
+ * Two decoder slots are kept: the current track and the next playlist entry,
+ * which is opened and pre-rolled once the current one is within the preroll
+ * window of its end. A timer-driven pump pulls PCM from the current slot into
+ * a JitterBuffer held at the target latency and switches slots mid-fill when
+ * a track runs out; the jitter buffer then tops the sink up in whole periods,
+ * so the sink and the PCM bus see one continuous stream. With a crossfade
+ * set, the last seconds of a track are read alongside the head of the next
+ * one and mixed before they enter the jitter buffer. Volume, EQ and the
+ * limiter (DspChain) run as the jitter buffer hands audio to the sink; the
+ * PCM bus is given the signal from before them, so the visualizer does not
+ * follow the volume knob.
+ *
+ * Never call its methods directly from another thread: AudioEngine queues
+ * every command onto the worker's event loop.
+ */
+class AudioWorker : public QObject {
+    Q_OBJECT
+public:
+    AudioWorker(std::shared_ptr<AudioBlockBus> bus, std::shared_ptr<PlaybackClock> clock);
+    ~AudioWorker();
+
+    /// Creates the decoders and pump timer; must run on the audio thread.
+    void initialize();
+    /// Stops output and destroys the Qt multimedia objects on the audio thread.
+    void shutdown();
+
+    void setPlaylist(const QStringList& files);
+    void play();
+    void pause();
+    void stop();
+    void next();
+    void previous();
+    void seek(qint64 positionMs);
+
+    /// How long before the end of the current track the next one is opened.
+    void setPrerollSeconds(double seconds);
+    /// Decoded audio kept queued for the sink; the sink's own buffer is sized
+    /// to match the next time it is opened.
+    void setTargetLatencyMs(int ms);
+    /// Rebuilds both slots; the current entry restarts from its beginning.
+    void setDecoderBackend(DecoderBackend backend);
+    /// Measured tracks to normalise; looked up as each track starts.
+    void setLoudnessStore(std::shared_ptr<const LoudnessStore> store);
+    /// Bring measured tracks to @p targetLufs on the sink and/or the PCM bus.
+    void setNormalization(bool output, bool visualizer, double targetLufs);
+    /// Overlap consecutive tracks by @p seconds with an equal-power fade; 0 plays them gaplessly.
+    void setCrossfadeSeconds(double seconds);
+    /// Seek tables for the libav backend; requested as each track becomes current.
+    void setSeekIndexCache(std::shared_ptr<SeekIndexCache> cache);
+    /// Slider position 0-1; glides there within a few milliseconds.
+    void setVolume(double volume);
+    void setEqualizer(bool enabled, const std::vector<EqBand>& bands);
+    void setLimiterEnabled(bool enabled);
+
+    // Thread-safe readers
+    CallbackStats callbackStats() const;
+    GaplessStats gaplessStats() const;
+    JitterStats jitterStats() const;
+    NormalizationStats normalizationStats() const;
+    SeekStats seekStats() const;
+    SampleConverter::FormatStats conversionStats(SampleType type) const { return m_converter.stats(type); }
+
+signals:
+    void positionChanged(qint64 positionMs, qint64 durationMs);
+    void stateChanged(QMediaPlayer::PlaybackState state);
+    void trackChanged(int index);
+
+private:
+    TrackDecoder& current() { return *m_slots[m_current]; }
+    TrackDecoder& upcoming() { return *m_slots[m_current ^ 1]; }
+    std::unique_ptr<TrackDecoder> makeDecoder();
+
+    void pump();
+    void fillJitter();
+    std::size_t drainJitter();
+    void loadCurrent();
+    void prerollNext();
+    bool advance();
+    bool openSink(int sampleRate);
+    void closeSink();
+    std::size_t sinkBufferedFrames() const;
+    std::size_t writeOut(const float* stereo, std::size_t frames);
+    void setState(QMediaPlayer::PlaybackState state);
+    void requestSeekIndex();
+    std::uint64_t remainingTrackFrames(int rate) const;
+    bool startCrossfade(int rate, std::uint64_t frames);
+    std::size_t mixCrossfade(std::size_t want);
+    void finishCrossfade();
+    void cancelCrossfade();
+
+    struct TrackGains {
+        bool measured = false;
+        double outputDb = 0.0;
+        double visualDb = 0.0;
+        float output = 1.0f; ///< Applied before the jitter buffer
+        float bus = 1.0f;    ///< Applied on top of it for the PCM bus
+    };
+    TrackGains gainsFor(int index) const;
+    void noteTrackGains(const TrackGains& gains);
+    void updateTrackGain();
+    void stampClock(bool running);
+    void recordPass(std::uint64_t elapsedNs, std::uint64_t budgetNs);
+
+    std::array<std::unique_ptr<TrackDecoder>, 2> m_slots;
+    DecoderBackend m_backend{ DecoderBackend::QtMultimedia };
+    std::array<int, 2> m_slotIndex{ -1, -1 }; // playlist entry loaded in each slot
+    int m_current{ 0 };
+
+    std::unique_ptr<QAudioSink> m_audio_sink;
+    QIODevice* m_sink_device = nullptr;
+    QAudioFormat m_sinkFormat;
+    std::unique_ptr<QTimer> m_pumpTimer;
+    QElapsedTimer m_pumpClock;
+    JitterBuffer m_jitter;
+    std::atomic<std::size_t> m_sinkBufferedFrames{0}; // mirrored each pass for stats()
+    QMediaPlayer::PlaybackState m_state{ QMediaPlayer::StoppedState };
+
+    std::shared_ptr<AudioBlockBus> m_bus;
+    std::shared_ptr<PlaybackClock> m_clock;
+    std::uint64_t m_sinkStartFrame{ 0 }; // stream frame of the first sample written to the current sink
+    std::uint64_t m_flushedFrame{ 0 };   // stream frames before this were dropped unheard; see PlaybackClock
+    SampleConverter m_converter;
+    std::vector<float> m_stereoScratch;
+    std::vector<qint16> m_int16Scratch;
+    std::uint64_t m_streamFrame{ 0 };
+    std::uint64_t m_trackFrame{ 0 };
+    QStringList m_files;
+    int m_index{ -1 };
+    double m_prerollSeconds{ 5.0 };
+    qint64 m_lastPositionEmitMs{ 0 };
+
+    // Loudness normalisation. The output gain is applied as PCM enters the
+    // jitter buffer; the bus gain changes when the first frame of a track
+    // leaves it, so the visualizer switches exactly at the boundary.
+    struct BusGainChange { std::uint64_t streamFrame; float gain; };
+    std::shared_ptr<const LoudnessStore> m_loudness;
+    bool m_normalizeOutput{ false };
+    bool m_normalizeVisuals{ true };
+    double m_targetLufs{ -18.0 };
+    bool m_trackGainPending{ true };
+    float m_outputGain{ 1.0f };
+    float m_busGain{ 1.0f };
+    std::deque<BusGainChange> m_busGainChanges;
+    std::vector<float> m_busScratch;
+    std::atomic<bool> m_trackMeasured{false};
+    std::atomic<float> m_outputGainDb{0.0f};
+    std::atomic<float> m_visualGainDb{0.0f};
+
+    // Crossfade. The outgoing track stays in the current slot and the incoming
+    // one is read from the upcoming slot until the fade is over; only then do
+    // the slots switch, so trackChanged fires when the old track is gone.
+    double m_crossfadeSeconds{ 0.0 };
+    CrossfadeMixer m_crossfade;
+    std::vector<float> m_incomingScratch;
+    std::uint64_t m_incomingFrame{ 0 }; // frames of the incoming track already mixed
+    TrackGains m_incomingGains;
+
+    // Output DSP. It is stateful, so frames it has processed but the sink has
+    // not accepted yet are kept for the next write rather than run twice.
+    DspChain m_dsp;
+    std::vector<float> m_dspOut;
+    std::size_t m_dspPending{ 0 };
+
+    // Seeking
+    std::shared_ptr<SeekIndexCache> m_seekIndexes;
+    bool m_seekPending{ false };
+    QElapsedTimer m_seekTimer;
+
+    // Boundary bookkeeping: sink fill and wall time when the outgoing track ran out
+    bool m_awaitingNextTrack{ false };
+    std::size_t m_bufferedAtTrackEnd{ 0 };
+    QElapsedTimer m_trackEndTimer;
+
+    std::atomic<std::uint64_t> m_callbacks{0};
+    std::atomic<std::uint64_t> m_callbackTotalNs{0};
+    std::atomic<std::uint64_t> m_callbackLastNs{0};
+    std::atomic<std::uint64_t> m_callbackMaxNs{0};
+    std::atomic<std::uint64_t> m_lastBufferNs{0};
+    std::atomic<std::uint64_t> m_overBudget{0};
+
+    std::atomic<std::uint64_t> m_transitions{0};
+    std::atomic<std::uint64_t> m_lastGapFrames{0};
+    std::atomic<std::uint64_t> m_maxGapFrames{0};
+    std::atomic<std::uint64_t> m_gappedTransitions{0};
+    std::atomic<std::uint64_t> m_crossfades{0};
+
+    std::atomic<std::uint64_t> m_seeks{0};
+    std::atomic<std::uint64_t> m_indexedSeeks{0};
+    std::atomic<std::uint64_t> m_lastSeekNs{0};
+    std::atomic<std::uint64_t> m_maxSeekNs{0};
+};
+
+}
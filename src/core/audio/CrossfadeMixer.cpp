@@ -0,0 +1,204 @@
+#include "CrossfadeMixer.h"
+#include "SimdIsa.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+namespace NeonWave::Core::Audio {
+
+namespace {
+
+constexpr double kHalfPi = 1.57079632679489661923;
+
+/// dst = a * (ga + i * gaStep) + b * (gb + i * gbStep) for frame i, both channels alike.
+using MixKernel = void (*)(const float* a, const float* b, float* dst, std::size_t frames,
+                           float ga, float gaStep, float gb, float gbStep);
+
+// ---- scalar ---------------------------------------------------------------
+
+void mixTail(const float* a, const float* b, float* dst, std::size_t from, std::size_t frames,
+             float ga, float gaStep, float gb, float gbStep) {
+    for (std::size_t i = from; i < frames; ++i) {
+        const float t = static_cast<float>(i);
+        const float gA = ga + gaStep * t;
+        const float gB = gb + gbStep * t;
+        dst[2 * i] = a[2 * i] * gA + b[2 * i] * gB;
+        dst[2 * i + 1] = a[2 * i + 1] * gA + b[2 * i + 1] * gB;
+    }
+}
+
+void mixScalar(const float* a, const float* b, float* dst, std::size_t frames,
+               float ga, float gaStep, float gb, float gbStep) {
+    mixTail(a, b, dst, 0, frames, ga, gaStep, gb, gbStep);
+}
+
+#if defined(NEONWAVE_SIMD_X86)
+
+// ---- SSE2 ------------------------------------------------------------------
+
+void mixSse2(const float* a, const float* b, float* dst, std::size_t frames,
+             float ga, float gaStep, float gb, float gbStep) {
+    const __m128 lane = _mm_setr_ps(0.0f, 0.0f, 1.0f, 1.0f); // two frames, L R L R
+    const __m128 gaV = _mm_set1_ps(ga), gaStepV = _mm_set1_ps(gaStep);
+    const __m128 gbV = _mm_set1_ps(gb), gbStepV = _mm_set1_ps(gbStep);
+    std::size_t i = 0;
+    for (; i + 2 <= frames; i += 2) {
+        const __m128 t = _mm_add_ps(_mm_set1_ps(static_cast<float>(i)), lane);
+        const __m128 gA = _mm_add_ps(gaV, _mm_mul_ps(gaStepV, t));
+        const __m128 gB = _mm_add_ps(gbV, _mm_mul_ps(gbStepV, t));
+        const __m128 mixed = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(a + 2 * i), gA),
+                                        _mm_mul_ps(_mm_loadu_ps(b + 2 * i), gB));
+        _mm_storeu_ps(dst + 2 * i, mixed);
+    }
+    mixTail(a, b, dst, i, frames, ga, gaStep, gb, gbStep);
+}
+
+// ---- AVX2 ------------------------------------------------------------------
+
+__attribute__((target("avx2"))) void mixAvx2(const float* a, const float* b, float* dst, std::size_t frames,
+                                             float ga, float gaStep, float gb, float gbStep) {
+    const __m256 lane = _mm256_setr_ps(0.0f, 0.0f, 1.0f, 1.0f, 2.0f, 2.0f, 3.0f, 3.0f); // four frames
+    const __m256 gaV = _mm256_set1_ps(ga), gaStepV = _mm256_set1_ps(gaStep);
+    const __m256 gbV = _mm256_set1_ps(gb), gbStepV = _mm256_set1_ps(gbStep);
+    std::size_t i = 0;
+    for (; i + 4 <= frames; i += 4) {
+        const __m256 t = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(i)), lane);
+        const __m256 gA = _mm256_add_ps(gaV, _mm256_mul_ps(gaStepV, t));
+        const __m256 gB = _mm256_add_ps(gbV, _mm256_mul_ps(gbStepV, t));
+        const __m256 mixed = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(a + 2 * i), gA),
+                                           _mm256_mul_ps(_mm256_loadu_ps(b + 2 * i), gB));
+        _mm256_storeu_ps(dst + 2 * i, mixed);
+    }
+    // The tail and the caller's libm calls are legacy SSE; leave the upper halves clean for them
+    _mm256_zeroupper();
+    mixTail(a, b, dst, i, frames, ga, gaStep, gb, gbStep);
+}
+
+#elif defined(NEONWAVE_SIMD_NEON)
+
+// ---- NEON ------------------------------------------------------------------
+
+void mixNeon(const float* a, const float* b, float* dst, std::size_t frames,
+             float ga, float gaStep, float gb, float gbStep) {
+    static const float kLane[4] = { 0.0f, 0.0f, 1.0f, 1.0f };
+    const float32x4_t lane = vld1q_f32(kLane);
+    const float32x4_t gaV = vdupq_n_f32(ga), gbV = vdupq_n_f32(gb);
+    std::size_t i = 0;
+    for (; i + 2 <= frames; i += 2) {
+        const float32x4_t t = vaddq_f32(vdupq_n_f32(static_cast<float>(i)), lane);
+        const float32x4_t gA = vmlaq_n_f32(gaV, t, gaStep);
+        const float32x4_t gB = vmlaq_n_f32(gbV, t, gbStep);
+        const float32x4_t mixed = vmlaq_f32(vmulq_f32(vld1q_f32(a + 2 * i), gA), vld1q_f32(b + 2 * i), gB);
+        vst1q_f32(dst + 2 * i, mixed);
+    }
+    mixTail(a, b, dst, i, frames, ga, gaStep, gb, gbStep);
+}
+
+#endif
+
+MixKernel mixKernelFor(SimdIsa isa) {
+    switch (isa) {
+#if defined(NEONWAVE_SIMD_X86)
+    case SimdIsa::AVX2: return mixAvx2;
+    case SimdIsa::SSE2: return mixSse2;
+#elif defined(NEONWAVE_SIMD_NEON)
+    case SimdIsa::NEON: return mixNeon;
+#endif
+    default: return mixScalar;
+    }
+}
+
+} // namespace
+
+CrossfadeMixer::CrossfadeMixer(SimdIsa isa)
+    : m_isa(isa) {}
+
+void CrossfadeMixer::start(std::size_t frames, float outgoingGain, float incomingGain) {
+    m_length = frames;
+    m_remaining = frames;
+    m_outgoingGain = outgoingGain;
+    m_incomingGain = incomingGain;
+}
+
+void CrossfadeMixer::cancel() {
+    m_remaining = 0;
+}
+
+std::size_t CrossfadeMixer::mix(const float* outgoing, const float* incoming, float* dst, std::size_t frames) {
+    frames = std::min(frames, m_remaining);
+    const MixKernel kernel = mixKernelFor(m_isa);
+    const double scale = kHalfPi / static_cast<double>(m_length);
+
+    std::size_t done = 0;
+    while (done < frames) {
+        // Exact gains at this frame and at the next segment boundary, linear in between
+        const std::size_t pos = m_length - m_remaining;
+        const std::size_t segmentEnd = std::min(pos / kSegmentFrames * kSegmentFrames + kSegmentFrames, m_length);
+        const std::size_t n = std::min(segmentEnd - pos, frames - done);
+        const double theta0 = scale * static_cast<double>(pos);
+        const double theta1 = scale * static_cast<double>(segmentEnd);
+        const double span = static_cast<double>(segmentEnd - pos);
+        const auto gOut = static_cast<float>(std::cos(theta0) * m_outgoingGain);
+        const auto gIn = static_cast<float>(std::sin(theta0) * m_incomingGain);
+        const auto gOutStep = static_cast<float>((std::cos(theta1) - std::cos(theta0)) * m_outgoingGain / span);
+        const auto gInStep = static_cast<float>((std::sin(theta1) - std::sin(theta0)) * m_incomingGain / span);
+
+        kernel(outgoing + 2 * done, incoming + 2 * done, dst + 2 * done, n, gOut, gOutStep, gIn, gInStep);
+        done += n;
+        m_remaining -= n;
+    }
+    return frames;
+}
+
+std::vector<CrossfadeMixer::BenchmarkResult> CrossfadeMixer::benchmark(std::size_t frames) {
+    const std::vector<SimdIsa> isas = availableIsas();
+
+    // Chunks the size of a 5 ms pump pass at 48 kHz, as on the audio thread
+    constexpr std::size_t kChunk = 240;
+    std::vector<float> outgoing(frames * 2), incoming(frames * 2), mixed(frames * 2);
+    for (std::size_t i = 0; i < frames * 2; ++i) {
+        outgoing[i] = static_cast<float>(std::sin(0.01 * static_cast<double>(i)));
+        incoming[i] = static_cast<float>(std::cos(0.013 * static_cast<double>(i)));
+    }
+
+    std::vector<BenchmarkResult> results;
+    for (const SimdIsa isa : isas) {
+        CrossfadeMixer mixer(isa);
+        mixer.start(frames);
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t f = 0; f < frames; f += kChunk) {
+            const std::size_t n = std::min(kChunk, frames - f);
+            mixer.mix(outgoing.data() + 2 * f, incoming.data() + 2 * f, mixed.data() + 2 * f, n);
+        }
+        const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        results.push_back({ isa, ns / static_cast<double>(frames) });
+    }
+    return results;
+}
+
+double CrossfadeMixer::measureGainErrorDb(std::size_t fadeFrames) {
+    // Unit outgoing and silent incoming (and vice versa) make the output the gain curve itself
+    constexpr std::size_t kChunk = 333; // deliberately not a multiple of the segment length
+    std::vector<float> ones(kChunk * 2, 1.0f), zeros(kChunk * 2, 0.0f), mixed(kChunk * 2);
+    double maxError = 0.0;
+    for (const bool outgoingSide : { true, false }) {
+        CrossfadeMixer mixer;
+        mixer.start(fadeFrames);
+        std::size_t pos = 0;
+        while (mixer.active()) {
+            const std::size_t n = mixer.mix(outgoingSide ? ones.data() : zeros.data(),
+                                            outgoingSide ? zeros.data() : ones.data(), mixed.data(), kChunk);
+            for (std::size_t i = 0; i < n; ++i) {
+                const double theta = kHalfPi * static_cast<double>(pos + i) / static_cast<double>(fadeFrames);
+                const double exact = outgoingSide ? std::cos(theta) : std::sin(theta);
+                maxError = std::max({ maxError, std::abs(mixed[2 * i] - exact), std::abs(mixed[2 * i + 1] - exact) });
+            }
+            pos += n;
+        }
+    }
+    return maxError > 0.0 ? 20.0 * std::log10(maxError) : -std::numeric_limits<double>::infinity();
+}
+
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "SimdIsa.h"
+
+namespace NeonWave::Core::Audio {
+
+/**
+ * @brief Equal-power crossfade between two interleaved float stereo streams.
+ *
+ * start() arms a fade of a fixed length; each mix() call then consumes the
+ * next frames of it, so the fade can be fed in whatever chunks the decoders
+ * happen to have ready. The outgoing stream follows cos and the incoming one
+ * sin of the fade position, which keeps the summed power constant for
+ * uncorrelated material. Gains are evaluated exactly every kSegmentFrames and
+ * ramped linearly in between, which keeps the trig off the per-sample path;
+ * the kernel is picked per ISA like SampleConverter's (AVX2/SSE2/NEON/scalar).
+ *
+ * Never allocates; not thread-safe.
+ */
+class CrossfadeMixer {
+public:
+    static constexpr std::size_t kSegmentFrames = 64;
+
+    struct BenchmarkResult {
+        SimdIsa isa;
+        double nsPerFrame;
+    };
+
+    explicit CrossfadeMixer(SimdIsa isa = detectIsa());
+
+    /// Arm a fade of @p frames frames; each side is also scaled by its own constant gain.
+    void start(std::size_t frames, float outgoingGain = 1.0f, float incomingGain = 1.0f);
+    /// Abandon the fade in progress.
+    void cancel();
+
+    bool active() const { return m_remaining > 0; }
+    std::size_t length() const { return m_length; }
+    std::size_t remaining() const { return m_remaining; }
+    SimdIsa isa() const { return m_isa; }
+
+    /// Mix the next @p frames of the fade into @p dst (which may alias either input);
+    /// clamped to remaining(), returns frames written.
+    std::size_t mix(const float* outgoing, const float* incoming, float* dst, std::size_t frames);
+
+    /// Time every kernel available on this CPU.
+    static std::vector<BenchmarkResult> benchmark(std::size_t frames = 1 << 18);
+    /// Largest deviation from the exact cos/sin gains over a whole fade, in dB of the full-scale input.
+    static double measureGainErrorDb(std::size_t fadeFrames = 48000 * 3);
+
+private:
+    SimdIsa m_isa;
+    std::size_t m_length = 0;
+    std::size_t m_remaining = 0;
+    float m_outgoingGain = 1.0f;
+    float m_incomingGain = 1.0f;
+};
+
+}
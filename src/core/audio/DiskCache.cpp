@@ -0,0 +1,215 @@
+#include "DiskCache.h"
+#include "FileDecoder.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <map>
+
+namespace NeonWave::Core::Audio {
+
+namespace {
+
+static_assert(sizeof(DiskCache::FileHeader) == 48, "FileHeader layout is part of every cache's file format");
+
+/// Content keys of every track hashed this session, shared by all caches.
+struct KeyMemo {
+    struct Entry { qint64 size; qint64 mtime; QByteArray key; };
+    std::mutex mutex;
+    std::map<QString, Entry> entries;
+};
+
+KeyMemo& keyMemo() {
+    static KeyMemo memo;
+    return memo;
+}
+
+} // namespace
+
+DiskCache::DiskCache(std::filesystem::path directory, const Format& format)
+    : m_directory(std::move(directory))
+    , m_format(format)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(m_directory, ec);
+    if (ec) {
+        std::cerr << "[" << m_format.name << "] Cannot create " << m_directory << ": " << ec.message() << std::endl;
+    }
+}
+
+DiskCache::~DiskCache() {
+    stop();
+}
+
+void DiskCache::start(Job job, KeyedJob keyed) {
+    m_job = std::move(job);
+    m_keyed = std::move(keyed);
+    m_thread = std::thread([this]() { run(); });
+}
+
+void DiskCache::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+        m_queue.clear();
+        m_keyQueue.clear();
+    }
+    m_cancel.store(true, std::memory_order_relaxed);
+    m_wake.notify_one();
+    if (m_thread.joinable()) m_thread.join();
+}
+
+void DiskCache::enqueue(const QString& path) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (std::find(m_queue.begin(), m_queue.end(), path) != m_queue.end()) return;
+        m_queue.push_back(path);
+    }
+    m_wake.notify_one();
+}
+
+void DiskCache::request(const QString& path) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.erase(std::remove(m_queue.begin(), m_queue.end(), path), m_queue.end());
+        m_queue.push_front(path);
+    }
+    m_wake.notify_one();
+}
+
+void DiskCache::requestKey(const QString& path) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (std::find(m_keyQueue.begin(), m_keyQueue.end(), path) != m_keyQueue.end()) return;
+        m_keyQueue.push_back(path);
+    }
+    m_wake.notify_one();
+}
+
+void DiskCache::cancelPending() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_queue.clear();
+    m_keyQueue.clear();
+    m_cancel.store(true, std::memory_order_relaxed);
+}
+
+std::size_t DiskCache::pending() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_queue.size();
+}
+
+void DiskCache::run() {
+    for (;;) {
+        QString path;
+        bool keyOnly = false;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this]() { return m_stop || !m_queue.empty() || !m_keyQueue.empty(); });
+            if (m_stop) return;
+            // A missing key is all that stands between a lookup and a hit, so hashing goes first
+            keyOnly = !m_keyQueue.empty();
+            std::deque<QString>& queue = keyOnly ? m_keyQueue : m_queue;
+            path = queue.front();
+            queue.pop_front();
+            if (!keyOnly) m_cancel.store(false, std::memory_order_relaxed);
+        }
+
+        if (keyOnly) {
+            const QByteArray key = keyFor(path);
+            if (m_keyed) m_keyed(path, key);
+        } else {
+            m_job(path);
+        }
+    }
+}
+
+QString DiskCache::fileFor(const QByteArray& key) const {
+    return QString::fromStdString(m_directory.string()) + '/' + QString::fromLatin1(key.toHex().left(32))
+        + QString::fromLatin1(m_format.suffix);
+}
+
+QByteArray DiskCache::knownKey(const QString& path) {
+    const QFileInfo info(path);
+    if (!info.isFile()) return {};
+    const qint64 size = info.size();
+    const qint64 mtime = info.lastModified().toMSecsSinceEpoch();
+    KeyMemo& memo = keyMemo();
+    std::lock_guard<std::mutex> lock(memo.mutex);
+    const auto it = memo.entries.find(path);
+    if (it == memo.entries.end() || it->second.size != size || it->second.mtime != mtime) return {};
+    return it->second.key;
+}
+
+QByteArray DiskCache::keyFor(const QString& path) {
+    if (QByteArray known = knownKey(path); !known.isEmpty()) return known;
+    // Taken before hashing: if the file changes meanwhile the memo goes stale rather than wrong
+    const QFileInfo info(path);
+    QByteArray key = contentHash(path);
+    if (!key.isEmpty()) {
+        KeyMemo& memo = keyMemo();
+        std::lock_guard<std::mutex> lock(memo.mutex);
+        memo.entries[path] = { info.size(), info.lastModified().toMSecsSinceEpoch(), key };
+    }
+    return key;
+}
+
+QByteArray DiskCache::contentHash(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return {};
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    if (!hash.addData(&file)) return {};
+    return hash.result();
+}
+
+DiskCache::FileHeader DiskCache::header(const Format& format, const QByteArray& key) {
+    FileHeader header{};
+    std::memcpy(header.magic, format.magic, sizeof(header.magic));
+    header.formatVersion = format.version;
+    header.decoderVersion = fileDecoderVersion();
+    if (key.size() == kKeyBytes) std::memcpy(header.key, key.constData(), kKeyBytes);
+    return header;
+}
+
+std::shared_ptr<DiskCache::MappedFile> DiskCache::map(const QString& file, const Format& format, const QByteArray& key,
+                                                      std::size_t headerBytes) {
+    if (key.size() != kKeyBytes) return nullptr;
+    auto mapped = std::make_shared<MappedFile>();
+    mapped->file.setFileName(file);
+    if (!mapped->file.open(QIODevice::ReadOnly)) return nullptr;
+    const qint64 size = mapped->file.size();
+    if (size < static_cast<qint64>(std::max(headerBytes, sizeof(FileHeader)))) return nullptr;
+    mapped->data = mapped->file.map(0, size);
+    if (!mapped->data) return nullptr;
+    mapped->size = static_cast<std::size_t>(size);
+
+    FileHeader header;
+    std::memcpy(&header, mapped->data, sizeof(header));
+    const bool current = std::memcmp(header.magic, format.magic, sizeof(header.magic)) == 0
+        && header.formatVersion == format.version
+        && header.decoderVersion == fileDecoderVersion()
+        && std::memcmp(header.key, key.constData(), kKeyBytes) == 0;
+    return current ? mapped : nullptr;
+}
+
+bool DiskCache::write(const QString& file, const Format& format, const void* header, std::size_t headerBytes,
+                      const void* payload, std::size_t payloadBytes, QString* error) {
+    QSaveFile out(file);
+    const auto headerSize = static_cast<qint64>(headerBytes);
+    const auto payloadSize = static_cast<qint64>(payloadBytes);
+    if (out.open(QIODevice::WriteOnly)
+        && out.write(static_cast<const char*>(header), headerSize) == headerSize
+        && (payloadSize == 0 || out.write(static_cast<const char*>(payload), payloadSize) == payloadSize)
+        && out.commit()) {
+        return true;
+    }
+    std::cerr << "[" << format.name << "] Cannot write " << file.toStdString() << ": "
+              << out.errorString().toStdString() << std::endl;
+    if (error) *error = out.errorString();
+    return false;
+}
+
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace NeonWave::Core::Audio {
+
+/**
+ * @brief What the per-track caches on disk share: keys, file names, atomic writes, mapping and the worker.
+ *
+ * AnalysisCache, WaveformCache and SeekIndexCache each keep one directory of
+ * files derived from a track. All of them key those files by the SHA-256 of
+ * the track's bytes, so renames and copies still hit and an edited file never
+ * does. Hashing reads the whole track, so only the worker does it; the result
+ * is memoised process-wide on path, size and mtime, and the three caches hash
+ * a track once between them.
+ *
+ * Every file starts with a FileHeader that map() checks against the owner's
+ * Format, the decoder version and the key; any mismatch is a miss and the
+ * owner rebuilds the file. The owner's fields and payload follow the header.
+ *
+ * An instance owns the directory and one worker thread that runs the owner's
+ * job for each queued path. Queueing is safe from any thread.
+ */
+class DiskCache {
+public:
+    static constexpr int kKeyBytes = 32;
+
+    /// Identity of one owner's files.
+    struct Format {
+        const char* name;        ///< Owner, for log messages
+        char magic[8];
+        std::uint32_t version;   ///< Bump when the owner's header or payload layout changes
+        const char* suffix;      ///< File extension, dot included
+    };
+
+    /// Common start of every cache file.
+    struct FileHeader {
+        char magic[8];
+        std::uint32_t formatVersion;
+        std::uint32_t decoderVersion;
+        std::uint8_t key[kKeyBytes];
+    };
+
+    /// A current cache file, mapped read-only for as long as this lives.
+    struct MappedFile {
+        QFile file;
+        const uchar* data = nullptr;
+        std::size_t size = 0;
+    };
+
+    /// Runs on the worker for every path taken off the queue.
+    using Job = std::function<void(const QString& path)>;
+    /// Runs on the worker once a requestKey() path is hashed; @p key is empty if the track cannot be read.
+    using KeyedJob = std::function<void(const QString& path, const QByteArray& key)>;
+
+    DiskCache(std::filesystem::path directory, const Format& format);
+    ~DiskCache();
+
+    /// Start the worker. Owners call stop() in their destructor, before anything @p job uses goes away.
+    void start(Job job, KeyedJob keyed = {});
+    /// Cancel the current job, drop the queue and join the worker.
+    void stop();
+
+    /// Queue @p path behind everything else, unless it is queued already.
+    void enqueue(const QString& path);
+    /// Queue @p path ahead of everything else, moving it if it is queued already.
+    void request(const QString& path);
+    /// Hash @p path on the worker ahead of any job, then hand it to the KeyedJob.
+    void requestKey(const QString& path);
+    /// Drop everything not yet started and raise cancelFlag() for the job in progress.
+    void cancelPending();
+    std::size_t pending() const;
+    /// Raised by cancelPending() and stop(), lowered before each job starts.
+    const std::atomic<bool>* cancelFlag() const { return &m_cancel; }
+
+    const std::filesystem::path& directory() const { return m_directory; }
+    /// Where the file for @p key lives.
+    QString fileFor(const QByteArray& key) const;
+
+    /// Memoised key of @p path's current contents; empty until some worker has hashed them.
+    static QByteArray knownKey(const QString& path);
+    /// Key of @p path's current contents, hashing the file on a miss; empty if it cannot be read.
+    static QByteArray keyFor(const QString& path);
+    /// SHA-256 of the file's bytes, not memoised; empty if it cannot be read.
+    static QByteArray contentHash(const QString& path);
+
+    /// Header for a new file of @p format keyed by @p key.
+    static FileHeader header(const Format& format, const QByteArray& key);
+    /// Map @p file if it is at least @p headerBytes long and its FileHeader is current for @p format and @p key.
+    static std::shared_ptr<MappedFile> map(const QString& file, const Format& format, const QByteArray& key,
+                                           std::size_t headerBytes);
+    /// Write @p header then @p payload to @p file through QSaveFile, so no reader maps a half-written file.
+    static bool write(const QString& file, const Format& format, const void* header, std::size_t headerBytes,
+                      const void* payload, std::size_t payloadBytes, QString* error = nullptr);
+
+private:
+    void run();
+
+    std::filesystem::path m_directory;
+    Format m_format;
+    Job m_job;
+    KeyedJob m_keyed;
+
+    std::thread m_thread;
+    mutable std::mutex m_mutex;          // guards m_queue, m_keyQueue and m_stop
+    std::condition_variable m_wake;
+    std::deque<QString> m_queue;
+    std::deque<QString> m_keyQueue;      // served before m_queue
+    bool m_stop = false;
+    std::atomic<bool> m_cancel{false};
+};
+
+}
@@ -0,0 +1,587 @@
+#include "DspChain.h"
+#include "SimdIsa.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <random>
+
+namespace NeonWave::Core::Audio {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr std::size_t kMaxLimiterWindow =
+    static_cast<std::size_t>(DspChain::kLimiterLookaheadSeconds * DspChain::kMaxSampleRate) + 2;
+constexpr double kFlatBandDb = 0.01;
+constexpr double kDenormalFloor = 1e-30;
+
+/// x[2i], x[2i + 1] *= g + i * step.
+using GainKernel = void (*)(float* x, std::size_t frames, float g, float step);
+/// One biquad in place over interleaved double stereo; c = b0 b1 b2 a1 a2, state = s1 L/R, s2 L/R.
+using BiquadKernel = void (*)(double* x, std::size_t frames, const double* c, double* state);
+/// Gain each frame needs to stay under @p ceiling, stored to both of its samples; returns the smallest.
+using RequiredKernel = float (*)(const float* x, std::size_t frames, float ceiling, float* required);
+/// dst[i] = x[i] * g[i].
+using ApplyKernel = void (*)(const float* x, const float* g, float* dst, std::size_t samples);
+
+// ---- scalar ---------------------------------------------------------------
+
+void gainTail(float* x, std::size_t from, std::size_t frames, float g, float step) {
+    for (std::size_t i = from; i < frames; ++i) {
+        const float gain = g + step * static_cast<float>(i);
+        x[2 * i] *= gain;
+        x[2 * i + 1] *= gain;
+    }
+}
+
+void gainScalar(float* x, std::size_t frames, float g, float step) {
+    gainTail(x, 0, frames, g, step);
+}
+
+void biquadScalar(double* x, std::size_t frames, const double* c, double* state) {
+    for (int ch = 0; ch < 2; ++ch) {
+        double s1 = state[ch], s2 = state[2 + ch];
+        for (std::size_t i = 0; i < frames; ++i) {
+            const double in = x[2 * i + ch];
+            const double y = c[0] * in + s1;
+            s1 = c[1] * in - c[3] * y + s2;
+            s2 = c[2] * in - c[4] * y;
+            x[2 * i + ch] = y;
+        }
+        state[ch] = s1;
+        state[2 + ch] = s2;
+    }
+}
+
+float requiredTail(const float* x, std::size_t from, std::size_t frames, float ceiling, float* required, float least) {
+    for (std::size_t i = from; i < frames; ++i) {
+        const float peak = std::max(std::abs(x[2 * i]), std::abs(x[2 * i + 1]));
+        const float g = ceiling / std::max(peak, ceiling);
+        required[2 * i] = g;
+        required[2 * i + 1] = g;
+        least = std::min(least, g);
+    }
+    return least;
+}
+
+float requiredScalar(const float* x, std::size_t frames, float ceiling, float* required) {
+    return requiredTail(x, 0, frames, ceiling, required, 1.0f);
+}
+
+void applyScalar(const float* x, const float* g, float* dst, std::size_t samples) {
+    for (std::size_t i = 0; i < samples; ++i) dst[i] = x[i] * g[i];
+}
+
+#if defined(NEONWAVE_SIMD_X86)
+
+// ---- SSE2 ------------------------------------------------------------------
+
+void gainSse2(float* x, std::size_t frames, float g, float step) {
+    const __m128 lane = _mm_setr_ps(0.0f, 0.0f, 1.0f, 1.0f); // two frames, L R L R
+    const __m128 gV = _mm_set1_ps(g), stepV = _mm_set1_ps(step);
+    std::size_t i = 0;
+    for (; i + 2 <= frames; i += 2) {
+        const __m128 t = _mm_add_ps(_mm_set1_ps(static_cast<float>(i)), lane);
+        _mm_storeu_ps(x + 2 * i, _mm_mul_ps(_mm_loadu_ps(x + 2 * i), _mm_add_ps(gV, _mm_mul_ps(stepV, t))));
+    }
+    gainTail(x, i, frames, g, step);
+}
+
+void biquadSse2(double* x, std::size_t frames, const double* c, double* state) {
+    const __m128d b0 = _mm_set1_pd(c[0]), b1 = _mm_set1_pd(c[1]), b2 = _mm_set1_pd(c[2]);
+    const __m128d a1 = _mm_set1_pd(c[3]), a2 = _mm_set1_pd(c[4]);
+    __m128d s1 = _mm_loadu_pd(state), s2 = _mm_loadu_pd(state + 2);
+    for (std::size_t i = 0; i < frames; ++i) {
+        const __m128d in = _mm_loadu_pd(x + 2 * i); // L R
+        const __m128d y = _mm_add_pd(_mm_mul_pd(b0, in), s1);
+        s1 = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(b1, in), _mm_mul_pd(a1, y)), s2);
+        s2 = _mm_sub_pd(_mm_mul_pd(b2, in), _mm_mul_pd(a2, y));
+        _mm_storeu_pd(x + 2 * i, y);
+    }
+    _mm_storeu_pd(state, s1);
+    _mm_storeu_pd(state + 2, s2);
+}
+
+float requiredSse2(const float* x, std::size_t frames, float ceiling, float* required) {
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 ceilingV = _mm_set1_ps(ceiling);
+    __m128 least = _mm_set1_ps(1.0f);
+    std::size_t i = 0;
+    for (; i + 2 <= frames; i += 2) {
+        const __m128 a = _mm_andnot_ps(signMask, _mm_loadu_ps(x + 2 * i));
+        const __m128 peak = _mm_max_ps(a, _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1))); // max of each L/R pair
+        const __m128 g = _mm_div_ps(ceilingV, _mm_max_ps(peak, ceilingV));
+        _mm_storeu_ps(required + 2 * i, g);
+        least = _mm_min_ps(least, g);
+    }
+    least = _mm_min_ps(least, _mm_movehl_ps(least, least));
+    least = _mm_min_ss(least, _mm_shuffle_ps(least, least, _MM_SHUFFLE(1, 1, 1, 1)));
+    return requiredTail(x, i, frames, ceiling, required, _mm_cvtss_f32(least));
+}
+
+void applySse2(const float* x, const float* g, float* dst, std::size_t samples) {
+    std::size_t i = 0;
+    for (; i + 4 <= samples; i += 4) {
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(g + i)));
+    }
+    for (; i < samples; ++i) dst[i] = x[i] * g[i];
+}
+
+// ---- AVX2 ------------------------------------------------------------------
+// The biquad keeps the SSE2 kernel: with two channels there is nothing for a
+// wider register to hold, and the recursion leaves no independent samples.
+
+__attribute__((target("avx2"))) void gainAvx2(float* x, std::size_t frames, float g, float step) {
+    const __m256 lane = _mm256_setr_ps(0.0f, 0.0f, 1.0f, 1.0f, 2.0f, 2.0f, 3.0f, 3.0f); // four frames
+    const __m256 gV = _mm256_set1_ps(g), stepV = _mm256_set1_ps(step);
+    std::size_t i = 0;
+    for (; i + 4 <= frames; i += 4) {
+        const __m256 t = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(i)), lane);
+        _mm256_storeu_ps(x + 2 * i, _mm256_mul_ps(_mm256_loadu_ps(x + 2 * i), _mm256_add_ps(gV, _mm256_mul_ps(stepV, t))));
+    }
+    _mm256_zeroupper();
+    gainTail(x, i, frames, g, step);
+}
+
+__attribute__((target("avx2"))) float requiredAvx2(const float* x, std::size_t frames, float ceiling, float* required) {
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    const __m256 ceilingV = _mm256_set1_ps(ceiling);
+    __m256 least = _mm256_set1_ps(1.0f);
+    std::size_t i = 0;
+    for (; i + 4 <= frames; i += 4) {
+        const __m256 a = _mm256_andnot_ps(signMask, _mm256_loadu_ps(x + 2 * i));
+        const __m256 peak = _mm256_max_ps(a, _mm256_permute_ps(a, _MM_SHUFFLE(2, 3, 0, 1)));
+        const __m256 g = _mm256_div_ps(ceilingV, _mm256_max_ps(peak, ceilingV));
+        _mm256_storeu_ps(required + 2 * i, g);
+        least = _mm256_min_ps(least, g);
+    }
+    __m128 half = _mm_min_ps(_mm256_castps256_ps128(least), _mm256_extractf128_ps(least, 1));
+    _mm256_zeroupper();
+    half = _mm_min_ps(half, _mm_movehl_ps(half, half));
+    half = _mm_min_ss(half, _mm_shuffle_ps(half, half, _MM_SHUFFLE(1, 1, 1, 1)));
+    return requiredTail(x, i, frames, ceiling, required, _mm_cvtss_f32(half));
+}
+
+__attribute__((target("avx2"))) void applyAvx2(const float* x, const float* g, float* dst, std::size_t samples) {
+    std::size_t i = 0;
+    for (; i + 8 <= samples; i += 8) {
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(g + i)));
+    }
+    _mm256_zeroupper();
+    for (; i < samples; ++i) dst[i] = x[i] * g[i];
+}
+
+#elif defined(NEONWAVE_SIMD_NEON)
+
+// ---- NEON ------------------------------------------------------------------
+
+void gainNeon(float* x, std::size_t frames, float g, float step) {
+    static const float kLane[4] = { 0.0f, 0.0f, 1.0f, 1.0f };
+    const float32x4_t lane = vld1q_f32(kLane);
+    const float32x4_t gV = vdupq_n_f32(g);
+    std::size_t i = 0;
+    for (; i + 2 <= frames; i += 2) {
+        const float32x4_t t = vaddq_f32(vdupq_n_f32(static_cast<float>(i)), lane);
+        vst1q_f32(x + 2 * i, vmulq_f32(vld1q_f32(x + 2 * i), vaddq_f32(gV, vmulq_n_f32(t, step))));
+    }
+    gainTail(x, i, frames, g, step);
+}
+
+void applyNeon(const float* x, const float* g, float* dst, std::size_t samples) {
+    std::size_t i = 0;
+    for (; i + 4 <= samples; i += 4) {
+        vst1q_f32(dst + i, vmulq_f32(vld1q_f32(x + i), vld1q_f32(g + i)));
+    }
+    for (; i < samples; ++i) dst[i] = x[i] * g[i];
+}
+
+#if defined(__aarch64__)
+// Double-precision lanes and vector division are AArch64 only; 32-bit NEON keeps the scalar kernels for these
+
+void biquadNeon(double* x, std::size_t frames, const double* c, double* state) {
+    const float64x2_t b0 = vdupq_n_f64(c[0]), b1 = vdupq_n_f64(c[1]), b2 = vdupq_n_f64(c[2]);
+    const float64x2_t a1 = vdupq_n_f64(c[3]), a2 = vdupq_n_f64(c[4]);
+    float64x2_t s1 = vld1q_f64(state), s2 = vld1q_f64(state + 2);
+    for (std::size_t i = 0; i < frames; ++i) {
+        const float64x2_t in = vld1q_f64(x + 2 * i);
+        const float64x2_t y = vaddq_f64(vmulq_f64(b0, in), s1);
+        s1 = vaddq_f64(vsubq_f64(vmulq_f64(b1, in), vmulq_f64(a1, y)), s2);
+        s2 = vsubq_f64(vmulq_f64(b2, in), vmulq_f64(a2, y));
+        vst1q_f64(x + 2 * i, y);
+    }
+    vst1q_f64(state, s1);
+    vst1q_f64(state + 2, s2);
+}
+
+float requiredNeon(const float* x, std::size_t frames, float ceiling, float* required) {
+    const float32x4_t ceilingV = vdupq_n_f32(ceiling);
+    float32x4_t least = vdupq_n_f32(1.0f);
+    std::size_t i = 0;
+    for (; i + 2 <= frames; i += 2) {
+        const float32x4_t a = vabsq_f32(vld1q_f32(x + 2 * i));
+        const float32x4_t peak = vmaxq_f32(a, vrev64q_f32(a)); // max of each L/R pair
+        const float32x4_t g = vdivq_f32(ceilingV, vmaxq_f32(peak, ceilingV));
+        vst1q_f32(required + 2 * i, g);
+        least = vminq_f32(least, g);
+    }
+    return requiredTail(x, i, frames, ceiling, required, vminvq_f32(least));
+}
+#endif
+
+#endif
+
+struct KernelSet {
+    GainKernel gain;
+    BiquadKernel biquad;
+    RequiredKernel required;
+    ApplyKernel apply;
+};
+
+KernelSet kernelsFor(SimdIsa isa) {
+    switch (isa) {
+#if defined(NEONWAVE_SIMD_X86)
+    case SimdIsa::AVX2: return { gainAvx2, biquadSse2, requiredAvx2, applyAvx2 };
+    case SimdIsa::SSE2: return { gainSse2, biquadSse2, requiredSse2, applySse2 };
+#elif defined(NEONWAVE_SIMD_NEON)
+#if defined(__aarch64__)
+    case SimdIsa::NEON: return { gainNeon, biquadNeon, requiredNeon, applyNeon };
+#else
+    case SimdIsa::NEON: return { gainNeon, biquadScalar, requiredScalar, applyNeon };
+#endif
+#endif
+    default: return { gainScalar, biquadScalar, requiredScalar, applyScalar };
+    }
+}
+
+/// RBJ audio-EQ-cookbook coefficients, normalised by a0.
+std::array<double, 5> biquadFor(const EqBand& band, int sampleRate) {
+    const double frequency = std::clamp(band.frequencyHz, 10.0, 0.45 * sampleRate);
+    const double a = std::pow(10.0, band.gainDb / 40.0);
+    const double w0 = 2.0 * kPi * frequency / sampleRate;
+    const double cosW = std::cos(w0);
+    const double alpha = std::sin(w0) / (2.0 * std::max(band.q, 0.1));
+    const double shelf = 2.0 * std::sqrt(a) * alpha;
+
+    double b0, b1, b2, a0, a1, a2;
+    switch (band.type) {
+    case EqBandType::LowShelf:
+        b0 = a * ((a + 1.0) - (a - 1.0) * cosW + shelf);
+        b1 = 2.0 * a * ((a - 1.0) - (a + 1.0) * cosW);
+        b2 = a * ((a + 1.0) - (a - 1.0) * cosW - shelf);
+        a0 = (a + 1.0) + (a - 1.0) * cosW + shelf;
+        a1 = -2.0 * ((a - 1.0) + (a + 1.0) * cosW);
+        a2 = (a + 1.0) + (a - 1.0) * cosW - shelf;
+        break;
+    case EqBandType::HighShelf:
+        b0 = a * ((a + 1.0) + (a - 1.0) * cosW + shelf);
+        b1 = -2.0 * a * ((a - 1.0) + (a + 1.0) * cosW);
+        b2 = a * ((a + 1.0) + (a - 1.0) * cosW - shelf);
+        a0 = (a + 1.0) - (a - 1.0) * cosW + shelf;
+        a1 = 2.0 * ((a - 1.0) - (a + 1.0) * cosW);
+        a2 = (a + 1.0) - (a - 1.0) * cosW - shelf;
+        break;
+    case EqBandType::Peak:
+    default:
+        b0 = 1.0 + alpha * a;
+        b1 = -2.0 * cosW;
+        b2 = 1.0 - alpha * a;
+        a0 = 1.0 + alpha / a;
+        a1 = -2.0 * cosW;
+        a2 = 1.0 - alpha / a;
+        break;
+    }
+    return { b0 / a0, b1 / a0, b2 / a0, a1 / a0, a2 / a0 };
+}
+
+} // namespace
+
+DspChain::DspChain(SimdIsa isa)
+    : m_isa(isa)
+    , m_eqScratch(kBlockFrames * 2)
+    , m_delay((kMaxLimiterWindow - 1 + kBlockFrames) * 2)
+    , m_required(kBlockFrames * 2)
+    , m_gains(kBlockFrames * 2)
+    , m_minValues(kMaxLimiterWindow)
+    , m_minTimes(kMaxLimiterWindow)
+    , m_box(kMaxLimiterWindow)
+{
+}
+
+void DspChain::prepare(int sampleRate) {
+    m_sampleRate = sampleRate;
+    const auto lookahead = static_cast<std::size_t>(std::llround(kLimiterLookaheadSeconds * sampleRate));
+    m_window = std::clamp<std::size_t>(lookahead, 1, kMaxLimiterWindow - 1) + 1;
+    m_release = 1.0 - std::exp(-1.0 / (kLimiterReleaseSeconds * sampleRate));
+    m_ceiling = static_cast<float>(std::pow(10.0, kLimiterCeilingDb / 20.0));
+    m_gain = m_gainTarget;
+    updateEqCoefficients();
+    reset();
+}
+
+void DspChain::reset() {
+    resetEq();
+    resetLimiter();
+}
+
+void DspChain::setEnabled(Node node, bool enabled) {
+    const int i = static_cast<int>(node);
+    if (m_enabled[i] == enabled) return;
+    m_enabled[i] = enabled;
+    // Nodes come back without memory of what they last saw
+    if (node == Node::Equalizer) resetEq();
+    if (node == Node::Limiter) resetLimiter();
+}
+
+void DspChain::setGain(float gain) {
+    m_gainTarget = std::max(gain, 0.0f);
+}
+
+void DspChain::setEqBands(const std::vector<EqBand>& bands) {
+    m_bandCount = std::min(bands.size(), kMaxEqBands);
+    std::copy_n(bands.begin(), m_bandCount, m_bands.begin());
+    updateEqCoefficients();
+}
+
+std::size_t DspChain::latencyFrames() const {
+    return enabled(Node::Limiter) ? m_window - 1 : 0;
+}
+
+void DspChain::process(float* stereo, std::size_t frames) {
+    if (m_sampleRate <= 0) return;
+    for (std::size_t done = 0; done < frames;) {
+        const std::size_t n = std::min(kBlockFrames, frames - done);
+        processBlock(stereo + 2 * done, n);
+        done += n;
+    }
+}
+
+void DspChain::processBlock(float* stereo, std::size_t frames) {
+    if (enabled(Node::Equalizer)) processEq(stereo, frames);
+    if (enabled(Node::Gain)) processGain(stereo, frames);
+    if (enabled(Node::Limiter)) processLimiter(stereo, frames);
+}
+
+void DspChain::processEq(float* stereo, std::size_t frames) {
+    if (m_activeBandCount == 0) return;
+    const std::size_t samples = frames * 2;
+    const BiquadKernel biquad = kernelsFor(m_isa).biquad;
+    std::copy(stereo, stereo + samples, m_eqScratch.begin());
+    for (std::size_t a = 0; a < m_activeBandCount; ++a) {
+        const std::size_t band = m_activeBands[a];
+        biquad(m_eqScratch.data(), frames, m_coefficients[band].data(), m_eqState[band].data());
+        // Decaying state would otherwise reach the denormal range over a long silence
+        for (double& s : m_eqState[band]) {
+            if (std::abs(s) < kDenormalFloor) s = 0.0;
+        }
+    }
+    for (std::size_t i = 0; i < samples; ++i) stereo[i] = static_cast<float>(m_eqScratch[i]);
+}
+
+void DspChain::processGain(float* stereo, std::size_t frames) {
+    const GainKernel gain = kernelsFor(m_isa).gain;
+    if (m_gain == m_gainTarget) {
+        if (m_gain != 1.0f) gain(stereo, frames, m_gain, 0.0f);
+        return;
+    }
+    const double decay = std::exp(-static_cast<double>(frames) / (kGainSmoothingSeconds * m_sampleRate));
+    auto next = static_cast<float>(m_gainTarget + (m_gain - m_gainTarget) * decay);
+    if (std::abs(next - m_gainTarget) < 1e-5f) next = m_gainTarget; // land exactly, so a settled gain is a plain multiply
+    gain(stereo, frames, m_gain, (next - m_gain) / static_cast<float>(frames));
+    m_gain = next;
+}
+
+void DspChain::processLimiter(float* stereo, std::size_t frames) {
+    const KernelSet k = kernelsFor(m_isa);
+    const std::size_t samples = frames * 2;
+    const std::size_t history = (m_window - 1) * 2;
+    float* const block = m_delay.data() + history;
+    std::copy(stereo, stereo + samples, block);
+
+    const float least = k.required(block, frames, m_ceiling, m_required.data());
+    if (m_limiterIdle && least >= 1.0f) {
+        // Nothing over the ceiling anywhere in the window: a pure delay
+        std::copy(m_delay.data(), m_delay.data() + samples, stereo);
+        m_minCount = 0;
+        m_time += frames;
+    } else {
+        const std::size_t capacity = m_minValues.size();
+        const double inverseWindow = 1.0 / static_cast<double>(m_window);
+        for (std::size_t i = 0; i < frames; ++i, ++m_time) {
+            const float r = m_required[2 * i];
+
+            // Smallest required gain over the lookahead window (monotonic queue)
+            while (m_minCount > 0) {
+                std::size_t back = m_minHead + m_minCount - 1;
+                if (back >= capacity) back -= capacity;
+                if (m_minValues[back] < r) break;
+                --m_minCount;
+            }
+            std::size_t tail = m_minHead + m_minCount;
+            if (tail >= capacity) tail -= capacity;
+            m_minValues[tail] = r;
+            m_minTimes[tail] = m_time;
+            ++m_minCount;
+            if (m_minTimes[m_minHead] + m_window <= m_time) {
+                if (++m_minHead == capacity) m_minHead = 0;
+                --m_minCount;
+            }
+            const float windowMin = m_minValues[m_minHead];
+
+            // Instant attack, exponential release; snaps back to exactly 1 once recovered
+            if (windowMin < m_envelope) {
+                m_envelope = windowMin;
+            } else {
+                m_envelope += (windowMin - m_envelope) * m_release;
+                if (windowMin >= 1.0f && m_envelope > 1.0 - 1e-6) m_envelope = 1.0;
+            }
+            m_unityRun = m_envelope == 1.0 ? m_unityRun + 1 : 0;
+
+            // Averaging over the window spreads the attack across the lookahead
+            m_boxSum += m_envelope - m_box[m_boxPos];
+            m_box[m_boxPos] = m_envelope;
+            if (++m_boxPos == m_window) m_boxPos = 0;
+            const auto g = static_cast<float>(m_boxSum * inverseWindow);
+            m_gains[2 * i] = g;
+            m_gains[2 * i + 1] = g;
+        }
+        k.apply(m_delay.data(), m_gains.data(), stereo, samples);
+
+        m_limiterIdle = m_unityRun >= m_window;
+        if (m_limiterIdle) m_boxSum = static_cast<double>(m_window); // every entry is exactly 1 again
+    }
+    std::copy(m_delay.data() + samples, m_delay.data() + samples + history, m_delay.data());
+}
+
+void DspChain::updateEqCoefficients() {
+    m_activeBandCount = 0;
+    if (m_sampleRate <= 0) return;
+    for (std::size_t b = 0; b < m_bandCount; ++b) {
+        if (std::abs(m_bands[b].gainDb) < kFlatBandDb) {
+            m_eqState[b] = {}; // starts clean if it is raised again
+            continue;
+        }
+        m_coefficients[b] = biquadFor(m_bands[b], m_sampleRate);
+        m_activeBands[m_activeBandCount++] = b;
+    }
+    for (std::size_t b = m_bandCount; b < kMaxEqBands; ++b) m_eqState[b] = {};
+}
+
+void DspChain::resetEq() {
+    for (auto& state : m_eqState) state = {};
+}
+
+void DspChain::resetLimiter() {
+    std::fill(m_delay.begin(), m_delay.end(), 0.0f);
+    std::fill(m_box.begin(), m_box.end(), 1.0);
+    m_minHead = 0;
+    m_minCount = 0;
+    m_boxPos = 0;
+    m_boxSum = static_cast<double>(m_window);
+    m_envelope = 1.0;
+    m_time = 0;
+    m_unityRun = m_window;
+    m_limiterIdle = true;
+}
+
+std::vector<DspChain::BenchmarkResult> DspChain::benchmark(int sampleRate, std::size_t blocks) {
+    const std::vector<SimdIsa> isas = availableIsas();
+
+    // Tones plus noise, hot enough after the EQ for the limiter to work on most blocks
+    constexpr std::size_t kPassBlocks = 64;
+    const std::size_t passFrames = kPassBlocks * kBlockFrames;
+    std::vector<float> input(passFrames * 2);
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> noise(-0.25f, 0.25f);
+    for (std::size_t i = 0; i < passFrames; ++i) {
+        const double t = static_cast<double>(i) / sampleRate;
+        input[2 * i] = static_cast<float>(0.8 * std::sin(2.0 * kPi * 220.0 * t)) + noise(rng);
+        input[2 * i + 1] = static_cast<float>(0.8 * std::sin(2.0 * kPi * 330.0 * t)) + noise(rng);
+    }
+    const std::vector<EqBand> bands{
+        { EqBandType::LowShelf, 80.0, 4.0, 0.707 },
+        { EqBandType::Peak, 250.0, -3.0, 1.0 },
+        { EqBandType::Peak, 1000.0, 2.0, 1.0 },
+        { EqBandType::Peak, 4000.0, -2.0, 1.0 },
+        { EqBandType::HighShelf, 10000.0, 3.0, 0.707 },
+    };
+
+    struct Stage {
+        const char* name;
+        std::array<bool, kNodeCount> enabled;
+    };
+    const Stage stages[] = {
+        { "equalizer", { true, false, false } },
+        { "gain", { false, true, false } },
+        { "limiter", { false, false, true } },
+        { "chain", { true, true, true } },
+    };
+
+    const std::size_t passes = std::max<std::size_t>(1, blocks / kPassBlocks);
+    std::vector<float> work(input.size()), reference(input.size());
+    std::vector<BenchmarkResult> results;
+    for (const Stage& stage : stages) {
+        for (const SimdIsa isa : isas) {
+            DspChain chain(isa);
+            for (int n = 0; n < kNodeCount; ++n) chain.setEnabled(static_cast<Node>(n), stage.enabled[n]);
+            chain.setEqBands(bands);
+            chain.setGain(0.9f);
+            chain.prepare(sampleRate);
+
+            double ns = 0.0;
+            double deviation = 0.0;
+            for (std::size_t p = 0; p < passes; ++p) {
+                std::copy(input.begin(), input.end(), work.begin());
+                const auto start = std::chrono::steady_clock::now();
+                chain.process(work.data(), passFrames);
+                ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+                if (p > 0) continue;
+                if (isa == SimdIsa::Scalar) {
+                    reference = work;
+                } else {
+                    for (std::size_t i = 0; i < work.size(); ++i) {
+                        deviation = std::max(deviation, static_cast<double>(std::abs(work[i] - reference[i])));
+                    }
+                }
+            }
+            results.push_back({ isa, stage.name, ns / static_cast<double>(passes * kPassBlocks), deviation });
+        }
+    }
+    return results;
+}
+
+double DspChain::measureLimiterOvershootDb(int sampleRate, double overdriveDb) {
+    DspChain chain;
+    chain.setEnabled(Node::Equalizer, false);
+    chain.setEnabled(Node::Gain, false);
+    chain.prepare(sampleRate);
+
+    // A steady tone under the ceiling with bursts and single-sample spikes far over it
+    const auto ceiling = static_cast<float>(std::pow(10.0, kLimiterCeilingDb / 20.0));
+    const auto hot = static_cast<float>(ceiling * std::pow(10.0, overdriveDb / 20.0));
+    const std::size_t frames = static_cast<std::size_t>(sampleRate) * 4;
+    std::vector<float> signal(frames * 2);
+    std::mt19937 rng(99);
+    std::uniform_real_distribution<float> noise(-1.0f, 1.0f);
+    const std::size_t burstEvery = static_cast<std::size_t>(sampleRate) / 4;
+    const std::size_t burstLength = static_cast<std::size_t>(sampleRate) / 200;
+    for (std::size_t i = 0; i < frames; ++i) {
+        const auto tone = static_cast<float>(0.5 * ceiling * std::sin(2.0 * kPi * 100.0 * i / sampleRate));
+        const bool burst = i % burstEvery < burstLength;
+        const bool spike = i % 9973 == 0;
+        signal[2 * i] = burst ? hot * noise(rng) : spike ? hot : tone;
+        signal[2 * i + 1] = burst ? hot * noise(rng) : spike ? -hot : tone;
+    }
+
+    constexpr std::size_t kChunk = 333; // deliberately not a multiple of the block size
+    float peak = 0.0f;
+    for (std::size_t f = 0; f < frames; f += kChunk) {
+        const std::size_t n = std::min(kChunk, frames - f);
+        chain.process(signal.data() + 2 * f, n);
+        for (std::size_t i = 0; i < n * 2; ++i) peak = std::max(peak, std::abs(signal[2 * f + i]));
+    }
+    return peak > 0.0f ? 20.0 * std::log10(peak / ceiling) : -std::numeric_limits<double>::infinity();
+}
+
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "SimdIsa.h"
+
+namespace NeonWave::Core::Audio {
+
+enum class EqBandType { Peak, LowShelf, HighShelf };
+
+/// One band of the parametric equalizer (RBJ cookbook shapes); a band at 0 dB is skipped.
+struct EqBand {
+    EqBandType type = EqBandType::Peak;
+    double frequencyHz = 1000.0;
+    double gainDb = 0.0;
+    double q = 0.707;
+};
+
+/**
+ * @brief Output-path DSP: parametric EQ, smoothed gain and a lookahead limiter, in that order.
+ *
+ * process() works in place on interleaved float stereo, in blocks of at
+ * most kBlockFrames; parameter changes take effect at block boundaries.
+ * Each node can be switched off and then costs nothing, as does an EQ with
+ * every band flat, a gain that has settled at unity and a limiter whose
+ * lookahead window holds nothing above the ceiling.
+ *
+ * - Equalizer: transposed direct form II biquads in double precision, which
+ *   low bands at 192 kHz need. The recursion is serial in time, so the SIMD
+ *   kernels run the two channels side by side (SSE2; NEON on AArch64).
+ * - Gain: a one-pole glide towards the target, evaluated per block and
+ *   ramped linearly across it, so volume changes never step.
+ * - Limiter: brickwall at kLimiterCeilingDb sample peak. The gain each frame
+ *   needs is found with SIMD; a sliding minimum over the lookahead window,
+ *   an instant-attack/exponential-release envelope and a box filter as long
+ *   as the window turn it into a smooth gain that is already down when the
+ *   peak leaves the delay line. Adds latencyFrames() of delay.
+ *
+ * All buffers are sized for kMaxSampleRate at construction, so neither
+ * prepare() nor process() allocates. Not thread-safe.
+ */
+class DspChain {
+public:
+    enum class Node { Equalizer, Gain, Limiter };
+    static constexpr int kNodeCount = 3;
+
+    static constexpr std::size_t kBlockFrames = 256;
+    static constexpr std::size_t kMaxEqBands = 8;
+    static constexpr int kMaxSampleRate = 384000;
+    static constexpr double kGainSmoothingSeconds = 0.015;
+    static constexpr double kLimiterLookaheadSeconds = 0.002;
+    static constexpr double kLimiterReleaseSeconds = 0.15;
+    static constexpr double kLimiterCeilingDb = -1.0;
+
+    struct BenchmarkResult {
+        SimdIsa isa;
+        const char* stage;   ///< "equalizer", "gain", "limiter" or "chain"
+        double nsPerBlock;
+        double maxDeviation; ///< Largest difference from the scalar kernels' output
+    };
+
+    explicit DspChain(SimdIsa isa = detectIsa());
+
+    /// Set the stream rate; clears all filter and limiter state and lands the gain on its target.
+    void prepare(int sampleRate);
+    /// Clear filter and limiter state, as for a discontinuity in the input.
+    void reset();
+
+    int sampleRate() const { return m_sampleRate; }
+    SimdIsa isa() const { return m_isa; }
+
+    void setEnabled(Node node, bool enabled);
+    bool enabled(Node node) const { return m_enabled[static_cast<int>(node)]; }
+
+    /// Linear gain to glide to.
+    void setGain(float gain);
+    /// Replace the equalizer bands; anything past kMaxEqBands is ignored.
+    void setEqBands(const std::vector<EqBand>& bands);
+
+    /// Delay the chain adds to the signal: the limiter's lookahead while it is enabled.
+    std::size_t latencyFrames() const;
+
+    void process(float* stereo, std::size_t frames);
+
+    /// Time each node on its own, and the whole chain, at @p sampleRate for every kernel set on this CPU.
+    static std::vector<BenchmarkResult> benchmark(int sampleRate = 192000, std::size_t blocks = 4096);
+    /// Largest sample the limiter lets out of @p overdriveDb-hot material, in dB relative to its ceiling.
+    static double measureLimiterOvershootDb(int sampleRate = 48000, double overdriveDb = 12.0);
+
+private:
+    void processBlock(float* stereo, std::size_t frames);
+    void processEq(float* stereo, std::size_t frames);
+    void processGain(float* stereo, std::size_t frames);
+    void processLimiter(float* stereo, std::size_t frames);
+    void updateEqCoefficients();
+    void resetEq();
+    void resetLimiter();
+
+    SimdIsa m_isa;
+    int m_sampleRate = 0;
+    std::array<bool, kNodeCount> m_enabled{ true, true, true };
+
+    // Equalizer. Coefficients are b0 b1 b2 a1 a2 (a0 normalised out); state is
+    // s1 L/R then s2 L/R, so the SIMD kernels load it as two channel pairs.
+    std::array<EqBand, kMaxEqBands> m_bands{};
+    std::size_t m_bandCount = 0;
+    std::array<std::array<double, 5>, kMaxEqBands> m_coefficients{};
+    std::array<std::array<double, 4>, kMaxEqBands> m_eqState{};
+    std::array<std::size_t, kMaxEqBands> m_activeBands{};
+    std::size_t m_activeBandCount = 0;
+    std::vector<double> m_eqScratch;
+
+    // Gain
+    float m_gainTarget = 1.0f;
+    float m_gain = 1.0f;
+
+    // Limiter
+    std::size_t m_window = 1;          // lookahead + 1 frames
+    float m_ceiling = 1.0f;
+    double m_release = 0.0;
+    std::vector<float> m_delay;        // window - 1 frames of history, then the block being processed
+    std::vector<float> m_required;     // gain each frame needs, written to both of its samples
+    std::vector<float> m_gains;        // gain applied, likewise per sample
+    std::vector<float> m_minValues;    // monotonic queue for the sliding minimum (ring)
+    std::vector<std::uint64_t> m_minTimes;
+    std::size_t m_minHead = 0;
+    std::size_t m_minCount = 0;
+    std::vector<double> m_box;         // envelope over the last window frames (ring)
+    std::size_t m_boxPos = 0;
+    double m_boxSum = 0.0;
+    double m_envelope = 1.0;
+    std::uint64_t m_time = 0;
+    std::size_t m_unityRun = 0;        // consecutive frames the envelope has sat at exactly 1
+    bool m_limiterIdle = true;
+};
+
+}
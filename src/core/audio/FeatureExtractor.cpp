@@ -0,0 +1,130 @@
+#include "FeatureExtractor.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace NeonWave::Core::Audio {
+
+namespace {
+
+constexpr float kFloorDb = -100.0f;
+constexpr float kFluxCompression = 100.0f; // log(1 + k*mag): keeps quiet onsets visible
+constexpr float kHannEnbw = 1.5f;          // Hann leaks a sine into neighbouring bins; undo it for band energy
+constexpr std::size_t kMonoBlockFrames = 4096; // resampled input taken per pass, behind the pending window
+
+} // namespace
+
+FeatureExtractor::FeatureExtractor()
+    : m_resampler(detectIsa())
+    , m_mono(kWindowFrames + kMonoBlockFrames)
+    , m_window(kWindowFrames)
+    , m_fftPlan(kWindowFrames)
+    , m_fft(kWindowFrames)
+    , m_bandStartBin(kBandCount + 1)
+    , m_previousLogMag(kWindowFrames / 2 + 1)
+{
+    m_window = m_fftPlan.hannWindow();
+    double windowSum = 0.0;
+    for (const float w : m_window) windowSum += w;
+    m_magnitudeScale = static_cast<float>(2.0 / windowSum);
+
+    const int nyquistBin = kWindowFrames / 2;
+    for (int b = 0; b < kBandCount; ++b) {
+        const int bin = static_cast<int>(std::lround(kBandEdgesHz[b] * kWindowFrames / kSampleRate));
+        m_bandStartBin[b] = std::clamp(bin, 1, nyquistBin);
+    }
+    m_bandStartBin[kBandCount] = nyquistBin + 1;
+
+    reset();
+}
+
+void FeatureExtractor::reset() {
+    m_resampler.reset();
+    // Leading silence so hop h covers [h * hop, (h + 1) * hop) with a full window behind it
+    m_monoStart = 0;
+    m_monoEnd = kWindowFrames - kHopFrames;
+    std::fill(m_mono.begin(), m_mono.begin() + static_cast<std::ptrdiff_t>(m_monoEnd), 0.0f);
+    std::fill(m_previousLogMag.begin(), m_previousLogMag.end(), 0.0f);
+    m_values.clear();
+}
+
+void FeatureExtractor::push(const float* stereo, std::size_t frames, int sampleRate) {
+    if (frames == 0 || sampleRate <= 0) return;
+    if (m_resampler.inputRate() != 0 && m_resampler.inputRate() != sampleRate) {
+        // configure() drops the filter's contents; let the old rate's tail through first
+        m_resampled.resize(std::max(m_resampled.size(), m_resampler.maxOutputFrames(m_resampler.latencyFrames()) * 2));
+        appendMono(m_resampled.data(), m_resampler.flush(m_resampled.data()));
+    }
+    m_resampler.configure(sampleRate, kSampleRate);
+    m_resampled.resize(std::max(m_resampled.size(), m_resampler.maxOutputFrames(frames) * 2));
+    appendMono(m_resampled.data(), m_resampler.process(stereo, frames, m_resampled.data()));
+}
+
+void FeatureExtractor::finish() {
+    if (m_resampler.inputRate() != 0) {
+        m_resampled.resize(std::max(m_resampled.size(), m_resampler.maxOutputFrames(m_resampler.latencyFrames()) * 2));
+        appendMono(m_resampled.data(), m_resampler.flush(m_resampled.data()));
+    }
+
+    // Less than a window is pending; anything beyond the overlap is a partial hop
+    const std::size_t pending = m_monoEnd - m_monoStart;
+    if (pending <= static_cast<std::size_t>(kWindowFrames - kHopFrames)) return;
+    std::memmove(m_mono.data(), m_mono.data() + m_monoStart, pending * sizeof(float));
+    std::fill(m_mono.begin() + static_cast<std::ptrdiff_t>(pending), m_mono.begin() + kWindowFrames, 0.0f);
+    analyzeWindow(m_mono.data());
+    m_monoStart = kHopFrames;
+    m_monoEnd = kWindowFrames;
+}
+
+void FeatureExtractor::appendMono(const float* stereo, std::size_t frames) {
+    for (std::size_t done = 0; done < frames;) {
+        const std::size_t count = std::min(frames - done, m_mono.size() - m_monoEnd);
+        const float* in = stereo + 2 * done;
+        for (std::size_t i = 0; i < count; ++i) {
+            m_mono[m_monoEnd + i] = 0.5f * (in[2 * i] + in[2 * i + 1]);
+        }
+        m_monoEnd += count;
+        done += count;
+
+        while (m_monoEnd - m_monoStart >= static_cast<std::size_t>(kWindowFrames)) {
+            analyzeWindow(m_mono.data() + m_monoStart);
+            m_monoStart += kHopFrames;
+        }
+        if (m_monoEnd == m_mono.size()) {
+            // Full: move the pending part of a window to the front to make room for the next block
+            m_monoEnd -= m_monoStart;
+            std::memmove(m_mono.data(), m_mono.data() + m_monoStart, m_monoEnd * sizeof(float));
+            m_monoStart = 0;
+        }
+    }
+}
+
+void FeatureExtractor::analyzeWindow(const float* x) {
+    m_fftPlan.forwardReal(x, m_window.data(), m_fft.data());
+
+    const std::size_t base = m_values.size();
+    m_values.resize(base + kValuesPerHop);
+    float* out = m_values.data() + base;
+
+    float flux = 0.0f;
+    const int bins = kWindowFrames / 2 + 1;
+    for (int b = 0; b < kBandCount; ++b) {
+        float energy = 0.0f;
+        for (int k = m_bandStartBin[b]; k < m_bandStartBin[b + 1]; ++k) {
+            const float mag = std::abs(m_fft[k]) * m_magnitudeScale;
+            energy += mag * mag;
+            const float logMag = std::log1p(kFluxCompression * mag);
+            flux += std::max(0.0f, logMag - m_previousLogMag[k]);
+            m_previousLogMag[k] = logMag;
+        }
+        energy /= kHannEnbw;
+        out[b] = energy > 0.0f ? std::max(kFloorDb, 10.0f * std::log10(energy)) : kFloorDb;
+    }
+    out[kOnsetIndex] = flux / bins;
+
+    double sumSquares = 0.0;
+    for (int i = kWindowFrames - kHopFrames; i < kWindowFrames; ++i) sumSquares += x[i] * x[i];
+    out[kRmsIndex] = static_cast<float>(std::sqrt(sumSquares / kHopFrames));
+}
+
+}
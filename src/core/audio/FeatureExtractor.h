@@ -0,0 +1,70 @@
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Fft.h"
+#include "PolyphaseResampler.h"
+
+namespace NeonWave::Core::Audio {
+
+/**
+ * @brief Per-hop features of a whole track, computed in one streaming pass.
+ *
+ * Input of any rate is resampled to kSampleRate and downmixed to mono; every
+ * kHopFrames a kWindowFrames Hann-windowed FFT yields kBandCount band
+ * energies (dB re full scale), a spectral-flux onset strength and the RMS of
+ * the hop. Values are appended hop-major, kValuesPerHop floats per hop, in
+ * exactly the layout AnalysisCache writes to disk. finish() analyses the
+ * track's last, partial hop.
+ *
+ * Bump kVersion whenever the output changes so cached results are redone.
+ */
+class FeatureExtractor {
+public:
+    static constexpr std::uint32_t kVersion = 2;
+    static constexpr int kSampleRate = 44100;
+    static constexpr int kHopFrames = 512;
+    static constexpr int kWindowFrames = 1024;
+    static constexpr int kBandCount = 8;
+    static constexpr int kOnsetIndex = kBandCount;    ///< Offset of the onset value within a hop
+    static constexpr int kRmsIndex = kBandCount + 1;  ///< Offset of the RMS value within a hop
+    static constexpr int kValuesPerHop = kBandCount + 2;
+
+    /// Lower edges of the bands in Hz; the last band runs to Nyquist.
+    static constexpr float kBandEdgesHz[kBandCount] = { 20.f, 60.f, 250.f, 500.f, 2000.f, 4000.f, 6000.f, 11000.f };
+
+    FeatureExtractor();
+
+    /// Start a new track.
+    void reset();
+    /// Feed interleaved float stereo at @p sampleRate; complete hops are analysed immediately.
+    void push(const float* stereo, std::size_t frames, int sampleRate);
+    /// End of the track: flush the resampler and analyse the last hop, zero-padded. Call once.
+    void finish();
+
+    std::size_t hopCount() const { return m_values.size() / kValuesPerHop; }
+    const std::vector<float>& values() const { return m_values; }
+
+private:
+    /// Downmix resampled stereo into m_mono, analysing every window that completes.
+    void appendMono(const float* stereo, std::size_t frames);
+    /// One hop from kWindowFrames mono samples; the hop is the last kHopFrames of them.
+    void analyzeWindow(const float* x);
+
+    PolyphaseResampler m_resampler;
+    std::vector<float> m_resampled;
+    std::vector<float> m_mono;              // fixed size; pending samples in [m_monoStart, m_monoEnd)
+    std::size_t m_monoStart = 0;            // next window
+    std::size_t m_monoEnd = 0;
+    std::vector<float> m_window;            // Hann
+    Fft m_fftPlan;
+    std::vector<std::complex<float>> m_fft;
+    std::vector<int> m_bandStartBin;        // kBandCount + 1 entries
+    std::vector<float> m_previousLogMag;
+    float m_magnitudeScale = 0.0f;          // maps |X| to sine amplitude
+    std::vector<float> m_values;
+};
+
+}
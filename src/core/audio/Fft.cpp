@@ -0,0 +1,114 @@
+#include "Fft.h"
+#include <cmath>
+
+namespace NeonWave::Core::Audio {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+} // namespace
+
+Fft::Fft(int size)
+    : m_size(size)
+    , m_twiddles(size / 2)
+    , m_bitReverse(size)
+{
+    for (int k = 0; k < size / 2; ++k) {
+        m_twiddles[k] = std::polar(1.0f, static_cast<float>(-2.0 * kPi * k / size));
+    }
+    int bits = 0;
+    while ((1 << bits) < size) ++bits;
+    for (std::uint32_t i = 0; i < static_cast<std::uint32_t>(size); ++i) {
+        std::uint32_t r = 0;
+        for (int b = 0; b < bits; ++b) r |= ((i >> b) & 1u) << (bits - 1 - b);
+        m_bitReverse[i] = r;
+    }
+}
+
+void Fft::forwardReal(const float* input, const float* window, std::complex<float>* out) const {
+    for (int i = 0; i < m_size; ++i) {
+        out[m_bitReverse[i]] = { input[i] * window[i], 0.0f };
+    }
+    butterflies(out);
+}
+
+void Fft::forward(const std::complex<float>* input, std::complex<float>* out) const {
+    for (int i = 0; i < m_size; ++i) {
+        out[m_bitReverse[i]] = input[i];
+    }
+    butterflies(out);
+}
+
+void Fft::butterflies(std::complex<float>* data) const {
+    // Plain float arithmetic on the interleaved re/im pairs std::complex guarantees: its operator*
+    // carries a NaN/infinity fixup, and GCC round-trips the packed halves through the stack
+    auto* d = reinterpret_cast<float*>(data);
+    const auto* tw = reinterpret_cast<const float*>(m_twiddles.data());
+    for (int len = 2; len <= m_size; len <<= 1) {
+        const int half = len / 2;
+        const int step = m_size / len;
+        for (int i = 0; i < m_size; i += len) {
+            float* lo = d + 2 * i;
+            float* hi = d + 2 * (i + half);
+            for (int j = 0; j < half; ++j) {
+                const float wr = tw[2 * j * step], wi = tw[2 * j * step + 1];
+                const float ar = hi[2 * j], ai = hi[2 * j + 1];
+                const float vr = ar * wr - ai * wi;
+                const float vi = ar * wi + ai * wr;
+                const float ur = lo[2 * j], ui = lo[2 * j + 1];
+                lo[2 * j] = ur + vr;
+                lo[2 * j + 1] = ui + vi;
+                hi[2 * j] = ur - vr;
+                hi[2 * j + 1] = ui - vi;
+            }
+        }
+    }
+}
+
+std::vector<float> Fft::hannWindow() const {
+    std::vector<float> window(m_size);
+    for (int i = 0; i < m_size; ++i) {
+        window[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * kPi * i / m_size));
+    }
+    return window;
+}
+
+RealFft::RealFft(int size)
+    : m_size(size)
+    , m_half(size / 2)
+    , m_twiddles(size / 2 + 1)
+    , m_packed(size / 2)
+    , m_spectrum(size / 2)
+{
+    for (int k = 0; k <= size / 2; ++k) {
+        m_twiddles[k] = std::polar(1.0f, static_cast<float>(-2.0 * kPi * k / size));
+    }
+}
+
+void RealFft::forward(const float* input, const float* window, std::complex<float>* out) {
+    const int half = m_size / 2;
+    for (int n = 0; n < half; ++n) {
+        m_packed[n] = { input[2 * n] * window[2 * n], input[2 * n + 1] * window[2 * n + 1] };
+    }
+    m_half.forward(m_packed.data(), m_spectrum.data());
+
+    // Z = E + iO, where E and O are the spectra of the even and odd samples;
+    // both are conjugate-symmetric, which separates them: X[k] = E[k] + W^k O[k]
+    const auto* z = reinterpret_cast<const float*>(m_spectrum.data());
+    const auto* tw = reinterpret_cast<const float*>(m_twiddles.data());
+    auto* x = reinterpret_cast<float*>(out);
+    for (int k = 0; k <= half; ++k) {
+        const int at = k == half ? 0 : k;
+        const int mirror = k == 0 ? 0 : half - k;
+        const float zRe = z[2 * at], zIm = z[2 * at + 1];
+        const float mRe = z[2 * mirror], mIm = -z[2 * mirror + 1]; // conj(Z[N/2 - k])
+        const float eRe = 0.5f * (zRe + mRe), eIm = 0.5f * (zIm + mIm);
+        const float oRe = 0.5f * (zIm - mIm), oIm = -0.5f * (zRe - mRe);
+        const float wRe = tw[2 * k], wIm = tw[2 * k + 1];
+        x[2 * k] = eRe + wRe * oRe - wIm * oIm;
+        x[2 * k + 1] = eIm + wRe * oIm + wIm * oRe;
+    }
+}
+
+}
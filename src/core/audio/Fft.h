@@ -0,0 +1,66 @@
+#pragma once
+
+#include <complex>
+#include <cstdint>
+#include <vector>
+
+namespace NeonWave::Core::Audio {
+
+/**
+ * @brief Radix-2 complex FFT of a fixed power-of-two size.
+ *
+ * Twiddles and the bit-reversal table are built once; transforms allocate
+ * nothing, so one instance can be reused for every hop of a stream.
+ */
+class Fft {
+public:
+    explicit Fft(int size);
+
+    int size() const { return m_size; }
+
+    /// Transform size() windowed real samples into @p out (size() bins, the upper half mirrored).
+    void forwardReal(const float* input, const float* window, std::complex<float>* out) const;
+    /// Transform size() complex samples into @p out; @p input and @p out must not overlap.
+    void forward(const std::complex<float>* input, std::complex<float>* out) const;
+
+    /// Periodic Hann window of size() samples.
+    std::vector<float> hannWindow() const;
+
+private:
+    /// In-place butterflies over data already in bit-reversed order.
+    void butterflies(std::complex<float>* data) const;
+
+    int m_size;
+    std::vector<std::complex<float>> m_twiddles;
+    std::vector<std::uint32_t> m_bitReverse;
+};
+
+/**
+ * @brief Real-input FFT of a fixed power-of-two size, returning only the non-redundant half.
+ *
+ * Packs even and odd samples into one complex sequence of size() / 2, runs
+ * a half-size Fft on it and untangles the two spectra in a single pass, so
+ * it does a little over half the work of Fft::forwardReal for the same
+ * bins. Keeps its own scratch, so an instance is not thread-safe.
+ */
+class RealFft {
+public:
+    /// @p size is a power of two, at least 4.
+    explicit RealFft(int size);
+
+    int size() const { return m_size; }
+    /// Bins forward() writes: DC to Nyquist inclusive.
+    int bins() const { return m_size / 2 + 1; }
+
+    /// Transform size() windowed real samples into @p out (bins() bins).
+    void forward(const float* input, const float* window, std::complex<float>* out);
+
+private:
+    int m_size;
+    Fft m_half;
+    std::vector<std::complex<float>> m_twiddles; // e^(-2 pi i k / size) for k in [0, size / 2]
+    std::vector<std::complex<float>> m_packed;
+    std::vector<std::complex<float>> m_spectrum;
+};
+
+}
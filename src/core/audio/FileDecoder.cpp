@@ -0,0 +1,45 @@
+#include "FileDecoder.h"
+
+#ifdef NEONWAVE_HAVE_LIBAV
+#include "LibavFileDecoder.h"
+#endif
+
+namespace NeonWave::Core::Audio {
+
+bool hasFileDecoder() {
+#ifdef NEONWAVE_HAVE_LIBAV
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::unique_ptr<FileDecoder> createFileDecoder() {
+#ifdef NEONWAVE_HAVE_LIBAV
+    return std::make_unique<LibavFileDecoder>();
+#else
+    return nullptr;
+#endif
+}
+
+SeekScanResult scanSeekIndex(const QString& path, const std::function<bool()>& keepGoing) {
+#ifdef NEONWAVE_HAVE_LIBAV
+    return LibavFileDecoder::scanSeekIndex(path, keepGoing);
+#else
+    SeekScanResult result;
+    result.error = QStringLiteral("built without libav");
+    (void)path;
+    (void)keepGoing;
+    return result;
+#endif
+}
+
+std::uint32_t fileDecoderVersion() {
+#ifdef NEONWAVE_HAVE_LIBAV
+    return LibavFileDecoder::libraryVersion();
+#else
+    return 0;
+#endif
+}
+
+}
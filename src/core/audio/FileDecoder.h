@@ -0,0 +1,71 @@
+#pragma once
+
+#include <QString>
+#include <QtGlobal>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include "SeekIndex.h"
+
+namespace NeonWave::Core::Audio {
+
+/**
+ * @brief Synchronous decoder: one file to interleaved float stereo.
+ *
+ * Unlike TrackDecoder there is no pacing and no event loop; decode() does
+ * the work on the calling thread and returns as soon as it has frames, so a
+ * loop over it runs as fast as the CPU allows. Used for batch/offline work
+ * and, wrapped in a ThreadedTrackDecoder, for playback.
+ */
+class FileDecoder {
+public:
+    virtual ~FileDecoder() = default;
+
+    virtual bool open(const QString& path) = 0;
+    virtual void close() = 0;
+
+    /// Decode up to @p frames into @p dst (frames * 2 floats); 0 at end of file or on error.
+    virtual std::size_t decode(float* dst, std::size_t frames) = 0;
+
+    /// Continue decoding from @p frame (in the file's own sample rate).
+    virtual bool seek(qint64 frame) = 0;
+
+    /// Native sample rate, known once open() succeeds.
+    virtual int sampleRate() const = 0;
+    /// -1 if the container does not say.
+    virtual qint64 durationMs() const = 0;
+
+    virtual bool hasError() const = 0;
+    virtual QString errorString() const = 0;
+
+    /// Table for seek() to use from now on (null to stop); decoders that cannot seek by byte ignore it.
+    virtual void setSeekIndex(std::shared_ptr<const SeekIndex> index) { (void)index; }
+
+    const QString& path() const { return m_path; }
+
+protected:
+    QString m_path;
+};
+
+/// True when this build includes a FileDecoder implementation (libav).
+bool hasFileDecoder();
+
+/// New decoder from the best backend in this build; null if there is none.
+std::unique_ptr<FileDecoder> createFileDecoder();
+
+/// Result of scanSeekIndex().
+struct SeekScanResult {
+    std::shared_ptr<SeekIndex> index;
+    bool needed = true; ///< False when the container's own seeking is already sample-exact
+    QString error;
+};
+
+/// Demux @p path once and record a SeekPoint every SeekIndex::kIntervalSeconds;
+/// @p keepGoing is polled between packets and stops the scan when it returns false.
+SeekScanResult scanSeekIndex(const QString& path, const std::function<bool()>& keepGoing = {});
+
+/// Version of the backend createFileDecoder() uses (0 if none); changes when its output may differ.
+std::uint32_t fileDecoderVersion();
+
+}
@@ -0,0 +1,78 @@
+#include "JitterBuffer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace NeonWave::Core::Audio {
+
+namespace {
+
+constexpr std::size_t kPeriodGranularity = 64;
+constexpr double kIntervalSmoothing = 0.05;
+
+} // namespace
+
+JitterBuffer::JitterBuffer(std::size_t capacityFrames)
+    : m_ring(capacityFrames * 2)
+{
+}
+
+void JitterBuffer::reset(int sampleRate) {
+    m_ring.discard(m_ring.readAvailable());
+    m_sampleRate.store(sampleRate, std::memory_order_relaxed);
+}
+
+void JitterBuffer::setTargetLatencyMs(int ms) {
+    m_targetLatencyMs.store(std::clamp(ms, kMinTargetLatencyMs, kMaxTargetLatencyMs), std::memory_order_relaxed);
+}
+
+std::size_t JitterBuffer::targetFrames() const {
+    const auto frames = static_cast<std::size_t>(sampleRate()) * static_cast<std::size_t>(targetLatencyMs()) / 1000;
+    return std::min(frames, m_ring.capacity() / 2);
+}
+
+std::size_t JitterBuffer::fillRoom() const {
+    const std::size_t target = targetFrames();
+    const std::size_t buffered = bufferedFrames();
+    return buffered < target ? target - buffered : 0;
+}
+
+std::size_t JitterBuffer::push(const float* stereo, std::size_t frames) {
+    const std::size_t written = m_ring.write(stereo, frames * 2) / 2;
+    if (written < frames) {
+        m_overruns.fetch_add(1, std::memory_order_relaxed);
+    }
+    return written;
+}
+
+void JitterBuffer::notePumpInterval(std::uint64_t nanoseconds) {
+    const int rate = sampleRate();
+    if (rate <= 0 || nanoseconds == 0) return;
+
+    // Scheduler hiccups are what the buffer exists for; don't let one stretch the period
+    const double sample = std::min<double>(static_cast<double>(nanoseconds), targetLatencyMs() * 1e6);
+    m_intervalEmaNs = m_intervalEmaNs > 0.0
+        ? m_intervalEmaNs + kIntervalSmoothing * (sample - m_intervalEmaNs)
+        : sample;
+
+    const auto intervalFrames = static_cast<std::size_t>(std::ceil(m_intervalEmaNs * 1e-9 * rate));
+    std::size_t period = (intervalFrames + kPeriodGranularity - 1) / kPeriodGranularity * kPeriodGranularity;
+    period = std::clamp(period, kPeriodGranularity, std::max(targetFrames() / 2, kPeriodGranularity));
+    m_periodFrames.store(period, std::memory_order_relaxed);
+}
+
+JitterStats JitterBuffer::stats() const {
+    JitterStats s;
+    s.sampleRate = sampleRate();
+    s.targetLatencyMs = targetLatencyMs();
+    if (s.sampleRate > 0) {
+        s.periodMs = periodFrames() * 1000.0 / s.sampleRate;
+        s.queuedMs = bufferedFrames() * 1000.0 / s.sampleRate;
+    }
+    s.underruns = m_underruns.load(std::memory_order_relaxed);
+    s.overruns = m_overruns.load(std::memory_order_relaxed);
+    s.partialWrites = m_partialWrites.load(std::memory_order_relaxed);
+    s.framesWritten = m_framesWritten.load(std::memory_order_relaxed);
+    return s;
+}
+
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "SpscRingBuffer.h"
+
+namespace NeonWave::Core::Audio {
+
+/// Snapshot of the output jitter buffer; safe to take from any thread.
+struct JitterStats {
+    int sampleRate = 0;
+    double targetLatencyMs = 0.0;
+    double periodMs = 0.0;        ///< Current sink write granularity
+    double queuedMs = 0.0;        ///< Decoded audio waiting in front of the sink
+    double sinkBufferedMs = 0.0;  ///< Audio accepted by the sink but not yet played
+    std::uint64_t underruns = 0;     ///< Sink ran dry while playing
+    std::uint64_t overruns = 0;      ///< Writes the sink refused outright; data kept and retried
+    std::uint64_t partialWrites = 0; ///< Writes the sink only partly accepted; remainder kept
+    std::uint64_t framesWritten = 0;
+};
+
+/**
+ * @brief Decoded float stereo queued in front of the QAudioSink.
+ *
+ * The producer tops it up to the target latency; drainTo() moves whole
+ * periods into the sink and keeps anything the sink did not accept, so no
+ * sample is ever dropped on a full device. The period follows the measured
+ * pump interval: each pass should refill what the device played since the
+ * previous one in a single write.
+ *
+ * Filled and drained on the audio thread; stats() may be read from any other.
+ */
+class JitterBuffer {
+public:
+    static constexpr int kMinTargetLatencyMs = 10;
+    static constexpr int kMaxTargetLatencyMs = 200;
+
+    explicit JitterBuffer(std::size_t capacityFrames = 1 << 17);
+
+    /// Drops everything queued; a rate change always starts from empty.
+    void reset(int sampleRate);
+    int sampleRate() const { return m_sampleRate.load(std::memory_order_relaxed); }
+
+    void setTargetLatencyMs(int ms);
+    int targetLatencyMs() const { return m_targetLatencyMs.load(std::memory_order_relaxed); }
+    std::size_t targetFrames() const;
+
+    std::size_t bufferedFrames() const { return m_ring.size() / 2; }
+    /// Frames the producer should supply to get back to the target.
+    std::size_t fillRoom() const;
+    /// Queue @p frames of interleaved stereo; anything that does not fit counts as an overrun.
+    std::size_t push(const float* stereo, std::size_t frames);
+
+    /// Feed the period estimate with the time since the previous pump pass.
+    void notePumpInterval(std::uint64_t nanoseconds);
+    void noteUnderrun() { m_underruns.fetch_add(1, std::memory_order_relaxed); }
+    std::size_t periodFrames() const { return m_periodFrames.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Hand queued audio to the sink.
+     * @param roomFrames Frames the sink has room for
+     * @param sinkBufferedFrames Frames the sink still holds; below one period
+     *        everything available is written instead of whole periods
+     * @param write write(const float* stereo, size_t frames) -> frames accepted
+     * @return Frames accepted by the sink
+     */
+    template <typename WriteFn>
+    std::size_t drainTo(std::size_t roomFrames, std::size_t sinkBufferedFrames, WriteFn&& write);
+
+    JitterStats stats() const;
+
+private:
+    SpscRingBuffer<float> m_ring; // interleaved stereo, always whole frames
+    std::atomic<int> m_sampleRate{0};
+    std::atomic<int> m_targetLatencyMs{50};
+    std::atomic<std::size_t> m_periodFrames{256};
+    double m_intervalEmaNs = 0.0;
+
+    std::atomic<std::uint64_t> m_underruns{0};
+    std::atomic<std::uint64_t> m_overruns{0};
+    std::atomic<std::uint64_t> m_partialWrites{0};
+    std::atomic<std::uint64_t> m_framesWritten{0};
+};
+
+template <typename WriteFn>
+std::size_t JitterBuffer::drainTo(std::size_t roomFrames, std::size_t sinkBufferedFrames, WriteFn&& write) {
+    std::size_t frames = std::min(roomFrames, bufferedFrames());
+    const std::size_t period = periodFrames();
+    if (sinkBufferedFrames >= period) {
+        frames -= frames % period; // sink is safe: only top it up in whole periods
+    }
+    if (frames == 0) return 0;
+
+    const std::size_t taken = m_ring.consume([&write](const float* data, std::size_t samples, std::size_t) {
+        return write(data, samples / 2) * 2;
+    }, frames * 2) / 2;
+
+    if (taken == 0) {
+        m_overruns.fetch_add(1, std::memory_order_relaxed);
+    } else if (taken < frames) {
+        m_partialWrites.fetch_add(1, std::memory_order_relaxed);
+    }
+    m_framesWritten.fetch_add(taken, std::memory_order_relaxed);
+    return taken;
+}
+
+}
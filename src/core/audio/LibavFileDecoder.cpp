@@ -0,0 +1,365 @@
+#include "LibavFileDecoder.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavutil/channel_layout.h>
+#include <libswresample/swresample.h>
+}
+
+namespace NeonWave::Core::Audio {
+
+namespace {
+
+// Decoded and dropped ahead of an indexed seek target, so codecs that borrow
+// from earlier packets (the mp3 bit reservoir, AAC overlap) have warmed up
+constexpr qint64 kSeekPrerollFrames = 8192;
+
+/// Raw elementary streams: no index in the container, timestamps after a seek are bitrate guesses.
+bool needsSeekIndex(const AVFormatContext* format) {
+    static constexpr const char* kRawFormats[] = { "mp3", "aac", "ac3", "eac3" };
+    for (const char* name : kRawFormats) {
+        if (std::strcmp(format->iformat->name, name) == 0) return true;
+    }
+    return false;
+}
+
+/// Padding the demuxer marked for trimming off the end of @p packet, in samples.
+int64_t endPadding(const AVPacket* packet) {
+    std::size_t size = 0;
+    const uint8_t* skip = av_packet_get_side_data(packet, AV_PKT_DATA_SKIP_SAMPLES, &size);
+    if (!skip || size < 8) return 0;
+    return static_cast<int64_t>(skip[4] | skip[5] << 8 | skip[6] << 16 | static_cast<uint32_t>(skip[7]) << 24);
+}
+
+} // namespace
+
+LibavFileDecoder::LibavFileDecoder() = default;
+
+LibavFileDecoder::~LibavFileDecoder() {
+    close();
+}
+
+std::uint32_t LibavFileDecoder::libraryVersion() {
+    return avcodec_version();
+}
+
+bool LibavFileDecoder::open(const QString& path) {
+    close();
+    m_path = path;
+
+    const QByteArray file = path.toUtf8();
+    int err = avformat_open_input(&m_format, file.constData(), nullptr, nullptr);
+    if (err < 0) { fail("open", err); return false; }
+    if ((err = avformat_find_stream_info(m_format, nullptr)) < 0) { fail("probe", err); return false; }
+
+    const AVCodec* codec = nullptr;
+    m_stream = av_find_best_stream(m_format, AVMEDIA_TYPE_AUDIO, -1, -1, &codec, 0);
+    if (m_stream < 0) { fail("no audio stream", m_stream); return false; }
+
+    // Only the audio stream matters; let the demuxer skip cover art and the like
+    for (unsigned i = 0; i < m_format->nb_streams; ++i) {
+        if (static_cast<int>(i) != m_stream) m_format->streams[i]->discard = AVDISCARD_ALL;
+    }
+
+    const AVStream* stream = m_format->streams[m_stream];
+    m_codec = avcodec_alloc_context3(codec);
+    if (!m_codec) { fail("codec context", AVERROR(ENOMEM)); return false; }
+    if ((err = avcodec_parameters_to_context(m_codec, stream->codecpar)) < 0) { fail("codec parameters", err); return false; }
+    if ((err = avcodec_open2(m_codec, codec, nullptr)) < 0) { fail("codec open", err); return false; }
+
+    m_packet = av_packet_alloc();
+    m_frame = av_frame_alloc();
+    if (!m_packet || !m_frame) { fail("frame alloc", AVERROR(ENOMEM)); return false; }
+
+    m_sampleRate = m_codec->sample_rate;
+    if (stream->duration != AV_NOPTS_VALUE) {
+        m_durationMs = av_rescale_q(stream->duration, stream->time_base, AVRational{ 1, 1000 });
+    } else if (m_format->duration != AV_NOPTS_VALUE) {
+        m_durationMs = m_format->duration / (AV_TIME_BASE / 1000);
+    }
+    return true;
+}
+
+void LibavFileDecoder::close() {
+    swr_free(&m_swr);
+    av_frame_free(&m_frame);
+    av_packet_free(&m_packet);
+    avcodec_free_context(&m_codec);
+    avformat_close_input(&m_format);
+    m_stream = -1;
+    m_pendingFrames = 0;
+    m_pendingOffset = 0;
+    m_seekTarget = -1;
+    m_nextFrame = 0;
+    m_countFrames = false;
+    m_keepEncoderDelay = false;
+    m_swrFormat = -1;
+    m_swrChannels = 0;
+    m_swrRate = 0;
+    m_drained = false;
+    m_flushSent = false;
+    m_sampleRate = 0;
+    m_durationMs = -1;
+    m_error.clear();
+}
+
+std::size_t LibavFileDecoder::decode(float* dst, std::size_t frames) {
+    std::size_t done = 0;
+    while (done < frames) {
+        if (m_pendingOffset >= m_pendingFrames) {
+            if (!m_codec || m_drained || hasError() || !decodeNextFrame()) break;
+            continue;
+        }
+        const std::size_t n = std::min(frames - done, m_pendingFrames - m_pendingOffset);
+        std::memcpy(dst + 2 * done, m_pending.data() + 2 * m_pendingOffset, n * 2 * sizeof(float));
+        m_pendingOffset += n;
+        done += n;
+    }
+    return done;
+}
+
+bool LibavFileDecoder::seek(qint64 frame) {
+    if (!m_format || !m_codec || m_sampleRate <= 0) return false;
+    frame = std::max<qint64>(frame, 0);
+
+    // The first entry is the first packet, so targets within the preroll of the start count from there too
+    const SeekPoint* point = nullptr;
+    if (m_seekIndex && m_seekIndex->sampleRate() == m_sampleRate && needsSeekIndex(m_format)
+        && !m_seekIndex->points().empty()) {
+        point = m_seekIndex->pointAtOrBefore(frame - kSeekPrerollFrames);
+        if (!point) point = &m_seekIndex->points().front();
+    }
+
+    int err = 0;
+    if (point) {
+        err = av_seek_frame(m_format, m_stream, point->bytePos, AVSEEK_FLAG_BYTE);
+    } else {
+        const AVStream* stream = m_format->streams[m_stream];
+        const int64_t start = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+        const int64_t ts = start + av_rescale_q(frame, AVRational{ 1, m_sampleRate }, stream->time_base);
+        err = av_seek_frame(m_format, m_stream, ts, AVSEEK_FLAG_BACKWARD);
+    }
+    if (err < 0) { fail("seek", err); return false; }
+    avcodec_flush_buffers(m_codec);
+    swr_free(&m_swr); // anything it still holds is from before the seek
+
+    m_pendingFrames = 0;
+    m_pendingOffset = 0;
+    m_drained = false;
+    m_flushSent = false;
+    m_seekTarget = frame;
+    m_countFrames = point != nullptr;
+    m_keepEncoderDelay = point != nullptr;
+    m_nextFrame = point ? point->frame : frame;
+    return true;
+}
+
+SeekScanResult LibavFileDecoder::scanSeekIndex(const QString& path, const std::function<bool()>& keepGoing) {
+    SeekScanResult result;
+    AVFormatContext* format = nullptr;
+    const QByteArray file = path.toUtf8();
+    auto failWith = [&result, &format](const char* what, int err) {
+        char reason[AV_ERROR_MAX_STRING_SIZE] = {};
+        av_strerror(err, reason, sizeof(reason));
+        result.error = QString("%1: %2").arg(what, reason);
+        avformat_close_input(&format);
+        return result;
+    };
+
+    int err = avformat_open_input(&format, file.constData(), nullptr, nullptr);
+    if (err < 0) return failWith("open", err);
+    if ((err = avformat_find_stream_info(format, nullptr)) < 0) return failWith("probe", err);
+    const int streamIndex = av_find_best_stream(format, AVMEDIA_TYPE_AUDIO, -1, -1, nullptr, 0);
+    if (streamIndex < 0) return failWith("no audio stream", streamIndex);
+    if (!needsSeekIndex(format)) {
+        result.needed = false;
+        avformat_close_input(&format);
+        return result;
+    }
+    for (unsigned i = 0; i < format->nb_streams; ++i) {
+        if (static_cast<int>(i) != streamIndex) format->streams[i]->discard = AVDISCARD_ALL;
+    }
+
+    const AVStream* stream = format->streams[streamIndex];
+    const int rate = stream->codecpar->sample_rate;
+    if (rate <= 0) return failWith("no sample rate", AVERROR_INVALIDDATA);
+    const AVRational frameBase{ 1, rate };
+    const int64_t start = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+    const auto interval = static_cast<int64_t>(SeekIndex::kIntervalSeconds * rate);
+
+    // Read sequentially from the top, the demuxer's timestamps are exact, unlike after a seek
+    std::vector<SeekPoint> points;
+    AVPacket* packet = av_packet_alloc();
+    if (!packet) return failWith("packet alloc", AVERROR(ENOMEM));
+    int64_t position = 0;
+    int64_t padding = 0;
+    int64_t nextPoint = 0;
+    std::uint64_t packets = 0;
+    while (av_read_frame(format, packet) >= 0) {
+        if (packet->stream_index == streamIndex) {
+            if (packet->pts != AV_NOPTS_VALUE) position = av_rescale_q(packet->pts - start, stream->time_base, frameBase);
+            // The first packet is always an entry, even when encoder delay puts it before frame 0
+            if ((points.empty() || position >= nextPoint) && packet->pos >= 0) {
+                points.push_back({ position, packet->pos });
+                nextPoint = position + interval;
+            }
+            if (packet->duration > 0) position += av_rescale_q(packet->duration, stream->time_base, frameBase);
+            padding += endPadding(packet);
+        }
+        av_packet_unref(packet);
+        if (keepGoing && (++packets & 255) == 0 && !keepGoing()) {
+            av_packet_free(&packet);
+            avformat_close_input(&format);
+            return result; // cancelled: no index and no error
+        }
+    }
+    av_packet_free(&packet);
+    avformat_close_input(&format);
+
+    result.index = std::make_shared<SeekIndex>(rate, position - padding, std::move(points));
+    return result;
+}
+
+bool LibavFileDecoder::decodeNextFrame() {
+    const AVStream* stream = m_format->streams[m_stream];
+    const int64_t start = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+
+    for (;;) {
+        int err = avcodec_receive_frame(m_codec, m_frame);
+        if (err == 0) {
+            std::size_t carried = 0;
+            if (!resamplerMatches(m_frame)) {
+                // Format or rate change mid-stream: what the old resampler still holds comes first
+                const int tail = m_swr ? drainResampler() : 0;
+                if (tail < 0 || !configureResampler(m_frame)) { av_frame_unref(m_frame); return false; }
+                carried = static_cast<std::size_t>(tail);
+            }
+
+            const int capacity = swr_get_out_samples(m_swr, m_frame->nb_samples);
+            const std::size_t needed = (carried + static_cast<std::size_t>(std::max(capacity, 0))) * 2;
+            if (m_pending.size() < needed) m_pending.resize(needed);
+            uint8_t* out[1] = { reinterpret_cast<uint8_t*>(m_pending.data() + carried * 2) };
+            const int converted = swr_convert(m_swr, out, capacity,
+                                              const_cast<const uint8_t**>(m_frame->extended_data), m_frame->nb_samples);
+
+            const int64_t pts = m_frame->best_effort_timestamp;
+            const qint64 position = pts != AV_NOPTS_VALUE && !m_countFrames
+                ? av_rescale_q(pts - start, stream->time_base, AVRational{ 1, m_sampleRate })
+                : m_nextFrame;
+            av_frame_unref(m_frame);
+            if (converted < 0) { fail("convert", converted); return false; }
+
+            if (takePending(position - static_cast<qint64>(carried), carried + static_cast<std::size_t>(converted))) {
+                return true;
+            }
+            continue;
+        }
+        if (err == AVERROR_EOF) {
+            // The resampler keeps back its filter history; that is the last of the track
+            const int tail = m_swr ? drainResampler() : 0;
+            if (tail < 0) return false;
+            if (tail > 0) {
+                if (takePending(m_nextFrame, static_cast<std::size_t>(tail))) return true;
+                continue;
+            }
+            m_drained = true;
+            return false;
+        }
+        if (err != AVERROR(EAGAIN)) { fail("decode", err); return false; }
+        if (m_flushSent) { m_drained = true; return false; }
+
+        err = av_read_frame(m_format, m_packet);
+        if (err < 0) {
+            // End of file (or an unreadable tail): drain what the codec still holds
+            avcodec_send_packet(m_codec, nullptr);
+            m_flushSent = true;
+            continue;
+        }
+        if (m_packet->stream_index == m_stream) {
+            if (m_keepEncoderDelay) {
+                // After a byte seek the demuxer takes the next packet for the first and marks the encoder
+                // delay for trimming again; the index positions already count it, so it must decode
+                m_keepEncoderDelay = false;
+                std::size_t size = 0;
+                uint8_t* skip = av_packet_get_side_data(m_packet, AV_PKT_DATA_SKIP_SAMPLES, &size);
+                if (skip && size >= 4) std::memset(skip, 0, 4);
+            }
+            err = avcodec_send_packet(m_codec, m_packet);
+            if (err < 0 && err != AVERROR(EAGAIN) && err != AVERROR_INVALIDDATA) {
+                av_packet_unref(m_packet);
+                fail("send packet", err);
+                return false;
+            }
+        }
+        av_packet_unref(m_packet);
+    }
+}
+
+bool LibavFileDecoder::takePending(qint64 position, std::size_t frames) {
+    if (m_countFrames && m_seekIndex) {
+        // After a byte seek the demuxer loses track of the end padding as well; the index knows where the track ends
+        frames = std::min<std::size_t>(frames, static_cast<std::size_t>(std::max<qint64>(m_seekIndex->frames() - position, 0)));
+    }
+    m_pendingFrames = frames;
+    m_pendingOffset = 0;
+    m_nextFrame = position + static_cast<qint64>(frames);
+    if (m_seekTarget >= 0) {
+        // Seeks land on the packet before the target; trim to the exact frame
+        if (m_nextFrame <= m_seekTarget) { m_pendingFrames = 0; return false; }
+        m_pendingOffset = static_cast<std::size_t>(std::max<qint64>(m_seekTarget - position, 0));
+        m_seekTarget = -1;
+    }
+    return m_pendingOffset < m_pendingFrames;
+}
+
+bool LibavFileDecoder::resamplerMatches(const AVFrame* frame) const {
+    return m_swr && frame->format == m_swrFormat && frame->ch_layout.nb_channels == m_swrChannels
+        && frame->sample_rate == m_swrRate;
+}
+
+bool LibavFileDecoder::configureResampler(const AVFrame* frame) {
+    swr_free(&m_swr);
+    if (m_sampleRate <= 0) m_sampleRate = frame->sample_rate;
+
+    AVChannelLayout in{};
+    if (frame->ch_layout.order == AV_CHANNEL_ORDER_UNSPEC) {
+        av_channel_layout_default(&in, frame->ch_layout.nb_channels);
+    } else {
+        av_channel_layout_copy(&in, &frame->ch_layout);
+    }
+    // Output stays at the rate reported since open(), whatever the stream switches to
+    const AVChannelLayout stereo = AV_CHANNEL_LAYOUT_STEREO;
+    int err = swr_alloc_set_opts2(&m_swr, &stereo, AV_SAMPLE_FMT_FLT, m_sampleRate,
+                                  &in, static_cast<AVSampleFormat>(frame->format), frame->sample_rate, 0, nullptr);
+    av_channel_layout_uninit(&in);
+    if (err >= 0) err = swr_init(m_swr);
+    if (err < 0) { fail("resampler", err); return false; }
+
+    m_swrFormat = frame->format;
+    m_swrChannels = frame->ch_layout.nb_channels;
+    m_swrRate = frame->sample_rate;
+    return true;
+}
+
+int LibavFileDecoder::drainResampler() {
+    const int capacity = swr_get_out_samples(m_swr, 0);
+    if (capacity <= 0) return capacity;
+    if (m_pending.size() < static_cast<std::size_t>(capacity) * 2) m_pending.resize(static_cast<std::size_t>(capacity) * 2);
+    uint8_t* out[1] = { reinterpret_cast<uint8_t*>(m_pending.data()) };
+    const int flushed = swr_convert(m_swr, out, capacity, nullptr, 0);
+    if (flushed < 0) fail("convert", flushed);
+    return flushed;
+}
+
+void LibavFileDecoder::fail(const char* what, int err) {
+    char reason[AV_ERROR_MAX_STRING_SIZE] = {};
+    av_strerror(err, reason, sizeof(reason));
+    m_error = QString("%1: %2").arg(what, reason);
+    std::cerr << "[LibavFileDecoder] " << m_path.toStdString() << ": " << m_error.toStdString() << std::endl;
+}
+
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "FileDecoder.h"
+
+struct AVCodecContext;
+struct AVFormatContext;
+struct AVFrame;
+struct AVPacket;
+struct SwrContext;
+
+namespace NeonWave::Core::Audio {
+
+/**
+ * @brief FileDecoder on libavformat/libavcodec.
+ *
+ * libswresample turns whatever sample format and channel layout the codec
+ * produces into interleaved float stereo at the stream's native rate (the
+ * rate at open()). It only resamples if a stream changes rate mid-file.
+ *
+ * Seeks go through the container's index and are trimmed to the exact frame
+ * by timestamp. Raw elementary streams (mp3, ADTS AAC, AC-3) have no index and
+ * only estimated timestamps after a seek; given a SeekIndex, those byte-seek
+ * to a known packet instead and count frames from there.
+ */
+class LibavFileDecoder : public FileDecoder {
+public:
+    LibavFileDecoder();
+    ~LibavFileDecoder() override;
+
+    bool open(const QString& path) override;
+    void close() override;
+    std::size_t decode(float* dst, std::size_t frames) override;
+    bool seek(qint64 frame) override;
+    int sampleRate() const override { return m_sampleRate; }
+    qint64 durationMs() const override { return m_durationMs; }
+    bool hasError() const override { return !m_error.isEmpty(); }
+    QString errorString() const override { return m_error; }
+    void setSeekIndex(std::shared_ptr<const SeekIndex> index) override { m_seekIndex = std::move(index); }
+
+    /// libavcodec's runtime version (major << 16 | minor << 8 | micro).
+    static std::uint32_t libraryVersion();
+
+    /// Implementation of scanSeekIndex(): one demux pass, no decoding.
+    static SeekScanResult scanSeekIndex(const QString& path, const std::function<bool()>& keepGoing);
+
+private:
+    /// Decode the next frame into m_pending; false at end of stream.
+    bool decodeNextFrame();
+    bool resamplerMatches(const AVFrame* frame) const;
+    bool configureResampler(const AVFrame* frame);
+    /// Flush what m_swr still holds into the start of m_pending; frames written, or < 0 on error.
+    int drainResampler();
+    /// Hand out the first @p frames of m_pending, starting at stream frame @p position; false if a seek drops them all.
+    bool takePending(qint64 position, std::size_t frames);
+    void fail(const char* what, int err);
+
+    AVFormatContext* m_format = nullptr;
+    AVCodecContext* m_codec = nullptr;
+    SwrContext* m_swr = nullptr;
+    AVPacket* m_packet = nullptr;
+    AVFrame* m_frame = nullptr;
+    int m_stream = -1;
+
+    std::vector<float> m_pending;    // last converted codec frame, interleaved stereo
+    std::size_t m_pendingFrames = 0;
+    std::size_t m_pendingOffset = 0; // frames of m_pending already handed out
+    qint64 m_seekTarget = -1;        // drop output before this frame after a seek
+    qint64 m_nextFrame = 0;          // stream position of the next decoded frame
+    bool m_countFrames = false;      // after an indexed seek: position by counting, not by timestamp
+    bool m_keepEncoderDelay = false; // after an indexed seek: the next packet's start trimming is already counted
+    std::shared_ptr<const SeekIndex> m_seekIndex;
+    int m_swrFormat = -1;            // input format m_swr was configured for
+    int m_swrChannels = 0;
+    int m_swrRate = 0;
+    bool m_drained = false;
+    bool m_flushSent = false;
+    int m_sampleRate = 0;
+    qint64 m_durationMs = -1;
+    QString m_error;
+};
+
+}
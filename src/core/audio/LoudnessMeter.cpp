@@ -0,0 +1,127 @@
+#include "LoudnessMeter.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace NeonWave::Core::Audio {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr int kSubBlocksPerBlock = 4;       // 400 ms gating block, 100 ms step
+constexpr double kRelativeGateLu = -10.0;
+constexpr int kTruePeakMinRate = 176400;
+
+double energyToLufs(double energy) {
+    return energy > 0.0 ? -0.691 + 10.0 * std::log10(energy) : -std::numeric_limits<double>::infinity();
+}
+
+} // namespace
+
+LoudnessMeter::LoudnessMeter()
+    : m_oversampler(detectIsa())
+{
+}
+
+void LoudnessMeter::reset() {
+    m_sampleRate = 0;
+    m_subBlockFill = 0;
+    m_subBlockSum = 0.0;
+    m_subBlocks.clear();
+    m_peak = 0.0f;
+}
+
+void LoudnessMeter::configure(int sampleRate) {
+    reset();
+    m_sampleRate = sampleRate;
+    m_subBlockFrames = static_cast<std::size_t>(sampleRate / 10);
+
+    // BS.1770 K-weighting, re-derived for this rate (the spec only tabulates 48 kHz)
+    {
+        const double f0 = 1681.974450955533, gainDb = 3.999843853973347, q = 0.7071752369554196;
+        const double k = std::tan(kPi * f0 / sampleRate);
+        const double vh = std::pow(10.0, gainDb / 20.0);
+        const double vb = std::pow(vh, 0.4996667741545416);
+        const double a0 = 1.0 + k / q + k * k;
+        m_shelf = {};
+        m_shelf.b0 = (vh + vb * k / q + k * k) / a0;
+        m_shelf.b1 = 2.0 * (k * k - vh) / a0;
+        m_shelf.b2 = (vh - vb * k / q + k * k) / a0;
+        m_shelf.a1 = 2.0 * (k * k - 1.0) / a0;
+        m_shelf.a2 = (1.0 - k / q + k * k) / a0;
+    }
+    {
+        const double f0 = 38.13547087602444, q = 0.5003270373238773;
+        const double k = std::tan(kPi * f0 / sampleRate);
+        const double a0 = 1.0 + k / q + k * k;
+        m_highPass = {};
+        m_highPass.b0 = 1.0;
+        m_highPass.b1 = -2.0;
+        m_highPass.b2 = 1.0;
+        m_highPass.a1 = 2.0 * (k * k - 1.0) / a0;
+        m_highPass.a2 = (1.0 - k / q + k * k) / a0;
+    }
+
+    int factor = 1;
+    while (sampleRate * factor < kTruePeakMinRate) factor *= 2;
+    m_oversampler.configure(sampleRate, sampleRate * factor);
+}
+
+void LoudnessMeter::push(const float* stereo, std::size_t frames, int sampleRate) {
+    if (frames == 0 || sampleRate <= 0) return;
+    if (sampleRate != m_sampleRate) configure(sampleRate);
+
+    for (std::size_t i = 0; i < frames; ++i) {
+        for (int c = 0; c < 2; ++c) {
+            const double y = m_highPass.process(c, m_shelf.process(c, stereo[2 * i + c]));
+            m_subBlockSum += y * y; // L and R both weigh 1.0
+        }
+        if (++m_subBlockFill == m_subBlockFrames) {
+            m_subBlocks.push_back(static_cast<float>(m_subBlockSum / m_subBlockFrames));
+            m_subBlockFill = 0;
+            m_subBlockSum = 0.0;
+        }
+    }
+
+    m_oversampled.resize(m_oversampler.maxOutputFrames(frames) * 2);
+    const std::size_t produced = m_oversampler.process(stereo, frames, m_oversampled.data());
+    float peak = m_peak;
+    for (std::size_t i = 0; i < produced * 2; ++i) peak = std::max(peak, std::abs(m_oversampled[i]));
+    m_peak = peak;
+}
+
+double LoudnessMeter::integratedLufs() const {
+    if (m_subBlocks.size() < static_cast<std::size_t>(kSubBlocksPerBlock)) return kSilenceLufs;
+
+    std::vector<double> blocks;
+    blocks.reserve(m_subBlocks.size());
+    for (std::size_t i = 0; i + kSubBlocksPerBlock <= m_subBlocks.size(); ++i) {
+        double sum = 0.0;
+        for (int j = 0; j < kSubBlocksPerBlock; ++j) sum += m_subBlocks[i + j];
+        blocks.push_back(sum / kSubBlocksPerBlock);
+    }
+
+    auto gatedMean = [&blocks](double thresholdLufs) {
+        double sum = 0.0;
+        std::size_t count = 0;
+        for (const double e : blocks) {
+            if (energyToLufs(e) > thresholdLufs) {
+                sum += e;
+                ++count;
+            }
+        }
+        return count ? sum / count : 0.0;
+    };
+
+    const double absoluteGated = gatedMean(kSilenceLufs);
+    if (absoluteGated <= 0.0) return kSilenceLufs;
+    const double relativeGate = energyToLufs(absoluteGated) + kRelativeGateLu;
+    const double integrated = gatedMean(std::max(relativeGate, kSilenceLufs));
+    return integrated > 0.0 ? energyToLufs(integrated) : kSilenceLufs;
+}
+
+double LoudnessMeter::truePeakDbtp() const {
+    return m_peak > 0.0f ? 20.0 * std::log10(m_peak) : -std::numeric_limits<double>::infinity();
+}
+
+}
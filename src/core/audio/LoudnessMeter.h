@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "PolyphaseResampler.h"
+
+namespace NeonWave::Core::Audio {
+
+/**
+ * @brief ITU-R BS.1770-4 / EBU R128 integrated loudness and true peak of one stream.
+ *
+ * Stereo input is K-weighted (shelf + high-pass biquads designed for the
+ * actual rate), squared into 100 ms sub-blocks and combined into 400 ms
+ * gating blocks with 75% overlap; integratedLufs() applies the absolute
+ * (-70 LUFS) and relative (-10 LU) gates. True peak is the sample peak of
+ * the signal oversampled to at least 176.4 kHz.
+ *
+ * Feed a whole track, then read the results; push() never allocates beyond
+ * one float per 100 ms of audio.
+ */
+class LoudnessMeter {
+public:
+    static constexpr double kSilenceLufs = -70.0;
+
+    LoudnessMeter();
+
+    void reset();
+    /// Interleaved float stereo; a rate change restarts the measurement.
+    void push(const float* stereo, std::size_t frames, int sampleRate);
+
+    /// Gated integrated loudness; kSilenceLufs when nothing passed the gate.
+    double integratedLufs() const;
+    /// Inter-sample peak in dBTP; -inf for digital silence.
+    double truePeakDbtp() const;
+
+private:
+    struct Biquad {
+        double b0 = 1, b1 = 0, b2 = 0, a1 = 0, a2 = 0;
+        double z1[2] = { 0, 0 };
+        double z2[2] = { 0, 0 };
+        double process(int channel, double x) {
+            const double y = b0 * x + z1[channel];
+            z1[channel] = b1 * x - a1 * y + z2[channel];
+            z2[channel] = b2 * x - a2 * y;
+            return y;
+        }
+    };
+
+    void configure(int sampleRate);
+
+    int m_sampleRate = 0;
+    Biquad m_shelf;
+    Biquad m_highPass;
+    std::size_t m_subBlockFrames = 0;     // 100 ms
+    std::size_t m_subBlockFill = 0;
+    double m_subBlockSum = 0.0;
+    std::vector<float> m_subBlocks;       // mean square per 100 ms, summed over channels
+
+    PolyphaseResampler m_oversampler;
+    std::vector<float> m_oversampled;
+    float m_peak = 0.0f;
+};
+
+}
@@ -0,0 +1,236 @@
+#include "LoudnessScanner.h"
+#include "FileDecoder.h"
+#include "LoudnessMeter.h"
+#include "OfflineAudioEngine.h"
+
+#include <QDateTime>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMetaObject>
+#include <QSaveFile>
+#include <QThread>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+namespace NeonWave::Core::Audio {
+
+namespace {
+
+constexpr double kFloorDb = -200.0; // JSON has no -inf; digital silence is stored as this
+
+double finiteDb(double db) {
+    return std::isfinite(db) ? std::max(db, kFloorDb) : kFloorDb;
+}
+
+} // namespace
+
+double TrackLoudness::gainDb(double targetLufs, double maxGainDb, std::optional<double> peakCeilingDbtp) const {
+    if (integratedLufs <= LoudnessMeter::kSilenceLufs) return 0.0; // silence: leave it alone
+    double gain = std::clamp(targetLufs - integratedLufs, -maxGainDb, maxGainDb);
+    if (peakCeilingDbtp) gain = std::min(gain, *peakCeilingDbtp - truePeakDbtp);
+    return gain;
+}
+
+// ---- LoudnessStore ----------------------------------------------------------
+
+std::optional<TrackLoudness> LoudnessStore::lookup(const QString& path) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto it = m_entries.constFind(path);
+    if (it == m_entries.constEnd()) return std::nullopt;
+    return it->loudness;
+}
+
+std::optional<TrackLoudness> LoudnessStore::lookupCurrent(const QString& path, qint64 size, qint64 mtime) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto it = m_entries.constFind(path);
+    if (it == m_entries.constEnd() || it->size != size || it->mtime != mtime) return std::nullopt;
+    return it->loudness;
+}
+
+void LoudnessStore::insert(const QString& path, qint64 size, qint64 mtime, const TrackLoudness& loudness) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.insert(path, Entry{ size, mtime, loudness });
+    m_dirty = true;
+}
+
+std::size_t LoudnessStore::size() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return static_cast<std::size_t>(m_entries.size());
+}
+
+bool LoudnessStore::load(const std::filesystem::path& file) {
+    QFile in(QString::fromStdString(file.string()));
+    if (!in.open(QIODevice::ReadOnly)) return false;
+    const QJsonObject root = QJsonDocument::fromJson(in.readAll()).object();
+    if (root.value("version").toInt() != kVersion
+        || static_cast<std::uint32_t>(root.value("decoder").toDouble()) != fileDecoderVersion()) {
+        std::cout << "[LoudnessScanner] Stored loudness is from another meter or decoder version; rescanning" << std::endl;
+        return false;
+    }
+
+    QHash<QString, Entry> entries;
+    const QJsonObject tracks = root.value("tracks").toObject();
+    entries.reserve(tracks.size());
+    for (auto it = tracks.begin(); it != tracks.end(); ++it) {
+        const QJsonObject t = it.value().toObject();
+        TrackLoudness loudness;
+        loudness.integratedLufs = t.value("lufs").toDouble(LoudnessMeter::kSilenceLufs);
+        loudness.truePeakDbtp = t.value("peak").toDouble(kFloorDb);
+        loudness.durationSeconds = t.value("seconds").toDouble();
+        entries.insert(it.key(), Entry{ static_cast<qint64>(t.value("size").toDouble()),
+                                        static_cast<qint64>(t.value("mtime").toDouble()), loudness });
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries = std::move(entries);
+    m_dirty = false;
+    return true;
+}
+
+bool LoudnessStore::save(const std::filesystem::path& file) const {
+    QJsonObject tracks;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_dirty) return true;
+        for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+            QJsonObject t;
+            t.insert("size", static_cast<double>(it->size));
+            t.insert("mtime", static_cast<double>(it->mtime));
+            t.insert("lufs", finiteDb(it->loudness.integratedLufs));
+            t.insert("peak", finiteDb(it->loudness.truePeakDbtp));
+            t.insert("seconds", it->loudness.durationSeconds);
+            tracks.insert(it.key(), t);
+        }
+    }
+    QJsonObject root;
+    root.insert("version", kVersion);
+    root.insert("decoder", static_cast<double>(fileDecoderVersion()));
+    root.insert("tracks", tracks);
+
+    QSaveFile out(QString::fromStdString(file.string()));
+    if (!out.open(QIODevice::WriteOnly) || out.write(QJsonDocument(root).toJson(QJsonDocument::Compact)) < 0
+        || !out.commit()) {
+        std::cerr << "[LoudnessScanner] Cannot write " << file.string() << ": " << out.errorString().toStdString() << std::endl;
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_dirty = false;
+    return true;
+}
+
+// ---- LoudnessScanner --------------------------------------------------------
+
+LoudnessScanner::LoudnessScanner(std::filesystem::path storeFile, QObject* parent)
+    : QObject(parent)
+    , m_storeFile(std::move(storeFile))
+    , m_store(std::make_shared<LoudnessStore>())
+{
+    if (m_store->load(m_storeFile)) {
+        std::cout << "[LoudnessScanner] Loaded loudness of " << m_store->size() << " tracks" << std::endl;
+    }
+    // Decoding is CPU-bound, so one job per core; lower priority keeps playback and rendering ahead
+    m_pool.setMaxThreadCount(std::max(1, QThread::idealThreadCount()));
+    m_pool.setThreadPriority(QThread::LowPriority);
+    m_stats.threads = m_pool.maxThreadCount();
+}
+
+LoudnessScanner::~LoudnessScanner() {
+    cancelPending();
+    m_pool.waitForDone();
+    m_store->save(m_storeFile);
+}
+
+void LoudnessScanner::scan(const QStringList& files) {
+    for (const QString& path : files) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_stats.requests;
+            if (m_inFlight.contains(path)) continue;
+        }
+
+        const QFileInfo info(path);
+        if (m_store->lookupCurrent(path, info.size(), info.lastModified().toMSecsSinceEpoch())) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_stats.cached;
+            continue;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_inFlight.isEmpty()) m_batchTimer.start();
+            m_inFlight.insert(path);
+        }
+        const std::uint64_t generation = m_generation.load(std::memory_order_relaxed);
+        m_pool.start([this, path, generation]() { measure(path, generation); });
+    }
+}
+
+void LoudnessScanner::cancelPending() {
+    // Queued jobs still run, but return at once; running ones stop at their next block
+    m_generation.fetch_add(1, std::memory_order_relaxed);
+}
+
+LoudnessScanner::Stats LoudnessScanner::stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats s = m_stats;
+    s.pending = static_cast<std::size_t>(m_inFlight.size());
+    if (!m_inFlight.isEmpty()) s.wallSeconds += m_batchTimer.nsecsElapsed() * 1e-9;
+    return s;
+}
+
+void LoudnessScanner::measure(const QString& path, std::uint64_t generation) {
+    auto current = [this, generation]() { return m_generation.load(std::memory_order_relaxed) == generation; };
+    const QFileInfo info(path);
+    const qint64 size = info.size();
+    const qint64 mtime = info.lastModified().toMSecsSinceEpoch();
+
+    LoudnessMeter meter;
+    DecodeStats decoded;
+    decoded.cancelled = true;
+    if (current()) {
+        decoded = OfflineAudioEngine::decodeFile(path,
+            [&meter, &current](const float* stereo, std::size_t frames, std::uint32_t sampleRate, std::uint64_t) {
+                meter.push(stereo, frames, static_cast<int>(sampleRate));
+                return current();
+            });
+    }
+
+    TrackLoudness loudness;
+    if (decoded.ok) {
+        loudness.integratedLufs = meter.integratedLufs();
+        loudness.truePeakDbtp = finiteDb(meter.truePeakDbtp());
+        loudness.durationSeconds = decoded.audioSeconds;
+        m_store->insert(path, size, mtime, loudness);
+    }
+
+    bool drained = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (decoded.ok) {
+            ++m_stats.scanned;
+            m_stats.audioSeconds += decoded.audioSeconds;
+        } else if (!decoded.cancelled) {
+            ++m_stats.failures;
+        }
+        m_stats.busySeconds += decoded.wallSeconds;
+        m_inFlight.remove(path);
+        if (m_inFlight.isEmpty()) {
+            drained = true;
+            m_stats.wallSeconds += m_batchTimer.nsecsElapsed() * 1e-9;
+        }
+    }
+
+    QMetaObject::invokeMethod(this, [this, path, decoded, loudness, drained]() {
+        if (decoded.ok) emit trackScanned(path, loudness.integratedLufs, loudness.truePeakDbtp);
+        else if (!decoded.cancelled) emit trackFailed(path, decoded.error);
+        if (drained) {
+            m_store->save(m_storeFile);
+            emit idle();
+        }
+    }, Qt::QueuedConnection);
+}
+
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QStringList>
+#include <QThreadPool>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+namespace NeonWave::Core::Audio {
+
+/// EBU R128 measurement of one whole track.
+struct TrackLoudness {
+    double integratedLufs = -70.0;
+    double truePeakDbtp = -70.0;
+    double durationSeconds = 0.0;
+
+    /// Gain in dB that brings the track to @p targetLufs, clamped to +-@p maxGainDb;
+    /// with @p peakCeilingDbtp set, also capped so the true peak stays below it.
+    double gainDb(double targetLufs, double maxGainDb = 18.0,
+                  std::optional<double> peakCeilingDbtp = std::nullopt) const;
+};
+
+/**
+ * @brief Thread-safe table of measured tracks, persisted as JSON.
+ *
+ * Entries are keyed by path and remember the file's size and mtime, so a
+ * replaced file is measured again. The file records the meter and decoder
+ * versions; a mismatch discards it wholesale.
+ */
+class LoudnessStore {
+public:
+    static constexpr int kVersion = 1; ///< Bump when LoudnessMeter's results change
+
+    std::optional<TrackLoudness> lookup(const QString& path) const;
+    /// Like lookup(), but only if @p size and @p mtime still match.
+    std::optional<TrackLoudness> lookupCurrent(const QString& path, qint64 size, qint64 mtime) const;
+    void insert(const QString& path, qint64 size, qint64 mtime, const TrackLoudness& loudness);
+    std::size_t size() const;
+
+    bool load(const std::filesystem::path& file);
+    bool save(const std::filesystem::path& file) const;
+
+private:
+    struct Entry { qint64 size; qint64 mtime; TrackLoudness loudness; };
+
+    mutable std::mutex m_mutex;
+    QHash<QString, Entry> m_entries;
+    mutable bool m_dirty = false;
+};
+
+/**
+ * @brief Measures loudness of added tracks on a pool of background threads.
+ *
+ * scan() queues one job per track on a private QThreadPool sized to the
+ * machine's cores; each job decodes its file flat out through
+ * OfflineAudioEngine::decodeFile() and runs a LoudnessMeter over it. Tracks
+ * already in the store with an unchanged size and mtime are skipped. The
+ * store is written back whenever the queue drains and on destruction.
+ */
+class LoudnessScanner : public QObject {
+    Q_OBJECT
+public:
+    struct Stats {
+        std::uint64_t requests = 0;
+        std::uint64_t cached = 0;   ///< Already in the store, not decoded
+        std::uint64_t scanned = 0;
+        std::uint64_t failures = 0;
+        std::size_t pending = 0;
+        int threads = 0;
+        double audioSeconds = 0.0;  ///< Audio measured this session
+        double busySeconds = 0.0;   ///< Sum of per-job wall time, across all threads
+        double wallSeconds = 0.0;   ///< Elapsed time while the queue was non-empty
+
+        /// Measured seconds of audio per elapsed second, all threads together.
+        double speed() const { return wallSeconds > 0.0 ? audioSeconds / wallSeconds : 0.0; }
+        /// Average per-thread speed.
+        double speedPerThread() const { return busySeconds > 0.0 ? audioSeconds / busySeconds : 0.0; }
+    };
+
+    /// @param storeFile JSON file to load now and save to (normally Application::getDataPath()/loudness.json)
+    explicit LoudnessScanner(std::filesystem::path storeFile, QObject* parent = nullptr);
+    ~LoudnessScanner();
+
+    /// Queue tracks; those already measured or in flight are skipped.
+    void scan(const QStringList& files);
+    /// Drop queued jobs and stop the running ones early.
+    void cancelPending();
+
+    /// Shared with the audio thread, which looks gains up when a track starts.
+    std::shared_ptr<const LoudnessStore> store() const { return m_store; }
+    Stats stats() const;
+
+signals:
+    /// Emitted on this object's thread once a track's loudness is in the store.
+    void trackScanned(const QString& path, double integratedLufs, double truePeakDbtp);
+    void trackFailed(const QString& path, const QString& error);
+    /// The queue ran dry and the store was saved.
+    void idle();
+
+private:
+    void measure(const QString& path, std::uint64_t generation);
+
+    std::filesystem::path m_storeFile;
+    std::shared_ptr<LoudnessStore> m_store;
+    QThreadPool m_pool;
+    std::atomic<std::uint64_t> m_generation{0}; // bumped by cancelPending(); older jobs bail out
+
+    mutable std::mutex m_mutex;         // guards everything below
+    QSet<QString> m_inFlight;
+    Stats m_stats;
+    QElapsedTimer m_batchTimer;         // runs while m_inFlight is non-empty
+};
+
+}
@@ -0,0 +1,108 @@
+#include "OfflineAudioEngine.h"
+#include "FileDecoder.h"
+#include <QMetaObject>
+#include <chrono>
+#include <vector>
+
+namespace NeonWave::Core::Audio {
+
+OfflineAudioEngine::OfflineAudioEngine(QObject* parent)
+    : QObject(parent)
+{
+}
+
+OfflineAudioEngine::~OfflineAudioEngine() {
+    cancel();
+    join();
+}
+
+void OfflineAudioEngine::setPlaylist(const QStringList& files) {
+    m_files = files;
+    m_index = m_files.isEmpty() ? -1 : 0;
+}
+
+void OfflineAudioEngine::next() {
+    if (m_files.isEmpty()) return;
+    m_index = (m_index + 1) % m_files.size();
+}
+
+void OfflineAudioEngine::previous() {
+    if (m_files.isEmpty()) return;
+    m_index = (m_index - 1 + m_files.size()) % m_files.size();
+}
+
+QString OfflineAudioEngine::currentFile() const {
+    return m_index >= 0 && m_index < m_files.size() ? m_files[m_index] : QString();
+}
+
+DecodeStats OfflineAudioEngine::decodeCurrent(const BlockConsumer& consumer) {
+    return decodeFile(currentFile(), consumer, 4096, &m_cancel);
+}
+
+bool OfflineAudioEngine::start(BlockConsumer consumer) {
+    if (isRunning() || m_index < 0) return false;
+    join();
+    m_cancel.store(false, std::memory_order_relaxed);
+    m_running.store(true, std::memory_order_release);
+
+    const int index = m_index;
+    m_thread = std::thread([this, index, path = currentFile(), consumer = std::move(consumer)]() {
+        const DecodeStats stats = decodeFile(path, consumer, 4096, &m_cancel);
+        m_running.store(false, std::memory_order_release);
+        QMetaObject::invokeMethod(this, [this, index, stats]() {
+            emit finished(index, stats.ok, stats.audioSeconds, stats.wallSeconds);
+        }, Qt::QueuedConnection);
+    });
+    return true;
+}
+
+void OfflineAudioEngine::cancel() {
+    m_cancel.store(true, std::memory_order_relaxed);
+}
+
+void OfflineAudioEngine::join() {
+    if (m_thread.joinable()) m_thread.join();
+}
+
+DecodeStats OfflineAudioEngine::decodeFile(const QString& path, const BlockConsumer& consumer,
+                                           std::size_t blockFrames, const std::atomic<bool>* cancel) {
+    DecodeStats stats;
+    stats.path = path;
+
+    auto decoder = createFileDecoder();
+    if (!decoder) {
+        stats.error = "no FileDecoder backend in this build (configure with NEONWAVE_WITH_LIBAV)";
+        return stats;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    if (!decoder->open(path)) {
+        stats.error = decoder->errorString();
+        return stats;
+    }
+    stats.sampleRate = decoder->sampleRate();
+
+    std::vector<float> block(blockFrames * 2);
+    for (;;) {
+        if (cancel && cancel->load(std::memory_order_relaxed)) {
+            stats.cancelled = true;
+            break;
+        }
+        const std::size_t frames = decoder->decode(block.data(), blockFrames);
+        if (frames == 0) break;
+        if (consumer && !consumer(block.data(), frames, static_cast<std::uint32_t>(stats.sampleRate), stats.frames)) {
+            stats.cancelled = true;
+            stats.frames += frames;
+            break;
+        }
+        stats.frames += frames;
+    }
+
+    stats.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    stats.audioSeconds = stats.sampleRate > 0 ? static_cast<double>(stats.frames) / stats.sampleRate : 0.0;
+    stats.ok = !decoder->hasError() && !stats.cancelled;
+    if (decoder->hasError()) stats.error = decoder->errorString();
+    return stats;
+}
+
+}
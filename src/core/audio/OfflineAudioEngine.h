@@ -0,0 +1,77 @@
+#pragma once
+
+#include <QObject>
+#include <QStringList>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+namespace NeonWave::Core::Audio {
+
+/// Outcome of decoding one file flat out.
+struct DecodeStats {
+    QString path;
+    int sampleRate = 0;
+    std::uint64_t frames = 0;
+    double audioSeconds = 0.0;
+    double wallSeconds = 0.0;
+    bool ok = false;
+    bool cancelled = false;
+    QString error;
+
+    /// Decoded seconds per wall-clock second.
+    double speed() const { return wallSeconds > 0.0 ? audioSeconds / wallSeconds : 0.0; }
+};
+
+/**
+ * @brief Playlist decoding without a sink: as fast as the CPU allows.
+ *
+ * Same playlist API as AudioEngine, but there is no output device and no
+ * wall-clock pacing; every decoded block goes to a caller-supplied consumer,
+ * in order and without drops. Meant for offline rendering, analysis and
+ * batch jobs. Requires a FileDecoder backend (libav); see hasFileDecoder().
+ */
+class OfflineAudioEngine : public QObject {
+    Q_OBJECT
+public:
+    /// Receives interleaved float stereo; return false to stop decoding.
+    using BlockConsumer = std::function<bool(const float* stereo, std::size_t frames,
+                                             std::uint32_t sampleRate, std::uint64_t streamFrame)>;
+
+    explicit OfflineAudioEngine(QObject* parent = nullptr);
+    ~OfflineAudioEngine();
+
+    void setPlaylist(const QStringList& files);
+    void next();
+    void previous();
+    int currentIndex() const { return m_index; }
+    QString currentFile() const;
+
+    /// Decode the current entry on the calling thread.
+    DecodeStats decodeCurrent(const BlockConsumer& consumer);
+
+    /// Decode the current entry on a worker thread; finished() is emitted on this object's thread.
+    bool start(BlockConsumer consumer);
+    void cancel();
+    bool isRunning() const { return m_running.load(std::memory_order_acquire); }
+
+    /// Decode any file on the calling thread, delivering @p blockFrames frames at a time.
+    static DecodeStats decodeFile(const QString& path, const BlockConsumer& consumer,
+                                  std::size_t blockFrames = 4096,
+                                  const std::atomic<bool>* cancel = nullptr);
+
+signals:
+    void finished(int index, bool ok, double audioSeconds, double wallSeconds);
+
+private:
+    void join();
+
+    QStringList m_files;
+    int m_index{ -1 };
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+    std::atomic<bool> m_cancel{false};
+};
+
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace NeonWave::Core::Audio {
+
+/**
+ * @brief Which output-stream frame is audible right now.
+ *
+ * The audio thread stamps it after every pump pass from the sink's
+ * processedUSecs(); readers on any thread extrapolate from the last stamp
+ * with their own clock. Frames are counted on the same axis as
+ * AudioBlock::streamFrame, so a consumer can hold blocks back until they
+ * are actually being heard.
+ */
+class PlaybackClock {
+public:
+    struct Sample {
+        std::uint64_t frame = 0;      ///< Audible stream frame at @c stampNs
+        std::int64_t stampNs = 0;     ///< steady_clock time of the measurement
+        std::uint32_t sampleRate = 0;
+        bool running = false;         ///< False while paused/stopped: frame does not advance
+        std::uint64_t writtenFrame = 0; ///< Stream frames handed to the sink so far
+        std::uint64_t flushedFrame = 0; ///< Frames before this were discarded unheard (seek, skip); drop them
+    };
+
+    static std::int64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /// Single writer (the audio thread).
+    void update(const Sample& s) {
+        const std::uint32_t seq = m_seq.load(std::memory_order_relaxed);
+        m_seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_frame.store(s.frame, std::memory_order_relaxed);
+        m_stampNs.store(s.stampNs, std::memory_order_relaxed);
+        m_sampleRate.store(s.sampleRate, std::memory_order_relaxed);
+        m_running.store(s.running, std::memory_order_relaxed);
+        m_writtenFrame.store(s.writtenFrame, std::memory_order_relaxed);
+        m_flushedFrame.store(s.flushedFrame, std::memory_order_relaxed);
+        m_seq.store(seq + 2, std::memory_order_release);
+    }
+
+    /// Consistent copy of the last update; never blocks the writer.
+    Sample sample() const {
+        Sample s;
+        for (;;) {
+            const std::uint32_t before = m_seq.load(std::memory_order_acquire);
+            if (before & 1u) continue;
+            s.frame = m_frame.load(std::memory_order_relaxed);
+            s.stampNs = m_stampNs.load(std::memory_order_relaxed);
+            s.sampleRate = m_sampleRate.load(std::memory_order_relaxed);
+            s.running = m_running.load(std::memory_order_relaxed);
+            s.writtenFrame = m_writtenFrame.load(std::memory_order_relaxed);
+            s.flushedFrame = m_flushedFrame.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (m_seq.load(std::memory_order_relaxed) == before) return s;
+        }
+    }
+
+    /// Audible frame at @p atNs, extrapolated from the last stamp but never past what was written.
+    std::uint64_t audibleFrame(std::int64_t atNs = nowNs()) const {
+        const Sample s = sample();
+        if (!s.running || s.sampleRate == 0 || atNs <= s.stampNs) return s.frame;
+        const auto advanced = static_cast<std::uint64_t>((atNs - s.stampNs) * static_cast<double>(s.sampleRate) * 1e-9);
+        const std::uint64_t frame = s.frame + advanced;
+        return frame < s.writtenFrame ? frame : s.writtenFrame;
+    }
+
+private:
+    std::atomic<std::uint32_t> m_seq{0};
+    std::atomic<std::uint64_t> m_frame{0};
+    std::atomic<std::int64_t> m_stampNs{0};
+    std::atomic<std::uint32_t> m_sampleRate{0};
+    std::atomic<bool> m_running{false};
+    std::atomic<std::uint64_t> m_writtenFrame{0};
+    std::atomic<std::uint64_t> m_flushedFrame{0};
+};
+
+}
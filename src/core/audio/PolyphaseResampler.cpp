@@ -0,0 +1,347 @@
+#include "PolyphaseResampler.h"
+#include "SimdIsa.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+namespace NeonWave::Core::Audio {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kRolloff = 0.92;     // passband edge as a fraction of the lower Nyquist
+constexpr double kKaiserBeta = 8.6;   // ~85 dB stopband
+constexpr std::size_t kBlockFrames = 1024; // input deinterleaved per pass, behind the history
+
+/// Both channels' dot product with one coefficient row; taps is a multiple of 8.
+using DotKernel = void (*)(const float* c, const float* l, const float* r, std::size_t taps,
+                           float* outL, float* outR);
+
+// ---- scalar ---------------------------------------------------------------
+
+void dotScalar(const float* c, const float* l, const float* r, std::size_t taps, float* outL, float* outR) {
+    float accL = 0.0f;
+    float accR = 0.0f;
+    for (std::size_t j = 0; j < taps; ++j) {
+        accL += c[j] * l[j];
+        accR += c[j] * r[j];
+    }
+    *outL = accL;
+    *outR = accR;
+}
+
+#if defined(NEONWAVE_SIMD_X86)
+
+// ---- SSE2 ------------------------------------------------------------------
+
+float hsumSse(__m128 v) {
+    __m128 shuf = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 sums = _mm_add_ps(v, shuf);
+    shuf = _mm_movehl_ps(shuf, sums);
+    return _mm_cvtss_f32(_mm_add_ss(sums, shuf));
+}
+
+void dotSse2(const float* c, const float* l, const float* r, std::size_t taps, float* outL, float* outR) {
+    __m128 accL0 = _mm_setzero_ps(), accL1 = _mm_setzero_ps();
+    __m128 accR0 = _mm_setzero_ps(), accR1 = _mm_setzero_ps();
+    for (std::size_t j = 0; j < taps; j += 8) {
+        const __m128 c0 = _mm_loadu_ps(c + j);
+        const __m128 c1 = _mm_loadu_ps(c + j + 4);
+        accL0 = _mm_add_ps(accL0, _mm_mul_ps(c0, _mm_loadu_ps(l + j)));
+        accL1 = _mm_add_ps(accL1, _mm_mul_ps(c1, _mm_loadu_ps(l + j + 4)));
+        accR0 = _mm_add_ps(accR0, _mm_mul_ps(c0, _mm_loadu_ps(r + j)));
+        accR1 = _mm_add_ps(accR1, _mm_mul_ps(c1, _mm_loadu_ps(r + j + 4)));
+    }
+    *outL = hsumSse(_mm_add_ps(accL0, accL1));
+    *outR = hsumSse(_mm_add_ps(accR0, accR1));
+}
+
+// ---- AVX2 ------------------------------------------------------------------
+
+__attribute__((target("avx2"))) void dotAvx2(const float* c, const float* l, const float* r, std::size_t taps,
+                                             float* outL, float* outR) {
+    __m256 accL = _mm256_setzero_ps();
+    __m256 accR = _mm256_setzero_ps();
+    for (std::size_t j = 0; j < taps; j += 8) {
+        const __m256 cv = _mm256_loadu_ps(c + j);
+        accL = _mm256_add_ps(accL, _mm256_mul_ps(cv, _mm256_loadu_ps(l + j)));
+        accR = _mm256_add_ps(accR, _mm256_mul_ps(cv, _mm256_loadu_ps(r + j)));
+    }
+    // Fold both accumulators at once: low/high halves, then the 4-lane sums
+    const __m128 sumL = _mm_add_ps(_mm256_castps256_ps128(accL), _mm256_extractf128_ps(accL, 1));
+    const __m128 sumR = _mm_add_ps(_mm256_castps256_ps128(accR), _mm256_extractf128_ps(accR, 1));
+    const __m128 pair = _mm_hadd_ps(sumL, sumR);  // l01 l23 r01 r23
+    const __m128 both = _mm_hadd_ps(pair, pair);  // l r l r
+    *outL = _mm_cvtss_f32(both);
+    *outR = _mm_cvtss_f32(_mm_shuffle_ps(both, both, _MM_SHUFFLE(1, 1, 1, 1)));
+}
+
+#elif defined(NEONWAVE_SIMD_NEON)
+
+// ---- NEON ------------------------------------------------------------------
+
+void dotNeon(const float* c, const float* l, const float* r, std::size_t taps, float* outL, float* outR) {
+    float32x4_t accL0 = vdupq_n_f32(0.0f), accL1 = vdupq_n_f32(0.0f);
+    float32x4_t accR0 = vdupq_n_f32(0.0f), accR1 = vdupq_n_f32(0.0f);
+    for (std::size_t j = 0; j < taps; j += 8) {
+        const float32x4_t c0 = vld1q_f32(c + j);
+        const float32x4_t c1 = vld1q_f32(c + j + 4);
+        accL0 = vmlaq_f32(accL0, c0, vld1q_f32(l + j));
+        accL1 = vmlaq_f32(accL1, c1, vld1q_f32(l + j + 4));
+        accR0 = vmlaq_f32(accR0, c0, vld1q_f32(r + j));
+        accR1 = vmlaq_f32(accR1, c1, vld1q_f32(r + j + 4));
+    }
+    const float32x4_t sumL = vaddq_f32(accL0, accL1);
+    const float32x4_t sumR = vaddq_f32(accR0, accR1);
+    const float32x2_t l2 = vadd_f32(vget_low_f32(sumL), vget_high_f32(sumL));
+    const float32x2_t r2 = vadd_f32(vget_low_f32(sumR), vget_high_f32(sumR));
+    *outL = vget_lane_f32(vpadd_f32(l2, l2), 0);
+    *outR = vget_lane_f32(vpadd_f32(r2, r2), 0);
+}
+
+#endif
+
+DotKernel dotKernelFor(SimdIsa isa) {
+    switch (isa) {
+#if defined(NEONWAVE_SIMD_X86)
+    case SimdIsa::AVX2: return dotAvx2;
+    case SimdIsa::SSE2: return dotSse2;
+#elif defined(NEONWAVE_SIMD_NEON)
+    case SimdIsa::NEON: return dotNeon;
+#endif
+    default: return dotScalar;
+    }
+}
+
+/// Zeroth-order modified Bessel function of the first kind, for the Kaiser window.
+double besselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 50; ++k) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < sum * 1e-12) break;
+    }
+    return sum;
+}
+
+std::vector<float> stereoTone(double frequency, int sampleRate, std::size_t frames, float amplitude) {
+    std::vector<float> out(frames * 2);
+    for (std::size_t i = 0; i < frames; ++i) {
+        const auto s = static_cast<float>(amplitude * std::sin(2.0 * kPi * frequency * static_cast<double>(i) / sampleRate));
+        out[2 * i] = s;
+        out[2 * i + 1] = s;
+    }
+    return out;
+}
+
+} // namespace
+
+PolyphaseResampler::PolyphaseResampler(SimdIsa isa)
+    : m_isa(isa) {}
+
+void PolyphaseResampler::configure(int inputRate, int outputRate, int tapsPerPhase) {
+    // When decimating the transition band has to shrink with the ratio, so the
+    // filter is tapsPerPhase long in output samples rather than input samples
+    const int decimation = outputRate > 0 && inputRate > outputRate ? (inputRate + outputRate - 1) / outputRate : 1;
+    const int taps = std::max(8, (tapsPerPhase * decimation + 7) / 8 * 8);
+    if (inputRate == m_inputRate && outputRate == m_outputRate && taps == m_taps) return;
+    m_inputRate = inputRate;
+    m_outputRate = outputRate;
+    m_taps = taps;
+
+    const int g = std::gcd(std::max(inputRate, 1), std::max(outputRate, 1));
+    m_up = static_cast<std::uint32_t>(std::max(outputRate, 1) / g);
+    m_down = static_cast<std::uint32_t>(std::max(inputRate, 1) / g);
+    m_coeffs.clear();
+
+    if (!isPassthrough()) {
+        // Prototype low-pass at the upsampled rate (input * L), cut below the lower Nyquist
+        const std::size_t length = static_cast<std::size_t>(m_up) * taps;
+        const double cutoff = 0.5 * kRolloff * std::min(1.0, static_cast<double>(m_up) / m_down) / m_up;
+        const double center = (static_cast<double>(length) - 1.0) / 2.0;
+        const double i0Beta = besselI0(kKaiserBeta);
+        std::vector<double> prototype(length);
+        for (std::size_t n = 0; n < length; ++n) {
+            const double x = static_cast<double>(n) - center;
+            const double sinc = x == 0.0 ? 2.0 * cutoff : std::sin(2.0 * kPi * cutoff * x) / (kPi * x);
+            const double ratio = 2.0 * x / (static_cast<double>(length) - 1.0);
+            const double window = besselI0(kKaiserBeta * std::sqrt(std::max(0.0, 1.0 - ratio * ratio))) / i0Beta;
+            prototype[n] = sinc * window * m_up; // gain L makes up for the zero-stuffing
+        }
+
+        // Phase p, tap j multiplies x[base - (taps - 1) + j], i.e. prototype[p + (taps - 1 - j) * L]
+        m_coeffs.resize(length);
+        for (std::uint32_t p = 0; p < m_up; ++p) {
+            for (int j = 0; j < taps; ++j) {
+                m_coeffs[p * taps + j] = static_cast<float>(prototype[p + static_cast<std::size_t>(taps - 1 - j) * m_up]);
+            }
+        }
+    }
+    reset();
+}
+
+void PolyphaseResampler::reset() {
+    // Storage is sized once per filter; process() never grows it
+    const std::size_t history = m_taps > 0 ? static_cast<std::size_t>(m_taps - 1) : 0;
+    if (m_left.size() != history + kBlockFrames) {
+        m_left.resize(history + kBlockFrames);
+        m_right.resize(history + kBlockFrames);
+    }
+    std::fill(m_left.begin(), m_left.begin() + static_cast<std::ptrdiff_t>(history), 0.0f);
+    std::fill(m_right.begin(), m_right.begin() + static_cast<std::ptrdiff_t>(history), 0.0f);
+    m_held = history;
+    m_phase = 0;
+}
+
+std::size_t PolyphaseResampler::maxOutputFrames(std::size_t inputFrames) const {
+    if (isPassthrough()) return inputFrames;
+    return (inputFrames + static_cast<std::size_t>(m_taps)) * m_up / m_down + 2;
+}
+
+std::size_t PolyphaseResampler::process(const float* src, std::size_t frames, float* dst) {
+    if (isPassthrough()) {
+        std::memcpy(dst, src, frames * 2 * sizeof(float));
+        return frames;
+    }
+    const auto start = std::chrono::steady_clock::now();
+
+    const DotKernel dot = dotKernelFor(m_isa);
+    const std::size_t taps = static_cast<std::size_t>(m_taps);
+    float* left = m_left.data();
+    float* right = m_right.data();
+    std::size_t out = 0;
+    for (std::size_t done = 0; done < frames;) {
+        // Deinterleave the next block behind the carried-over history
+        const std::size_t block = std::min(frames - done, m_left.size() - m_held);
+        const float* in = src + 2 * done;
+        for (std::size_t i = 0; i < block; ++i) {
+            left[m_held + i] = in[2 * i];
+            right[m_held + i] = in[2 * i + 1];
+        }
+        done += block;
+        const std::size_t available = m_held + block;
+
+        std::size_t pos = 0; // first input sample of the current window
+        while (pos + taps <= available) {
+            dot(m_coeffs.data() + static_cast<std::size_t>(m_phase) * taps, left + pos, right + pos, taps,
+                dst + 2 * out, dst + 2 * out + 1);
+            ++out;
+            m_phase += m_down;
+            pos += m_phase / m_up;
+            m_phase %= m_up;
+        }
+
+        // What the next window starts with becomes the new history: at most taps - 1 frames, as a
+        // step never exceeds the decimation factor and taps are at least that long
+        m_held = available - pos;
+        std::memmove(left, left + pos, m_held * sizeof(float));
+        std::memmove(right, right + pos, m_held * sizeof(float));
+    }
+
+    m_outputFrames += out;
+    m_nanoseconds += static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
+    return out;
+}
+
+std::size_t PolyphaseResampler::flush(float* dst) {
+    static const float kSilence[2 * kBlockFrames] = {};
+    std::size_t out = 0;
+    for (std::size_t left = latencyFrames(); left > 0;) {
+        const std::size_t frames = std::min(left, kBlockFrames);
+        out += process(kSilence, frames, dst + 2 * out);
+        left -= frames;
+    }
+    return out;
+}
+
+std::vector<PolyphaseResampler::BenchmarkResult> PolyphaseResampler::benchmark(std::size_t frames) {
+    const std::vector<SimdIsa> isas = availableIsas();
+
+    constexpr int kInputRates[] = { 48000, 96000, 192000 };
+    constexpr int kOutputRate = 44100;
+    constexpr int kTaps = 32;
+    constexpr std::size_t kChunk = 1024;
+
+    std::vector<BenchmarkResult> results;
+    for (const int inputRate : kInputRates) {
+        const std::vector<float> input = stereoTone(997.0, inputRate, frames, 0.5f);
+        for (const SimdIsa isa : isas) {
+            PolyphaseResampler resampler(isa);
+            resampler.configure(inputRate, kOutputRate, kTaps);
+            std::vector<float> output(resampler.maxOutputFrames(kChunk) * 2);
+            std::size_t produced = 0;
+            const auto start = std::chrono::steady_clock::now();
+            for (std::size_t f = 0; f + kChunk <= frames; f += kChunk) {
+                produced += resampler.process(input.data() + 2 * f, kChunk, output.data());
+            }
+            const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            results.push_back({ isa, inputRate, kOutputRate, resampler.tapsPerPhase(), produced ? ns / produced : 0.0 });
+        }
+    }
+    return results;
+}
+
+PolyphaseResampler::QualityResult PolyphaseResampler::measureQuality(int inputRate, int outputRate, int tapsPerPhase) {
+    QualityResult q{ inputRate, outputRate, tapsPerPhase, 0.0, std::numeric_limits<double>::quiet_NaN() };
+    const std::size_t frames = static_cast<std::size_t>(inputRate); // one second
+    {
+        PolyphaseResampler probe(SimdIsa::Scalar);
+        probe.configure(inputRate, outputRate, tapsPerPhase);
+        q.tapsPerPhase = probe.tapsPerPhase();
+    }
+
+    auto run = [&](double frequency) {
+        PolyphaseResampler resampler(detectIsa());
+        resampler.configure(inputRate, outputRate, tapsPerPhase);
+        const std::vector<float> input = stereoTone(frequency, inputRate, frames, 0.5f);
+        std::vector<float> output(resampler.maxOutputFrames(frames) * 2);
+        const std::size_t produced = resampler.process(input.data(), frames, output.data());
+        // Drop the filter's start-up transient
+        const std::size_t skip = std::min<std::size_t>(produced, static_cast<std::size_t>(q.tapsPerPhase) * 4);
+        std::vector<double> left;
+        left.reserve(produced - skip);
+        for (std::size_t i = skip; i < produced; ++i) left.push_back(output[2 * i]);
+        return left;
+    };
+
+    // Least-squares fit of a sine at the tone frequency; everything else is error
+    {
+        const double w = 2.0 * kPi * 1000.0 / outputRate;
+        const std::vector<double> y = run(1000.0);
+        double ss = 0, cc = 0, sc = 0, ys = 0, yc = 0;
+        for (std::size_t n = 0; n < y.size(); ++n) {
+            const double s = std::sin(w * n), c = std::cos(w * n);
+            ss += s * s; cc += c * c; sc += s * c; ys += y[n] * s; yc += y[n] * c;
+        }
+        const double det = ss * cc - sc * sc;
+        const double a = (ys * cc - yc * sc) / det;
+        const double b = (yc * ss - ys * sc) / det;
+        double signal = 0, noise = 0;
+        for (std::size_t n = 0; n < y.size(); ++n) {
+            const double fit = a * std::sin(w * n) + b * std::cos(w * n);
+            signal += fit * fit;
+            noise += (y[n] - fit) * (y[n] - fit);
+        }
+        q.sineSnrDb = noise > 0 ? 10.0 * std::log10(signal / noise) : 200.0;
+    }
+
+    // Only meaningful when downsampling: a tone the output cannot represent must not fold back
+    const double aliasFrequency = std::min(0.55 * outputRate, 0.25 * (inputRate + outputRate));
+    if (outputRate < inputRate) {
+        const std::vector<double> y = run(aliasFrequency);
+        double energy = 0;
+        for (const double v : y) energy += v * v;
+        const double rmsOut = y.empty() ? 0.0 : std::sqrt(energy / y.size());
+        const double rmsIn = 0.5 / std::sqrt(2.0);
+        q.aliasRejectionDb = rmsOut > 0 ? 20.0 * std::log10(rmsIn / rmsOut) : 200.0;
+    }
+    return q;
+}
+
+}
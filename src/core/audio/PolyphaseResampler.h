@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "SimdIsa.h"
+
+namespace NeonWave::Core::Audio {
+
+/**
+ * @brief Rational-ratio polyphase resampler for interleaved float stereo.
+ *
+ * The ratio is reduced to L/M and a Kaiser-windowed sinc prototype is split
+ * into L phases of tapsPerPhase coefficients, so every output frame costs one
+ * tapsPerPhase-long dot product per channel regardless of the rates. Input is
+ * kept planar internally so those dot products run over contiguous memory;
+ * the kernel is picked per ISA like SampleConverter's (AVX2/SSE2/NEON/scalar).
+ *
+ * Streaming and not thread-safe: one instance per consumer.
+ */
+class PolyphaseResampler {
+public:
+    struct BenchmarkResult {
+        SimdIsa isa;
+        int inputRate;
+        int outputRate;
+        int tapsPerPhase;
+        double nsPerOutputFrame;
+    };
+
+    struct QualityResult {
+        int inputRate;
+        int outputRate;
+        int tapsPerPhase;
+        double sineSnrDb;         ///< 1 kHz tone: fitted sine vs residual
+        double aliasRejectionDb;  ///< Tone just above the output Nyquist: output vs input level
+    };
+
+    explicit PolyphaseResampler(SimdIsa isa = detectIsa());
+
+    /// Rebuild the filter for a new rate pair (no-op if unchanged). Taps are scaled by the
+    /// decimation factor when downsampling and rounded up to a multiple of 8.
+    void configure(int inputRate, int outputRate, int tapsPerPhase = 32);
+    /// Forget the stream history (e.g. after a seek).
+    void reset();
+
+    int inputRate() const { return m_inputRate; }
+    int outputRate() const { return m_outputRate; }
+    int tapsPerPhase() const { return m_taps; }
+    bool isPassthrough() const { return m_up == m_down; }
+    SimdIsa isa() const { return m_isa; }
+
+    /// Upper bound on the frames process() can write for @p inputFrames.
+    std::size_t maxOutputFrames(std::size_t inputFrames) const;
+
+    /// Resample @p frames of interleaved stereo into @p dst; returns frames written.
+    std::size_t process(const float* src, std::size_t frames, float* dst);
+    /// Input frames still inside the filter: what the output lags behind the input.
+    std::size_t latencyFrames() const { return isPassthrough() ? 0 : static_cast<std::size_t>(m_taps / 2); }
+    /// End of stream: push the last latencyFrames() of input out through silence. @p dst must hold
+    /// maxOutputFrames(latencyFrames()) frames; returns frames written.
+    std::size_t flush(float* dst);
+
+    /// Cumulative cost of process() on this instance.
+    double nsPerOutputFrame() const { return m_outputFrames ? static_cast<double>(m_nanoseconds) / m_outputFrames : 0.0; }
+
+    /// Time every kernel available on this CPU for the common rate pairs.
+    static std::vector<BenchmarkResult> benchmark(std::size_t frames = 1 << 18);
+    /// Measure passband SNR and alias rejection for a rate pair.
+    static QualityResult measureQuality(int inputRate, int outputRate, int tapsPerPhase = 32);
+
+private:
+    SimdIsa m_isa;
+    int m_inputRate = 0;
+    int m_outputRate = 0;
+    int m_taps = 0;
+    std::uint32_t m_up = 1;    // L
+    std::uint32_t m_down = 1;  // M
+    std::vector<float> m_coeffs; // m_up rows of m_taps, time-reversed per phase
+
+    std::vector<float> m_left;   // planar: up to taps - 1 frames of history, then one block of input
+    std::vector<float> m_right;
+    std::size_t m_held = 0;      // frames of history at the front of m_left/m_right
+    std::uint32_t m_phase = 0;
+
+    std::uint64_t m_outputFrames = 0;
+    std::uint64_t m_nanoseconds = 0;
+};
+
+}
@@ -0,0 +1,215 @@
+#include "PulseCapture.h"
+#include <pulse/pulseaudio.h>
+#include <algorithm>
+#include <iostream>
+
+namespace NeonWave::Core::Audio {
+
+namespace {
+
+constexpr int kChannels = 2;
+constexpr std::size_t kFrameBytes = kChannels * sizeof(float);
+
+} // namespace
+
+PulseCapture::PulseCapture()
+    : m_bus(std::make_shared<AudioBlockBus>())
+    , m_clock(std::make_shared<PlaybackClock>())
+{
+}
+
+PulseCapture::~PulseCapture() {
+    stop();
+}
+
+bool PulseCapture::fail(const std::string& what) {
+    m_error = what;
+    if (m_context && pa_context_errno(m_context) != 0) {
+        m_error += ": ";
+        m_error += pa_strerror(pa_context_errno(m_context));
+    }
+    std::cerr << "[PulseCapture] " << m_error << std::endl;
+    return false;
+}
+
+bool PulseCapture::start(const std::string& source, int sampleRate, int fragmentMs) {
+    stop();
+    m_error.clear();
+    m_source = source.empty() ? kDefaultSource : source;
+
+    m_mainloop = pa_threaded_mainloop_new();
+    if (!m_mainloop) return fail("Cannot create main loop");
+    m_context = pa_context_new(pa_threaded_mainloop_get_api(m_mainloop), "NeonWave");
+    if (!m_context) {
+        stop();
+        return fail("Cannot create context");
+    }
+    pa_context_set_state_callback(m_context, &PulseCapture::onContextState, this);
+
+    pa_threaded_mainloop_lock(m_mainloop);
+    bool ok = pa_context_connect(m_context, nullptr, PA_CONTEXT_NOFLAGS, nullptr) >= 0
+        && pa_threaded_mainloop_start(m_mainloop) >= 0;
+    for (;;) {
+        if (!ok) break;
+        const pa_context_state_t state = pa_context_get_state(m_context);
+        if (state == PA_CONTEXT_READY) break;
+        if (!PA_CONTEXT_IS_GOOD(state)) {
+            ok = false;
+            break;
+        }
+        pa_threaded_mainloop_wait(m_mainloop);
+    }
+    if (!ok) {
+        fail("Cannot connect to the sound server");
+        pa_threaded_mainloop_unlock(m_mainloop);
+        const std::string error = m_error;
+        stop();
+        m_error = error;
+        return false;
+    }
+
+    pa_sample_spec spec{};
+    spec.format = PA_SAMPLE_FLOAT32NE;
+    spec.rate = static_cast<std::uint32_t>(sampleRate);
+    spec.channels = kChannels;
+    m_stream = pa_stream_new(m_context, "NeonWave visualizer", &spec, nullptr);
+    if (m_stream) {
+        pa_stream_set_state_callback(m_stream, &PulseCapture::onStreamState, this);
+        pa_stream_set_read_callback(m_stream, &PulseCapture::onRead, this);
+
+        // Only fragsize matters for recording: it is how much the server gathers before waking us
+        pa_buffer_attr attr{};
+        attr.maxlength = static_cast<std::uint32_t>(-1);
+        attr.tlength = static_cast<std::uint32_t>(-1);
+        attr.prebuf = static_cast<std::uint32_t>(-1);
+        attr.minreq = static_cast<std::uint32_t>(-1);
+        attr.fragsize = static_cast<std::uint32_t>(pa_usec_to_bytes(static_cast<pa_usec_t>(fragmentMs) * 1000, &spec));
+        const auto flags = static_cast<pa_stream_flags_t>(
+            PA_STREAM_ADJUST_LATENCY | PA_STREAM_INTERPOLATE_TIMING | PA_STREAM_AUTO_TIMING_UPDATE);
+        ok = pa_stream_connect_record(m_stream, m_source.c_str(), &attr, flags) >= 0;
+        for (;;) {
+            if (!ok) break;
+            const pa_stream_state_t state = pa_stream_get_state(m_stream);
+            if (state == PA_STREAM_READY) break;
+            if (!PA_STREAM_IS_GOOD(state)) {
+                ok = false;
+                break;
+            }
+            pa_threaded_mainloop_wait(m_mainloop);
+        }
+    } else {
+        ok = false;
+    }
+
+    if (ok) {
+        const pa_sample_spec* actual = pa_stream_get_sample_spec(m_stream);
+        m_sampleRate = actual ? actual->rate : spec.rate;
+        if (const pa_buffer_attr* granted = pa_stream_get_buffer_attr(m_stream)) {
+            m_fragmentBytes.store(granted->fragsize, std::memory_order_relaxed);
+        }
+        if (const char* device = pa_stream_get_device_name(m_stream)) m_source = device;
+        m_running.store(true, std::memory_order_release);
+    } else {
+        fail("Cannot record from " + m_source);
+    }
+    pa_threaded_mainloop_unlock(m_mainloop);
+
+    if (!ok) {
+        const std::string error = m_error;
+        stop();
+        m_error = error;
+        return false;
+    }
+    std::cout << "[PulseCapture] Recording " << m_source << " at " << m_sampleRate << " Hz, "
+              << m_fragmentBytes.load(std::memory_order_relaxed) / kFrameBytes * 1000.0 / m_sampleRate
+              << " ms fragments" << std::endl;
+    return true;
+}
+
+void PulseCapture::stop() {
+    m_running.store(false, std::memory_order_release);
+    if (m_mainloop) {
+        pa_threaded_mainloop_lock(m_mainloop);
+        if (m_stream) {
+            pa_stream_set_read_callback(m_stream, nullptr, nullptr);
+            pa_stream_set_state_callback(m_stream, nullptr, nullptr);
+            pa_stream_disconnect(m_stream);
+            pa_stream_unref(m_stream);
+            m_stream = nullptr;
+        }
+        if (m_context) {
+            pa_context_set_state_callback(m_context, nullptr, nullptr);
+            pa_context_disconnect(m_context);
+            pa_context_unref(m_context);
+            m_context = nullptr;
+        }
+        pa_threaded_mainloop_unlock(m_mainloop);
+        pa_threaded_mainloop_stop(m_mainloop);
+        pa_threaded_mainloop_free(m_mainloop);
+        m_mainloop = nullptr;
+    }
+    // Stop the clock where it is so consumers don't extrapolate past the last capture
+    auto s = m_clock->sample();
+    s.running = false;
+    m_clock->update(s);
+}
+
+void PulseCapture::onContextState(pa_context*, void* userdata) {
+    pa_threaded_mainloop_signal(static_cast<PulseCapture*>(userdata)->m_mainloop, 0);
+}
+
+void PulseCapture::onStreamState(pa_stream*, void* userdata) {
+    pa_threaded_mainloop_signal(static_cast<PulseCapture*>(userdata)->m_mainloop, 0);
+}
+
+void PulseCapture::onRead(pa_stream*, std::size_t, void* userdata) {
+    static_cast<PulseCapture*>(userdata)->read();
+}
+
+void PulseCapture::read() {
+    // Runs on libpulse's thread with the main loop locked
+    m_reads.fetch_add(1, std::memory_order_relaxed);
+    std::uint64_t streamFrame = m_streamFrame.load(std::memory_order_relaxed);
+    while (pa_stream_readable_size(m_stream) > 0) {
+        const void* data = nullptr;
+        std::size_t bytes = 0;
+        if (pa_stream_peek(m_stream, &data, &bytes) < 0 || bytes == 0) break;
+
+        const std::size_t frames = bytes / kFrameBytes;
+        if (data) {
+            m_bus->publish(static_cast<const float*>(data), frames, kChannels, m_sampleRate, streamFrame);
+        } else {
+            // A hole: the server overran our buffer. Keep the stream axis continuous with silence.
+            if (m_silence.size() < frames * kChannels) m_silence.assign(frames * kChannels, 0.0f);
+            m_bus->publish(m_silence.data(), frames, kChannels, m_sampleRate, streamFrame);
+            m_holeFrames.fetch_add(frames, std::memory_order_relaxed);
+        }
+        streamFrame += frames;
+        pa_stream_drop(m_stream);
+    }
+    m_streamFrame.store(streamFrame, std::memory_order_relaxed);
+
+    // The newest frame entered the source this long ago; that is when it was audible
+    pa_usec_t latency = 0;
+    int negative = 0;
+    if (pa_stream_get_latency(m_stream, &latency, &negative) < 0 || negative) latency = 0;
+    m_sourceLatencyUs.store(latency, std::memory_order_relaxed);
+    m_clock->update({ streamFrame, PlaybackClock::nowNs() - static_cast<std::int64_t>(latency) * 1000,
+                      m_sampleRate, true, streamFrame });
+}
+
+CaptureStats PulseCapture::stats() const {
+    CaptureStats s;
+    s.running = isRunning();
+    if (!s.running) return s;
+    s.source = m_source;
+    s.sampleRate = m_sampleRate;
+    s.fragmentMs = m_sampleRate ? m_fragmentBytes.load(std::memory_order_relaxed) / kFrameBytes * 1000.0 / m_sampleRate : 0.0;
+    s.sourceLatencyMs = m_sourceLatencyUs.load(std::memory_order_relaxed) / 1000.0;
+    s.frames = m_streamFrame.load(std::memory_order_relaxed);
+    s.holeFrames = m_holeFrames.load(std::memory_order_relaxed);
+    s.reads = m_reads.load(std::memory_order_relaxed);
+    return s;
+}
+
+}
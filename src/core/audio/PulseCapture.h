@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "AudioBlockBus.h"
+#include "PlaybackClock.h"
+
+struct pa_context;
+struct pa_stream;
+struct pa_threaded_mainloop;
+
+namespace NeonWave::Core::Audio {
+
+/// Snapshot of a running capture.
+struct CaptureStats {
+    bool running = false;
+    std::string source;              ///< Source actually connected to
+    std::uint32_t sampleRate = 0;
+    double fragmentMs = 0.0;         ///< Fragment size the server granted
+    double sourceLatencyMs = 0.0;    ///< Age of the newest frame when it was read, per the server
+    std::uint64_t frames = 0;        ///< Frames published, holes included
+    std::uint64_t holeFrames = 0;    ///< Frames the server dropped (overruns), published as silence
+    std::uint64_t reads = 0;         ///< Read callbacks
+};
+
+/**
+ * @brief Captures a PulseAudio (or PipeWire-Pulse) source into its own PCM bus.
+ *
+ * Uses the libpulse threaded main loop: the read callback runs on libpulse's
+ * thread and publishes every fragment straight onto audioBus(), so the
+ * visualizer sees system audio one fragment after the server does. The
+ * default source is "@DEFAULT_MONITOR@", i.e. whatever the default sink is
+ * playing.
+ *
+ * clock() is stamped on every read with the newest captured frame and the
+ * time it entered the source, so consumers built for playback (delay line,
+ * latency stats) work unchanged: a monitored frame is already audible.
+ */
+class PulseCapture {
+public:
+    static constexpr const char* kDefaultSource = "@DEFAULT_MONITOR@";
+
+    PulseCapture();
+    ~PulseCapture();
+
+    /**
+     * @brief Connect to the server and start recording
+     * @param source Source name; empty for the default sink's monitor
+     * @param sampleRate Rate to capture at (the server resamples if needed)
+     * @param fragmentMs Requested fragment size; smaller means lower latency and more wakeups
+     * @return False if the server or source is unavailable; see errorString()
+     */
+    bool start(const std::string& source = {}, int sampleRate = 48000, int fragmentMs = 5);
+    void stop();
+    bool isRunning() const { return m_running.load(std::memory_order_acquire); }
+
+    std::shared_ptr<AudioBlockBus> audioBus() const { return m_bus; }
+    std::shared_ptr<const PlaybackClock> clock() const { return m_clock; }
+
+    CaptureStats stats() const;
+    std::string errorString() const { return m_error; }
+
+private:
+    static void onContextState(pa_context* context, void* userdata);
+    static void onStreamState(pa_stream* stream, void* userdata);
+    static void onRead(pa_stream* stream, std::size_t bytes, void* userdata);
+    void read();
+    bool fail(const std::string& what);
+
+    std::shared_ptr<AudioBlockBus> m_bus;
+    std::shared_ptr<PlaybackClock> m_clock;
+
+    pa_threaded_mainloop* m_mainloop = nullptr;
+    pa_context* m_context = nullptr;
+    pa_stream* m_stream = nullptr;
+    std::string m_error;
+    std::string m_source;
+    std::uint32_t m_sampleRate = 0;
+    std::vector<float> m_silence;    // published in place of holes
+
+    // Written on libpulse's thread, read by stats()
+    std::atomic<bool> m_running{false};
+    std::atomic<std::uint64_t> m_streamFrame{0};
+    std::atomic<std::uint64_t> m_holeFrames{0};
+    std::atomic<std::uint64_t> m_reads{0};
+    std::atomic<std::uint64_t> m_fragmentBytes{0};
+    std::atomic<std::uint64_t> m_sourceLatencyUs{0};
+};
+
+}
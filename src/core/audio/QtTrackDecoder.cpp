@@ -0,0 +1,109 @@
+#include "QtTrackDecoder.h"
+#include <QAudioFormat>
+#include <QUrl>
+#include <algorithm>
+#include <iostream>
+
+namespace NeonWave::Core::Audio {
+
+QtTrackDecoder::QtTrackDecoder(SampleConverter& converter, qint64 maxBufferedMs, QObject* parent)
+    : QObject(parent)
+    , m_converter(converter)
+    , m_maxBufferedMs(std::max<qint64>(maxBufferedMs, 100))
+{
+    connect(&m_decoder, &QAudioDecoder::bufferReady, this, &QtTrackDecoder::pullFromDecoder);
+    connect(&m_decoder, &QAudioDecoder::finished, this, [this]() { m_decodeFinished = true; });
+    connect(&m_decoder, QOverload<QAudioDecoder::Error>::of(&QAudioDecoder::error), this,
+            [this](QAudioDecoder::Error) {
+                std::cerr << "[QtTrackDecoder] " << m_path.toStdString() << ": "
+                          << m_decoder.errorString().toStdString() << std::endl;
+                m_error = true;
+            });
+}
+
+QtTrackDecoder::~QtTrackDecoder() {
+    close();
+}
+
+bool QtTrackDecoder::open(const QString& path) {
+    close();
+    m_path = path;
+    m_decoder.setSource(QUrl::fromLocalFile(path));
+    m_decoder.start();
+    return m_decoder.error() == QAudioDecoder::NoError;
+}
+
+void QtTrackDecoder::close() {
+    m_decoder.stop();
+    m_queue.clear();
+    m_frontOffset = 0;
+    m_queuedFrames = 0;
+    m_skipFrames = 0;
+    m_sampleRate = 0;
+    m_decodeFinished = false;
+    m_error = false;
+}
+
+qint64 QtTrackDecoder::durationMs() const {
+    return m_decoder.duration();
+}
+
+bool QtTrackDecoder::seek(qint64 frame) {
+    // QAudioDecoder cannot seek: restart and discard up to the target
+    const QString path = m_path;
+    if (!open(path)) return false;
+    m_skipFrames = std::max<qint64>(frame, 0);
+    return true;
+}
+
+void QtTrackDecoder::pullFromDecoder() {
+    while (m_decoder.bufferAvailable()) {
+        if (m_sampleRate > 0 && m_queuedFrames * 1000 / static_cast<std::size_t>(m_sampleRate)
+                                    >= static_cast<std::size_t>(m_maxBufferedMs)) {
+            return; // full: leave the next buffer pending in the decoder
+        }
+
+        QAudioBuffer buffer = m_decoder.read();
+        if (!buffer.isValid() || buffer.frameCount() <= 0) continue;
+        const QAudioFormat format = buffer.format();
+        if (format.channelCount() <= 0 || format.channelCount() > DownmixMatrix::kMaxChannels) continue;
+        m_sampleRate = format.sampleRate();
+
+        qsizetype offset = 0;
+        if (m_skipFrames > 0) {
+            offset = std::min<qsizetype>(m_skipFrames, buffer.frameCount());
+            m_skipFrames -= offset;
+            if (offset == buffer.frameCount()) continue;
+        }
+        if (m_queue.empty()) m_frontOffset = offset;
+        else if (offset > 0) continue; // only the first kept buffer can start mid-way
+
+        m_queuedFrames += static_cast<std::size_t>(buffer.frameCount() - offset);
+        m_queue.push_back(std::move(buffer));
+    }
+}
+
+std::size_t QtTrackDecoder::read(float* dst, std::size_t frames) {
+    std::size_t done = 0;
+    while (done < frames && !m_queue.empty()) {
+        const QAudioBuffer& front = m_queue.front();
+        const QAudioFormat format = front.format();
+        const qsizetype available = front.frameCount() - m_frontOffset;
+        const std::size_t n = std::min<std::size_t>(frames - done, static_cast<std::size_t>(available));
+
+        const char* src = front.constData<char>() + m_frontOffset * format.bytesPerFrame();
+        m_converter.toStereoFloat(src, sampleTypeFor(format), n, downmixFor(format), dst + 2 * done);
+
+        done += n;
+        m_frontOffset += static_cast<qsizetype>(n);
+        m_queuedFrames -= n;
+        if (m_frontOffset >= front.frameCount()) {
+            m_queue.pop_front();
+            m_frontOffset = 0;
+        }
+    }
+    if (done > 0) pullFromDecoder();
+    return done;
+}
+
+}
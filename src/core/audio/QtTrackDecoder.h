@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QObject>
+#include <QAudioBuffer>
+#include <QAudioDecoder>
+#include <deque>
+#include "TrackDecoder.h"
+#include "SampleConverter.h"
+
+namespace NeonWave::Core::Audio {
+
+/**
+ * @brief TrackDecoder backed by QAudioDecoder.
+ *
+ * Decoded QAudioBuffers are queued as-is (implicitly shared, no copy) and
+ * converted to float stereo only when read. Once the queue holds
+ * maxBufferedMs of audio the decoder is left with its next buffer pending,
+ * which holds the FFmpeg backend until read() makes room again.
+ */
+class QtTrackDecoder : public QObject, public TrackDecoder {
+    Q_OBJECT
+public:
+    QtTrackDecoder(SampleConverter& converter, qint64 maxBufferedMs, QObject* parent = nullptr);
+    ~QtTrackDecoder() override;
+
+    bool open(const QString& path) override;
+    void close() override;
+    std::size_t read(float* dst, std::size_t frames) override;
+    std::size_t bufferedFrames() const override { return m_queuedFrames; }
+    bool atEnd() const override { return (m_decodeFinished || m_error) && m_queue.empty(); }
+    bool hasError() const override { return m_error; }
+    int sampleRate() const override { return m_sampleRate; }
+    qint64 durationMs() const override;
+    bool seek(qint64 frame) override;
+
+private:
+    void pullFromDecoder();
+
+    SampleConverter& m_converter;
+    QAudioDecoder m_decoder;
+    std::deque<QAudioBuffer> m_queue;
+    qsizetype m_frontOffset = 0;   // frames already read from m_queue.front()
+    std::size_t m_queuedFrames = 0;
+    qint64 m_skipFrames = 0;       // frames still to discard after a seek
+    qint64 m_maxBufferedMs;
+    int m_sampleRate = 0;
+    bool m_decodeFinished = false;
+    bool m_error = false;
+};
+
+}
@@ -0,0 +1,443 @@
+#include "SampleConverter.h"
+#include "SimdIsa.h"
+
+#include <QAudioFormat>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <random>
+
+namespace NeonWave::Core::Audio {
+
+namespace {
+
+constexpr float kScaleU8 = 1.0f / 128.0f;
+constexpr float kScaleS16 = 1.0f / 32768.0f;
+constexpr float kScaleS32 = 1.0f / 2147483648.0f;
+
+using ConvertKernel = void (*)(const void* src, float* dst, std::size_t n);
+using DuplicateKernel = void (*)(const float* src, float* dst, std::size_t frames);
+
+// ---- scalar ---------------------------------------------------------------
+
+void u8Scalar(const void* src, float* dst, std::size_t n) {
+    const auto* s = static_cast<const std::uint8_t*>(src);
+    for (std::size_t i = 0; i < n; ++i) dst[i] = (static_cast<float>(s[i]) - 128.0f) * kScaleU8;
+}
+
+void s16Scalar(const void* src, float* dst, std::size_t n) {
+    const auto* s = static_cast<const std::int16_t*>(src);
+    for (std::size_t i = 0; i < n; ++i) dst[i] = static_cast<float>(s[i]) * kScaleS16;
+}
+
+void s32Scalar(const void* src, float* dst, std::size_t n) {
+    const auto* s = static_cast<const std::int32_t*>(src);
+    for (std::size_t i = 0; i < n; ++i) dst[i] = static_cast<float>(s[i]) * kScaleS32;
+}
+
+void f32Copy(const void* src, float* dst, std::size_t n) {
+    if (src != dst) std::memcpy(dst, src, n * sizeof(float));
+}
+
+void dupScalar(const float* src, float* dst, std::size_t frames) {
+    for (std::size_t i = 0; i < frames; ++i) {
+        dst[2 * i] = src[i];
+        dst[2 * i + 1] = src[i];
+    }
+}
+
+#if defined(NEONWAVE_SIMD_X86)
+
+// ---- SSE2 (x86-64 baseline) -----------------------------------------------
+
+void u8Sse2(const void* src, float* dst, std::size_t n) {
+    const auto* s = static_cast<const std::uint8_t*>(src);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128 bias = _mm_set1_ps(128.0f);
+    const __m128 scale = _mm_set1_ps(kScaleU8);
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        const __m128i lo16 = _mm_unpacklo_epi8(v, zero);
+        const __m128i hi16 = _mm_unpackhi_epi8(v, zero);
+        const __m128i q[4] = { _mm_unpacklo_epi16(lo16, zero), _mm_unpackhi_epi16(lo16, zero),
+                               _mm_unpacklo_epi16(hi16, zero), _mm_unpackhi_epi16(hi16, zero) };
+        for (int k = 0; k < 4; ++k) {
+            _mm_storeu_ps(dst + i + 4 * k, _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(q[k]), bias), scale));
+        }
+    }
+    u8Scalar(s + i, dst + i, n - i);
+}
+
+void s16Sse2(const void* src, float* dst, std::size_t n) {
+    const auto* s = static_cast<const std::int16_t*>(src);
+    const __m128 scale = _mm_set1_ps(kScaleS16);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        // Interleave with itself then arithmetic-shift to sign-extend to 32 bits
+        const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+    s16Scalar(s + i, dst + i, n - i);
+}
+
+void s32Sse2(const void* src, float* dst, std::size_t n) {
+    const auto* s = static_cast<const std::int32_t*>(src);
+    const __m128 scale = _mm_set1_ps(kScaleS32);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(v), scale));
+    }
+    s32Scalar(s + i, dst + i, n - i);
+}
+
+void dupSse2(const float* src, float* dst, std::size_t frames) {
+    std::size_t i = 0;
+    for (; i + 4 <= frames; i += 4) {
+        const __m128 v = _mm_loadu_ps(src + i);
+        _mm_storeu_ps(dst + 2 * i, _mm_unpacklo_ps(v, v));
+        _mm_storeu_ps(dst + 2 * i + 4, _mm_unpackhi_ps(v, v));
+    }
+    dupScalar(src + i, dst + 2 * i, frames - i);
+}
+
+// ---- AVX2 (runtime-detected) ----------------------------------------------
+
+__attribute__((target("avx2"))) void u8Avx2(const void* src, float* dst, std::size_t n) {
+    const auto* s = static_cast<const std::uint8_t*>(src);
+    const __m256 bias = _mm256_set1_ps(128.0f);
+    const __m256 scale = _mm256_set1_ps(kScaleU8);
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        const __m256i lo = _mm256_cvtepu8_epi32(v);
+        const __m256i hi = _mm256_cvtepu8_epi32(_mm_srli_si128(v, 8));
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_sub_ps(_mm256_cvtepi32_ps(lo), bias), scale));
+        _mm256_storeu_ps(dst + i + 8, _mm256_mul_ps(_mm256_sub_ps(_mm256_cvtepi32_ps(hi), bias), scale));
+    }
+    u8Scalar(s + i, dst + i, n - i);
+}
+
+__attribute__((target("avx2"))) void s16Avx2(const void* src, float* dst, std::size_t n) {
+    const auto* s = static_cast<const std::int16_t*>(src);
+    const __m256 scale = _mm256_set1_ps(kScaleS16);
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+        const __m256i lo = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(v));
+        const __m256i hi = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(v, 1));
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(lo), scale));
+        _mm256_storeu_ps(dst + i + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(hi), scale));
+    }
+    s16Scalar(s + i, dst + i, n - i);
+}
+
+__attribute__((target("avx2"))) void s32Avx2(const void* src, float* dst, std::size_t n) {
+    const auto* s = static_cast<const std::int32_t*>(src);
+    const __m256 scale = _mm256_set1_ps(kScaleS32);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+    }
+    s32Scalar(s + i, dst + i, n - i);
+}
+
+#elif defined(NEONWAVE_SIMD_NEON)
+
+// ---- NEON (ARMv8 baseline) ------------------------------------------------
+
+void u8Neon(const void* src, float* dst, std::size_t n) {
+    const auto* s = static_cast<const std::uint8_t*>(src);
+    const float32x4_t bias = vdupq_n_f32(128.0f);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const uint16x8_t w = vmovl_u8(vld1_u8(s + i));
+        const float32x4_t lo = vcvtq_f32_u32(vmovl_u16(vget_low_u16(w)));
+        const float32x4_t hi = vcvtq_f32_u32(vmovl_u16(vget_high_u16(w)));
+        vst1q_f32(dst + i, vmulq_n_f32(vsubq_f32(lo, bias), kScaleU8));
+        vst1q_f32(dst + i + 4, vmulq_n_f32(vsubq_f32(hi, bias), kScaleU8));
+    }
+    u8Scalar(s + i, dst + i, n - i);
+}
+
+void s16Neon(const void* src, float* dst, std::size_t n) {
+    const auto* s = static_cast<const std::int16_t*>(src);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const int16x8_t v = vld1q_s16(s + i);
+        vst1q_f32(dst + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), kScaleS16));
+        vst1q_f32(dst + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), kScaleS16));
+    }
+    s16Scalar(s + i, dst + i, n - i);
+}
+
+void s32Neon(const void* src, float* dst, std::size_t n) {
+    const auto* s = static_cast<const std::int32_t*>(src);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        vst1q_f32(dst + i, vmulq_n_f32(vcvtq_f32_s32(vld1q_s32(s + i)), kScaleS32));
+    }
+    s32Scalar(s + i, dst + i, n - i);
+}
+
+void dupNeon(const float* src, float* dst, std::size_t frames) {
+    std::size_t i = 0;
+    for (; i + 4 <= frames; i += 4) {
+        const float32x4_t v = vld1q_f32(src + i);
+        vst2q_f32(dst + 2 * i, (float32x4x2_t{ { v, v } }));
+    }
+    dupScalar(src + i, dst + 2 * i, frames - i);
+}
+
+#endif
+
+struct KernelSet {
+    ConvertKernel convert[4]; // indexed by SampleType
+    DuplicateKernel duplicate;
+};
+
+KernelSet kernelsFor(SimdIsa isa) {
+    switch (isa) {
+#if defined(NEONWAVE_SIMD_X86)
+    case SimdIsa::AVX2:
+        return { { u8Avx2, s16Avx2, s32Avx2, f32Copy }, dupSse2 };
+    case SimdIsa::SSE2:
+        return { { u8Sse2, s16Sse2, s32Sse2, f32Copy }, dupSse2 };
+#elif defined(NEONWAVE_SIMD_NEON)
+    case SimdIsa::NEON:
+        return { { u8Neon, s16Neon, s32Neon, f32Copy }, dupNeon };
+#endif
+    default:
+        return { { u8Scalar, s16Scalar, s32Scalar, f32Copy }, dupScalar };
+    }
+}
+
+template <int Channels>
+void downmixFixed(const float* src, const DownmixMatrix& m, std::size_t frames, float* dst) {
+    // Compile-time channel count lets the compiler unroll and keep the gains in registers
+    float gl[Channels];
+    float gr[Channels];
+    for (int c = 0; c < Channels; ++c) {
+        gl[c] = m.left[c];
+        gr[c] = m.right[c];
+    }
+    for (std::size_t f = 0; f < frames; ++f) {
+        const float* in = src + f * Channels;
+        float l = 0.0f;
+        float r = 0.0f;
+        for (int c = 0; c < Channels; ++c) {
+            l += in[c] * gl[c];
+            r += in[c] * gr[c];
+        }
+        dst[2 * f] = l;
+        dst[2 * f + 1] = r;
+    }
+}
+
+void downmixToStereo(const float* src, const DownmixMatrix& m, std::size_t frames, float* dst) {
+    switch (m.channels) {
+    case 2: return downmixFixed<2>(src, m, frames, dst);
+    case 3: return downmixFixed<3>(src, m, frames, dst);
+    case 4: return downmixFixed<4>(src, m, frames, dst);
+    case 5: return downmixFixed<5>(src, m, frames, dst);
+    case 6: return downmixFixed<6>(src, m, frames, dst);
+    case 7: return downmixFixed<7>(src, m, frames, dst);
+    case 8: return downmixFixed<8>(src, m, frames, dst);
+    default: break;
+    }
+    const int ch = m.channels;
+    for (std::size_t f = 0; f < frames; ++f) {
+        const float* in = src + f * static_cast<std::size_t>(ch);
+        float l = 0.0f;
+        float r = 0.0f;
+        for (int c = 0; c < ch; ++c) {
+            l += in[c] * m.left[c];
+            r += in[c] * m.right[c];
+        }
+        dst[2 * f] = l;
+        dst[2 * f + 1] = r;
+    }
+}
+
+} // namespace
+
+const char* toString(SampleType type) {
+    switch (type) {
+    case SampleType::UInt8: return "u8";
+    case SampleType::Int16: return "s16";
+    case SampleType::Int32: return "s32";
+    case SampleType::Float: return "f32";
+    }
+    return "?";
+}
+
+// ---- DownmixMatrix ---------------------------------------------------------
+
+DownmixMatrix DownmixMatrix::passthrough(int channels) {
+    DownmixMatrix m;
+    m.channels = std::clamp(channels, 1, 2);
+    m.left[0] = 1.0f;
+    m.right[m.channels - 1] = 1.0f;
+    return m;
+}
+
+DownmixMatrix DownmixMatrix::standard(int channels, int frontLeft, int frontRight, int center,
+                                      int backLeft, int backRight, int sideLeft, int sideRight) {
+    if (channels <= 2) return passthrough(channels);
+
+    DownmixMatrix m;
+    m.channels = std::min(channels, kMaxChannels);
+    constexpr float kMinus3dB = 0.70710678f;
+    auto add = [&m](int index, float l, float r) {
+        if (index < 0 || index >= m.channels) return;
+        m.left[index] += l;
+        m.right[index] += r;
+    };
+    add(frontLeft, 1.0f, 0.0f);
+    add(frontRight, 0.0f, 1.0f);
+    add(center, kMinus3dB, kMinus3dB);
+    add(backLeft, kMinus3dB, 0.0f);
+    add(backRight, 0.0f, kMinus3dB);
+    add(sideLeft, kMinus3dB, 0.0f);
+    add(sideRight, 0.0f, kMinus3dB);
+
+    // Unknown layout: fall back to the first two channels
+    if (frontLeft < 0 && frontRight < 0) {
+        m.left[0] = 1.0f;
+        m.right[1] = 1.0f;
+    }
+
+    // Normalize so a full-scale signal on every channel cannot clip
+    float sumL = 0.0f;
+    float sumR = 0.0f;
+    for (int c = 0; c < m.channels; ++c) {
+        sumL += m.left[c];
+        sumR += m.right[c];
+    }
+    const float norm = 1.0f / std::max({ sumL, sumR, 1.0f });
+    for (int c = 0; c < m.channels; ++c) {
+        m.left[c] *= norm;
+        m.right[c] *= norm;
+    }
+    return m;
+}
+
+bool DownmixMatrix::isPassthrough() const {
+    if (channels == 1) return left[0] == 1.0f && right[0] == 1.0f;
+    return channels == 2 && left[0] == 1.0f && left[1] == 0.0f && right[0] == 0.0f && right[1] == 1.0f;
+}
+
+SampleType sampleTypeFor(const QAudioFormat& format) {
+    switch (format.sampleFormat()) {
+    case QAudioFormat::UInt8: return SampleType::UInt8;
+    case QAudioFormat::Int16: return SampleType::Int16;
+    case QAudioFormat::Int32: return SampleType::Int32;
+    default: return SampleType::Float;
+    }
+}
+
+DownmixMatrix downmixFor(const QAudioFormat& format) {
+    const int channels = format.channelCount();
+    if (channels <= 2) return DownmixMatrix::passthrough(channels);
+    return DownmixMatrix::standard(channels,
+                                   format.channelOffset(QAudioFormat::FrontLeft),
+                                   format.channelOffset(QAudioFormat::FrontRight),
+                                   format.channelOffset(QAudioFormat::FrontCenter),
+                                   format.channelOffset(QAudioFormat::BackLeft),
+                                   format.channelOffset(QAudioFormat::BackRight),
+                                   format.channelOffset(QAudioFormat::SideLeft),
+                                   format.channelOffset(QAudioFormat::SideRight));
+}
+
+// ---- SampleConverter -------------------------------------------------------
+
+SampleConverter::SampleConverter(SimdIsa isa)
+    : m_isa(isa) {}
+
+void SampleConverter::toFloat(const void* src, SampleType type, std::size_t samples, float* dst) const {
+    kernelsFor(m_isa).convert[static_cast<int>(type)](src, dst, samples);
+}
+
+void SampleConverter::toStereoFloat(const void* src, SampleType type, std::size_t frames,
+                                    const DownmixMatrix& downmix, float* dst) {
+    const auto start = std::chrono::steady_clock::now();
+    const KernelSet k = kernelsFor(m_isa);
+    const auto convert = k.convert[static_cast<int>(type)];
+    const std::size_t channels = static_cast<std::size_t>(downmix.channels);
+    const std::size_t samples = frames * channels;
+
+    if (downmix.isPassthrough() && channels == 2) {
+        convert(src, dst, samples);
+    } else {
+        // Float input can be read in place; everything else goes through scratch
+        const float* planar = static_cast<const float*>(src);
+        if (type != SampleType::Float) {
+            if (m_scratch.size() < samples) m_scratch.resize(samples);
+            convert(src, m_scratch.data(), samples);
+            planar = m_scratch.data();
+        }
+        if (downmix.isPassthrough()) {
+            k.duplicate(planar, dst, frames);
+        } else {
+            downmixToStereo(planar, downmix, frames, dst);
+        }
+    }
+
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    auto& s = m_stats[static_cast<int>(type)];
+    s.samples.fetch_add(samples, std::memory_order_relaxed);
+    s.nanoseconds.fetch_add(static_cast<std::uint64_t>(ns), std::memory_order_relaxed);
+}
+
+SampleConverter::FormatStats SampleConverter::stats(SampleType type) const {
+    const auto& s = m_stats[static_cast<int>(type)];
+    return { s.samples.load(std::memory_order_relaxed), s.nanoseconds.load(std::memory_order_relaxed) };
+}
+
+std::vector<SampleConverter::BenchmarkResult> SampleConverter::benchmark(std::size_t frames) {
+    const std::vector<SimdIsa> isas = availableIsas();
+
+    constexpr int kChannelCounts[] = { 2, 6 };
+    constexpr SampleType kTypes[] = { SampleType::UInt8, SampleType::Int16, SampleType::Int32, SampleType::Float };
+    constexpr int kRepeats = 8;
+
+    std::mt19937 rng(1234);
+    std::vector<std::uint8_t> input(frames * 6 * sizeof(float));
+    for (auto& b : input) b = static_cast<std::uint8_t>(rng());
+    // Keep float input finite: overwrite with real samples where it is read as float
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    auto* asFloat = reinterpret_cast<float*>(input.data());
+    std::vector<float> output(frames * 2);
+
+    std::vector<BenchmarkResult> results;
+    for (const SimdIsa isa : isas) {
+        SampleConverter converter(isa);
+        for (const int channels : kChannelCounts) {
+            const DownmixMatrix m = channels == 2
+                ? DownmixMatrix::passthrough(2)
+                : DownmixMatrix::standard(6, 0, 1, 2, 4, 5, -1, -1);
+            for (const SampleType type : kTypes) {
+                if (type == SampleType::Float) {
+                    for (std::size_t i = 0; i < frames * 6; ++i) asFloat[i] = dist(rng);
+                }
+                converter.toStereoFloat(input.data(), type, frames, m, output.data()); // warm-up
+                const auto start = std::chrono::steady_clock::now();
+                for (int r = 0; r < kRepeats; ++r) {
+                    converter.toStereoFloat(input.data(), type, frames, m, output.data());
+                }
+                const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                const double samples = static_cast<double>(frames) * channels * kRepeats;
+                results.push_back({ isa, type, channels, seconds > 0.0 ? samples / seconds : 0.0 });
+            }
+        }
+    }
+    return results;
+}
+
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "SimdIsa.h"
+
+class QAudioFormat;
+
+namespace NeonWave::Core::Audio {
+
+enum class SampleType { UInt8, Int16, Int32, Float };
+
+const char* toString(SampleType type);
+
+/**
+ * @brief Per-channel contribution to the left/right output of a downmix.
+ *
+ * Built by the caller from whatever channel layout description it has
+ * (e.g. QAudioFormat::channelOffset); see DownmixMatrix::standard for the
+ * ITU-R BS.775 defaults.
+ */
+struct DownmixMatrix {
+    static constexpr int kMaxChannels = 16;
+
+    int channels = 2;
+    std::array<float, kMaxChannels> left{};
+    std::array<float, kMaxChannels> right{};
+
+    /// Mono is duplicated, stereo passes through.
+    static DownmixMatrix passthrough(int channels);
+
+    /// Fold front/centre/surround/side channels at given indices (-1 = absent); LFE is dropped.
+    static DownmixMatrix standard(int channels, int frontLeft, int frontRight, int center,
+                                  int backLeft, int backRight, int sideLeft, int sideRight);
+
+    bool isPassthrough() const;
+};
+
+/// Sample type of a Qt Multimedia buffer; anything but u8/s16/s32 is read as float.
+SampleType sampleTypeFor(const QAudioFormat& format);
+
+/// Downmix for a Qt Multimedia buffer's channel layout (QAudioFormat::channelOffset).
+DownmixMatrix downmixFor(const QAudioFormat& format);
+
+/**
+ * @brief Normalizes any integer/float interleaved PCM to interleaved float stereo.
+ *
+ * The sample-type kernels are vectorized (SSE2/AVX2 on x86-64, NEON on ARM)
+ * and the widest one the CPU supports is picked once at construction.
+ * Convert calls never allocate once the scratch buffer has grown to the
+ * largest block seen.
+ */
+class SampleConverter {
+public:
+    struct FormatStats {
+        std::uint64_t samples = 0;
+        std::uint64_t nanoseconds = 0;
+        double samplesPerSecond() const { return nanoseconds ? samples * 1e9 / nanoseconds : 0.0; }
+    };
+
+    struct BenchmarkResult {
+        SimdIsa isa;
+        SampleType type;
+        int channels;
+        double samplesPerSecond;
+    };
+
+    explicit SampleConverter(SimdIsa isa = detectIsa());
+
+    SimdIsa isa() const { return m_isa; }
+
+    /**
+     * @brief Convert interleaved input to interleaved float stereo
+     * @param src Interleaved samples of @p type
+     * @param frames Frame count
+     * @param downmix Channel layout of @p src
+     * @param dst Receives frames * 2 floats
+     */
+    void toStereoFloat(const void* src, SampleType type, std::size_t frames,
+                       const DownmixMatrix& downmix, float* dst);
+
+    /// Sample-type conversion only: @p samples values in, same count of floats in [-1, 1) out.
+    void toFloat(const void* src, SampleType type, std::size_t samples, float* dst) const;
+
+    /// Cumulative throughput of toStereoFloat, indexed by SampleType.
+    FormatStats stats(SampleType type) const;
+
+    /// Time every kernel available on this CPU over @p frames of synthetic input.
+    static std::vector<BenchmarkResult> benchmark(std::size_t frames = 1 << 20);
+
+private:
+    SimdIsa m_isa;
+    std::vector<float> m_scratch;
+
+    struct AtomicStats {
+        std::atomic<std::uint64_t> samples{0};
+        std::atomic<std::uint64_t> nanoseconds{0};
+    };
+    std::array<AtomicStats, 4> m_stats;
+};
+
+}
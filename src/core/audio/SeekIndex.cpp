@@ -0,0 +1,21 @@
+#include "SeekIndex.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace NeonWave::Core::Audio {
+
+SeekIndex::SeekIndex(int sampleRate, std::int64_t frames, std::vector<SeekPoint> points)
+    : m_sampleRate(sampleRate)
+    , m_frames(frames)
+    , m_points(std::move(points))
+{
+}
+
+const SeekPoint* SeekIndex::pointAtOrBefore(std::int64_t frame) const {
+    const auto it = std::upper_bound(m_points.begin(), m_points.end(), frame,
+                                     [](std::int64_t f, const SeekPoint& p) { return f < p.frame; });
+    return it == m_points.begin() ? nullptr : &*(it - 1);
+}
+
+}
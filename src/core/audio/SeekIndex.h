@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace NeonWave::Core::Audio {
+
+/// Stream position of a packet boundary: the first sample frame it decodes to, and where it starts in the file.
+struct SeekPoint {
+    std::int64_t frame;
+    std::int64_t bytePos;
+};
+
+/**
+ * @brief Frame-to-byte table of one file, one entry per kIntervalSeconds.
+ *
+ * Built from a single demux pass (see scanSeekIndex()), so the frame
+ * numbers are exact even for streams whose container has no index of its
+ * own, such as VBR mp3, where the demuxer can only guess timestamps after a
+ * seek. A decoder holding one byte-seeks to the entry before the target and
+ * counts decoded frames from the entry's frame instead of trusting those
+ * guesses, which bounds both the cost and the error of a seek.
+ */
+class SeekIndex {
+public:
+    static constexpr double kIntervalSeconds = 1.0;
+
+    SeekIndex(int sampleRate, std::int64_t frames, std::vector<SeekPoint> points);
+
+    int sampleRate() const { return m_sampleRate; }
+    /// Frames the whole stream decodes to, with encoder delay and end padding trimmed.
+    std::int64_t frames() const { return m_frames; }
+    /// Ascending by frame (and byte position). The first is the first packet, before frame 0 if it carries encoder delay.
+    const std::vector<SeekPoint>& points() const { return m_points; }
+
+    /// Last entry at or before @p frame; null if the first entry is already past it.
+    const SeekPoint* pointAtOrBefore(std::int64_t frame) const;
+
+private:
+    int m_sampleRate;
+    std::int64_t m_frames;
+    std::vector<SeekPoint> m_points;
+};
+
+}
@@ -0,0 +1,145 @@
+#include "SeekIndexCache.h"
+#include "FileDecoder.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+namespace NeonWave::Core::Audio {
+
+namespace {
+
+constexpr DiskCache::Format kFormat = { "SeekIndexCache", { 'N', 'W', 'S', 'E', 'E', 'K', 'I', 'X' }, 3, ".nws" };
+constexpr std::size_t kMaxLoaded = 16;
+
+/// On-disk header; the SeekPoints follow immediately as native-endian int64 pairs.
+struct SeekIndexHeader {
+    DiskCache::FileHeader common;
+    std::uint32_t sampleRate;
+    std::uint32_t intervalMs;
+    std::int64_t frames;
+};
+static_assert(sizeof(SeekIndexHeader) == 64, "SeekIndexHeader layout is part of the file format");
+static_assert(sizeof(SeekPoint) == 16, "SeekPoint layout is part of the file format");
+
+std::uint32_t intervalMs() {
+    return static_cast<std::uint32_t>(SeekIndex::kIntervalSeconds * 1000.0);
+}
+
+} // namespace
+
+SeekIndexCache::SeekIndexCache(std::filesystem::path directory)
+    : m_disk(std::move(directory), kFormat)
+{
+    m_disk.start([this](const QString& path) { process(path); });
+}
+
+SeekIndexCache::~SeekIndexCache() {
+    m_disk.stop();
+}
+
+void SeekIndexCache::request(const QString& path) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_notNeeded.contains(path)) return;
+        for (const auto& entry : m_loaded) {
+            if (entry.first == path) return;
+        }
+    }
+    m_disk.request(path); // the track just opened is the one about to be seeked in
+}
+
+std::shared_ptr<const SeekIndex> SeekIndexCache::lookup(const QString& path) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& [loadedPath, index] : m_loaded) {
+        if (loadedPath == path) return index;
+    }
+    return nullptr;
+}
+
+SeekIndexCache::Stats SeekIndexCache::stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void SeekIndexCache::process(const QString& path) {
+    auto index = load(path);
+    if (index) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_loaded.remove_if([&path](const auto& entry) { return entry.first == path; });
+        m_loaded.emplace_front(path, std::move(index));
+        if (m_loaded.size() > kMaxLoaded) m_loaded.pop_back();
+    }
+}
+
+std::shared_ptr<const SeekIndex> SeekIndexCache::read(const QString& file, const QByteArray& key) const {
+    const auto mapped = DiskCache::map(file, kFormat, key, sizeof(SeekIndexHeader));
+    if (!mapped) return nullptr;
+
+    SeekIndexHeader header;
+    std::memcpy(&header, mapped->data, sizeof(header));
+    const std::size_t pointBytes = mapped->size - sizeof(SeekIndexHeader);
+    const bool current = header.intervalMs == intervalMs()
+        && header.sampleRate > 0
+        && pointBytes % sizeof(SeekPoint) == 0;
+    if (!current) return nullptr;
+
+    // Copied out: the table is small and SeekIndex outlives any mapping
+    std::vector<SeekPoint> points(pointBytes / sizeof(SeekPoint));
+    std::memcpy(points.data(), mapped->data + sizeof(SeekIndexHeader), pointBytes);
+    return std::make_shared<SeekIndex>(static_cast<int>(header.sampleRate), header.frames, std::move(points));
+}
+
+bool SeekIndexCache::write(const QString& file, const QByteArray& key, const SeekIndex& index) const {
+    SeekIndexHeader header{};
+    header.common = DiskCache::header(kFormat, key);
+    header.sampleRate = static_cast<std::uint32_t>(index.sampleRate());
+    header.intervalMs = intervalMs();
+    header.frames = index.frames();
+    return DiskCache::write(file, kFormat, &header, sizeof(header),
+                            index.points().data(), index.points().size() * sizeof(SeekPoint));
+}
+
+std::shared_ptr<const SeekIndex> SeekIndexCache::load(const QString& path) {
+    const QByteArray key = DiskCache::keyFor(path);
+    if (key.isEmpty()) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_stats.failures;
+        return nullptr;
+    }
+    const QString file = m_disk.fileFor(key);
+    if (auto hit = read(file, key)) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_stats.hits;
+        return hit;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const SeekScanResult scan = scanSeekIndex(path, [cancel = m_disk.cancelFlag()]() {
+        return !cancel->load(std::memory_order_relaxed);
+    });
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (scan.index) {
+        write(file, key, *scan.index); // still usable for this session if the write fails
+    } else if (scan.needed && !scan.error.isEmpty()) {
+        std::cerr << "[SeekIndexCache] " << path.toStdString() << ": " << scan.error.toStdString() << std::endl;
+    }
+
+    // lookup() runs on the audio thread, so nothing above happens under this lock
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.wallSeconds += seconds;
+    if (!scan.needed) {
+        m_notNeeded.insert(path);
+        ++m_stats.notNeeded;
+        return nullptr;
+    }
+    if (!scan.index) {
+        ++m_stats.failures;
+        return nullptr;
+    }
+    ++m_stats.built;
+    m_stats.points += scan.index->points().size();
+    return scan.index;
+}
+
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QByteArray>
+#include <QSet>
+#include <QString>
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include "DiskCache.h"
+#include "SeekIndex.h"
+
+namespace NeonWave::Core::Audio {
+
+/**
+ * @brief Seek indexes of played tracks, built in the background and kept on disk.
+ *
+ * Works like WaveformCache: request() puts a track at the front of the
+ * DiskCache worker's queue, which loads its index file if there is a current
+ * one and otherwise scans the track with scanSeekIndex() and writes one.
+ * Files live in one directory (normally Application::getDataPath()/seek) and
+ * are keyed by the track's contents. Tracks whose container already seeks
+ * exactly are remembered as such and never scanned.
+ *
+ * lookup() never does I/O, so the audio thread can call it on every seek.
+ */
+class SeekIndexCache {
+public:
+    struct Stats {
+        std::uint64_t hits = 0;
+        std::uint64_t built = 0;
+        std::uint64_t notNeeded = 0; ///< Containers with exact seeking of their own
+        std::uint64_t failures = 0;
+        std::uint64_t points = 0;    ///< Entries across every index built
+        double wallSeconds = 0.0;    ///< Time spent scanning
+    };
+
+    explicit SeekIndexCache(std::filesystem::path directory);
+    ~SeekIndexCache();
+
+    /// Make @p path's index available through lookup() as soon as possible.
+    void request(const QString& path);
+    /// Index of @p path if it is loaded already; never blocks on I/O.
+    std::shared_ptr<const SeekIndex> lookup(const QString& path) const;
+
+    Stats stats() const;
+
+private:
+    /// Worker job for a requested track.
+    void process(const QString& path);
+    std::shared_ptr<const SeekIndex> load(const QString& path);
+    std::shared_ptr<const SeekIndex> read(const QString& file, const QByteArray& key) const;
+    bool write(const QString& file, const QByteArray& key, const SeekIndex& index) const;
+
+    mutable std::mutex m_mutex;              // guards m_loaded, m_notNeeded and m_stats
+    std::list<std::pair<QString, std::shared_ptr<const SeekIndex>>> m_loaded; // most recent first
+    QSet<QString> m_notNeeded;
+    Stats m_stats;
+
+    DiskCache m_disk;                        // last: its worker uses everything above
+};
+
+}
@@ -0,0 +1,40 @@
+#include "SimdIsa.h"
+
+namespace NeonWave::Core::Audio {
+
+const char* toString(SimdIsa isa) {
+    switch (isa) {
+    case SimdIsa::Scalar: return "scalar";
+    case SimdIsa::SSE2: return "sse2";
+    case SimdIsa::AVX2: return "avx2";
+    case SimdIsa::NEON: return "neon";
+    }
+    return "?";
+}
+
+SimdIsa detectIsa() {
+#if defined(NEONWAVE_SIMD_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return SimdIsa::AVX2;
+    if (__builtin_cpu_supports("sse2")) return SimdIsa::SSE2;
+    return SimdIsa::Scalar;
+#elif defined(NEONWAVE_SIMD_NEON)
+    return SimdIsa::NEON;
+#else
+    return SimdIsa::Scalar;
+#endif
+}
+
+std::vector<SimdIsa> availableIsas() {
+    std::vector<SimdIsa> isas{ SimdIsa::Scalar };
+    const SimdIsa best = detectIsa();
+#if defined(NEONWAVE_SIMD_X86)
+    if (best == SimdIsa::SSE2 || best == SimdIsa::AVX2) isas.push_back(SimdIsa::SSE2);
+    if (best == SimdIsa::AVX2) isas.push_back(SimdIsa::AVX2);
+#else
+    if (best != SimdIsa::Scalar) isas.push_back(best);
+#endif
+    return isas;
+}
+
+}
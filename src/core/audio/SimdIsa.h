@@ -0,0 +1,27 @@
+#pragma once
+
+#include <vector>
+
+// Kernel family this build carries; AVX2 kernels are compiled per function with target attributes
+#if defined(__x86_64__) || defined(__i386__)
+#define NEONWAVE_SIMD_X86 1
+#include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(__aarch64__)
+#define NEONWAVE_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace NeonWave::Core::Audio {
+
+/// Instruction set a DSP kernel was built for.
+enum class SimdIsa { Scalar, SSE2, AVX2, NEON };
+
+const char* toString(SimdIsa isa);
+
+/// Best ISA the running CPU supports.
+SimdIsa detectIsa();
+
+/// Every ISA the running CPU can run a kernel for, Scalar first and detectIsa() last; what the benchmarks compare.
+std::vector<SimdIsa> availableIsas();
+
+}
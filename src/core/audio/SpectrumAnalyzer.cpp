@@ -0,0 +1,343 @@
+#include "SpectrumAnalyzer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+namespace NeonWave::Core::Audio {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+static_assert(SpectrumFrame::kMaxBins == SpectrumAnalyzer::kMaxFftSize / 2 + 1,
+              "SpectrumFrame must hold the bins of the largest FFT");
+
+/// Copy the part of @p from that is in use; the arrays are sized for the largest FFT.
+void copyFrame(const SpectrumFrame& from, SpectrumFrame& to) {
+    to.sequence = from.sequence;
+    to.streamFrame = from.streamFrame;
+    to.sampleRate = from.sampleRate;
+    to.fftSize = from.fftSize;
+    to.binCount = from.binCount;
+    to.bandCount = from.bandCount;
+    to.binHz = from.binHz;
+    to.rms = from.rms;
+    std::copy_n(from.magnitudes.begin(), from.binCount, to.magnitudes.begin());
+    std::copy_n(from.bands.begin(), from.bandCount, to.bands.begin());
+    std::copy_n(from.bandEdgesHz.begin(), from.bandCount + 1, to.bandEdgesHz.begin());
+}
+
+} // namespace
+
+// ---- Analysis ----------------------------------------------------------
+
+SpectrumAnalyzer::Analysis::Analysis(const Settings& settings, std::uint32_t sampleRate)
+    : m_fft(settings.fftSize)
+    , m_sampleRate(sampleRate)
+    , m_window(Fft(settings.fftSize).hannWindow())
+    , m_bins(m_fft.bins())
+    , m_bandCount(settings.bands)
+{
+    double windowSum = 0.0;
+    for (float w : m_window) windowSum += w;
+    m_scale = static_cast<float>(2.0 / windowSum);
+
+    const double binHz = static_cast<double>(sampleRate) / settings.fftSize;
+    const double maxHz = std::min(settings.maxHz, sampleRate / 2.0);
+    const double minHz = std::min(settings.minHz, maxHz / 2.0);
+    const double ratio = std::pow(maxHz / minHz, 1.0 / m_bandCount);
+    for (int b = 0; b <= m_bandCount; ++b) {
+        m_bandEdgesHz[b] = static_cast<float>(minHz * std::pow(ratio, b));
+    }
+    for (int b = 0; b < m_bandCount; ++b) {
+        const double lo = m_bandEdgesHz[b];
+        const double hi = m_bandEdgesHz[b + 1];
+        int first = static_cast<int>(std::ceil(lo / binHz));
+        int end = static_cast<int>(std::ceil(hi / binHz));
+        if (end <= first) {
+            // Narrower than a bin, which low bands of a short FFT are: take the bin nearest its centre
+            first = static_cast<int>(std::lround(std::sqrt(lo * hi) / binHz));
+            end = first + 1;
+        }
+        m_bandFirst[b] = std::clamp(first, 0, m_fft.bins() - 1);
+        m_bandEnd[b] = std::clamp(end, m_bandFirst[b] + 1, m_fft.bins());
+    }
+}
+
+void SpectrumAnalyzer::Analysis::run(const float* window, int hopFrames, SpectrumFrame& out) {
+    const int size = m_fft.size();
+    const int bins = m_fft.bins();
+    m_fft.forward(window, m_window.data(), m_bins.data());
+
+    out.sampleRate = m_sampleRate;
+    out.fftSize = size;
+    out.binCount = bins;
+    out.bandCount = m_bandCount;
+    out.binHz = static_cast<float>(m_sampleRate) / size;
+    for (int k = 0; k < bins; ++k) {
+        // Not std::abs, which goes through hypot's overflow-safe path
+        const float re = m_bins[k].real();
+        const float im = m_bins[k].imag();
+        out.magnitudes[k] = std::sqrt(re * re + im * im) * m_scale;
+    }
+    // DC and Nyquist have no mirror image to share their energy with
+    out.magnitudes[0] *= 0.5f;
+    out.magnitudes[bins - 1] *= 0.5f;
+
+    for (int b = 0; b < m_bandCount; ++b) {
+        float sum = 0.0f;
+        for (int k = m_bandFirst[b]; k < m_bandEnd[b]; ++k) sum += out.magnitudes[k] * out.magnitudes[k];
+        out.bands[b] = std::sqrt(sum / static_cast<float>(m_bandEnd[b] - m_bandFirst[b]));
+    }
+    std::copy_n(m_bandEdgesHz.begin(), m_bandCount + 1, out.bandEdgesHz.begin());
+
+    const int recent = std::min(hopFrames, size);
+    float energy = 0.0f;
+    for (int i = size - recent; i < size; ++i) energy += window[i] * window[i];
+    out.rms = std::sqrt(energy / static_cast<float>(recent));
+}
+
+// ---- SpectrumAnalyzer --------------------------------------------------
+
+SpectrumAnalyzer::SpectrumAnalyzer(const std::shared_ptr<AudioBlockBus>& bus,
+                                   std::shared_ptr<const PlaybackClock> clock,
+                                   const Settings& settings)
+    : m_input(bus ? bus->subscribe("spectrum") : nullptr)
+    , m_clock(std::move(clock))
+    , m_active(clamped(settings))
+    , m_ring(kRingFrames, 0.0f)
+    , m_windowSamples(kMaxFftSize, 0.0f)
+    , m_settings(m_active)
+{
+    m_thread = std::thread([this]() { run(); });
+}
+
+SpectrumAnalyzer::~SpectrumAnalyzer() {
+    m_stop.store(true, std::memory_order_relaxed);
+    if (m_thread.joinable()) m_thread.join();
+}
+
+void SpectrumAnalyzer::setSource(const std::shared_ptr<AudioBlockBus>& bus, std::shared_ptr<const PlaybackClock> clock) {
+    auto input = bus ? bus->subscribe("spectrum") : nullptr;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pendingInput = std::move(input);
+    m_pendingClock = std::move(clock);
+    m_sourceChanged = true;
+}
+
+void SpectrumAnalyzer::configure(const Settings& settings) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_settings = clamped(settings);
+    m_settingsChanged = true;
+}
+
+SpectrumAnalyzer::Settings SpectrumAnalyzer::settings() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_settings;
+}
+
+std::shared_ptr<SpectrumAnalyzer::Feed> SpectrumAnalyzer::subscribe() {
+    auto feed = std::make_shared<Feed>();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_feeds.push_back(feed);
+    return feed;
+}
+
+SpectrumAnalyzer::Stats SpectrumAnalyzer::stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+SpectrumAnalyzer::Settings SpectrumAnalyzer::clamped(Settings settings) {
+    int size = kMinFftSize;
+    while (size * 2 <= std::min(settings.fftSize, kMaxFftSize)) size *= 2;
+    settings.fftSize = size;
+    settings.hopFrames = std::clamp(settings.hopFrames, 32, size);
+    settings.bands = std::clamp(settings.bands, 1, SpectrumFrame::kMaxBands);
+    settings.minHz = std::max(settings.minHz, 1.0);
+    settings.maxHz = std::max(settings.maxHz, settings.minHz * 2.0);
+    return settings;
+}
+
+void SpectrumAnalyzer::run() {
+    AudioBlockRef block;
+    while (!m_stop.load(std::memory_order_relaxed)) {
+        adoptPending();
+        if (m_input) {
+            while (m_input->pop(block)) {
+                push(*block.get());
+                block.reset();
+            }
+            analyseDueHops();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(kPollMs));
+    }
+}
+
+void SpectrumAnalyzer::adoptPending() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_sourceChanged) {
+        m_input = std::move(m_pendingInput);
+        m_clock = std::move(m_pendingClock);
+        m_sourceChanged = false;
+        m_sampleRate = 0; // the first block from the new source restarts the window
+    }
+    if (m_settingsChanged) {
+        m_active = m_settings;
+        m_settingsChanged = false;
+        m_analysis.reset();
+        m_nextHopEnd = m_nextFrame; // keep the history, restart the hop grid
+    }
+
+    m_feeds.erase(std::remove_if(m_feeds.begin(), m_feeds.end(),
+                                 [](const std::weak_ptr<Feed>& feed) { return feed.expired(); }),
+                  m_feeds.end());
+    m_publishTo.clear();
+    for (const auto& weak : m_feeds) {
+        if (auto feed = weak.lock()) m_publishTo.push_back(std::move(feed));
+    }
+    m_stats.feeds = m_publishTo.size();
+}
+
+void SpectrumAnalyzer::resetStream(std::uint64_t streamFrame, std::uint32_t sampleRate) {
+    if (sampleRate != m_sampleRate) m_analysis.reset();
+    m_sampleRate = sampleRate;
+    m_firstFrame = streamFrame;
+    m_nextFrame = streamFrame;
+    m_nextHopEnd = streamFrame + static_cast<std::uint64_t>(m_active.hopFrames);
+}
+
+void SpectrumAnalyzer::push(const AudioBlock& block) {
+    if (block.sampleRate != m_sampleRate || block.streamFrame != m_nextFrame) {
+        if (m_sampleRate != 0) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_stats.discontinuities;
+        }
+        resetStream(block.streamFrame, block.sampleRate);
+    }
+    constexpr std::size_t mask = kRingFrames - 1;
+    for (std::uint32_t i = 0; i < block.frames; ++i) {
+        m_ring[(block.streamFrame + i) & mask] = 0.5f * (block.samples[2 * i] + block.samples[2 * i + 1]);
+    }
+    m_nextFrame = block.streamFrame + block.frames;
+}
+
+void SpectrumAnalyzer::analyseDueHops() {
+    if (m_sampleRate == 0) return;
+    if (!m_analysis) m_analysis = std::make_unique<Analysis>(m_active, m_sampleRate);
+    const auto size = static_cast<std::uint64_t>(m_analysis->fftSize());
+    const auto hop = static_cast<std::uint64_t>(m_active.hopFrames);
+
+    std::uint64_t skipped = 0;
+    std::uint64_t limit = m_nextFrame; // last hop end we have samples for
+    if (m_clock) {
+        const PlaybackClock::Sample clock = m_clock->sample();
+        if (clock.flushedFrame > m_nextHopEnd) {
+            const std::uint64_t unheard = (clock.flushedFrame - m_nextHopEnd + hop - 1) / hop;
+            m_nextHopEnd += unheard * hop;
+            skipped += unheard;
+        }
+        // Due once the centre of the window is being heard
+        limit = std::min(limit, m_clock->audibleFrame() + size / 2);
+    }
+    if (limit >= m_nextHopEnd + kMaxCatchUpHops * hop) {
+        const std::uint64_t stale = (limit - m_nextHopEnd) / hop;
+        m_nextHopEnd += stale * hop;
+        skipped += stale;
+    }
+
+    while (m_nextHopEnd <= limit) {
+        if (m_nextHopEnd + kRingFrames >= m_nextFrame + size) {
+            publish(m_nextHopEnd);
+        } else {
+            ++skipped; // window already overwritten in the ring
+        }
+        m_nextHopEnd += hop;
+    }
+    if (skipped) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats.skippedHops += skipped;
+    }
+}
+
+void SpectrumAnalyzer::publish(std::uint64_t hopEnd) {
+    const auto start = std::chrono::steady_clock::now();
+    const int size = m_analysis->fftSize();
+    // Signed, as a window can reach back past frame 0 right after a reset
+    const std::int64_t first = static_cast<std::int64_t>(hopEnd) - size;
+    const auto firstKept = static_cast<std::int64_t>(m_firstFrame);
+    constexpr std::size_t mask = kRingFrames - 1;
+    for (int i = 0; i < size; ++i) {
+        const std::int64_t frame = first + i;
+        m_windowSamples[i] = frame < firstKept ? 0.0f : m_ring[static_cast<std::size_t>(frame) & mask];
+    }
+    m_analysis->run(m_windowSamples.data(), m_active.hopFrames, m_frame);
+    m_frame.sequence = ++m_sequence;
+    m_frame.streamFrame = hopEnd - static_cast<std::uint64_t>(size / 2);
+
+    for (const auto& feed : m_publishTo) {
+        copyFrame(m_frame, feed->m_buffer.back());
+        feed->m_buffer.publish();
+    }
+
+    m_hopSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    m_audioSeconds += static_cast<double>(m_active.hopFrames) / m_sampleRate;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_stats.hops;
+    m_stats.meanHopUs = 1e6 * m_hopSeconds / static_cast<double>(m_stats.hops);
+    m_stats.load = m_hopSeconds / m_audioSeconds;
+}
+
+std::vector<SpectrumAnalyzer::BenchmarkResult> SpectrumAnalyzer::benchmark(const std::vector<int>& fftSizes) {
+    std::vector<BenchmarkResult> results;
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> noise(-0.25f, 0.25f);
+
+    for (int requested : fftSizes) {
+        Settings settings;
+        settings.fftSize = requested;
+        settings = clamped(settings);
+        const int size = settings.fftSize;
+        const int iterations = std::max(256, (1 << 23) / size);
+
+        std::vector<float> signal(size);
+        for (int i = 0; i < size; ++i) {
+            signal[i] = 0.5f * static_cast<float>(std::sin(2.0 * kPi * 1000.0 * i / 48000.0)) + noise(rng);
+        }
+        Fft complexFft(size);
+        RealFft realFft(size);
+        const std::vector<float> window = complexFft.hannWindow();
+        std::vector<std::complex<float>> full(size);
+        std::vector<std::complex<float>> half(realFft.bins());
+
+        auto timePerSecond = [iterations](auto&& body) {
+            const auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < iterations; ++i) body();
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            return iterations / std::max(seconds, 1e-9);
+        };
+
+        BenchmarkResult result{};
+        result.fftSize = size;
+        result.complexPerSecond = timePerSecond([&]() { complexFft.forwardReal(signal.data(), window.data(), full.data()); });
+        result.realPerSecond = timePerSecond([&]() { realFft.forward(signal.data(), window.data(), half.data()); });
+
+        Analysis analysis(settings, 48000);
+        auto frame = std::make_unique<SpectrumFrame>();
+        result.hopsPerSecond = timePerSecond([&]() { analysis.run(signal.data(), settings.hopFrames, *frame); });
+
+        float peak = 0.0f;
+        float error = 0.0f;
+        for (int k = 0; k < realFft.bins(); ++k) {
+            peak = std::max(peak, std::abs(full[k]));
+            error = std::max(error, std::abs(full[k] - half[k]));
+        }
+        result.maxError = peak > 0.0f ? error / peak : 0.0;
+        results.push_back(result);
+    }
+    return results;
+}
+
+}
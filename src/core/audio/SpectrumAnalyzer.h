@@ -0,0 +1,183 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <complex>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "AudioBlockBus.h"
+#include "Fft.h"
+#include "PlaybackClock.h"
+#include "TripleBuffer.h"
+
+namespace NeonWave::Core::Audio {
+
+/// One analysed hop, as published by SpectrumAnalyzer.
+struct SpectrumFrame {
+    static constexpr int kMaxBins = 8192 / 2 + 1;
+    static constexpr int kMaxBands = 64;
+
+    std::uint64_t sequence = 0;    ///< Hops published since the analyzer started; 0 = nothing yet
+    std::uint64_t streamFrame = 0; ///< Stream frame at the centre of the window
+    std::uint32_t sampleRate = 0;
+    int fftSize = 0;
+    int binCount = 0;              ///< fftSize / 2 + 1, DC to Nyquist
+    int bandCount = 0;
+    float binHz = 0.0f;
+    float rms = 0.0f;              ///< RMS of the mono mix over the last hop
+    std::array<float, kMaxBins> magnitudes{};      ///< Linear amplitude per bin; a full-scale sine reads 1
+    std::array<float, kMaxBands> bands{};          ///< RMS of the bin magnitudes in each band, same scale
+    std::array<float, kMaxBands + 1> bandEdgesHz{}; ///< Band b spans [bandEdgesHz[b], bandEdgesHz[b + 1])
+};
+
+/**
+ * @brief One FFT of the playing stream, shared by every consumer that needs a spectrum.
+ *
+ * Subscribes to a PCM bus as "spectrum" and, on its own thread, takes a
+ * Hann-windowed real FFT of the mono mix every hopFrames frames. With a
+ * PlaybackClock a hop is analysed only once the centre of its window is
+ * audible, so the spectrum matches the speakers rather than the decoder,
+ * which runs ahead by the output buffer; without one, hops are analysed as
+ * soon as their samples arrive. If the thread falls more than
+ * kMaxCatchUpHops behind it skips to the newest window instead of
+ * replaying stale ones.
+ *
+ * Results are handed out through subscribe(): each Feed is a TripleBuffer,
+ * so its reader — a render thread inside paintGL, a UI timer — gets the
+ * newest complete SpectrumFrame without locks or waiting, and a reader
+ * that is slow or stops reading costs the analysis nothing. Consumers
+ * should read bands and magnitudes here instead of running FFTs of their
+ * own.
+ */
+class SpectrumAnalyzer {
+public:
+    static constexpr int kMinFftSize = 256;
+    static constexpr int kMaxFftSize = 8192;
+    static constexpr int kPollMs = 5;
+    static constexpr int kMaxCatchUpHops = 8;
+
+    struct Settings {
+        int fftSize = 2048;     ///< Power of two in [kMinFftSize, kMaxFftSize]
+        int hopFrames = 512;    ///< Frames between analyses, at most fftSize
+        int bands = 32;         ///< Log-spaced bands, at most SpectrumFrame::kMaxBands
+        double minHz = 30.0;
+        double maxHz = 16000.0; ///< Clamped to Nyquist
+    };
+
+    /// Read side of one consumer. Only one thread may read a given Feed.
+    class Feed {
+    public:
+        /// Adopt the newest spectrum if one arrived; returns whether latest() changed.
+        bool update() { return m_buffer.update(); }
+        const SpectrumFrame& latest() const { return m_buffer.front(); }
+
+    private:
+        friend class SpectrumAnalyzer;
+        TripleBuffer<SpectrumFrame> m_buffer;
+    };
+
+    struct Stats {
+        std::uint64_t hops = 0;
+        std::uint64_t skippedHops = 0;      ///< Left out to catch up, or discarded unheard
+        std::uint64_t discontinuities = 0;  ///< Stream gaps and rate changes that restarted the window
+        double meanHopUs = 0.0;             ///< Analysis plus publication, per hop
+        double load = 0.0;                  ///< Analysis time per second of audio analysed
+        std::size_t feeds = 0;
+    };
+
+    struct BenchmarkResult {
+        int fftSize;
+        double complexPerSecond; ///< Fft::forwardReal, the full-size complex transform
+        double realPerSecond;    ///< RealFft::forward
+        double hopsPerSecond;    ///< Whole hop: window, RealFft, magnitudes and bands
+        double maxError;         ///< Largest bin difference between the two transforms, relative to the peak
+    };
+
+    SpectrumAnalyzer(const std::shared_ptr<AudioBlockBus>& bus,
+                     std::shared_ptr<const PlaybackClock> clock,
+                     const Settings& settings);
+    ~SpectrumAnalyzer();
+
+    SpectrumAnalyzer(const SpectrumAnalyzer&) = delete;
+    SpectrumAnalyzer& operator=(const SpectrumAnalyzer&) = delete;
+
+    /// Follow another bus, e.g. when the visualizer switches input; the window restarts.
+    void setSource(const std::shared_ptr<AudioBlockBus>& bus, std::shared_ptr<const PlaybackClock> clock);
+    /// New analysis settings, clamped to what is supported; applied before the next hop.
+    void configure(const Settings& settings);
+    Settings settings() const;
+
+    /// New consumer; dropping the returned pointer unsubscribes it.
+    std::shared_ptr<Feed> subscribe();
+
+    Stats stats() const;
+
+    /// Time both transforms and whole hops at each supported size, on @p fftSizes.
+    static std::vector<BenchmarkResult> benchmark(const std::vector<int>& fftSizes = { 512, 1024, 2048, 4096, 8192 });
+
+private:
+    /// Per-hop maths for one settings/rate combination; no threads, no allocation in run().
+    class Analysis {
+    public:
+        Analysis(const Settings& settings, std::uint32_t sampleRate);
+        int fftSize() const { return m_fft.size(); }
+        /// Analyse fftSize() mono samples; fills everything in @p out but sequence and streamFrame.
+        void run(const float* window, int hopFrames, SpectrumFrame& out);
+
+    private:
+        RealFft m_fft;
+        std::uint32_t m_sampleRate;
+        std::vector<float> m_window;
+        std::vector<std::complex<float>> m_bins;
+        float m_scale;                                  // bin magnitude of a unit sine, inverted
+        int m_bandCount;
+        std::array<int, SpectrumFrame::kMaxBands> m_bandFirst{};        // bins [first, end) of each band
+        std::array<int, SpectrumFrame::kMaxBands> m_bandEnd{};
+        std::array<float, SpectrumFrame::kMaxBands + 1> m_bandEdgesHz{};
+    };
+
+    static Settings clamped(Settings settings);
+    void run();
+    void adoptPending();
+    void resetStream(std::uint64_t streamFrame, std::uint32_t sampleRate);
+    void push(const AudioBlock& block);
+    void analyseDueHops();
+    void publish(std::uint64_t hopEnd);
+
+    // Mono history, indexed by stream frame modulo kRingFrames
+    static constexpr std::size_t kRingFrames = std::size_t(1) << 17;
+
+    std::thread m_thread;
+    std::atomic<bool> m_stop{false};
+
+    // Everything below up to the mutex belongs to the analysis thread
+    std::shared_ptr<AudioBlockBus::Subscription> m_input;
+    std::shared_ptr<const PlaybackClock> m_clock;
+    Settings m_active;
+    std::unique_ptr<Analysis> m_analysis;
+    std::vector<float> m_ring;
+    std::vector<float> m_windowSamples;
+    std::uint32_t m_sampleRate = 0;
+    std::uint64_t m_firstFrame = 0;   // oldest frame in the ring since the last reset
+    std::uint64_t m_nextFrame = 0;    // one past the newest frame received
+    std::uint64_t m_nextHopEnd = 0;   // window of the next hop ends here
+    std::uint64_t m_sequence = 0;
+    SpectrumFrame m_frame;
+    double m_hopSeconds = 0.0;
+    double m_audioSeconds = 0.0;
+    std::vector<std::shared_ptr<Feed>> m_publishTo;
+
+    mutable std::mutex m_mutex;       // guards the pending changes, m_feeds and m_stats
+    bool m_sourceChanged = false;
+    std::shared_ptr<AudioBlockBus::Subscription> m_pendingInput;
+    std::shared_ptr<const PlaybackClock> m_pendingClock;
+    bool m_settingsChanged = false;
+    Settings m_settings;
+    std::vector<std::weak_ptr<Feed>> m_feeds;
+    Stats m_stats;
+};
+
+}
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace NeonWave::Core::Audio {
+
+inline constexpr std::size_t kCacheLineSize = 64;
+
+/**
+ * @brief Fixed-capacity, wait-free single-producer/single-consumer ring.
+ *
+ * One thread may call the producer methods (write, push, writeAvailable) and
+ * one other thread the consumer methods (read, pop, drain, consume,
+ * readAvailable, discard). Head and tail live on separate cache lines so the two sides never
+ * false-share, and each side keeps a cached copy of the other's index to
+ * avoid touching the shared line on every call.
+ */
+template <typename T>
+class SpscRingBuffer {
+    static_assert(std::is_trivially_copyable_v<T>, "SpscRingBuffer requires trivially copyable elements");
+
+public:
+    /// Capacity is rounded up to the next power of two.
+    explicit SpscRingBuffer(std::size_t capacity)
+        : m_capacity(roundUpPow2(std::max<std::size_t>(capacity, 2)))
+        , m_mask(m_capacity - 1)
+        , m_data(std::make_unique<T[]>(m_capacity)) {}
+
+    SpscRingBuffer(const SpscRingBuffer&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+    std::size_t capacity() const { return m_capacity; }
+
+    /// Approximate fill level; safe to call from any thread (e.g. for stats).
+    std::size_t size() const {
+        const std::size_t tail = m_tail.load(std::memory_order_acquire);
+        return m_head.load(std::memory_order_acquire) - tail;
+    }
+
+    // ---- producer side -------------------------------------------------
+
+    std::size_t writeAvailable() {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        m_cachedTail = m_tail.load(std::memory_order_acquire);
+        return m_capacity - (head - m_cachedTail);
+    }
+
+    /// Copies up to @p count elements in; returns how many fit.
+    std::size_t write(const T* src, std::size_t count) {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        std::size_t free = m_capacity - (head - m_cachedTail);
+        if (free < count) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            free = m_capacity - (head - m_cachedTail);
+        }
+        const std::size_t n = std::min(count, free);
+        if (n == 0) return 0;
+
+        const std::size_t start = head & m_mask;
+        const std::size_t first = std::min(n, m_capacity - start);
+        std::copy_n(src, first, m_data.get() + start);
+        std::copy_n(src + first, n - first, m_data.get());
+        m_head.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+    bool push(const T& value) { return write(&value, 1) == 1; }
+
+    // ---- consumer side -------------------------------------------------
+
+    std::size_t readAvailable() {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        m_cachedHead = m_head.load(std::memory_order_acquire);
+        return m_cachedHead - tail;
+    }
+
+    /// Copies up to @p count elements out; returns how many were read.
+    std::size_t read(T* dst, std::size_t count) {
+        return drain([dst](const T* data, std::size_t n, std::size_t offset) {
+            std::copy_n(data, n, dst + offset);
+        }, count);
+    }
+
+    bool pop(T& value) { return read(&value, 1) == 1; }
+
+    /**
+     * @brief Zero-copy read: hands up to two contiguous regions to @p fn
+     *        as fn(const T* data, size_t count, size_t offset), then releases
+     *        them back to the producer.
+     */
+    template <typename Fn>
+    std::size_t drain(Fn&& fn, std::size_t maxCount = static_cast<std::size_t>(-1)) {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        std::size_t avail = m_cachedHead - tail;
+        if (avail == 0 || avail < maxCount) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            avail = m_cachedHead - tail;
+        }
+        const std::size_t n = std::min(avail, maxCount);
+        if (n == 0) return 0;
+
+        const std::size_t start = tail & m_mask;
+        const std::size_t first = std::min(n, m_capacity - start);
+        fn(m_data.get() + start, first, std::size_t{0});
+        if (n > first) {
+            fn(m_data.get(), n - first, first);
+        }
+        m_tail.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    /**
+     * @brief Like drain(), but fn returns how many of the offered elements it
+     *        took. A short count ends the walk and only what was taken is
+     *        released; the rest stays readable.
+     */
+    template <typename Fn>
+    std::size_t consume(Fn&& fn, std::size_t maxCount = static_cast<std::size_t>(-1)) {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        m_cachedHead = m_head.load(std::memory_order_acquire);
+        const std::size_t n = std::min(m_cachedHead - tail, maxCount);
+        if (n == 0) return 0;
+
+        const std::size_t start = tail & m_mask;
+        const std::size_t first = std::min(n, m_capacity - start);
+        std::size_t taken = std::min<std::size_t>(fn(m_data.get() + start, first, std::size_t{0}), first);
+        if (taken == first && n > first) {
+            taken += std::min<std::size_t>(fn(m_data.get(), n - first, first), n - first);
+        }
+        m_tail.store(tail + taken, std::memory_order_release);
+        return taken;
+    }
+
+    /// Drops up to @p count elements without reading them.
+    std::size_t discard(std::size_t count) {
+        return drain([](const T*, std::size_t, std::size_t) {}, count);
+    }
+
+private:
+    static std::size_t roundUpPow2(std::size_t v) {
+        std::size_t p = 1;
+        while (p < v) p <<= 1;
+        return p;
+    }
+
+    const std::size_t m_capacity;
+    const std::size_t m_mask;
+    std::unique_ptr<T[]> m_data;
+
+    alignas(kCacheLineSize) std::atomic<std::size_t> m_head{0}; // written by producer
+    std::size_t m_cachedTail{0};                                 // producer-local
+
+    alignas(kCacheLineSize) std::atomic<std::size_t> m_tail{0}; // written by consumer
+    std::size_t m_cachedHead{0};                                 // consumer-local
+};
+
+}
@@ -0,0 +1,48 @@
+#include "TempoAnalyzer.h"
+#include <chrono>
+
+namespace NeonWave::Core::Audio {
+
+TempoAnalyzer::TempoAnalyzer(const std::shared_ptr<AudioBlockBus>& bus, double cpuBudget)
+    : m_feed(bus ? bus->subscribe("tempo") : nullptr)
+    , m_tracker(cpuBudget)
+{
+    if (m_feed) {
+        m_thread = std::thread([this]() { run(); });
+    }
+}
+
+TempoAnalyzer::~TempoAnalyzer() {
+    m_stop.store(true, std::memory_order_relaxed);
+    if (m_thread.joinable()) m_thread.join();
+}
+
+TempoEstimate TempoAnalyzer::estimate() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_estimate;
+}
+
+TempoTracker::Cost TempoAnalyzer::cost() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_cost;
+}
+
+void TempoAnalyzer::run() {
+    AudioBlockRef block;
+    while (!m_stop.load(std::memory_order_relaxed)) {
+        bool fed = false;
+        while (m_feed->pop(block)) {
+            m_tracker.push(block->samples, block->frames, static_cast<int>(block->sampleRate), block->streamFrame);
+            block.reset();
+            fed = true;
+        }
+        if (fed) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_estimate = m_tracker.estimate();
+            m_cost = m_tracker.cost();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(kPollMs));
+    }
+}
+
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "AudioBlockBus.h"
+#include "TempoTracker.h"
+
+namespace NeonWave::Core::Audio {
+
+/**
+ * @brief Runs a TempoTracker on its own thread, fed from the PCM bus.
+ *
+ * Subscribes as "tempo" and drains the bus every kPollMs, so the estimate
+ * lags the decoded audio by at most one poll plus the tracker's update
+ * interval. Blocks are published as they are handed to the sink, i.e. ahead
+ * of what is audible, so in practice the beat grid is ready before the beat
+ * is heard. estimate() and cost() are safe from any thread.
+ */
+class TempoAnalyzer {
+public:
+    static constexpr int kPollMs = 10;
+
+    explicit TempoAnalyzer(const std::shared_ptr<AudioBlockBus>& bus, double cpuBudget = 0.01);
+    ~TempoAnalyzer();
+
+    TempoAnalyzer(const TempoAnalyzer&) = delete;
+    TempoAnalyzer& operator=(const TempoAnalyzer&) = delete;
+
+    TempoEstimate estimate() const;
+    TempoTracker::Cost cost() const;
+    double cpuBudget() const { return m_tracker.cpuBudget(); }
+
+private:
+    void run();
+
+    std::shared_ptr<AudioBlockBus::Subscription> m_feed;
+    TempoTracker m_tracker;              // analysis thread only
+    std::thread m_thread;
+    std::atomic<bool> m_stop{false};
+
+    mutable std::mutex m_mutex;          // guards the published copies below
+    TempoEstimate m_estimate;
+    TempoTracker::Cost m_cost;
+};
+
+}
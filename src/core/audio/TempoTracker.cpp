@@ -0,0 +1,229 @@
+#include "TempoTracker.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace NeonWave::Core::Audio {
+
+namespace {
+
+constexpr double kEnvelopeRate = static_cast<double>(TempoTracker::kSampleRate) / TempoTracker::kHopFrames;
+constexpr float kFluxCompression = 100.0f;
+constexpr float kFluxMeanAlpha = 1.0f / 86.0f;   // ~1 s running mean taken off the flux
+constexpr int kCombHarmonics = 4;
+constexpr double kPriorCenterBpm = 120.0;
+constexpr double kPriorOctaves = 1.0;            // std-dev of the log2 tempo prior
+constexpr float kSameTempo = 0.04f;              // relative BPM difference treated as agreement
+constexpr float kTempoSmoothing = 0.3f;
+constexpr int kPhasePeriods = 8;
+constexpr float kPhaseDecay = 0.8f;              // older beats count less when fitting the phase
+
+/// Envelope lag of the fastest and of the slowest tempo the comb scores.
+int shortestLag() { return static_cast<int>(std::floor(60.0 * kEnvelopeRate / TempoTracker::kMaxBpm)); }
+int longestLag() { return static_cast<int>(std::ceil(60.0 * kEnvelopeRate / TempoTracker::kMinBpm)); }
+
+} // namespace
+
+double TempoEstimate::beatPhaseAt(std::uint64_t frame) const {
+    if (bpm <= 0.0f || sampleRate == 0) return 0.0;
+    const double period = 60.0 * sampleRate / bpm;
+    const double beats = (static_cast<double>(frame) - static_cast<double>(beatFrame)) / period;
+    const double phase = beats - std::floor(beats);
+    return phase >= 1.0 ? 0.0 : phase;
+}
+
+TempoTracker::TempoTracker(double cpuBudget)
+    : m_budget(cpuBudget)
+    , m_resampler(detectIsa())
+    , m_fftPlan(kWindowFrames)
+    , m_fft(kWindowFrames)
+    , m_previousLogMag(kWindowFrames / 2 + 1)
+    , m_envelope(kHistoryHops)
+    , m_acf(kHistoryHops)
+    , m_linear(kHistoryHops)
+    , m_score(static_cast<std::size_t>(longestLag()) + 2)
+{
+    m_window = m_fftPlan.hannWindow();
+    reset();
+}
+
+void TempoTracker::reset() {
+    m_resampler.reset();
+    m_mono.assign(kWindowFrames - kHopFrames, 0.0f);
+    std::fill(m_previousLogMag.begin(), m_previousLogMag.end(), 0.0f);
+    std::fill(m_envelope.begin(), m_envelope.end(), 0.0f);
+    m_hops = 0;
+    m_fluxMean = 0.0f;
+    m_inputRate = 0;
+    m_streamOrigin = 0;
+    m_nextStreamFrame = 0;
+    m_sinceUpdate = 0;
+    m_estimate = {};
+    m_candidateBpm = 0.0f;
+}
+
+void TempoTracker::push(const float* stereo, std::size_t frames, int sampleRate, std::uint64_t streamFrame) {
+    if (frames == 0 || sampleRate <= 0) return;
+    const auto start = std::chrono::steady_clock::now();
+
+    // A new rate or a jump in the stream (seek, restart) invalidates the beat grid
+    if (m_inputRate != 0 && (sampleRate != m_inputRate || streamFrame != m_nextStreamFrame)) {
+        reset();
+    }
+    if (m_inputRate == 0) {
+        m_inputRate = sampleRate;
+        m_streamOrigin = streamFrame;
+        m_resampler.configure(sampleRate, kSampleRate);
+    }
+    m_nextStreamFrame = streamFrame + frames;
+
+    m_resampled.resize(m_resampler.maxOutputFrames(frames) * 2);
+    const std::size_t produced = m_resampler.process(stereo, frames, m_resampled.data());
+    const std::size_t offset = m_mono.size();
+    m_mono.resize(offset + produced);
+    for (std::size_t i = 0; i < produced; ++i) {
+        m_mono[offset + i] = 0.5f * (m_resampled[2 * i] + m_resampled[2 * i + 1]);
+    }
+
+    std::size_t consumed = 0;
+    while (m_mono.size() - consumed >= static_cast<std::size_t>(kWindowFrames)) {
+        analyzeHop(m_mono.data() + consumed);
+        consumed += kHopFrames;
+        if (++m_sinceUpdate >= m_cost.updateIntervalHops && m_hops >= static_cast<std::uint64_t>(kHistoryHops / 2)) {
+            updateEstimate();
+            m_sinceUpdate = 0;
+        }
+    }
+    m_mono.erase(m_mono.begin(), m_mono.begin() + static_cast<std::ptrdiff_t>(consumed));
+
+    const double cpu = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const double audio = static_cast<double>(frames) / sampleRate;
+    m_cost.cpuSeconds += cpu;
+    m_cost.audioSeconds += audio;
+    m_recentCpu += cpu;
+    m_recentAudio += audio;
+    if (m_recentAudio >= 1.0) {
+        const double load = m_recentCpu / m_recentAudio;
+        if (load > m_budget && m_cost.updateIntervalHops < kMaxUpdateHops) {
+            m_cost.updateIntervalHops *= 2;
+        } else if (load < m_budget / 4 && m_cost.updateIntervalHops > kBaseUpdateHops) {
+            m_cost.updateIntervalHops /= 2;
+        }
+        m_recentCpu = 0.0;
+        m_recentAudio = 0.0;
+    }
+}
+
+void TempoTracker::analyzeHop(const float* x) {
+    m_fftPlan.forwardReal(x, m_window.data(), m_fft.data());
+    float flux = 0.0f;
+    for (int k = 1; k <= kWindowFrames / 2; ++k) {
+        const float logMag = std::log1p(kFluxCompression * std::abs(m_fft[k]) / kWindowFrames);
+        flux += std::max(0.0f, logMag - m_previousLogMag[k]);
+        m_previousLogMag[k] = logMag;
+    }
+    m_fluxMean += kFluxMeanAlpha * (flux - m_fluxMean);
+    m_envelope[m_hops % kHistoryHops] = std::max(0.0f, flux - m_fluxMean);
+    ++m_hops;
+}
+
+void TempoTracker::updateEstimate() {
+    const int n = static_cast<int>(std::min<std::uint64_t>(m_hops, kHistoryHops));
+    double mean = 0.0;
+    for (int i = 0; i < n; ++i) {
+        m_linear[i] = m_envelope[(m_hops - n + i) % kHistoryHops];
+        mean += m_linear[i];
+    }
+    mean /= n;
+
+    const int minLag = shortestLag();
+    const int maxLag = longestLag();
+    const int acfLags = std::min(n - 1, kCombHarmonics * maxLag + kCombHarmonics);
+
+    // Unbiased autocorrelation of the mean-removed envelope
+    for (int lag = 0; lag <= acfLags; ++lag) {
+        double sum = 0.0;
+        for (int i = lag; i < n; ++i) sum += (m_linear[i] - mean) * (m_linear[i - lag] - mean);
+        m_acf[lag] = static_cast<float>(sum / (n - lag));
+    }
+    if (m_acf[0] <= 0.0f) return; // silence
+
+    // Harmonic comb, tolerant of +-(k-1) lags at the k-th multiple, weighted by the tempo prior
+    std::vector<double>& score = m_score;
+    std::fill(score.begin(), score.end(), 0.0);
+    double scoreSum = 0.0;
+    int scored = 0;
+    for (int lag = minLag; lag <= maxLag + 1; ++lag) {
+        double comb = 0.0;
+        for (int k = 1; k <= kCombHarmonics; ++k) {
+            const int centre = k * lag;
+            if (centre + k - 1 > acfLags) break;
+            float peak = m_acf[centre];
+            for (int d = 1; d < k; ++d) peak = std::max({ peak, m_acf[centre - d], m_acf[centre + d] });
+            comb += peak / k;
+        }
+        const double bpm = 60.0 * kEnvelopeRate / lag;
+        const double octaves = std::log2(bpm / kPriorCenterBpm) / kPriorOctaves;
+        score[lag] = std::max(0.0, comb) * std::exp(-0.5 * octaves * octaves);
+        scoreSum += score[lag];
+        ++scored;
+    }
+
+    int best = minLag;
+    for (int lag = minLag + 1; lag <= maxLag; ++lag) {
+        if (score[lag] > score[best]) best = lag;
+    }
+    if (score[best] <= 0.0) return;
+
+    double period = best;
+    if (best > minLag) {
+        const double a = score[best - 1], b = score[best], c = score[best + 1];
+        const double denom = a - 2.0 * b + c;
+        if (denom < 0.0) period += std::clamp(0.5 * (a - c) / denom, -0.5, 0.5);
+    }
+    const auto bpm = static_cast<float>(60.0 * kEnvelopeRate / period);
+    const auto confidence = static_cast<float>(std::clamp(1.0 - (scoreSum / scored) / score[best], 0.0, 1.0));
+
+    // Hysteresis: small drift is smoothed in, a different tempo must be seen twice in a row
+    if (m_estimate.bpm > 0.0f && std::abs(bpm / m_estimate.bpm - 1.0f) > kSameTempo) {
+        const bool confirmed = m_candidateBpm > 0.0f && std::abs(bpm / m_candidateBpm - 1.0f) <= kSameTempo;
+        m_candidateBpm = bpm;
+        if (!confirmed) return;
+        m_estimate.bpm = bpm;
+    } else {
+        m_estimate.bpm = m_estimate.bpm > 0.0f ? m_estimate.bpm + kTempoSmoothing * (bpm - m_estimate.bpm) : bpm;
+    }
+    m_candidateBpm = 0.0f;
+    m_estimate.confidence = confidence;
+
+    // Phase: the offset from now at which an impulse train of the period hits the most onset energy
+    const double hopsPerBeat = 60.0 * kEnvelopeRate / m_estimate.bpm;
+    const int periods = std::min(kPhasePeriods, static_cast<int>((n - 1) / hopsPerBeat));
+    int bestOffset = 0;
+    double bestEnergy = -1.0;
+    for (int offset = 0; offset < static_cast<int>(std::ceil(hopsPerBeat)); ++offset) {
+        double energy = 0.0;
+        float weight = 1.0f;
+        for (int k = 0; k < periods; ++k) {
+            const int index = n - 1 - offset - static_cast<int>(std::lround(k * hopsPerBeat));
+            if (index < 0) break;
+            energy += weight * m_linear[index];
+            weight *= kPhaseDecay;
+        }
+        if (energy > bestEnergy) {
+            bestEnergy = energy;
+            bestOffset = offset;
+        }
+    }
+
+    m_estimate.sampleRate = static_cast<std::uint32_t>(m_inputRate);
+    m_estimate.beatFrame = streamFrameOfHop(m_hops - 1 - bestOffset);
+    m_estimate.analysedFrame = streamFrameOfHop(m_hops - 1);
+}
+
+std::uint64_t TempoTracker::streamFrameOfHop(std::uint64_t hop) const {
+    const double seconds = (static_cast<double>(hop) + 0.5) * kHopFrames / kSampleRate;
+    return m_streamOrigin + static_cast<std::uint64_t>(std::llround(seconds * m_inputRate));
+}
+
+}
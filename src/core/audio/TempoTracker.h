@@ -0,0 +1,106 @@
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Fft.h"
+#include "PolyphaseResampler.h"
+
+namespace NeonWave::Core::Audio {
+
+/// Latest tempo and beat grid, on the stream-frame axis of the PCM that was fed in.
+struct TempoEstimate {
+    float bpm = 0.0f;                ///< 0 until the tracker has locked on
+    float confidence = 0.0f;         ///< 0..1: how much the winning period stands out
+    std::uint32_t sampleRate = 0;    ///< Rate of the stream-frame axis
+    std::uint64_t beatFrame = 0;     ///< Stream frame of the most recent detected beat
+    std::uint64_t analysedFrame = 0; ///< Stream frame the estimate was made at
+
+    /// Position within the beat at stream frame @p frame, in [0, 1); 0 without a tempo.
+    double beatPhaseAt(std::uint64_t frame) const;
+};
+
+/**
+ * @brief Streaming tempo and beat-phase tracker.
+ *
+ * PCM is downmixed and resampled to kSampleRate, turned into a spectral-flux
+ * onset envelope (kHopFrames per envelope sample), and every update interval
+ * the last kHistoryHops of envelope are autocorrelated. Each candidate period
+ * between kMinBpm and kMaxBpm is scored with a four-harmonic comb over the
+ * autocorrelation and a log-normal prior around 120 BPM; the beat phase is
+ * the offset that best lines an impulse train of that period up with the
+ * envelope.
+ *
+ * Cost is measured on every push(). When it exceeds the CPU budget (fraction
+ * of one core per second of audio), the update interval doubles, up to
+ * kMaxUpdateHops; it shrinks back once there is headroom again. The estimate
+ * is therefore never older than the current interval.
+ *
+ * Not thread-safe: feed and query it from one thread (see TempoAnalyzer).
+ */
+class TempoTracker {
+public:
+    static constexpr int kSampleRate = 11025;
+    static constexpr int kHopFrames = 128;                 ///< ~11.6 ms per envelope sample
+    static constexpr int kWindowFrames = 256;
+    static constexpr int kHistoryHops = 512;               ///< ~5.9 s of envelope
+    static constexpr int kBaseUpdateHops = 43;             ///< ~0.5 s between estimates
+    static constexpr int kMaxUpdateHops = kBaseUpdateHops * 8;
+    static constexpr float kMinBpm = 60.0f;
+    static constexpr float kMaxBpm = 200.0f;
+
+    struct Cost {
+        double audioSeconds = 0.0;
+        double cpuSeconds = 0.0;
+        int updateIntervalHops = kBaseUpdateHops;
+        /// Fraction of one core used per second of audio.
+        double load() const { return audioSeconds > 0.0 ? cpuSeconds / audioSeconds : 0.0; }
+    };
+
+    explicit TempoTracker(double cpuBudget = 0.01);
+
+    /// Forget everything (seek, new stream).
+    void reset();
+    /// Feed interleaved stereo; @p streamFrame is the stream index of the first frame.
+    void push(const float* stereo, std::size_t frames, int sampleRate, std::uint64_t streamFrame);
+
+    const TempoEstimate& estimate() const { return m_estimate; }
+    Cost cost() const { return m_cost; }
+    double cpuBudget() const { return m_budget; }
+
+private:
+    void analyzeHop(const float* x);
+    void updateEstimate();
+    /// Stream frame at the centre of envelope sample @p hop.
+    std::uint64_t streamFrameOfHop(std::uint64_t hop) const;
+
+    double m_budget;
+    PolyphaseResampler m_resampler;
+    std::vector<float> m_resampled;
+    std::vector<float> m_mono;
+    std::vector<float> m_window;
+    Fft m_fftPlan;
+    std::vector<std::complex<float>> m_fft;
+    std::vector<float> m_previousLogMag;
+
+    std::vector<float> m_envelope;     // ring of kHistoryHops
+    std::uint64_t m_hops = 0;          // envelope samples produced since reset
+    float m_fluxMean = 0.0f;           // slow average removed from the raw flux
+    std::vector<float> m_acf;
+    std::vector<float> m_linear;       // envelope unrolled oldest-first for the update
+    std::vector<double> m_score;       // comb score per lag, sized for the slowest tempo
+
+    int m_inputRate = 0;
+    std::uint64_t m_streamOrigin = 0;  // stream frame of the first input frame since reset
+    std::uint64_t m_nextStreamFrame = 0;
+    int m_sinceUpdate = 0;
+
+    TempoEstimate m_estimate;
+    float m_candidateBpm = 0.0f;       // a new tempo has to win twice before it replaces the old one
+    Cost m_cost;
+    double m_recentAudio = 0.0;        // budget window
+    double m_recentCpu = 0.0;
+};
+
+}
@@ -0,0 +1,114 @@
+#include "ThreadedTrackDecoder.h"
+#include <vector>
+
+namespace NeonWave::Core::Audio {
+
+namespace {
+
+constexpr std::size_t kChunkFrames = 4096;
+
+} // namespace
+
+ThreadedTrackDecoder::ThreadedTrackDecoder(std::unique_ptr<FileDecoder> decoder, std::size_t capacityFrames)
+    : m_decoder(std::move(decoder))
+    , m_ring(capacityFrames * 2)
+{
+}
+
+ThreadedTrackDecoder::~ThreadedTrackDecoder() {
+    close();
+}
+
+bool ThreadedTrackDecoder::open(const QString& path) {
+    close();
+    m_path = path;
+    if (!m_decoder || !m_decoder->open(path)) {
+        m_error.store(true, std::memory_order_release);
+        m_finished.store(true, std::memory_order_release);
+        return false;
+    }
+    m_sampleRate = m_decoder->sampleRate();
+    m_durationMs = m_decoder->durationMs();
+    startThread();
+    return true;
+}
+
+void ThreadedTrackDecoder::close() {
+    stopThread();
+    if (m_decoder) m_decoder->close();
+    m_ring.discard(m_ring.readAvailable());
+    m_finished.store(false, std::memory_order_relaxed);
+    m_error.store(false, std::memory_order_relaxed);
+    m_sampleRate = 0;
+    m_durationMs = -1;
+    m_seekIndex.reset();
+    if (m_decoder) m_decoder->setSeekIndex(nullptr);
+}
+
+std::size_t ThreadedTrackDecoder::read(float* dst, std::size_t frames) {
+    const std::size_t got = m_ring.read(dst, frames * 2) / 2;
+    if (got > 0) {
+        m_wake.notify_one();
+    }
+    return got;
+}
+
+bool ThreadedTrackDecoder::atEnd() const {
+    return m_finished.load(std::memory_order_acquire) && m_ring.size() == 0;
+}
+
+bool ThreadedTrackDecoder::seek(qint64 frame) {
+    if (!m_decoder || m_sampleRate <= 0) return false;
+    stopThread();
+    m_ring.discard(m_ring.readAvailable());
+    m_finished.store(false, std::memory_order_relaxed);
+    m_decoder->setSeekIndex(m_seekIndex);
+    const bool ok = m_decoder->seek(frame);
+    startThread();
+    return ok;
+}
+
+void ThreadedTrackDecoder::startThread() {
+    m_stop.store(false, std::memory_order_relaxed);
+    m_thread = std::thread([this]() { run(); });
+}
+
+void ThreadedTrackDecoder::stopThread() {
+    if (!m_thread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop.store(true, std::memory_order_relaxed);
+    }
+    m_wake.notify_one();
+    m_thread.join();
+}
+
+void ThreadedTrackDecoder::run() {
+    std::vector<float> chunk(kChunkFrames * 2);
+    std::size_t have = 0; // floats in chunk not yet in the ring
+    std::size_t offset = 0;
+
+    while (!m_stop.load(std::memory_order_relaxed)) {
+        if (offset == have) {
+            const std::size_t frames = m_decoder->decode(chunk.data(), kChunkFrames);
+            if (frames == 0) {
+                if (m_decoder->hasError()) m_error.store(true, std::memory_order_release);
+                break;
+            }
+            have = frames * 2;
+            offset = 0;
+        }
+
+        offset += m_ring.write(chunk.data() + offset, have - offset);
+        if (offset < have) {
+            // Ring full: sleep until the audio thread reads (or we're told to stop)
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait_for(lock, std::chrono::milliseconds(20), [this]() {
+                return m_stop.load(std::memory_order_relaxed) || m_ring.writeAvailable() > 0;
+            });
+        }
+    }
+    m_finished.store(true, std::memory_order_release);
+}
+
+}
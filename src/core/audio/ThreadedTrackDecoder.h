@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "FileDecoder.h"
+#include "SpscRingBuffer.h"
+#include "TrackDecoder.h"
+
+namespace NeonWave::Core::Audio {
+
+/**
+ * @brief TrackDecoder that runs a FileDecoder on its own thread.
+ *
+ * The thread decodes flat out into a bounded ring and sleeps while the ring
+ * is full, so playback stays non-blocking on the audio thread while the
+ * decoder itself is never paced to the wall clock.
+ */
+class ThreadedTrackDecoder : public TrackDecoder {
+public:
+    ThreadedTrackDecoder(std::unique_ptr<FileDecoder> decoder, std::size_t capacityFrames);
+    ~ThreadedTrackDecoder() override;
+
+    bool open(const QString& path) override;
+    void close() override;
+    std::size_t read(float* dst, std::size_t frames) override;
+    std::size_t bufferedFrames() const override { return m_ring.size() / 2; }
+    bool atEnd() const override;
+    bool hasError() const override { return m_error.load(std::memory_order_acquire); }
+    int sampleRate() const override { return m_sampleRate; }
+    qint64 durationMs() const override { return m_durationMs; }
+    bool seek(qint64 frame) override;
+    void setSeekIndex(std::shared_ptr<const SeekIndex> index) override { m_seekIndex = std::move(index); }
+
+private:
+    void startThread();
+    void stopThread();
+    void run();
+
+    std::unique_ptr<FileDecoder> m_decoder; // touched only by the decode thread while it runs
+    SpscRingBuffer<float> m_ring;           // interleaved stereo
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::atomic<bool> m_stop{false};
+    std::atomic<bool> m_finished{false};
+    std::atomic<bool> m_error{false};
+    int m_sampleRate = 0;
+    qint64 m_durationMs = -1;
+    std::shared_ptr<const SeekIndex> m_seekIndex; // handed to m_decoder at the next seek
+};
+
+}
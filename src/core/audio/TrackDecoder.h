@@ -0,0 +1,55 @@
+#pragma once
+
+#include <QString>
+#include <QtGlobal>
+#include <cstddef>
+#include <memory>
+
+namespace NeonWave::Core::Audio {
+
+class SeekIndex;
+
+/**
+ * @brief Pull-style source of interleaved float stereo PCM for one file.
+ *
+ * Implementations decode ahead on their own (event loop or worker thread)
+ * into a bounded buffer; read() only hands out what is already decoded and
+ * never blocks, so the output pump can call it from the audio thread.
+ */
+class TrackDecoder {
+public:
+    virtual ~TrackDecoder() = default;
+
+    /// Start decoding @p path; false if it cannot be opened at all.
+    virtual bool open(const QString& path) = 0;
+    virtual void close() = 0;
+
+    /// Copy up to @p frames decoded frames into @p dst (frames * 2 floats).
+    virtual std::size_t read(float* dst, std::size_t frames) = 0;
+
+    /// Frames ready to read right now.
+    virtual std::size_t bufferedFrames() const = 0;
+
+    /// Whole file decoded and every frame read.
+    virtual bool atEnd() const = 0;
+    virtual bool hasError() const = 0;
+
+    /// Native sample rate; 0 until the first buffer is decoded.
+    virtual int sampleRate() const = 0;
+
+    /// -1 while unknown.
+    virtual qint64 durationMs() const = 0;
+
+    /// Restart output at @p frame (in the file's own sample rate).
+    virtual bool seek(qint64 frame) = 0;
+
+    /// Frame-to-byte table for later seeks on the open file; ignored by decoders that cannot use one.
+    virtual void setSeekIndex(std::shared_ptr<const SeekIndex> index) { (void)index; }
+
+    const QString& path() const { return m_path; }
+
+protected:
+    QString m_path;
+};
+
+}
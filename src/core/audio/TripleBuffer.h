@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include "SpscRingBuffer.h"
+
+namespace NeonWave::Core::Audio {
+
+/**
+ * @brief Wait-free hand-off of the latest value from one writer thread to one reader thread.
+ *
+ * Three slots rotate between the writer (back), the reader (front) and a
+ * shared middle. publish() swaps the freshly written back slot into the
+ * middle; update() swaps the middle into the front, but only if something
+ * newer arrived since the last call. Neither side ever waits for the other
+ * or sees a slot the other is touching, so the reader always holds one
+ * complete value — the newest published — and values it never looked at
+ * are simply overwritten. Unlike SpscRingBuffer, nothing queues up.
+ *
+ * Each side's methods may only be called from one thread; several readers
+ * need a TripleBuffer each.
+ */
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() = default;
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // ---- writer side ---------------------------------------------------
+
+    /// Slot to fill; it stays the writer's until publish().
+    T& back() { return m_slots[m_back]; }
+
+    /// Make back() the latest value and hand the writer a slot the reader is not using.
+    void publish() {
+        const std::uint8_t previous = m_middle.exchange(static_cast<std::uint8_t>(m_back | kFresh),
+                                                        std::memory_order_acq_rel);
+        m_back = previous & kIndexMask;
+    }
+
+    // ---- reader side ---------------------------------------------------
+
+    /// Adopt the newest published value, if there is one; returns whether front() changed.
+    bool update() {
+        if (!(m_middle.load(std::memory_order_relaxed) & kFresh)) return false;
+        const std::uint8_t previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+        m_front = previous & kIndexMask;
+        return true;
+    }
+
+    /// Value adopted by the last update(); default-constructed before the first publish.
+    const T& front() const { return m_slots[m_front]; }
+    /// The reader owns front() until its next update(), so it may also write to it.
+    T& front() { return m_slots[m_front]; }
+
+private:
+    static constexpr std::uint8_t kIndexMask = 0x3;
+    static constexpr std::uint8_t kFresh = 0x4; // middle holds a value the reader has not adopted
+
+    std::array<T, 3> m_slots{};
+    alignas(kCacheLineSize) std::atomic<std::uint8_t> m_middle{1};
+    alignas(kCacheLineSize) std::uint8_t m_back = 0;  // writer only
+    alignas(kCacheLineSize) std::uint8_t m_front = 2; // reader only
+};
+
+}
@@ -0,0 +1,138 @@
+#include "WaveformCache.h"
+#include "OfflineAudioEngine.h"
+
+#include <QMetaObject>
+#include <cstring>
+
+namespace NeonWave::Core::Audio {
+
+namespace {
+
+constexpr DiskCache::Format kFormat = { "WaveformCache", { 'N', 'W', 'W', 'A', 'V', 'E', 'F', 'M' }, 2, ".nww" };
+constexpr std::size_t kMaxMapped = 8;
+
+/// On-disk header; all levels follow immediately, finest first, as native-endian int16 triples.
+struct WaveformHeader {
+    DiskCache::FileHeader common;
+    std::uint32_t sampleRate;
+    std::uint32_t baseFrames;
+    std::uint64_t frames;
+};
+static_assert(sizeof(WaveformHeader) == 64, "WaveformHeader layout is part of the file format");
+
+} // namespace
+
+WaveformCache::WaveformCache(std::filesystem::path directory, QObject* parent)
+    : QObject(parent)
+    , m_disk(std::move(directory), kFormat)
+{
+    m_disk.start([this](const QString& path) { process(path); });
+}
+
+WaveformCache::~WaveformCache() {
+    m_disk.stop();
+}
+
+void WaveformCache::request(const QString& path) {
+    m_disk.request(path); // the track just started matters more than older requests
+}
+
+std::shared_ptr<const WaveformPyramid> WaveformCache::lookup(const QString& path) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& [mappedPath, pyramid] : m_mapped) {
+        if (mappedPath == path) return pyramid;
+    }
+    return nullptr;
+}
+
+WaveformCache::Stats WaveformCache::stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void WaveformCache::process(const QString& path) {
+    QString error;
+    auto pyramid = load(path, &error);
+    const bool ok = pyramid != nullptr;
+    if (ok) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_mapped.remove_if([&path](const auto& entry) { return entry.first == path; });
+        m_mapped.emplace_front(path, std::move(pyramid));
+        if (m_mapped.size() > kMaxMapped) m_mapped.pop_back();
+    }
+    QMetaObject::invokeMethod(this, [this, path, ok, error]() {
+        if (ok) emit ready(path);
+        else emit failed(path, error);
+    }, Qt::QueuedConnection);
+}
+
+std::shared_ptr<const WaveformPyramid> WaveformCache::map(const QString& file, const QByteArray& key) const {
+    auto mapped = DiskCache::map(file, kFormat, key, sizeof(WaveformHeader));
+    if (!mapped) return nullptr;
+
+    WaveformHeader header;
+    std::memcpy(&header, mapped->data, sizeof(header));
+    const std::size_t bucketBytes = mapped->size - sizeof(WaveformHeader);
+    const bool current = header.baseFrames == WaveformPyramid::kBaseFrames
+        && header.sampleRate > 0
+        && bucketBytes % sizeof(WaveformBucket) == 0
+        && bucketBytes / sizeof(WaveformBucket) == WaveformPyramid::bucketCountFor(header.frames);
+    if (!current) return nullptr;
+
+    const auto* buckets = reinterpret_cast<const WaveformBucket*>(mapped->data + sizeof(WaveformHeader));
+    return std::make_shared<WaveformPyramid>(header.frames, static_cast<int>(header.sampleRate), buckets,
+                                             std::move(mapped));
+}
+
+std::shared_ptr<const WaveformPyramid> WaveformCache::load(const QString& path, QString* error) {
+    const QByteArray key = DiskCache::keyFor(path);
+    if (key.isEmpty()) {
+        *error = QStringLiteral("cannot read file");
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_stats.failures;
+        return nullptr;
+    }
+    const QString file = m_disk.fileFor(key);
+    if (auto hit = map(file, key)) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_stats.hits;
+        return hit;
+    }
+
+    WaveformBuilder builder;
+    const DecodeStats decoded = OfflineAudioEngine::decodeFile(path,
+        [&builder](const float* stereo, std::size_t frames, std::uint32_t sampleRate, std::uint64_t) {
+            builder.push(stereo, frames, static_cast<int>(sampleRate));
+            return true;
+        }, 4096, m_disk.cancelFlag());
+    if (!decoded.ok || builder.frames() == 0) {
+        *error = decoded.ok ? QStringLiteral("no audio") : decoded.error;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!decoded.cancelled) ++m_stats.failures;
+        return nullptr;
+    }
+
+    const std::vector<WaveformBucket> buckets = builder.finish();
+    WaveformHeader header{};
+    header.common = DiskCache::header(kFormat, key);
+    header.sampleRate = static_cast<std::uint32_t>(builder.sampleRate());
+    header.baseFrames = WaveformPyramid::kBaseFrames;
+    header.frames = builder.frames();
+
+    if (!DiskCache::write(file, kFormat, &header, sizeof(header),
+                          buckets.data(), buckets.size() * sizeof(WaveformBucket), error)) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_stats.failures;
+        return nullptr;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_stats.built;
+        m_stats.audioSeconds += decoded.audioSeconds;
+        m_stats.wallSeconds += decoded.wallSeconds;
+    }
+    return map(file, key);
+}
+
+}
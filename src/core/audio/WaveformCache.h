@@ -0,0 +1,71 @@
+#pragma once
+
+#include <QByteArray>
+#include <QObject>
+#include <QString>
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include "DiskCache.h"
+#include "WaveformPyramid.h"
+
+namespace NeonWave::Core::Audio {
+
+/**
+ * @brief Waveform pyramids of played tracks, built in the background and kept on disk.
+ *
+ * request() puts a track at the front of the DiskCache worker's queue. The
+ * worker maps the track's pyramid file if there is a current one, otherwise
+ * decodes the track flat out through OfflineAudioEngine::decodeFile() into a
+ * WaveformBuilder and writes the file first. Files live in one directory
+ * (normally Application::getDataPath()/waveform) and are keyed by the
+ * track's contents like every DiskCache's.
+ *
+ * lookup() never does I/O, so the GUI can call it on every paint; it only
+ * returns pyramids the worker has already mapped (the last few requested).
+ */
+class WaveformCache : public QObject {
+    Q_OBJECT
+public:
+    struct Stats {
+        std::uint64_t hits = 0;
+        std::uint64_t built = 0;
+        std::uint64_t failures = 0;
+        double audioSeconds = 0.0;  ///< Audio decoded for builds
+        double wallSeconds = 0.0;   ///< Time spent building, decode included
+
+        double speed() const { return wallSeconds > 0.0 ? audioSeconds / wallSeconds : 0.0; }
+    };
+
+    explicit WaveformCache(std::filesystem::path directory, QObject* parent = nullptr);
+    ~WaveformCache();
+
+    /// Make @p path available through lookup() as soon as possible; ready() follows.
+    void request(const QString& path);
+    /// Pyramid of @p path if it has been mapped already; never blocks on I/O.
+    std::shared_ptr<const WaveformPyramid> lookup(const QString& path) const;
+
+    Stats stats() const;
+
+signals:
+    /// lookup(@p path) now returns the pyramid; emitted on this object's thread.
+    void ready(const QString& path);
+    void failed(const QString& path, const QString& error);
+
+private:
+    /// Worker job for a requested track.
+    void process(const QString& path);
+    std::shared_ptr<const WaveformPyramid> load(const QString& path, QString* error);
+    std::shared_ptr<const WaveformPyramid> map(const QString& file, const QByteArray& key) const;
+
+    mutable std::mutex m_mutex;              // guards m_mapped and m_stats
+    std::list<std::pair<QString, std::shared_ptr<const WaveformPyramid>>> m_mapped; // most recent first
+    Stats m_stats;
+
+    DiskCache m_disk;                        // last: its worker uses everything above
+};
+
+}
@@ -0,0 +1,152 @@
+#include "WaveformPyramid.h"
+#include <algorithm>
+#include <cmath>
+
+namespace NeonWave::Core::Audio {
+
+namespace {
+
+constexpr float kScale = 32767.0f;
+
+std::int16_t quantize(float v) {
+    return static_cast<std::int16_t>(std::lrint(std::clamp(v, -1.0f, 1.0f) * kScale));
+}
+
+/// Bucket counts per level for a track of @p frames, finest first.
+std::vector<std::size_t> levelSizes(std::uint64_t frames) {
+    std::vector<std::size_t> sizes;
+    if (frames == 0) return sizes;
+    std::size_t n = static_cast<std::size_t>((frames + WaveformPyramid::kBaseFrames - 1) / WaveformPyramid::kBaseFrames);
+    sizes.push_back(n);
+    while (n > 1) {
+        n = (n + 1) / 2;
+        sizes.push_back(n);
+    }
+    return sizes;
+}
+
+} // namespace
+
+// ---- WaveformPyramid --------------------------------------------------------
+
+WaveformPyramid::WaveformPyramid(std::uint64_t frames, int sampleRate, const WaveformBucket* buckets,
+                                 std::shared_ptr<const void> owner)
+    : m_frames(frames)
+    , m_sampleRate(sampleRate)
+    , m_owner(std::move(owner))
+{
+    for (const std::size_t size : levelSizes(frames)) {
+        m_levels.push_back({ buckets, size });
+        buckets += size;
+    }
+}
+
+int WaveformPyramid::levelCountFor(std::uint64_t frames) {
+    return static_cast<int>(levelSizes(frames).size());
+}
+
+std::size_t WaveformPyramid::bucketCountFor(std::uint64_t frames) {
+    std::size_t total = 0;
+    for (const std::size_t size : levelSizes(frames)) total += size;
+    return total;
+}
+
+void WaveformPyramid::render(double startSeconds, double endSeconds, WaveformColumn* columns, int count) const {
+    if (count <= 0) return;
+    std::fill(columns, columns + count, WaveformColumn{});
+    if (m_levels.empty() || endSeconds <= startSeconds) return;
+
+    const double startFrame = startSeconds * m_sampleRate;
+    const double framesPerColumn = (endSeconds - startSeconds) * m_sampleRate / count;
+
+    // Coarsest level whose buckets still fit inside one column: at most three buckets per column
+    int level = 0;
+    while (level + 1 < levelCount()
+           && static_cast<double>(static_cast<std::uint64_t>(kBaseFrames) << (level + 1)) <= framesPerColumn) {
+        ++level;
+    }
+    const double bucketFrames = static_cast<double>(static_cast<std::uint64_t>(kBaseFrames) << level);
+    const WaveformBucket* buckets = m_levels[level].buckets;
+    const auto size = static_cast<std::int64_t>(m_levels[level].size);
+
+    for (int c = 0; c < count; ++c) {
+        const double from = startFrame + c * framesPerColumn;
+        const double to = from + framesPerColumn;
+        auto first = static_cast<std::int64_t>(std::floor(from / bucketFrames));
+        auto last = std::max(first + 1, static_cast<std::int64_t>(std::ceil(to / bucketFrames)));
+        first = std::max<std::int64_t>(first, 0);
+        last = std::min(last, size);
+        if (first >= last) continue;
+
+        int lo = buckets[first].min;
+        int hi = buckets[first].max;
+        double squares = 0.0;
+        for (std::int64_t b = first; b < last; ++b) {
+            lo = std::min<int>(lo, buckets[b].min);
+            hi = std::max<int>(hi, buckets[b].max);
+            squares += static_cast<double>(buckets[b].rms) * buckets[b].rms;
+        }
+        columns[c].min = lo / kScale;
+        columns[c].max = hi / kScale;
+        columns[c].rms = static_cast<float>(std::sqrt(squares / static_cast<double>(last - first)) / kScale);
+    }
+}
+
+// ---- WaveformBuilder --------------------------------------------------------
+
+void WaveformBuilder::reset() {
+    m_base.clear();
+    m_frames = 0;
+    m_sampleRate = 0;
+    m_fill = 0;
+    m_sumSquares = 0.0;
+}
+
+void WaveformBuilder::push(const float* stereo, std::size_t frames, int sampleRate) {
+    if (m_sampleRate == 0) m_sampleRate = sampleRate;
+    for (std::size_t i = 0; i < frames; ++i) {
+        const float l = stereo[2 * i];
+        const float r = stereo[2 * i + 1];
+        if (m_fill == 0) {
+            m_min = std::min(l, r);
+            m_max = std::max(l, r);
+        } else {
+            m_min = std::min({ m_min, l, r });
+            m_max = std::max({ m_max, l, r });
+        }
+        m_sumSquares += 0.5 * (static_cast<double>(l) * l + static_cast<double>(r) * r);
+        if (++m_fill == WaveformPyramid::kBaseFrames) flushBucket();
+    }
+    m_frames += frames;
+}
+
+void WaveformBuilder::flushBucket() {
+    m_base.push_back({ quantize(m_min), quantize(m_max),
+                       quantize(static_cast<float>(std::sqrt(m_sumSquares / m_fill))) });
+    m_fill = 0;
+    m_sumSquares = 0.0;
+}
+
+std::vector<WaveformBucket> WaveformBuilder::finish() {
+    if (m_fill > 0) flushBucket();
+
+    std::vector<WaveformBucket> all;
+    all.reserve(WaveformPyramid::bucketCountFor(m_frames));
+    all.insert(all.end(), m_base.begin(), m_base.end());
+    std::size_t levelStart = 0;
+    std::size_t levelSize = m_base.size();
+    while (levelSize > 1) {
+        for (std::size_t i = 0; i < levelSize; i += 2) {
+            const WaveformBucket a = all[levelStart + i];
+            const WaveformBucket b = i + 1 < levelSize ? all[levelStart + i + 1] : a;
+            const double rms = std::sqrt(0.5 * (static_cast<double>(a.rms) * a.rms + static_cast<double>(b.rms) * b.rms));
+            all.push_back({ std::min(a.min, b.min), std::max(a.max, b.max), static_cast<std::int16_t>(std::lround(rms)) });
+        }
+        levelStart += levelSize;
+        levelSize = (levelSize + 1) / 2;
+    }
+    m_base.clear();
+    return all;
+}
+
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace NeonWave::Core::Audio {
+
+/// Peak envelope of one span of audio, both channels together, scaled to int16 full scale.
+struct WaveformBucket {
+    std::int16_t min;
+    std::int16_t max;
+    std::int16_t rms;
+};
+static_assert(sizeof(WaveformBucket) == 6, "WaveformBucket layout is part of the cache format");
+
+/// One rendered column, in [-1, 1] (rms in [0, 1]).
+struct WaveformColumn {
+    float min = 0.0f;
+    float max = 0.0f;
+    float rms = 0.0f;
+};
+
+/**
+ * @brief Min/max/RMS overview of a whole track at power-of-two resolutions.
+ *
+ * Level 0 has one bucket per kBaseFrames input frames; each further level
+ * halves the previous one, down to a single bucket. Levels are stored
+ * back to back, finest first. render() picks the coarsest level whose
+ * buckets are still no wider than a column, so any zoom costs O(columns)
+ * and never touches the audio.
+ *
+ * The view does not own the buckets; @p owner keeps whatever does (a mapped
+ * file, a vector) alive for as long as the pyramid is.
+ */
+class WaveformPyramid {
+public:
+    static constexpr int kBaseFrames = 256;
+
+    WaveformPyramid(std::uint64_t frames, int sampleRate, const WaveformBucket* buckets,
+                    std::shared_ptr<const void> owner);
+
+    /// Number of levels / buckets over all levels for a track of @p frames.
+    static int levelCountFor(std::uint64_t frames);
+    static std::size_t bucketCountFor(std::uint64_t frames);
+
+    std::uint64_t frames() const { return m_frames; }
+    int sampleRate() const { return m_sampleRate; }
+    double durationSeconds() const { return m_sampleRate > 0 ? static_cast<double>(m_frames) / m_sampleRate : 0.0; }
+    int levelCount() const { return static_cast<int>(m_levels.size()); }
+    std::size_t levelSize(int level) const { return m_levels[level].size; }
+    const WaveformBucket* level(int level) const { return m_levels[level].buckets; }
+
+    /// Summarise [@p startSeconds, @p endSeconds) into @p count columns; columns past the end are silent.
+    void render(double startSeconds, double endSeconds, WaveformColumn* columns, int count) const;
+
+private:
+    struct Level { const WaveformBucket* buckets; std::size_t size; };
+
+    std::uint64_t m_frames;
+    int m_sampleRate;
+    std::vector<Level> m_levels;
+    std::shared_ptr<const void> m_owner;
+};
+
+/**
+ * @brief Builds a WaveformPyramid in one streaming pass over a track.
+ *
+ * Only level 0 is accumulated while decoding (6 bytes per kBaseFrames
+ * frames, ~7 MB for a two-hour mix at 44.1 kHz); finish() derives the rest.
+ */
+class WaveformBuilder {
+public:
+    void reset();
+    /// Interleaved float stereo; the first call fixes the rate, later rate changes are ignored.
+    void push(const float* stereo, std::size_t frames, int sampleRate);
+    /// All levels, finest first, in WaveformPyramid layout. Flushes a partial last bucket.
+    std::vector<WaveformBucket> finish();
+
+    std::uint64_t frames() const { return m_frames; }
+    int sampleRate() const { return m_sampleRate; }
+
+private:
+    void flushBucket();
+
+    std::vector<WaveformBucket> m_base;
+    std::uint64_t m_frames = 0;
+    int m_sampleRate = 0;
+    int m_fill = 0;
+    float m_min = 0.0f;
+    float m_max = 0.0f;
+    double m_sumSquares = 0.0;
+};
+
+}
@@ -7,7 +7,10 @@
 #include "visualizer/ProjectMWidget.h"
 #include "PlaylistWidget.h"
 #include "SettingsDialog.h"
+#include "WaveformSlider.h"
 #include "core/Config.h"
+#include "core/Application.h"
+#include "core/audio/FileDecoder.h"
 #include "visualizer/PresetManager.h"
 
 #include <QMenuBar>
@@ -24,6 +27,9 @@
 #include <QMessageBox>
 #include <QStyle>
 #include <QTimer>
+#include <cmath>
+#include <iostream>
+#include <vector>
 
 namespace NeonWave::GUI {
 
@@ -48,15 +54,93 @@ MainWindow::MainWindow(QWidget *parent)
     setupMenuBar();
     setupToolBar();
     setupCentralWidget();
+
+    // One FFT of what the visualizer follows, for every consumer that needs a spectrum; sized by applyAudioSettings()
+    m_spectrum = std::make_unique<NeonWave::Core::Audio::SpectrumAnalyzer>(
+        m_audioEngine->audioBus(), m_audioEngine->playbackClock(), NeonWave::Core::Audio::SpectrumAnalyzer::Settings{});
+
+    applyAudioSettings();
+    connect(m_audioEngine.get(), &NeonWave::Core::Audio::AudioEngine::trackChanged,
+            m_audioPlaylist, &AudioPlaylistWidget::setCurrentTrackIndex);
+
+    // Feature cache shared by later sessions and offline renders
+    m_analysisCache = std::make_unique<NeonWave::Core::Audio::AnalysisCache>(
+        NeonWave::Core::Application::instance().getDataPath() / "analysis");
+    connect(m_analysisCache.get(), &NeonWave::Core::Audio::AnalysisCache::trackFailed, this,
+            [](const QString& path, const QString& error) {
+                std::cerr << "[AnalysisCache] " << path.toStdString() << ": " << error.toStdString() << std::endl;
+            });
+    connect(m_analysisCache.get(), &NeonWave::Core::Audio::AnalysisCache::idle, this, [this]() {
+        const auto s = m_analysisCache->stats();
+        std::cout << "[AnalysisCache] " << s.requests << " tracks, hit rate " << s.hitRate() * 100.0
+                  << "%, analysed " << s.audioSeconds << " s of audio at " << s.speed() << "x realtime" << std::endl;
+    });
+
+    // Loudness of everything added to the playlist, measured on all cores; feeds normalisation
+    m_loudnessScanner = std::make_unique<NeonWave::Core::Audio::LoudnessScanner>(
+        NeonWave::Core::Application::instance().getDataPath() / "loudness.json");
+    m_audioEngine->setLoudnessStore(m_loudnessScanner->store());
+    connect(m_loudnessScanner.get(), &NeonWave::Core::Audio::LoudnessScanner::trackFailed, this,
+            [](const QString& path, const QString& error) {
+                std::cerr << "[LoudnessScanner] " << path.toStdString() << ": " << error.toStdString() << std::endl;
+            });
+    connect(m_loudnessScanner.get(), &NeonWave::Core::Audio::LoudnessScanner::idle, this, [this]() {
+        const auto s = m_loudnessScanner->stats();
+        std::cout << "[LoudnessScanner] " << s.scanned << " tracks measured, " << s.cached << " already known, "
+                  << s.failures << " failed; " << s.speed() << "x realtime on " << s.threads << " threads" << std::endl;
+    });
+    // Waveform overview in the seek bar, built the first time a track plays
+    m_waveforms = std::make_unique<NeonWave::Core::Audio::WaveformCache>(
+        NeonWave::Core::Application::instance().getDataPath() / "waveform");
+    connect(m_waveforms.get(), &NeonWave::Core::Audio::WaveformCache::ready, this, [this](const QString& path) {
+        if (path == m_currentTrackPath) m_seekSlider->setWaveform(m_waveforms->lookup(path));
+    });
+    connect(m_waveforms.get(), &NeonWave::Core::Audio::WaveformCache::failed, this,
+            [](const QString& path, const QString& error) {
+                std::cerr << "[WaveformCache] " << path.toStdString() << ": " << error.toStdString() << std::endl;
+            });
+    connect(m_audioEngine.get(), &NeonWave::Core::Audio::AudioEngine::trackChanged, this, [this](int index) {
+        m_currentTrackPath = m_audioPlaylist->getTrackPath(index);
+        m_seekSlider->setWaveform(m_waveforms->lookup(m_currentTrackPath));
+        if (!m_currentTrackPath.isEmpty() && NeonWave::Core::Audio::hasFileDecoder()) {
+            m_waveforms->request(m_currentTrackPath);
+        }
+    });
+
+    // Frame-exact seeking in files without a container index (VBR mp3 and the like)
+    m_seekIndexes = std::make_shared<NeonWave::Core::Audio::SeekIndexCache>(
+        NeonWave::Core::Application::instance().getDataPath() / "seek");
+    m_audioEngine->setSeekIndexCache(m_seekIndexes);
+    connect(this, &MainWindow::seekRequested, this, [this](double position) {
+        m_audioEngine->seek(static_cast<qint64>(position * 1000.0));
+    });
+
+    // Volume is applied by the engine's output DSP chain and remembered across sessions
+    m_audioEngine->setVolume(m_volumeSlider->value() / 100.0);
+    connect(this, &MainWindow::volumeChanged, this, [this](double volume) {
+        m_audioEngine->setVolume(volume);
+        auto& config = NeonWave::Core::Config::instance();
+        config.audio().volume = volume;
+        if (!m_volumeSlider->isSliderDown()) config.save(); // a drag is saved once, on release
+    });
+    connect(m_volumeSlider, &QSlider::sliderReleased, this, []() { NeonWave::Core::Config::instance().save(); });
+
+    connect(m_audioPlaylist, &AudioPlaylistWidget::filesAdded, this, [this](const QStringList& files) {
+        if (NeonWave::Core::Config::instance().audio().loudnessScan && NeonWave::Core::Audio::hasFileDecoder()) {
+            m_loudnessScanner->scan(files);
+        }
+    });
     
     // Now that visualizer exists, connect audio and apply settings
     if (m_visualizer) {
-        connect(m_audioEngine.get(), &Core::Audio::AudioEngine::pcmDataAvailable,
-                m_visualizer, &ProjectMWidget::addAudioData);
+        applyVisualizerInput();
 
         const auto& v = cfg.visualizer();
         m_visualizer->setFPS(v.fps);
+        m_visualizer->setVsync(v.vsync);
         m_visualizer->setMeshSize(v.meshX, v.meshY);
+        m_visualizer->setAdaptiveQuality(v.adaptiveQuality);
+        m_visualizer->setTestSignal(v.debugInjectTestSignal);
         m_visualizer->setAspectCorrection(v.aspectCorrection);
         m_visualizer->setBeatSensitivity(v.beatSensitivity);
         m_visualizer->setHardCut(v.hardCutEnabled, v.hardCutDuration);
@@ -64,10 +148,21 @@ MainWindow::MainWindow(QWidget *parent)
         m_visualizer->setPresetDuration(v.presetDuration);
         m_visualizer->setPresetLocked(v.presetLocked);
         m_visualizer->setPresetAndTextureDirs(v.presetDirectory, v.textureDirectory);
+        m_visualizer->setAudioSyncOffset(v.audioSyncOffsetMs);
+        m_visualizer->setAnalysisSampleRate(v.analysisSampleRate);
     }
     
     // Set up status bar
     statusBar()->showMessage("Ready");
+
+    // Tempo tracking runs off the same PCM bus as the visualizer
+    m_tempo = std::make_unique<NeonWave::Core::Audio::TempoAnalyzer>(m_audioEngine->audioBus());
+    m_tempoLabel = new QLabel(this);
+    m_tempoLabel->setMinimumWidth(110);
+    statusBar()->addPermanentWidget(m_tempoLabel);
+    auto* tempoTimer = new QTimer(this);
+    connect(tempoTimer, &QTimer::timeout, this, &MainWindow::updateTempoLabel);
+    tempoTimer->start(50);
     
     // Connect signals for internal state management
     connect(this, &MainWindow::playStateChanged, 
@@ -111,6 +206,10 @@ void MainWindow::setupMenuBar() {
         }
     });
     
+    m_audioDiagnosticsAction = viewMenu->addAction("Audio &Diagnostics...");
+    connect(m_audioDiagnosticsAction, &QAction::triggered,
+            this, &MainWindow::onAudioDiagnosticsClicked);
+    
     // Settings menu
     auto* settingsMenu = menuBar->addMenu("&Settings");
     
@@ -238,7 +337,7 @@ void MainWindow::createAudioControls() {
     m_timeLabel->setMinimumWidth(100);
     
     // Seek slider
-    m_seekSlider = new QSlider(Qt::Horizontal);
+    m_seekSlider = new WaveformSlider();
     m_seekSlider->setMinimumWidth(200);
     connect(m_seekSlider, &QSlider::sliderMoved, [this](int value) {
         double position = static_cast<double>(value) / 1000.0;
@@ -248,7 +347,7 @@ void MainWindow::createAudioControls() {
     // Volume slider
     m_volumeSlider = new QSlider(Qt::Horizontal);
     m_volumeSlider->setRange(0, 100);
-    m_volumeSlider->setValue(70);
+    m_volumeSlider->setValue(static_cast<int>(std::lround(NeonWave::Core::Config::instance().audio().volume * 100.0)));
     m_volumeSlider->setMaximumWidth(100);
     m_volumeSlider->setToolTip("Volume");
     connect(m_volumeSlider, &QSlider::valueChanged, [this](int value) {
@@ -339,6 +438,9 @@ void MainWindow::onAddFilesClicked() {
         // Add files to audio playlist and audio engine
         m_audioPlaylist->addFiles(files);
         m_audioEngine->setPlaylist(files);
+        if (NeonWave::Core::Config::instance().audio().analysisCache && NeonWave::Core::Audio::hasFileDecoder()) {
+            m_analysisCache->enqueue(files);
+        }
         statusBar()->showMessage(QString("Added %1 files").arg(files.size()));
     }
 }
@@ -348,10 +450,15 @@ void MainWindow::onSettingsClicked() {
     if (dialog.exec() == QDialog::Accepted) {
         // Apply updated config to visualizer
         auto& cfg = NeonWave::Core::Config::instance();
+        applyAudioSettings();
+        applyVisualizerInput();
         const auto& v = cfg.visualizer();
         if (m_visualizer) {
             m_visualizer->setFPS(v.fps);
+            m_visualizer->setVsync(v.vsync);
             m_visualizer->setMeshSize(v.meshX, v.meshY);
+            m_visualizer->setAdaptiveQuality(v.adaptiveQuality);
+            m_visualizer->setTestSignal(v.debugInjectTestSignal);
             m_visualizer->setAspectCorrection(v.aspectCorrection);
             m_visualizer->setBeatSensitivity(v.beatSensitivity);
             m_visualizer->setHardCut(v.hardCutEnabled, v.hardCutDuration);
@@ -359,10 +466,61 @@ void MainWindow::onSettingsClicked() {
             m_visualizer->setPresetDuration(v.presetDuration);
             m_visualizer->setPresetLocked(v.presetLocked);
             m_visualizer->setPresetAndTextureDirs(v.presetDirectory, v.textureDirectory);
+            m_visualizer->setAudioSyncOffset(v.audioSyncOffsetMs);
+            m_visualizer->setAnalysisSampleRate(v.analysisSampleRate);
         }
     }
 }
 
+void MainWindow::applyAudioSettings() {
+    using NeonWave::Core::Audio::DecoderBackend;
+    const auto& a = NeonWave::Core::Config::instance().audio();
+    m_audioEngine->setPrerollSeconds(a.gaplessPrerollSeconds);
+    m_audioEngine->setCrossfadeSeconds(a.crossfadeSeconds);
+    m_audioEngine->setTargetLatencyMs(a.targetLatencyMs);
+    m_audioEngine->setDecoderBackend(a.decoder == "libav" ? DecoderBackend::Libav : DecoderBackend::QtMultimedia);
+    m_audioEngine->setNormalization(a.normalizeOutput, a.normalizeVisualizer, a.targetLufs);
+
+    std::vector<NeonWave::Core::Audio::EqBand> bands;
+    for (const auto& b : a.eqBands) {
+        using NeonWave::Core::Audio::EqBandType;
+        const EqBandType type = b.type == "low_shelf" ? EqBandType::LowShelf
+            : b.type == "high_shelf" ? EqBandType::HighShelf : EqBandType::Peak;
+        bands.push_back({ type, b.frequencyHz, b.gainDb, b.q });
+    }
+    m_audioEngine->setEqualizer(a.equalizer, bands);
+    m_audioEngine->setLimiterEnabled(a.limiter);
+
+    NeonWave::Core::Audio::SpectrumAnalyzer::Settings spectrum;
+    spectrum.fftSize = a.spectrumFftSize;
+    spectrum.hopFrames = a.spectrumHopFrames;
+    spectrum.bands = a.spectrumBands;
+    m_spectrum->configure(spectrum);
+}
+
+void MainWindow::applyVisualizerInput() {
+    if (!m_visualizer) return;
+    const auto& a = NeonWave::Core::Config::instance().audio();
+    if (a.visualizerInput == "capture") {
+        if (!m_capture) m_capture = std::make_unique<NeonWave::Core::Audio::PulseCapture>();
+        if (m_capture->start(a.captureSource, 48000, a.captureFragmentMs)) {
+            // A monitored frame is already audible, so the capture clock releases it at once
+            m_visualizer->setAudioBus(m_capture->audioBus());
+            m_visualizer->setPlaybackClock(m_capture->clock());
+            m_spectrum->setSource(m_capture->audioBus(), m_capture->clock());
+            return;
+        }
+        QMessageBox::warning(this, "System audio capture",
+            QString("Cannot capture system audio: %1\nThe visualizer follows playlist playback instead.")
+                .arg(QString::fromStdString(m_capture->errorString())));
+    } else if (m_capture) {
+        m_capture->stop();
+    }
+    m_visualizer->setAudioBus(m_audioEngine->audioBus());
+    m_visualizer->setPlaybackClock(m_audioEngine->playbackClock());
+    m_spectrum->setSource(m_audioEngine->audioBus(), m_audioEngine->playbackClock());
+}
+
 void MainWindow::onAboutClicked() {
     QMessageBox::about(this, "About NeonWave",
         "<h2>NeonWave 1.0.0</h2>"
@@ -373,6 +531,201 @@ void MainWindow::onAboutClicked() {
     );
 }
 
+void MainWindow::onAudioDiagnosticsClicked() {
+    const auto cb = m_audioEngine->callbackStats();
+    const auto bus = m_audioEngine->audioBus()->stats();
+    const auto gap = m_audioEngine->gaplessStats();
+    const auto jit = m_audioEngine->jitterStats();
+
+    QString text = QString("<h3>Audio thread</h3>"
+                           "<p>Pump passes: %1<br>"
+                           "Processing time: last %2 µs, mean %3 µs, max %4 µs<br>"
+                           "Buffer duration: %5 µs<br>"
+                           "Over budget: %6</p>")
+        .arg(cb.callbacks)
+        .arg(cb.lastUs, 0, 'f', 1)
+        .arg(cb.meanUs, 0, 'f', 1)
+        .arg(cb.maxUs, 0, 'f', 1)
+        .arg(cb.lastBufferUs, 0, 'f', 0)
+        .arg(cb.overBudget);
+
+    text += QString("<h3>Output buffer</h3>"
+                    "<p>Target latency: %1 ms, period %2 ms<br>"
+                    "Queued: %3 ms, in sink: %4 ms<br>"
+                    "Underruns: %5, overruns: %6, partial writes: %7</p>")
+        .arg(jit.targetLatencyMs, 0, 'f', 0)
+        .arg(jit.periodMs, 0, 'f', 1)
+        .arg(jit.queuedMs, 0, 'f', 1)
+        .arg(jit.sinkBufferedMs, 0, 'f', 1)
+        .arg(jit.underruns).arg(jit.overruns).arg(jit.partialWrites);
+
+    if (m_visualizer) {
+        const auto sync = m_visualizer->audioSyncStats();
+        text += QString("<h3>Visual sync</h3>"
+                        "<p>Measured output latency: %1 ms<br>"
+                        "Manual offset: %2 ms<br>"
+                        "Held for display: %3 ms (%4 blocks)<br>"
+                        "Analysis rate: %5 Hz, resampling %6 ns/frame<br>"
+                        "Heard to render: %7 ms</p>")
+            .arg(sync.outputLatencyMs, 0, 'f', 1)
+            .arg(sync.offsetMs)
+            .arg(sync.heldMs, 0, 'f', 1)
+            .arg(sync.heldBlocks)
+            .arg(sync.analysisRate)
+            .arg(sync.resampleNsPerFrame, 0, 'f', 1)
+            .arg(sync.renderLagMs, 0, 'f', 1);
+
+        const auto frames = m_visualizer->frameStats();
+        text += QString("<h3>Render thread</h3>"
+                        "<p>Frames: %1 rendered at %2 fps, %3 started late and skipped %4 slots<br>"
+                        "Frame interval: p50 %5 ms, p95 %6 ms, p99 %7 ms, max %8 ms (target %9 ms)<br>"
+                        "Render (CPU): p50 %10 ms, p95 %11 ms, p99 %12 ms, max %13 ms<br>"
+                        "Composited: %14, replaced before the GUI showed them: %15<br>"
+                        "Vsync alignment: %16 corrections, last phase error %17 ms</p>")
+            .arg(frames.frames).arg(frames.pacing.fps).arg(frames.pacing.lateFrames).arg(frames.pacing.skipped)
+            .arg(frames.intervalP50Ms, 0, 'f', 2).arg(frames.intervalP95Ms, 0, 'f', 2)
+            .arg(frames.intervalP99Ms, 0, 'f', 2).arg(frames.intervalMaxMs, 0, 'f', 2)
+            .arg(frames.pacing.targetMs, 0, 'f', 2)
+            .arg(frames.renderP50Ms, 0, 'f', 2).arg(frames.renderP95Ms, 0, 'f', 2)
+            .arg(frames.renderP99Ms, 0, 'f', 2).arg(frames.renderMaxMs, 0, 'f', 2)
+            .arg(frames.composited).arg(frames.notComposited)
+            .arg(frames.pacing.alignments).arg(frames.pacing.phaseErrorMs, 0, 'f', 2);
+
+        QStringList bins;
+        const auto& histogram = frames.pacing.intervalHistogram;
+        for (std::size_t i = 0; i < histogram.size(); ++i) {
+            if (histogram[i] == 0) continue;
+            bins << QString("%1%2 ms: %3")
+                        .arg(static_cast<double>(i) * NeonWave::GUI::FrameClock::kHistogramBinMs, 0, 'f', 1)
+                        .arg(i + 1 == histogram.size() ? "+" : "")
+                        .arg(histogram[i]);
+        }
+        text += QString("<p>Frame interval histogram (%1 ms bins): %2</p>")
+            .arg(NeonWave::GUI::FrameClock::kHistogramBinMs)
+            .arg(bins.isEmpty() ? QString("no frames yet") : bins.join(", "));
+
+        const auto& quality = frames.quality;
+        text += QString("<h3>Adaptive quality</h3>"
+                        "<p>%1, level %2 of %3: mesh %4x%5, rendering %6x%7<br>"
+                        "GPU: p50 %8 ms, p95 %9 ms<br>"
+                        "Frame cost p90: %10 ms of a %11 ms budget<br>"
+                        "Steps down: %12, up: %13, next step up after %14 quiet windows</p>")
+            .arg(quality.enabled ? "On" : "Off")
+            .arg(quality.level).arg(NeonWave::GUI::QualityGovernor::kLevels.size() - 1)
+            .arg(frames.meshX).arg(frames.meshY).arg(frames.renderWidth).arg(frames.renderHeight)
+            .arg(frames.gpuP50Ms, 0, 'f', 2).arg(frames.gpuP95Ms, 0, 'f', 2)
+            .arg(quality.costP90Ms, 0, 'f', 2).arg(quality.budgetMs, 0, 'f', 2)
+            .arg(quality.stepsDown).arg(quality.stepsUp).arg(quality.upDwellWindows);
+        if (!quality.recent.empty()) {
+            const std::int64_t nowNs = NeonWave::Core::Audio::PlaybackClock::nowNs();
+            text += "<p>Recent changes:<br>";
+            for (auto it = quality.recent.rbegin(); it != quality.recent.rend(); ++it) {
+                text += QString("%1 s ago, level %2 to %3: %4<br>")
+                    .arg((nowNs - it->atNs) * 1e-9, 0, 'f', 0)
+                    .arg(it->from).arg(it->to)
+                    .arg(QString::fromStdString(it->reason).toHtmlEscaped());
+            }
+            text += "</p>";
+        }
+    }
+
+    if (m_capture && m_capture->isRunning()) {
+        const auto cap = m_capture->stats();
+        text += QString("<h3>System audio capture</h3>"
+                        "<p>Source: %1 at %2 Hz<br>"
+                        "Fragment: %3 ms, source latency %4 ms<br>"
+                        "Captured: %5 s in %6 reads, %7 frames lost to overruns</p>")
+            .arg(QString::fromStdString(cap.source).toHtmlEscaped())
+            .arg(cap.sampleRate)
+            .arg(cap.fragmentMs, 0, 'f', 1)
+            .arg(cap.sourceLatencyMs, 0, 'f', 1)
+            .arg(cap.sampleRate ? static_cast<double>(cap.frames) / cap.sampleRate : 0.0, 0, 'f', 1)
+            .arg(cap.reads)
+            .arg(cap.holeFrames);
+    }
+
+    const auto seeks = m_audioEngine->seekStats();
+    const auto seekIndex = m_seekIndexes->stats();
+    text += QString("<h3>Seeking</h3>"
+                    "<p>Seeks: %1 (%2 through a seek index)<br>"
+                    "Time to audio: last %3 ms, max %4 ms<br>"
+                    "Seek indexes: %5 built (%6 entries, %7 s scanning), %8 loaded from disk, "
+                    "%9 not needed, %10 failed</p>")
+        .arg(seeks.seeks).arg(seeks.indexed)
+        .arg(seeks.lastMs, 0, 'f', 1).arg(seeks.maxMs, 0, 'f', 1)
+        .arg(seekIndex.built).arg(seekIndex.points).arg(seekIndex.wallSeconds, 0, 'f', 2)
+        .arg(seekIndex.hits).arg(seekIndex.notNeeded).arg(seekIndex.failures);
+
+    text += QString("<h3>Track transitions</h3>"
+                    "<p>Transitions: %1 (%2 with a gap, %3 crossfaded)<br>"
+                    "Gap: last %4 samples, max %5 samples</p>")
+        .arg(gap.transitions).arg(gap.gappedTransitions).arg(gap.crossfades)
+        .arg(gap.lastGapFrames).arg(gap.maxGapFrames);
+
+    const auto tempo = m_tempo->estimate();
+    const auto tempoCost = m_tempo->cost();
+    const auto clock = m_audioEngine->playbackClock()->sample();
+    text += QString("<h3>Tempo</h3>"
+                    "<p>Tempo: %1 BPM, confidence %2%<br>"
+                    "Analysed ahead of playback: %3 ms<br>"
+                    "CPU: %4% of a core (budget %5%), update every %6 ms</p>")
+        .arg(tempo.bpm, 0, 'f', 1)
+        .arg(static_cast<int>(tempo.confidence * 100.0f))
+        .arg(clock.sampleRate ? (static_cast<double>(tempo.analysedFrame) - static_cast<double>(clock.frame)) * 1000.0 / clock.sampleRate : 0.0, 0, 'f', 0)
+        .arg(tempoCost.load() * 100.0, 0, 'f', 2)
+        .arg(m_tempo->cpuBudget() * 100.0, 0, 'f', 2)
+        .arg(tempoCost.updateIntervalHops * 1000.0 * NeonWave::Core::Audio::TempoTracker::kHopFrames
+             / NeonWave::Core::Audio::TempoTracker::kSampleRate, 0, 'f', 0);
+
+    const auto spectrumSettings = m_spectrum->settings();
+    const auto spectrum = m_spectrum->stats();
+    text += QString("<h3>Spectrum</h3>"
+                    "<p>FFT: %1 points every %2 frames, %3 bands, %4 consumers<br>"
+                    "Spectra: %5 (%6 skipped, %7 stream restarts)<br>"
+                    "CPU: %8 us per spectrum, %9% of a core</p>")
+        .arg(spectrumSettings.fftSize).arg(spectrumSettings.hopFrames).arg(spectrumSettings.bands)
+        .arg(spectrum.feeds)
+        .arg(spectrum.hops).arg(spectrum.skippedHops).arg(spectrum.discontinuities)
+        .arg(spectrum.meanHopUs, 0, 'f', 1)
+        .arg(spectrum.load * 100.0, 0, 'f', 2);
+
+    const auto cache = m_analysisCache->stats();
+    text += QString("<h3>Analysis cache</h3>"
+                    "<p>Tracks: %1 (%2 cached, %3 analysed, %4 failed), %5 queued<br>"
+                    "Hit rate: %6%<br>"
+                    "Analysis throughput: %7x realtime</p>")
+        .arg(cache.requests).arg(cache.hits).arg(cache.analysed).arg(cache.failures)
+        .arg(cache.pending)
+        .arg(cache.hitRate() * 100.0, 0, 'f', 1)
+        .arg(cache.speed(), 0, 'f', 1);
+
+    const auto loud = m_loudnessScanner->stats();
+    const auto norm = m_audioEngine->normalizationStats();
+    text += QString("<h3>Loudness</h3>"
+                    "<p>Tracks: %1 measured, %2 already known, %3 failed, %4 queued<br>"
+                    "Throughput: %5x realtime on %6 threads (%7x per thread)<br>"
+                    "Current track: %8</p>")
+        .arg(loud.scanned).arg(loud.cached).arg(loud.failures).arg(loud.pending)
+        .arg(loud.speed(), 0, 'f', 1).arg(loud.threads).arg(loud.speedPerThread(), 0, 'f', 1)
+        .arg(norm.measured ? QString("output %1 dB, visualizer %2 dB")
+                                 .arg(norm.outputGainDb, 0, 'f', 1).arg(norm.visualGainDb, 0, 'f', 1)
+                           : QString("not measured yet"));
+
+    text += QString("<h3>PCM bus</h3>"
+                    "<p>Pool: %1 / %2 blocks in use (peak %3)<br>"
+                    "Published: %4, pool exhausted: %5</p><p>")
+        .arg(bus.blocksInUse).arg(bus.poolSize).arg(bus.peakBlocksInUse)
+        .arg(bus.published).arg(bus.poolExhausted);
+    for (const auto& sub : bus.subscribers) {
+        text += QString("%1: delivered %2, dropped %3, pending %4<br>")
+            .arg(QString::fromStdString(sub.name))
+            .arg(sub.delivered).arg(sub.dropped).arg(sub.pending);
+    }
+    text += "</p>";
+
+    QMessageBox::information(this, "Audio Diagnostics", text);
+}
+
 void MainWindow::onToggleFavoritePreset() {
     const auto presetName = m_visualizer ? QString::fromStdString(m_visualizer->getCurrentPresetName()) : QString();
     if (presetName.isEmpty()) return;
@@ -417,4 +770,18 @@ void MainWindow::updatePlaybackPosition(double position, double duration) {
         .arg(formatTime(duration)));
 }
 
+void MainWindow::updateTempoLabel() {
+    const auto tempo = m_tempo->estimate();
+    if (tempo.bpm <= 0.0f) {
+        m_tempoLabel->clear();
+        return;
+    }
+    // Pulse on the beat as it is heard, not as it was decoded
+    const double phase = tempo.beatPhaseAt(m_audioEngine->playbackClock()->audibleFrame());
+    m_tempoLabel->setText(QString("%1 %2 BPM (%3%)")
+        .arg(phase < 0.15 ? QChar(0x25CF) : QChar(0x25CB))
+        .arg(tempo.bpm, 0, 'f', 1)
+        .arg(static_cast<int>(tempo.confidence * 100.0f)));
+}
+
 } // namespace NeonWave::GUI
\ No newline at end of file
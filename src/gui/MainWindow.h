@@ -8,6 +8,13 @@
 #include <QMainWindow>
 #include <memory>
 #include "core/audio/AudioEngine.h"
+#include "core/audio/AnalysisCache.h"
+#include "core/audio/LoudnessScanner.h"
+#include "core/audio/PulseCapture.h"
+#include "core/audio/SeekIndexCache.h"
+#include "core/audio/SpectrumAnalyzer.h"
+#include "core/audio/TempoAnalyzer.h"
+#include "core/audio/WaveformCache.h"
 
 QT_BEGIN_NAMESPACE
 class QAction;
@@ -22,6 +29,7 @@ namespace NeonWave::GUI {
 
 class ProjectMWidget;
 class AudioPlaylistWidget;
+class WaveformSlider;
 
 /**
  * @class MainWindow
@@ -95,6 +103,11 @@ private slots:
      */
     void onAboutClicked();
     
+    /**
+     * @brief Show audio thread and PCM bus statistics
+     */
+    void onAudioDiagnosticsClicked();
+    
     /**
      * @brief Toggle preset as favorite
      */
@@ -111,6 +124,11 @@ private slots:
      * @param duration Total duration in seconds
      */
     void updatePlaybackPosition(double position, double duration);
+
+    /**
+     * @brief Refresh the tempo readout in the status bar
+     */
+    void updateTempoLabel();
     
 private:
     /**
@@ -132,6 +150,16 @@ private:
      * @brief Create audio control widgets
      */
     void createAudioControls();
+
+    /**
+     * @brief Push the audio section of Config to the engine
+     */
+    void applyAudioSettings();
+
+    /**
+     * @brief Point the visualizer at playback or at PulseAudio capture, per the config
+     */
+    void applyVisualizerInput();
     
     /**
      * @brief Create preset control widgets
@@ -147,7 +175,7 @@ private:
     QPushButton* m_stopBtn;
     QPushButton* m_prevBtn;
     QPushButton* m_nextBtn;
-    QSlider* m_seekSlider;
+    WaveformSlider* m_seekSlider;
     QSlider* m_volumeSlider;
     QLabel* m_timeLabel;
     
@@ -161,11 +189,21 @@ private:
     // State
     bool m_isPlaying;
     std::unique_ptr<NeonWave::Core::Audio::AudioEngine> m_audioEngine;
+    std::unique_ptr<NeonWave::Core::Audio::AnalysisCache> m_analysisCache;
+    std::unique_ptr<NeonWave::Core::Audio::LoudnessScanner> m_loudnessScanner;
+    std::unique_ptr<NeonWave::Core::Audio::TempoAnalyzer> m_tempo;
+    std::unique_ptr<NeonWave::Core::Audio::SpectrumAnalyzer> m_spectrum;
+    std::unique_ptr<NeonWave::Core::Audio::WaveformCache> m_waveforms;
+    std::unique_ptr<NeonWave::Core::Audio::PulseCapture> m_capture;
+    std::shared_ptr<NeonWave::Core::Audio::SeekIndexCache> m_seekIndexes;
+    QString m_currentTrackPath;
+    QLabel* m_tempoLabel;
     
     // Actions
     QAction* m_addFilesAction;
     QAction* m_settingsAction;
     QAction* m_fullscreenAction;
+    QAction* m_audioDiagnosticsAction;
     QAction* m_aboutAction;
     QAction* m_quitAction;
 };
@@ -52,6 +52,7 @@ void AudioPlaylistWidget::setupUI() {
 }
 
 void AudioPlaylistWidget::addFiles(const QStringList& files) {
+    QStringList added;
     for (const QString& file : files) {
         if (QFileInfo::exists(file)) {
             QString trackName = extractTrackName(file);
@@ -59,10 +60,14 @@ void AudioPlaylistWidget::addFiles(const QStringList& files) {
             item->setData(Qt::UserRole, file); // Store full path
             item->setToolTip(file);
             m_listWidget->addItem(item);
+            added.append(file);
         }
     }
     
     emit audioPlaylistChanged();
+    if (!added.isEmpty()) {
+        emit filesAdded(added);
+    }
 }
 
 void AudioPlaylistWidget::clearPlaylist() {
@@ -80,6 +80,12 @@ signals:
      * @brief Emitted when playlist changes
      */
     void audioPlaylistChanged();
+
+    /**
+     * @brief Emitted after addFiles() with the entries that were actually added
+     * @param files Full paths, in playlist order
+     */
+    void filesAdded(const QStringList& files);
     
 private slots:
     /**
@@ -5,6 +5,7 @@
 
 #include "SettingsDialog.h"
 #include "core/Config.h"
+#include "core/audio/FileDecoder.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -18,6 +19,9 @@
 #include <QPushButton>
 #include <QFileDialog>
 #include <QTabWidget>
+#include <QComboBox>
+#include <QStandardItemModel>
+#include <algorithm>
 
 namespace NeonWave::GUI {
 
@@ -91,6 +95,29 @@ void SettingsDialog::buildUI() {
     m_loadRandomPresetOnStartup = new QCheckBox("Load random preset on startup", visTab);
     visForm->addRow(m_loadRandomPresetOnStartup);
 
+    m_audioSyncOffset = new QSpinBox(visTab);
+    m_audioSyncOffset->setRange(-500, 500);
+    m_audioSyncOffset->setSingleStep(5);
+    m_audioSyncOffset->setSuffix(" ms");
+    m_audioSyncOffset->setToolTip("Positive values delay the visuals further; see View > Audio Diagnostics for the measured latency");
+    visForm->addRow("Audio sync offset", m_audioSyncOffset);
+
+    m_vsync = new QCheckBox("Sync to display refresh (vsync)", visTab);
+    m_vsync->setToolTip("Aligns frames to the display's refresh; turning swap sync on or off takes effect after a restart");
+    visForm->addRow(m_vsync);
+
+    m_adaptiveQuality = new QCheckBox("Lower mesh and resolution to hold the frame rate", visTab);
+    m_adaptiveQuality->setToolTip("Quality changes and their reasons are listed in View > Audio Diagnostics");
+    visForm->addRow(m_adaptiveQuality);
+
+    m_analysisRate = new QComboBox(visTab);
+    m_analysisRate->addItem("Stream rate", 0);
+    m_analysisRate->addItem("22050 Hz", 22050);
+    m_analysisRate->addItem("44100 Hz", 44100);
+    m_analysisRate->addItem("48000 Hz", 48000);
+    m_analysisRate->setToolTip("Rate the visualizer analyses audio at; only the visuals are resampled, playback is untouched");
+    visForm->addRow("Analysis sample rate", m_analysisRate);
+
     // Debug test signal
     m_debugInjectSignal = new QCheckBox("Inject test PCM signal (debug)", visTab);
     visForm->addRow(m_debugInjectSignal);
@@ -124,6 +151,125 @@ void SettingsDialog::buildUI() {
 
     tabs->addTab(visTab, "Visualizer");
 
+    // Audio tab
+    auto* audioTab = new QWidget(this);
+    auto* audioForm = new QFormLayout(audioTab);
+
+    m_gaplessPreroll = new QDoubleSpinBox(audioTab);
+    m_gaplessPreroll->setRange(0.5, 60.0);
+    m_gaplessPreroll->setSingleStep(0.5);
+    m_gaplessPreroll->setToolTip("How long before the end of a track the next one starts decoding");
+    audioForm->addRow("Gapless preroll (s)", m_gaplessPreroll);
+
+    m_crossfade = new QDoubleSpinBox(audioTab);
+    m_crossfade->setRange(0.0, 30.0);
+    m_crossfade->setSingleStep(0.5);
+    m_crossfade->setDecimals(1);
+    m_crossfade->setSuffix(" s");
+    m_crossfade->setSpecialValueText("Off (gapless)");
+    m_crossfade->setToolTip("Fade each track into the next; tracks at different sample rates still play back to back");
+    audioForm->addRow("Crossfade", m_crossfade);
+
+    m_targetLatency = new QSpinBox(audioTab);
+    m_targetLatency->setRange(10, 200);
+    m_targetLatency->setSingleStep(5);
+    m_targetLatency->setSuffix(" ms");
+    m_targetLatency->setToolTip("Audio queued ahead of the output device; raise it if playback crackles");
+    audioForm->addRow("Output latency", m_targetLatency);
+
+    m_decoder = new QComboBox(audioTab);
+    m_decoder->addItem("Qt Multimedia", "qt");
+    m_decoder->addItem("FFmpeg (libav)", "libav");
+    if (!NeonWave::Core::Audio::hasFileDecoder()) {
+        if (auto* model = qobject_cast<QStandardItemModel*>(m_decoder->model())) {
+            model->item(1)->setEnabled(false);
+        }
+        m_decoder->setItemData(1, "Not available in this build", Qt::ToolTipRole);
+    }
+    audioForm->addRow("Decoder", m_decoder);
+
+    m_analysisCache = new QCheckBox("Analyse added tracks in the background", audioTab);
+    m_analysisCache->setToolTip("Spectrum, onset and RMS features are cached on disk and reused across sessions (needs FFmpeg)");
+    m_analysisCache->setEnabled(NeonWave::Core::Audio::hasFileDecoder());
+    audioForm->addRow(m_analysisCache);
+
+    m_loudnessScan = new QCheckBox("Measure loudness of added tracks", audioTab);
+    m_loudnessScan->setToolTip("EBU R128 integrated loudness and true peak, measured on all cores and remembered (needs FFmpeg)");
+    m_loudnessScan->setEnabled(NeonWave::Core::Audio::hasFileDecoder());
+    audioForm->addRow(m_loudnessScan);
+
+    m_normalizeVisualizer = new QCheckBox("Normalise the visualizer feed", audioTab);
+    m_normalizeVisualizer->setToolTip("Quiet and loud masters drive the presets equally hard; playback volume is unchanged");
+    audioForm->addRow(m_normalizeVisualizer);
+
+    m_normalizeOutput = new QCheckBox("Normalise playback volume", audioTab);
+    m_normalizeOutput->setToolTip("Measured tracks play at the target loudness, never peaking above -1 dBTP");
+    audioForm->addRow(m_normalizeOutput);
+
+    m_targetLufs = new QDoubleSpinBox(audioTab);
+    m_targetLufs->setRange(-31.0, -8.0);
+    m_targetLufs->setSingleStep(1.0);
+    m_targetLufs->setDecimals(1);
+    m_targetLufs->setSuffix(" LUFS");
+    audioForm->addRow("Target loudness", m_targetLufs);
+
+    m_visualizerInput = new QComboBox(audioTab);
+    m_visualizerInput->addItem("Playlist playback", "playback");
+    m_visualizerInput->addItem("System audio (PulseAudio capture)", "capture");
+    m_visualizerInput->setToolTip("Capture visualizes whatever another application plays, through a monitor source");
+    audioForm->addRow("Visualize", m_visualizerInput);
+
+    m_captureSource = new QLineEdit(audioTab);
+    m_captureSource->setPlaceholderText("Default output's monitor");
+    m_captureSource->setToolTip("PulseAudio source name, e.g. alsa_output.pci-0000_00_1f.3.analog-stereo.monitor (see pactl list sources short)");
+    audioForm->addRow("Capture source", m_captureSource);
+
+    m_captureFragment = new QSpinBox(audioTab);
+    m_captureFragment->setRange(1, 50);
+    m_captureFragment->setSuffix(" ms");
+    m_captureFragment->setToolTip("How much audio the server gathers before handing it over");
+    audioForm->addRow("Capture fragment", m_captureFragment);
+
+    auto updateCaptureControls = [this]() {
+        const bool capture = m_visualizerInput->currentData().toString() == "capture";
+        m_captureSource->setEnabled(capture);
+        m_captureFragment->setEnabled(capture);
+    };
+    connect(m_visualizerInput, &QComboBox::currentIndexChanged, this, updateCaptureControls);
+
+    m_equalizer = new QCheckBox("Equalizer", audioTab);
+    m_equalizer->setToolTip("Parametric EQ on playback; band frequencies and Q are set in settings.json");
+    audioForm->addRow(m_equalizer);
+
+    // One gain per band in settings.json, labelled with its frequency
+    m_eqRow = new QWidget(audioTab);
+    auto* eqLayout = new QHBoxLayout(m_eqRow);
+    eqLayout->setContentsMargins(0, 0, 0, 0);
+    for (const auto& band : NeonWave::Core::Config::instance().audio().eqBands) {
+        auto* column = new QVBoxLayout();
+        auto* gain = new QDoubleSpinBox(m_eqRow);
+        gain->setRange(-12.0, 12.0);
+        gain->setSingleStep(0.5);
+        gain->setDecimals(1);
+        gain->setSuffix(" dB");
+        gain->setToolTip(QString("%1, Q %2").arg(QString::fromStdString(band.type)).arg(band.q));
+        const QString frequency = band.frequencyHz >= 1000.0
+            ? QString("%1 kHz").arg(band.frequencyHz / 1000.0)
+            : QString("%1 Hz").arg(band.frequencyHz);
+        column->addWidget(new QLabel(frequency, m_eqRow), 0, Qt::AlignHCenter);
+        column->addWidget(gain);
+        eqLayout->addLayout(column);
+        m_eqGains.push_back(gain);
+    }
+    audioForm->addRow(m_eqRow);
+    connect(m_equalizer, &QCheckBox::toggled, m_eqRow, &QWidget::setEnabled);
+
+    m_limiter = new QCheckBox("Limit output peaks to -1 dBFS", audioTab);
+    m_limiter->setToolTip("Lookahead limiter after volume and EQ, so boosts never clip; adds 2 ms of latency");
+    audioForm->addRow(m_limiter);
+
+    tabs->addTab(audioTab, "Audio");
+
     // Buttons
     auto* buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, this);
     connect(buttons, &QDialogButtonBox::accepted, this, [this]() {
@@ -150,8 +296,35 @@ void SettingsDialog::loadFromConfig() {
     m_presetLocked->setChecked(v.presetLocked);
     m_debugInjectSignal->setChecked(v.debugInjectTestSignal);
     m_loadRandomPresetOnStartup->setChecked(v.loadRandomPresetOnStartup);
+    m_audioSyncOffset->setValue(v.audioSyncOffsetMs);
+    m_vsync->setChecked(v.vsync);
+    m_adaptiveQuality->setChecked(v.adaptiveQuality);
+    m_analysisRate->setCurrentIndex(std::max(0, m_analysisRate->findData(v.analysisSampleRate)));
     m_presetDir->setText(QString::fromStdString(v.presetDirectory));
     m_textureDir->setText(QString::fromStdString(v.textureDirectory));
+
+    const auto& a = cfg.audio();
+    m_gaplessPreroll->setValue(a.gaplessPrerollSeconds);
+    m_crossfade->setValue(a.crossfadeSeconds);
+    m_targetLatency->setValue(a.targetLatencyMs);
+    m_decoder->setCurrentIndex(std::max(0, m_decoder->findData(QString::fromStdString(a.decoder))));
+    m_analysisCache->setChecked(a.analysisCache);
+    m_loudnessScan->setChecked(a.loudnessScan);
+    m_normalizeVisualizer->setChecked(a.normalizeVisualizer);
+    m_normalizeOutput->setChecked(a.normalizeOutput);
+    m_targetLufs->setValue(a.targetLufs);
+    m_visualizerInput->setCurrentIndex(std::max(0, m_visualizerInput->findData(QString::fromStdString(a.visualizerInput))));
+    m_captureSource->setText(QString::fromStdString(a.captureSource));
+    m_captureFragment->setValue(a.captureFragmentMs);
+    const bool capture = a.visualizerInput == "capture";
+    m_captureSource->setEnabled(capture);
+    m_captureFragment->setEnabled(capture);
+    m_equalizer->setChecked(a.equalizer);
+    for (std::size_t i = 0; i < m_eqGains.size() && i < a.eqBands.size(); ++i) {
+        m_eqGains[i]->setValue(a.eqBands[i].gainDb);
+    }
+    m_eqRow->setEnabled(a.equalizer);
+    m_limiter->setChecked(a.limiter);
 }
 
 void SettingsDialog::saveToConfig() {
@@ -169,8 +342,31 @@ void SettingsDialog::saveToConfig() {
     v.presetLocked = m_presetLocked->isChecked();
     v.debugInjectTestSignal = m_debugInjectSignal->isChecked();
     v.loadRandomPresetOnStartup = m_loadRandomPresetOnStartup->isChecked();
+    v.audioSyncOffsetMs = m_audioSyncOffset->value();
+    v.vsync = m_vsync->isChecked();
+    v.adaptiveQuality = m_adaptiveQuality->isChecked();
+    v.analysisSampleRate = m_analysisRate->currentData().toInt();
     v.presetDirectory = m_presetDir->text().toStdString();
     v.textureDirectory = m_textureDir->text().toStdString();
+
+    auto& a = cfg.audio();
+    a.gaplessPrerollSeconds = m_gaplessPreroll->value();
+    a.crossfadeSeconds = m_crossfade->value();
+    a.targetLatencyMs = m_targetLatency->value();
+    a.decoder = m_decoder->currentData().toString().toStdString();
+    a.analysisCache = m_analysisCache->isChecked();
+    a.loudnessScan = m_loudnessScan->isChecked();
+    a.normalizeVisualizer = m_normalizeVisualizer->isChecked();
+    a.normalizeOutput = m_normalizeOutput->isChecked();
+    a.targetLufs = m_targetLufs->value();
+    a.visualizerInput = m_visualizerInput->currentData().toString().toStdString();
+    a.captureSource = m_captureSource->text().trimmed().toStdString();
+    a.captureFragmentMs = m_captureFragment->value();
+    a.equalizer = m_equalizer->isChecked();
+    for (std::size_t i = 0; i < m_eqGains.size() && i < a.eqBands.size(); ++i) {
+        a.eqBands[i].gainDb = m_eqGains[i]->value();
+    }
+    a.limiter = m_limiter->isChecked();
     cfg.save();
 }
 
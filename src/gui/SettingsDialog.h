@@ -7,6 +7,7 @@
 
 #include <QDialog>
 #include <memory>
+#include <vector>
 
 QT_BEGIN_NAMESPACE
 class QSpinBox;
@@ -15,6 +16,7 @@ class QCheckBox;
 class QLineEdit;
 class QPushButton;
 class QTabWidget;
+class QComboBox;
 QT_END_NAMESPACE
 
 namespace NeonWave::GUI {
@@ -43,10 +45,32 @@ private:
     QCheckBox* m_presetLocked{};
     QCheckBox* m_debugInjectSignal{};
     QCheckBox* m_loadRandomPresetOnStartup{};
+    QSpinBox* m_audioSyncOffset{};
+    QCheckBox* m_vsync{};
+    QCheckBox* m_adaptiveQuality{};
+    QComboBox* m_analysisRate{};
     QLineEdit* m_presetDir{};
     QPushButton* m_browsePresetDir{};
     QLineEdit* m_textureDir{};
     QPushButton* m_browseTextureDir{};
+
+    // Audio tab controls
+    QDoubleSpinBox* m_gaplessPreroll{};
+    QDoubleSpinBox* m_crossfade{};
+    QSpinBox* m_targetLatency{};
+    QComboBox* m_decoder{};
+    QCheckBox* m_analysisCache{};
+    QCheckBox* m_loudnessScan{};
+    QCheckBox* m_normalizeVisualizer{};
+    QCheckBox* m_normalizeOutput{};
+    QDoubleSpinBox* m_targetLufs{};
+    QComboBox* m_visualizerInput{};
+    QLineEdit* m_captureSource{};
+    QSpinBox* m_captureFragment{};
+    QCheckBox* m_equalizer{};
+    QWidget* m_eqRow{};
+    std::vector<QDoubleSpinBox*> m_eqGains; // one per configured band
+    QCheckBox* m_limiter{};
 };
 
 } // namespace NeonWave::GUI
@@ -0,0 +1,193 @@
+/**
+ * @file WaveformSlider.cpp
+ * @brief Implementation of the waveform seek slider
+ */
+
+#include "WaveformSlider.h"
+#include <QMouseEvent>
+#include <QPainter>
+#include <QWheelEvent>
+#include <algorithm>
+#include <cmath>
+
+namespace NeonWave::GUI {
+
+namespace {
+
+constexpr double kZoomStep = 2.0;       // per wheel notch
+constexpr double kMinSpanMs = 50.0;     // deepest zoom
+constexpr double kPanFraction = 0.1;    // of the view, per wheel notch
+
+} // namespace
+
+WaveformSlider::WaveformSlider(QWidget* parent)
+    : QSlider(Qt::Horizontal, parent) {
+}
+
+WaveformSlider::~WaveformSlider() = default;
+
+void WaveformSlider::setWaveform(std::shared_ptr<const Core::Audio::WaveformPyramid> pyramid) {
+    m_pyramid = std::move(pyramid);
+    m_zoomed = false;
+    m_viewStart = minimum();
+    m_viewEnd = maximum();
+    updateGeometry();
+    update();
+}
+
+QSize WaveformSlider::sizeHint() const {
+    const QSize base = QSlider::sizeHint();
+    return m_pyramid ? QSize(base.width(), std::max(base.height(), 32)) : base;
+}
+
+QSize WaveformSlider::minimumSizeHint() const {
+    const QSize base = QSlider::minimumSizeHint();
+    return m_pyramid ? QSize(base.width(), std::max(base.height(), 24)) : base;
+}
+
+int WaveformSlider::valueAtX(double x) const {
+    const double value = m_viewStart + viewSpan() * std::clamp(x / std::max(width(), 1), 0.0, 1.0);
+    return static_cast<int>(std::lround(std::clamp(value, static_cast<double>(minimum()), static_cast<double>(maximum()))));
+}
+
+double WaveformSlider::xOfValue(int value) const {
+    return viewSpan() > 0.0 ? (value - m_viewStart) / viewSpan() * width() : 0.0;
+}
+
+void WaveformSlider::clampView() {
+    const double range = maximum() - minimum();
+    const double span = std::clamp(viewSpan(), std::min(kMinSpanMs, range), range);
+    m_viewStart = std::clamp(m_viewStart, static_cast<double>(minimum()), maximum() - span);
+    m_viewEnd = m_viewStart + span;
+    m_zoomed = span < range;
+}
+
+void WaveformSlider::sliderChange(SliderChange change) {
+    if (change == SliderRangeChange) {
+        if (!m_zoomed) {
+            m_viewStart = minimum();
+            m_viewEnd = maximum();
+        }
+        clampView();
+    } else if (change == SliderValueChange && m_zoomed && !isSliderDown()) {
+        // Page along with the playhead
+        if (value() < m_viewStart || value() > m_viewEnd) {
+            const double span = viewSpan();
+            m_viewStart = value();
+            m_viewEnd = m_viewStart + span;
+            clampView();
+        }
+    }
+    QSlider::sliderChange(change);
+}
+
+void WaveformSlider::paintEvent(QPaintEvent* event) {
+    if (!m_pyramid || maximum() <= minimum()) {
+        QSlider::paintEvent(event);
+        return;
+    }
+
+    QPainter painter(this);
+    const int w = width();
+    const int h = height();
+    const double mid = h / 2.0;
+    painter.fillRect(rect(), palette().base());
+
+    m_columns.resize(static_cast<std::size_t>(w));
+    m_pyramid->render(m_viewStart / 1000.0, m_viewEnd / 1000.0, m_columns.data(), w);
+
+    const int playheadX = static_cast<int>(std::lround(xOfValue(sliderPosition())));
+    const QColor played = palette().color(QPalette::Highlight);
+    const QColor unplayed = palette().color(QPalette::Mid);
+    for (int x = 0; x < w; ++x) {
+        const auto& c = m_columns[static_cast<std::size_t>(x)];
+        const QColor peak = x < playheadX ? played : unplayed;
+        painter.setPen(peak.darker(130));
+        painter.drawLine(QPointF(x + 0.5, mid - c.max * mid), QPointF(x + 0.5, mid - c.min * mid));
+        painter.setPen(peak.lighter(130));
+        painter.drawLine(QPointF(x + 0.5, mid - c.rms * mid), QPointF(x + 0.5, mid + c.rms * mid));
+    }
+
+    painter.setPen(palette().color(QPalette::Text));
+    painter.drawLine(playheadX, 0, playheadX, h);
+    if (m_zoomed) {
+        // Where the view sits within the whole track
+        const double range = maximum() - minimum();
+        const int left = static_cast<int>((m_viewStart - minimum()) / range * w);
+        const int right = std::max(left + 2, static_cast<int>((m_viewEnd - minimum()) / range * w));
+        painter.fillRect(left, h - 2, right - left, 2, played);
+    }
+    if (hasFocus()) {
+        painter.setPen(palette().color(QPalette::Highlight));
+        painter.drawRect(rect().adjusted(0, 0, -1, -1));
+    }
+}
+
+void WaveformSlider::mousePressEvent(QMouseEvent* event) {
+    if (!m_pyramid || event->button() != Qt::LeftButton) {
+        QSlider::mousePressEvent(event);
+        return;
+    }
+    setSliderDown(true);
+    setSliderPosition(valueAtX(event->position().x()));
+    event->accept();
+}
+
+void WaveformSlider::mouseMoveEvent(QMouseEvent* event) {
+    if (!m_pyramid || !isSliderDown()) {
+        QSlider::mouseMoveEvent(event);
+        return;
+    }
+    setSliderPosition(valueAtX(event->position().x()));
+    event->accept();
+}
+
+void WaveformSlider::mouseReleaseEvent(QMouseEvent* event) {
+    if (!m_pyramid || event->button() != Qt::LeftButton || !isSliderDown()) {
+        QSlider::mouseReleaseEvent(event);
+        return;
+    }
+    setSliderPosition(valueAtX(event->position().x()));
+    setSliderDown(false);
+    event->accept();
+}
+
+void WaveformSlider::mouseDoubleClickEvent(QMouseEvent* event) {
+    if (!m_pyramid) {
+        QSlider::mouseDoubleClickEvent(event);
+        return;
+    }
+    m_viewStart = minimum();
+    m_viewEnd = maximum();
+    clampView();
+    update();
+    event->accept();
+}
+
+void WaveformSlider::wheelEvent(QWheelEvent* event) {
+    if (!m_pyramid || maximum() <= minimum()) {
+        QSlider::wheelEvent(event);
+        return;
+    }
+    const double notches = event->angleDelta().y() / 120.0;
+    if (event->modifiers() & Qt::ControlModifier) {
+        // Zoom around the cursor so the point under it stays put
+        const double fraction = std::clamp(event->position().x() / std::max(width(), 1), 0.0, 1.0);
+        const double anchor = m_viewStart + viewSpan() * fraction;
+        const double span = viewSpan() / std::pow(kZoomStep, notches);
+        m_viewStart = anchor - span * fraction;
+        m_viewEnd = m_viewStart + span;
+    } else if (m_zoomed) {
+        const double shift = -notches * viewSpan() * kPanFraction;
+        m_viewStart += shift;
+        m_viewEnd += shift;
+    } else {
+        QSlider::wheelEvent(event);
+        return;
+    }
+    clampView();
+    update();
+    event->accept();
+}
+
+} // namespace NeonWave::GUI
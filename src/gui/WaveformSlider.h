@@ -0,0 +1,68 @@
+/**
+ * @file WaveformSlider.h
+ * @brief Seek slider that draws the track's waveform overview
+ */
+
+#pragma once
+
+#include <QSlider>
+#include <memory>
+#include <vector>
+#include "core/audio/WaveformPyramid.h"
+
+namespace NeonWave::GUI {
+
+/**
+ * @class WaveformSlider
+ * @brief Horizontal QSlider (value in milliseconds) drawn as a min/max/RMS waveform
+ *
+ * Behaves as a plain QSlider until a pyramid is set. With one:
+ * - Click or drag seeks to the point under the cursor (sliderMoved is emitted)
+ * - Ctrl+wheel zooms around the cursor, wheel pans while zoomed
+ * - Double-click shows the whole track again
+ * - While zoomed, the view pages along with the playhead
+ *
+ * Every paint renders one column per pixel from the pyramid, so zooming and
+ * resizing cost O(width) and never decode anything.
+ */
+class WaveformSlider : public QSlider {
+    Q_OBJECT
+
+public:
+    explicit WaveformSlider(QWidget* parent = nullptr);
+    ~WaveformSlider();
+
+    /**
+     * @brief Show @p pyramid, or nothing when null; the zoom is reset
+     * @param pyramid Overview of the track now playing
+     */
+    void setWaveform(std::shared_ptr<const Core::Audio::WaveformPyramid> pyramid);
+
+    QSize sizeHint() const override;
+    QSize minimumSizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void mouseMoveEvent(QMouseEvent* event) override;
+    void mouseReleaseEvent(QMouseEvent* event) override;
+    void mouseDoubleClickEvent(QMouseEvent* event) override;
+    void wheelEvent(QWheelEvent* event) override;
+    void sliderChange(SliderChange change) override;
+
+private:
+    /// Visible span in milliseconds of slider value.
+    double viewSpan() const { return m_viewEnd - m_viewStart; }
+    int valueAtX(double x) const;
+    double xOfValue(int value) const;
+    /// Keep the view inside [minimum, maximum] and at least a few pixels of audio wide.
+    void clampView();
+
+    std::shared_ptr<const Core::Audio::WaveformPyramid> m_pyramid;
+    std::vector<Core::Audio::WaveformColumn> m_columns;
+    double m_viewStart = 0.0;
+    double m_viewEnd = 0.0;
+    bool m_zoomed = false;
+};
+
+} // namespace NeonWave::GUI
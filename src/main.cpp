@@ -11,9 +11,20 @@
 #include <QTextStream>
 #include <iostream>
 #include <memory>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
 
 #include "core/Application.h"
+#include "core/Config.h"
 #include "gui/MainWindow.h"
+#include "core/audio/AudioBenchmark.h"
+#include "visualizer/FrameClock.h"
+#include "visualizer/HeadlessRunner.h"
+#include "visualizer/OfflineRenderer.h"
+#include "visualizer/ReadbackRing.h"
+#include "visualizer/RenderFarm.h"
 
 /**
  * @brief Application entry point
@@ -22,6 +33,45 @@
  * @return Exit code
  */
 int main(int argc, char *argv[]) {
+    // Headless developer entry points
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--benchmark-audio") == 0) {
+            return NeonWave::Core::Audio::runAudioBenchmarks({ argv + i + 1, argv + argc });
+        }
+        if (std::strcmp(argv[i], "--benchmark-tempo") == 0) {
+            return NeonWave::Core::Audio::runTempoBenchmark(i + 1 < argc ? argv[i + 1] : "");
+        }
+        if (std::strcmp(argv[i], "--benchmark-seek") == 0) {
+            return NeonWave::Core::Audio::runSeekBenchmark({ argv + i + 1, argv + argc });
+        }
+        if (std::strcmp(argv[i], "--benchmark-capture") == 0) {
+            return NeonWave::Core::Audio::runCaptureBenchmark(i + 1 < argc ? argv[i + 1] : "",
+                                                              i + 2 < argc ? std::atof(argv[i + 2]) : 10.0);
+        }
+        if (std::strcmp(argv[i], "--benchmark-frameclock") == 0) {
+            return NeonWave::GUI::FrameClock::runBenchmark(i + 1 < argc ? std::atoi(argv[i + 1]) : 60,
+                                                           i + 2 < argc ? std::atof(argv[i + 2]) : 5.0);
+        }
+        if (std::strcmp(argv[i], "--benchmark-readback") == 0) {
+            return NeonWave::GUI::ReadbackRing::runBenchmark(i + 1 < argc ? std::atoi(argv[i + 1]) : 3,
+                                                             i + 2 < argc ? std::atoi(argv[i + 2]) : 120);
+        }
+        if (std::strcmp(argv[i], "--headless") == 0 || std::strcmp(argv[i], "--render") == 0
+            || std::strcmp(argv[i], "--render-farm") == 0) {
+            // No QApplication: nothing here may need a display
+            QCoreApplication coreApp(argc, argv);
+            QCoreApplication::setOrganizationName("NeonWave");
+            QCoreApplication::setApplicationName("NeonWave");
+            NeonWave::Core::Application app;
+            app.initialize();
+            NeonWave::Core::Config::instance().load();
+            const std::vector<std::string> args(argv + i + 1, argv + argc);
+            if (std::strcmp(argv[i], "--headless") == 0) return NeonWave::GUI::runHeadless(args);
+            if (std::strcmp(argv[i], "--render-farm") == 0) return NeonWave::GUI::runRenderFarm(args);
+            return NeonWave::GUI::runRender(args);
+        }
+    }
+
     // Initialize Qt application
     QApplication qtApp(argc, argv);
     
@@ -0,0 +1,197 @@
+/**
+ * @file FrameClock.cpp
+ * @brief Implementation of frame pacing
+ */
+
+#include "FrameClock.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "core/audio/PlaybackClock.h"
+
+namespace NeonWave::GUI {
+
+namespace {
+
+using Core::Audio::PlaybackClock;
+
+/// Stand-in for rendering: spin for @p ns so the thread is busy, as it would be in projectM.
+void busyFor(std::int64_t ns) {
+    const std::int64_t until = PlaybackClock::nowNs() + ns;
+    while (PlaybackClock::nowNs() < until) {
+    }
+}
+
+struct LoopResult {
+    std::uint64_t frames = 0;
+    std::uint64_t skipped = 0;
+    double seconds = 0.0;
+    std::vector<double> intervalsMs;
+};
+
+/// Synthetic frame cost: a quarter of the period, with a 2.5-period stall every 97th frame.
+std::int64_t workloadNs(std::uint64_t frame, std::int64_t periodNs) {
+    return frame % 97 == 96 ? periodNs * 5 / 2 : periodNs / 4;
+}
+
+double sortedPercentile(const std::vector<double>& sorted, double fraction) {
+    if (sorted.empty()) return 0.0;
+    const auto rank = static_cast<std::size_t>(std::ceil(fraction * static_cast<double>(sorted.size())));
+    return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+void printLoop(const char* name, LoopResult& r, int fps) {
+    std::sort(r.intervalsMs.begin(), r.intervalsMs.end());
+    const double expected = r.seconds * fps;
+    std::printf("  %-22s %8llu %9.2f %+8.2f%% %8llu %8.2f %8.2f %8.2f\n", name,
+                static_cast<unsigned long long>(r.frames), r.frames / r.seconds,
+                expected > 0.0 ? (r.frames + r.skipped - expected) / expected * 100.0 : 0.0,
+                static_cast<unsigned long long>(r.skipped),
+                sortedPercentile(r.intervalsMs, 0.50), sortedPercentile(r.intervalsMs, 0.99),
+                r.intervalsMs.empty() ? 0.0 : r.intervalsMs.back());
+}
+
+} // namespace
+
+FrameClock::FrameClock(int fps)
+    : m_fps(std::clamp(fps, 1, 1000))
+{
+    m_stats.fps = m_fps;
+    m_stats.targetMs = 1000.0 / m_fps;
+}
+
+void FrameClock::setRate(int fps) {
+    fps = std::clamp(fps, 1, 1000);
+    if (fps == m_fps) return;
+    m_originNs = deadlineNs();
+    m_index = 0;
+    m_fps = fps;
+    m_stats.fps = m_fps;
+    m_stats.targetMs = 1000.0 / m_fps;
+}
+
+void FrameClock::reset(std::int64_t nowNs) {
+    m_originNs = nowNs;
+    m_index = 0;
+    m_lastStartNs = 0;
+    m_stats = Stats{};
+    m_stats.fps = m_fps;
+    m_stats.targetMs = 1000.0 / m_fps;
+}
+
+int FrameClock::beginFrame(std::int64_t nowNs) {
+    if (m_lastStartNs != 0) {
+        const double intervalMs = (nowNs - m_lastStartNs) * 1e-6;
+        const int bin = std::clamp(static_cast<int>(intervalMs / kHistogramBinMs), 0, kHistogramBins - 1);
+        ++m_stats.intervalHistogram[static_cast<std::size_t>(bin)];
+    }
+    m_lastStartNs = nowNs;
+    ++m_stats.frames;
+
+    // This frame takes the latest slot that has already begun, never an earlier one
+    std::int64_t slot = m_index;
+    if (nowNs - slotNs(m_index) >= periodNs()) {
+        slot += (nowNs - slotNs(m_index)) * m_fps / kNsPerSecond;
+        while (slotNs(slot + 1) <= nowNs) ++slot;
+        while (slot > m_index && slotNs(slot) > nowNs) --slot;
+    }
+    const auto skipped = static_cast<int>(slot - m_index);
+    if (skipped > 0) {
+        m_stats.skipped += static_cast<std::uint64_t>(skipped);
+        ++m_stats.lateFrames;
+    }
+    m_index = slot + 1;
+
+    // Whole seconds of grid fold into the origin exactly, so the index never grows large
+    if (m_index >= m_fps) {
+        m_originNs += (m_index / m_fps) * kNsPerSecond;
+        m_index %= m_fps;
+    }
+    return skipped;
+}
+
+void FrameClock::alignTo(std::int64_t swapNs, std::int64_t leadNs) {
+    const std::int64_t period = periodNs();
+    // Error from the pending deadline to the nearest wanted start, in [-period/2, period/2)
+    std::int64_t error = (swapNs - leadNs - deadlineNs()) % period;
+    if (error < 0) error += period;
+    if (error >= period / 2) error -= period;
+    m_stats.phaseErrorMs = error * 1e-6;
+
+    // Converge over a few frames rather than jump: swap timestamps carry scheduling noise
+    const std::int64_t step = std::clamp(error / 8, -kMaxPhaseStepNs, kMaxPhaseStepNs);
+    if (step == 0) return;
+    m_originNs += step;
+    ++m_stats.alignments;
+}
+
+void FrameClock::sleepUntil(std::int64_t deadlineNs) {
+    const std::chrono::steady_clock::time_point until{
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(deadlineNs))};
+    std::this_thread::sleep_until(until);
+}
+
+int FrameClock::runBenchmark(int fps, double seconds) {
+    fps = std::clamp(fps, 1, 1000);
+    const auto durationNs = static_cast<std::int64_t>(seconds * 1e9);
+    const std::int64_t periodNs = kNsPerSecond / fps;
+
+    std::cout << "[Benchmark] Frame pacing at " << fps << " fps for " << seconds
+              << " s per loop, render cost " << (periodNs / 4) * 1e-6 << " ms, stall every 97th frame" << std::endl;
+
+    // Whole-millisecond interval re-armed at each wake-up, like a QTimer with a fixed interval
+    LoopResult naive;
+    {
+        const std::int64_t intervalNs = (1000 / fps) * 1'000'000;
+        const std::int64_t start = PlaybackClock::nowNs();
+        std::int64_t last = 0;
+        std::int64_t wake = start;
+        while (wake - start < durationNs) {
+            if (last != 0) naive.intervalsMs.push_back((wake - last) * 1e-6);
+            last = wake;
+            busyFor(workloadNs(naive.frames++, periodNs));
+            sleepUntil(std::max(PlaybackClock::nowNs(), wake + intervalNs) / 1'000'000 * 1'000'000);
+            wake = PlaybackClock::nowNs();
+        }
+        naive.seconds = (wake - start) * 1e-9;
+    }
+
+    LoopResult paced;
+    FrameClock clock(fps);
+    {
+        const std::int64_t start = PlaybackClock::nowNs();
+        clock.reset(start);
+        std::int64_t last = 0;
+        std::int64_t now = start;
+        while (now - start < durationNs) {
+            sleepUntil(clock.deadlineNs());
+            now = PlaybackClock::nowNs();
+            if (last != 0) paced.intervalsMs.push_back((now - last) * 1e-6);
+            last = now;
+            clock.beginFrame(now);
+            busyFor(workloadNs(paced.frames++, periodNs));
+        }
+        paced.skipped = clock.stats().skipped;
+        paced.seconds = (now - start) * 1e-9;
+    }
+
+    std::printf("  %-22s %8s %9s %9s %8s %8s %8s %8s\n",
+                "loop", "frames", "fps", "drift", "skipped", "p50 ms", "p99 ms", "max ms");
+    printLoop("fixed-interval timer", naive, fps);
+    printLoop("FrameClock", paced, fps);
+
+    std::cout << "  FrameClock interval histogram (" << kHistogramBinMs << " ms bins):" << std::endl;
+    const auto& histogram = clock.stats().intervalHistogram;
+    for (int i = 0; i < kHistogramBins; ++i) {
+        if (histogram[static_cast<std::size_t>(i)] == 0) continue;
+        std::printf("    %6.1f%s ms %8llu\n", i * kHistogramBinMs, i == kHistogramBins - 1 ? "+" : " ",
+                    static_cast<unsigned long long>(histogram[static_cast<std::size_t>(i)]));
+    }
+    return 0;
+}
+
+} // namespace NeonWave::GUI
@@ -0,0 +1,102 @@
+/**
+ * @file FrameClock.h
+ * @brief Frame pacing against a fixed, drift-free deadline grid
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace NeonWave::GUI {
+
+/**
+ * @class FrameClock
+ * @brief Schedules frames at a target rate on the monotonic clock
+ *
+ * Deadlines are computed from a frame index on a fixed grid
+ * (origin + n * 1 s / fps, in integer nanoseconds) rather than as
+ * "previous frame + period", so timer slop and rounding never accumulate
+ * into drift. A frame that starts a whole period or more behind its
+ * deadline does not trigger catch-up frames back to back: the grid slots
+ * it missed are skipped and counted, and the next deadline is the first
+ * one still in the future.
+ *
+ * Optionally the grid is phase-locked to presentation: alignTo() nudges
+ * the origin so that deadlines fall a fixed lead before each observed
+ * buffer swap, making rendered frames ready just ahead of vsync.
+ *
+ * Not thread-safe; the render loop owns it and publishes stats() copies.
+ */
+class FrameClock {
+public:
+    static constexpr double kHistogramBinMs = 0.5;
+    static constexpr int kHistogramBins = 100;          ///< The last bin also takes every longer interval
+    static constexpr std::int64_t kFineWaitNs = 2'000'000; ///< Slept precisely rather than left to a millisecond timer
+    static constexpr std::int64_t kMaxPhaseStepNs = 500'000; ///< Most the grid moves per alignTo()
+
+    struct Stats {
+        int fps = 0;
+        double targetMs = 0.0;
+        std::uint64_t frames = 0;
+        std::uint64_t skipped = 0;        ///< Grid slots given up instead of rendered late
+        std::uint64_t lateFrames = 0;     ///< Frames that had to skip at least one slot
+        std::uint64_t alignments = 0;     ///< alignTo() calls that moved the grid
+        double phaseErrorMs = 0.0;        ///< Deadline-to-swap error at the last alignTo(), lead removed
+        std::array<std::uint64_t, kHistogramBins> intervalHistogram{}; ///< Frame start to frame start
+    };
+
+    explicit FrameClock(int fps = 60);
+
+    /// Change the target rate; the grid restarts at the pending deadline, so nothing jumps.
+    void setRate(int fps);
+    int fps() const { return m_fps; }
+    std::int64_t periodNs() const { return kNsPerSecond / m_fps; }
+
+    /// Start a new grid whose first deadline is @p nowNs; clears the interval history.
+    void reset(std::int64_t nowNs);
+
+    /// When the next frame should start.
+    std::int64_t deadlineNs() const { return slotNs(m_index); }
+
+    /**
+     * @brief Record that a frame starts now and advance to the next deadline
+     * @return Grid slots skipped because the frame started a period or more late
+     */
+    int beginFrame(std::int64_t nowNs);
+
+    /**
+     * @brief Pull the grid toward a presentation time
+     * @param swapNs When a buffer swap was observed
+     * @param leadNs How long before the swap a frame should start
+     */
+    void alignTo(std::int64_t swapNs, std::int64_t leadNs);
+
+    const Stats& stats() const { return m_stats; }
+
+    /// Sleep on the monotonic clock until @p deadlineNs (PlaybackClock::nowNs() time base).
+    static void sleepUntil(std::int64_t deadlineNs);
+
+    /**
+     * @brief Pace a simulated render loop and print the interval histogram
+     *
+     * Invoked by `neonwave --benchmark-frameclock [fps] [seconds]`. Runs a
+     * naive sleep-for-the-period loop and the FrameClock side by side on
+     * the same synthetic workload (with periodic stalls), then reports the
+     * achieved rate, drift, skipped slots and interval percentiles of each.
+     */
+    static int runBenchmark(int fps = 60, double seconds = 5.0);
+
+private:
+    static constexpr std::int64_t kNsPerSecond = 1'000'000'000;
+
+    std::int64_t slotNs(std::int64_t index) const { return m_originNs + index * kNsPerSecond / m_fps; }
+
+    int m_fps;
+    std::int64_t m_originNs = 0;
+    std::int64_t m_index = 0;       // grid slot of the next deadline
+    std::int64_t m_lastStartNs = 0; // 0 = no frame yet
+    Stats m_stats;
+};
+
+} // namespace NeonWave::GUI
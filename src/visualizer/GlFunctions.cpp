@@ -0,0 +1,22 @@
+/**
+ * @file GlFunctions.cpp
+ * @brief Implementation of the GL entry point table
+ */
+
+#include "GlFunctions.h"
+
+namespace NeonWave::GUI {
+
+bool GlFunctions::load(const Resolver& resolve, std::string* missing) {
+#define NEONWAVE_GL_RESOLVE(ret, name, params)                                              \
+    gl##name = reinterpret_cast<ret (APIENTRY*) params>(resolve("gl" #name));                \
+    if (!gl##name) {                                                                          \
+        if (missing) *missing = "gl" #name;                                                   \
+        return false;                                                                         \
+    }
+    NEONWAVE_GL_FUNCTIONS(NEONWAVE_GL_RESOLVE)
+#undef NEONWAVE_GL_RESOLVE
+    return true;
+}
+
+} // namespace NeonWave::GUI
@@ -0,0 +1,89 @@
+/**
+ * @file GlFunctions.h
+ * @brief OpenGL entry points resolved from whichever context the render core runs in
+ */
+
+#pragma once
+
+#include <GL/gl.h>
+#include <GL/glext.h>
+#include <functional>
+#include <string>
+
+namespace NeonWave::GUI {
+
+/// Return type, name without the gl prefix, parameter list.
+#define NEONWAVE_GL_FUNCTIONS(X) \
+    X(void, Enable, (GLenum cap)) \
+    X(void, BlendFunc, (GLenum sfactor, GLenum dfactor)) \
+    X(void, GetIntegerv, (GLenum pname, GLint* data)) \
+    X(const GLubyte*, GetString, (GLenum name)) \
+    X(GLenum, GetError, ()) \
+    X(void, Viewport, (GLint x, GLint y, GLsizei width, GLsizei height)) \
+    X(void, ClearColor, (GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)) \
+    X(void, Clear, (GLbitfield mask)) \
+    X(void, Flush, ()) \
+    X(void, Finish, ()) \
+    X(void, PixelStorei, (GLenum pname, GLint param)) \
+    X(void, ReadPixels, (GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void* pixels)) \
+    X(void, GenTextures, (GLsizei n, GLuint* textures)) \
+    X(void, DeleteTextures, (GLsizei n, const GLuint* textures)) \
+    X(void, BindTexture, (GLenum target, GLuint texture)) \
+    X(void, TexImage2D, (GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, \
+                         GLint border, GLenum format, GLenum type, const void* pixels)) \
+    X(void, TexParameteri, (GLenum target, GLenum pname, GLint param)) \
+    X(void, GenFramebuffers, (GLsizei n, GLuint* framebuffers)) \
+    X(void, DeleteFramebuffers, (GLsizei n, const GLuint* framebuffers)) \
+    X(void, BindFramebuffer, (GLenum target, GLuint framebuffer)) \
+    X(GLenum, CheckFramebufferStatus, (GLenum target)) \
+    X(void, FramebufferTexture2D, (GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level)) \
+    X(void, FramebufferRenderbuffer, (GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer)) \
+    X(void, BlitFramebuffer, (GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, \
+                              GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter)) \
+    X(void, GenRenderbuffers, (GLsizei n, GLuint* renderbuffers)) \
+    X(void, DeleteRenderbuffers, (GLsizei n, const GLuint* renderbuffers)) \
+    X(void, BindRenderbuffer, (GLenum target, GLuint renderbuffer)) \
+    X(void, RenderbufferStorageMultisample, (GLenum target, GLsizei samples, GLenum internalformat, \
+                                             GLsizei width, GLsizei height)) \
+    X(void, GenBuffers, (GLsizei n, GLuint* buffers)) \
+    X(void, DeleteBuffers, (GLsizei n, const GLuint* buffers)) \
+    X(void, BindBuffer, (GLenum target, GLuint buffer)) \
+    X(void, BufferData, (GLenum target, GLsizeiptr size, const void* data, GLenum usage)) \
+    X(void*, MapBufferRange, (GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)) \
+    X(GLboolean, UnmapBuffer, (GLenum target)) \
+    X(void, GenQueries, (GLsizei n, GLuint* ids)) \
+    X(void, DeleteQueries, (GLsizei n, const GLuint* ids)) \
+    X(void, BeginQuery, (GLenum target, GLuint id)) \
+    X(void, EndQuery, (GLenum target)) \
+    X(void, GetQueryObjectuiv, (GLuint id, GLenum pname, GLuint* params)) \
+    X(GLsync, FenceSync, (GLenum condition, GLbitfield flags)) \
+    X(void, DeleteSync, (GLsync sync)) \
+    X(GLenum, ClientWaitSync, (GLsync sync, GLbitfield flags, GLuint64 timeout)) \
+    X(void, WaitSync, (GLsync sync, GLbitfield flags, GLuint64 timeout))
+
+/**
+ * @struct GlFunctions
+ * @brief The GL 3.3 subset the render core uses, as function pointers
+ *
+ * The render core has to run in a QOpenGLContext next to the widget and
+ * in a bare EGL or OSMesa context on machines with no display, so it
+ * cannot go through QOpenGLFunctions. Instead every entry point is looked
+ * up through the context's own getProcAddress, which also picks the right
+ * driver where several are installed (GLVND).
+ */
+struct GlFunctions {
+#define NEONWAVE_GL_POINTER(ret, name, params) ret (APIENTRY* gl##name) params = nullptr;
+    NEONWAVE_GL_FUNCTIONS(NEONWAVE_GL_POINTER)
+#undef NEONWAVE_GL_POINTER
+
+    using Resolver = std::function<void*(const char* name)>;
+
+    /**
+     * @brief Look up every entry point in the current context
+     * @param missing Receives the first name that did not resolve
+     * @return False if any is missing; the table is then unusable
+     */
+    bool load(const Resolver& resolve, std::string* missing = nullptr);
+};
+
+} // namespace NeonWave::GUI
@@ -0,0 +1,293 @@
+/**
+ * @file HeadlessContext.cpp
+ * @brief Implementation of the windowless GL context
+ */
+
+#include "HeadlessContext.h"
+#include <GL/gl.h>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#ifdef NEONWAVE_HAVE_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+#ifdef NEONWAVE_HAVE_OSMESA
+#include <GL/osmesa.h>
+#endif
+
+namespace NeonWave::GUI {
+
+namespace {
+
+#ifdef NEONWAVE_HAVE_EGL
+bool hasExtension(const char* list, const char* name) {
+    if (!list) return false;
+    const std::size_t length = std::strlen(name);
+    for (const char* p = list; (p = std::strstr(p, name)) != nullptr; p += length) {
+        if ((p == list || p[-1] == ' ') && (p[length] == ' ' || p[length] == '\0')) return true;
+    }
+    return false;
+}
+#endif
+
+} // namespace
+
+/**
+ * @class HeadlessContext::Impl
+ * @brief Whichever backend's handles are in use
+ */
+class HeadlessContext::Impl {
+public:
+    Backend backend = Backend::Auto;
+    std::string description;
+#ifdef NEONWAVE_HAVE_EGL
+    EGLDisplay display = EGL_NO_DISPLAY;
+    EGLContext context = EGL_NO_CONTEXT;
+    EGLSurface surface = EGL_NO_SURFACE;
+#endif
+#ifdef NEONWAVE_HAVE_OSMESA
+    OSMesaContext osmesa = nullptr;
+    std::vector<unsigned char> osmesaBuffer; // OSMesaMakeCurrent needs a colour buffer; we draw into FBOs
+#endif
+
+    bool createEgl(bool surfaceless, std::string& error);
+    bool createOsMesa(std::string& error);
+    void destroy();
+};
+
+#ifdef NEONWAVE_HAVE_EGL
+bool HeadlessContext::Impl::createEgl(bool surfaceless, std::string& error) {
+    if (surfaceless) {
+        const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+        if (!hasExtension(clientExtensions, "EGL_MESA_platform_surfaceless")) {
+            error = "EGL_MESA_platform_surfaceless not supported";
+            return false;
+        }
+        auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+            eglGetProcAddress("eglGetPlatformDisplayEXT"));
+        if (!getPlatformDisplay) {
+            error = "eglGetPlatformDisplayEXT missing";
+            return false;
+        }
+        display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    } else {
+        display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr)) {
+        error = "cannot open an EGL display";
+        display = EGL_NO_DISPLAY;
+        return false;
+    }
+    if (surfaceless && !hasExtension(eglQueryString(display, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context")) {
+        error = "EGL_KHR_surfaceless_context not supported";
+        return false;
+    }
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        error = "EGL cannot bind desktop OpenGL";
+        return false;
+    }
+
+    const EGLint configAttribs[] = {
+        EGL_SURFACE_TYPE, surfaceless ? 0 : EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+        EGL_DEPTH_SIZE, 24, EGL_STENCIL_SIZE, 8,
+        EGL_NONE
+    };
+    EGLConfig config = nullptr;
+    EGLint configs = 0;
+    if (!eglChooseConfig(display, configAttribs, &config, 1, &configs) || configs < 1) {
+        error = "no EGL config with desktop OpenGL and RGBA8/D24S8";
+        return false;
+    }
+
+    // Compatibility first, like the widget's context: some presets assume it
+    for (const EGLint profile : { EGL_CONTEXT_OPENGL_COMPATIBILITY_PROFILE_BIT, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT }) {
+        const EGLint contextAttribs[] = {
+            EGL_CONTEXT_MAJOR_VERSION, 3, EGL_CONTEXT_MINOR_VERSION, 3,
+            EGL_CONTEXT_OPENGL_PROFILE_MASK, profile,
+            EGL_NONE
+        };
+        context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttribs);
+        if (context != EGL_NO_CONTEXT) break;
+    }
+    if (context == EGL_NO_CONTEXT) {
+        error = "cannot create an OpenGL 3.3 context";
+        return false;
+    }
+    if (!surfaceless) {
+        const EGLint surfaceAttribs[] = { EGL_WIDTH, 16, EGL_HEIGHT, 16, EGL_NONE };
+        surface = eglCreatePbufferSurface(display, config, surfaceAttribs);
+        if (surface == EGL_NO_SURFACE) {
+            error = "cannot create an EGL pbuffer";
+            return false;
+        }
+    }
+    backend = surfaceless ? Backend::EglSurfaceless : Backend::EglPbuffer;
+    return true;
+}
+#else
+bool HeadlessContext::Impl::createEgl(bool, std::string& error) {
+    error = "built without EGL";
+    return false;
+}
+#endif
+
+#ifdef NEONWAVE_HAVE_OSMESA
+bool HeadlessContext::Impl::createOsMesa(std::string& error) {
+    for (const int profile : { OSMESA_COMPAT_PROFILE, OSMESA_CORE_PROFILE }) {
+        const int attribs[] = {
+            OSMESA_FORMAT, OSMESA_RGBA,
+            OSMESA_DEPTH_BITS, 24,
+            OSMESA_STENCIL_BITS, 8,
+            OSMESA_PROFILE, profile,
+            OSMESA_CONTEXT_MAJOR_VERSION, 3,
+            OSMESA_CONTEXT_MINOR_VERSION, 3,
+            0
+        };
+        osmesa = OSMesaCreateContextAttribs(attribs, nullptr);
+        if (osmesa) break;
+    }
+    if (!osmesa) {
+        error = "cannot create an OSMesa OpenGL 3.3 context";
+        return false;
+    }
+    osmesaBuffer.assign(16 * 16 * 4, 0);
+    backend = Backend::OSMesa;
+    return true;
+}
+#else
+bool HeadlessContext::Impl::createOsMesa(std::string& error) {
+    error = "built without OSMesa";
+    return false;
+}
+#endif
+
+void HeadlessContext::Impl::destroy() {
+#ifdef NEONWAVE_HAVE_EGL
+    if (display != EGL_NO_DISPLAY) {
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (surface != EGL_NO_SURFACE) eglDestroySurface(display, surface);
+        if (context != EGL_NO_CONTEXT) eglDestroyContext(display, context);
+        eglTerminate(display);
+    }
+    display = EGL_NO_DISPLAY;
+    context = EGL_NO_CONTEXT;
+    surface = EGL_NO_SURFACE;
+#endif
+#ifdef NEONWAVE_HAVE_OSMESA
+    if (osmesa) OSMesaDestroyContext(osmesa);
+    osmesa = nullptr;
+#endif
+}
+
+HeadlessContext::HeadlessContext()
+    : pImpl(std::make_unique<Impl>())
+{
+}
+
+HeadlessContext::~HeadlessContext() {
+    pImpl->destroy();
+}
+
+std::unique_ptr<HeadlessContext> HeadlessContext::create(Backend backend, std::string* error) {
+    std::vector<Backend> candidates;
+    if (backend == Backend::Auto) {
+        candidates = { Backend::EglSurfaceless, Backend::EglPbuffer, Backend::OSMesa };
+    } else {
+        candidates = { backend };
+    }
+
+    std::string errors;
+    for (const Backend candidate : candidates) {
+        std::unique_ptr<HeadlessContext> context(new HeadlessContext());
+        std::string reason;
+        const bool created = candidate == Backend::OSMesa
+            ? context->pImpl->createOsMesa(reason)
+            : context->pImpl->createEgl(candidate == Backend::EglSurfaceless, reason);
+        if (created && context->makeCurrent()) {
+            using GetString = const GLubyte* (APIENTRY*)(GLenum);
+            const auto getString = reinterpret_cast<GetString>(context->getProcAddress("glGetString"));
+            const auto* renderer = getString ? reinterpret_cast<const char*>(getString(GL_RENDERER)) : nullptr;
+            const auto* version = getString ? reinterpret_cast<const char*>(getString(GL_VERSION)) : nullptr;
+            context->pImpl->description = std::string(backendName(candidate)) + ": "
+                + (renderer ? renderer : "unknown renderer") + ", OpenGL " + (version ? version : "?");
+            context->doneCurrent();
+            std::cout << "[HeadlessContext] " << context->pImpl->description << std::endl;
+            return context;
+        }
+        if (created) reason = "cannot make the context current";
+        errors += std::string(errors.empty() ? "" : "; ") + backendName(candidate) + ": " + reason;
+    }
+    if (error) *error = errors;
+    return nullptr;
+}
+
+bool HeadlessContext::makeCurrent() {
+#ifdef NEONWAVE_HAVE_EGL
+    if (pImpl->context != EGL_NO_CONTEXT) {
+        return eglMakeCurrent(pImpl->display, pImpl->surface, pImpl->surface, pImpl->context) == EGL_TRUE;
+    }
+#endif
+#ifdef NEONWAVE_HAVE_OSMESA
+    if (pImpl->osmesa) {
+        return OSMesaMakeCurrent(pImpl->osmesa, pImpl->osmesaBuffer.data(), GL_UNSIGNED_BYTE, 16, 16) == GL_TRUE;
+    }
+#endif
+    return false;
+}
+
+void HeadlessContext::doneCurrent() {
+#ifdef NEONWAVE_HAVE_EGL
+    if (pImpl->context != EGL_NO_CONTEXT) {
+        eglMakeCurrent(pImpl->display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        return;
+    }
+#endif
+#ifdef NEONWAVE_HAVE_OSMESA
+    if (pImpl->osmesa) OSMesaMakeCurrent(nullptr, nullptr, GL_UNSIGNED_BYTE, 0, 0);
+#endif
+}
+
+void* HeadlessContext::getProcAddress(const char* name) const {
+#ifdef NEONWAVE_HAVE_EGL
+    // EGL 1.5 (EGL_KHR_get_all_proc_addresses on Mesa) resolves core GL 1.x entry points as well
+    if (pImpl->context != EGL_NO_CONTEXT) return reinterpret_cast<void*>(eglGetProcAddress(name));
+#endif
+#ifdef NEONWAVE_HAVE_OSMESA
+    if (pImpl->osmesa) return reinterpret_cast<void*>(OSMesaGetProcAddress(name));
+#endif
+    (void)name;
+    return nullptr;
+}
+
+HeadlessContext::Backend HeadlessContext::backend() const {
+    return pImpl->backend;
+}
+
+std::string HeadlessContext::description() const {
+    return pImpl->description;
+}
+
+const char* HeadlessContext::backendName(Backend backend) {
+    switch (backend) {
+    case Backend::Auto: return "auto";
+    case Backend::EglSurfaceless: return "EGL surfaceless";
+    case Backend::EglPbuffer: return "EGL pbuffer";
+    case Backend::OSMesa: return "OSMesa";
+    }
+    return "unknown";
+}
+
+bool HeadlessContext::parseBackend(const std::string& name, Backend& backend) {
+    if (name == "auto") backend = Backend::Auto;
+    else if (name == "egl") backend = Backend::EglSurfaceless;
+    else if (name == "pbuffer") backend = Backend::EglPbuffer;
+    else if (name == "osmesa") backend = Backend::OSMesa;
+    else return false;
+    return true;
+}
+
+} // namespace NeonWave::GUI
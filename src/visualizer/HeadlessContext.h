@@ -0,0 +1,61 @@
+/**
+ * @file HeadlessContext.h
+ * @brief OpenGL context without a window: EGL surfaceless/pbuffer or OSMesa
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+namespace NeonWave::GUI {
+
+/**
+ * @class HeadlessContext
+ * @brief A desktop GL 3.3 context for rendering on machines with no display
+ *
+ * The render core only draws into its own framebuffer objects, so all it
+ * needs from the platform is a current context. Backends, in the order
+ * Backend::Auto tries them:
+ *  - EGL on Mesa's surfaceless platform: no display server, no GPU needed
+ *    (llvmpipe), no surface at all;
+ *  - EGL on the default display with a tiny pbuffer, for drivers that lack
+ *    EGL_MESA_platform_surfaceless;
+ *  - OSMesa, when the build found it (NEONWAVE_HAVE_OSMESA).
+ *
+ * Set LIBGL_ALWAYS_SOFTWARE=1 to force llvmpipe where a GPU driver exists.
+ * A context is current on one thread at a time; makeCurrent() on the
+ * thread that renders.
+ */
+class HeadlessContext {
+public:
+    enum class Backend { Auto, EglSurfaceless, EglPbuffer, OSMesa };
+
+    /// Null on failure, with the reason for each backend tried in @p error.
+    static std::unique_ptr<HeadlessContext> create(Backend backend = Backend::Auto, std::string* error = nullptr);
+    ~HeadlessContext();
+
+    HeadlessContext(const HeadlessContext&) = delete;
+    HeadlessContext& operator=(const HeadlessContext&) = delete;
+
+    bool makeCurrent();
+    void doneCurrent();
+    /// Any GL entry point, core or extension; valid while this context is current.
+    void* getProcAddress(const char* name) const;
+
+    Backend backend() const;
+    /// Backend, renderer and GL version, once the context has been current.
+    std::string description() const;
+
+    static const char* backendName(Backend backend);
+    /// "auto", "egl", "pbuffer" or "osmesa".
+    static bool parseBackend(const std::string& name, Backend& backend);
+
+private:
+    HeadlessContext();
+
+    class Impl;
+    std::unique_ptr<Impl> pImpl;
+};
+
+} // namespace NeonWave::GUI
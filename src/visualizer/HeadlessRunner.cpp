@@ -0,0 +1,296 @@
+/**
+ * @file HeadlessRunner.cpp
+ * @brief Implementation of the headless render loop
+ */
+
+#include "HeadlessRunner.h"
+#include <QString>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include "core/Config.h"
+#include "core/audio/FileDecoder.h"
+#include "core/audio/PlaybackClock.h"
+#include "FrameClock.h"
+#include "HeadlessContext.h"
+#include "OffscreenTarget.h"
+#include "RenderCore.h"
+
+namespace NeonWave::GUI {
+
+namespace {
+
+using Core::Audio::PlaybackClock;
+
+std::atomic<bool> g_stop{false};
+
+void onSignal(int) {
+    g_stop.store(true, std::memory_order_relaxed);
+}
+
+struct Options {
+    HeadlessContext::Backend backend = HeadlessContext::Backend::Auto;
+    int width = 1280;
+    int height = 720;
+    int fps = 0;                  // 0 = the configured FPS
+    double seconds = 10.0;
+    std::string preset;
+    std::string snapshot;
+    std::string audioFile;
+    bool paced = true;
+};
+
+void printUsage() {
+    std::cerr << "usage: neonwave --headless [--backend auto|egl|pbuffer|osmesa] [--size WxH] [--fps N]\n"
+                 "                           [--seconds S] [--preset PATH] [--snapshot FILE.ppm] [--unpaced]\n"
+                 "                           [audio file]" << std::endl;
+}
+
+bool parseOptions(const std::vector<std::string>& args, Options& options) {
+    for (std::size_t i = 0; i < args.size(); ++i) {
+        const std::string& arg = args[i];
+        const bool hasValue = i + 1 < args.size();
+        if (arg == "--backend" && hasValue) {
+            if (!HeadlessContext::parseBackend(args[++i], options.backend)) return false;
+        } else if (arg == "--size" && hasValue) {
+            if (std::sscanf(args[++i].c_str(), "%dx%d", &options.width, &options.height) != 2) return false;
+            if (options.width < 16 || options.height < 16) return false;
+        } else if (arg == "--fps" && hasValue) {
+            options.fps = std::atoi(args[++i].c_str());
+            if (options.fps < 1) return false;
+        } else if (arg == "--seconds" && hasValue) {
+            options.seconds = std::atof(args[++i].c_str());
+            if (options.seconds < 0.0) return false;
+        } else if (arg == "--preset" && hasValue) {
+            options.preset = args[++i];
+        } else if (arg == "--snapshot" && hasValue) {
+            options.snapshot = args[++i];
+        } else if (arg == "--unpaced") {
+            options.paced = false;
+        } else if (!arg.empty() && arg[0] != '-' && options.audioFile.empty()) {
+            options.audioFile = arg;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Nearest-rank percentile of an already sorted list.
+double percentile(const std::vector<float>& sorted, double fraction) {
+    if (sorted.empty()) return 0.0;
+    const auto rank = static_cast<std::size_t>(std::ceil(fraction * static_cast<double>(sorted.size())));
+    return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+bool writeSnapshot(const GlFunctions& gl, const OffscreenTarget& target, const std::string& path) {
+    const auto width = static_cast<std::size_t>(target.width);
+    const auto height = static_cast<std::size_t>(target.height);
+    std::vector<unsigned char> rgba(width * height * 4);
+    target.read(gl, rgba.data());
+
+    std::ofstream out(path, std::ios::binary);
+    if (!out) return false;
+    out << "P6\n" << width << " " << height << "\n255\n";
+    std::vector<unsigned char> row(width * 3);
+    // GL rows run bottom-up, PPM rows top-down
+    for (std::size_t y = height; y-- > 0;) {
+        const unsigned char* src = rgba.data() + y * width * 4;
+        for (std::size_t x = 0; x < width; ++x) {
+            row[3 * x] = src[4 * x];
+            row[3 * x + 1] = src[4 * x + 1];
+            row[3 * x + 2] = src[4 * x + 2];
+        }
+        out.write(reinterpret_cast<const char*>(row.data()), static_cast<std::streamsize>(row.size()));
+    }
+    return static_cast<bool>(out);
+}
+
+/// Decode exactly @p frames unless the file ends first; returns how many were decoded.
+std::size_t decodeFrames(Core::Audio::FileDecoder& decoder, float* dst, std::size_t frames) {
+    std::size_t done = 0;
+    while (done < frames) {
+        const std::size_t got = decoder.decode(dst + done * 2, frames - done);
+        if (got == 0) break;
+        done += got;
+    }
+    return done;
+}
+
+} // namespace
+
+int runHeadless(const std::vector<std::string>& args) {
+    Options options;
+    if (!parseOptions(args, options)) {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+
+    RenderCore::Settings settings = RenderCore::settingsFromConfig(Core::Config::instance().visualizer());
+    if (options.fps > 0) settings.fps = options.fps;
+    if (!options.preset.empty()) settings.presetLocked = true;
+
+    std::unique_ptr<Core::Audio::FileDecoder> decoder;
+    if (!options.audioFile.empty()) {
+        decoder = Core::Audio::createFileDecoder();
+        if (!decoder) {
+            std::cerr << "[Headless] No FileDecoder backend in this build (configure with NEONWAVE_WITH_LIBAV)" << std::endl;
+            return EXIT_FAILURE;
+        }
+        if (!decoder->open(QString::fromStdString(options.audioFile))) {
+            std::cerr << "[Headless] Cannot open " << options.audioFile << ": "
+                      << decoder->errorString().toStdString() << std::endl;
+            return EXIT_FAILURE;
+        }
+    } else {
+        // Nothing to listen to: let the test tone move the presets
+        settings.injectTestSignal = true;
+    }
+
+    std::string error;
+    auto context = HeadlessContext::create(options.backend, &error);
+    if (!context) {
+        std::cerr << "[Headless] No OpenGL context: " << error << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (!context->makeCurrent()) {
+        std::cerr << "[Headless] Cannot make the context current" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    RenderCore core;
+    core.setPresetChangedCallback([](const std::string& name) {
+        std::cout << "[Headless] Preset: " << name << std::endl;
+    });
+    HeadlessContext* ctx = context.get();
+    if (!core.initialize([ctx](const char* name) { return ctx->getProcAddress(name); },
+                         settings, options.width, options.height)) {
+        core.shutdown();
+        context->doneCurrent();
+        return EXIT_FAILURE;
+    }
+    if (!options.preset.empty()) core.loadPreset(options.preset);
+    const GlFunctions& gl = core.gl();
+
+    const int fps = settings.fps;
+    const int sampleRate = decoder ? decoder->sampleRate() : 0;
+    const std::uint64_t frameLimit = options.seconds > 0.0
+        ? static_cast<std::uint64_t>(std::llround(options.seconds * fps))
+        : 0;
+    std::cout << "[Headless] " << options.width << "x" << options.height << " at " << fps << " fps, "
+              << (options.paced ? "paced" : "unpaced") << ", "
+              << (frameLimit ? std::to_string(frameLimit) + " frames" : std::string("until stopped"))
+              << (decoder ? ", audio " + options.audioFile : std::string(", test tone")) << std::endl;
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    OffscreenTarget target;
+    GLsync inFlight = nullptr;
+    std::vector<float> pcm;
+    std::vector<float> cpuMs;
+    std::vector<float> gpuMs;
+    FrameClock clock(fps);
+    std::uint64_t frames = 0;
+    std::uint64_t audioFrames = 0;
+    bool ok = true;
+    const std::int64_t startNs = PlaybackClock::nowNs();
+    std::int64_t reportNs = startNs;
+    clock.reset(startNs);
+
+    while (!g_stop.load(std::memory_order_relaxed) && (frameLimit == 0 || frames < frameLimit)) {
+        if (options.paced) FrameClock::sleepUntil(clock.deadlineNs());
+        clock.beginFrame(PlaybackClock::nowNs());
+
+        if (decoder) {
+            // Exactly the audio this frame covers on the frame grid, so no remainder drifts
+            const std::uint64_t due = (frames + 1) * static_cast<std::uint64_t>(sampleRate) / fps - audioFrames;
+            pcm.resize(due * 2);
+            const std::size_t got = decodeFrames(*decoder, pcm.data(), due);
+            if (got == 0 && frameLimit == 0) break;
+            if (got > 0) core.addPcm(pcm.data(), got);
+            audioFrames += due;
+        }
+
+        if (inFlight) {
+            // Keep one frame queued on the GPU at most, or a fast CPU runs away from it
+            gl.glClientWaitSync(inFlight, GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000'000);
+            gl.glDeleteSync(inFlight);
+            inFlight = nullptr;
+        }
+        if (target.width != core.renderWidth() || target.height != core.renderHeight()) {
+            if (!target.allocate(gl, core.renderWidth(), core.renderHeight())) {
+                std::cerr << "[Headless] Render target is incomplete" << std::endl;
+                ok = false;
+                break;
+            }
+        }
+        const RenderCore::FrameCost cost = core.renderFrame(target.fbo);
+        inFlight = gl.glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        gl.glFlush();
+        cpuMs.push_back(static_cast<float>(cost.cpuMs));
+        gpuMs.push_back(static_cast<float>(cost.gpuMs));
+        ++frames;
+
+        const std::int64_t nowNs = PlaybackClock::nowNs();
+        if (nowNs - reportNs >= 5'000'000'000) {
+            reportNs = nowNs;
+            const auto quality = core.qualityStats();
+            std::cout << "[Headless] " << frames << " frames, "
+                      << frames / ((nowNs - startNs) * 1e-9) << " fps, quality level "
+                      << quality.governor.level << " (" << quality.renderWidth << "x" << quality.renderHeight
+                      << ", mesh " << quality.meshX << "x" << quality.meshY << ")" << std::endl;
+        }
+    }
+    if (inFlight) {
+        gl.glClientWaitSync(inFlight, GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000'000);
+        gl.glDeleteSync(inFlight);
+    }
+    gl.glFinish();
+    const double wallSeconds = (PlaybackClock::nowNs() - startNs) * 1e-9;
+
+    if (ok && !options.snapshot.empty() && target.fbo) {
+        if (writeSnapshot(gl, target, options.snapshot)) {
+            std::cout << "[Headless] Wrote " << target.width << "x" << target.height
+                      << " snapshot to " << options.snapshot << std::endl;
+        } else {
+            std::cerr << "[Headless] Cannot write " << options.snapshot << std::endl;
+            ok = false;
+        }
+    }
+
+    const auto quality = core.qualityStats();
+    const auto& pacing = clock.stats();
+    std::sort(cpuMs.begin(), cpuMs.end());
+    std::sort(gpuMs.begin(), gpuMs.end());
+    std::cout << "[Headless] " << context->description() << std::endl;
+    std::printf("  frames %llu in %.2f s: %.1f fps (target %d), %.2fx realtime\n",
+                static_cast<unsigned long long>(frames), wallSeconds,
+                wallSeconds > 0.0 ? frames / wallSeconds : 0.0, fps,
+                wallSeconds > 0.0 ? frames / (fps * wallSeconds) : 0.0);
+    std::printf("  cpu ms  p50 %.2f  p95 %.2f  p99 %.2f  max %.2f\n",
+                percentile(cpuMs, 0.50), percentile(cpuMs, 0.95), percentile(cpuMs, 0.99),
+                cpuMs.empty() ? 0.0 : cpuMs.back());
+    std::printf("  gpu ms  p50 %.2f  p95 %.2f\n", percentile(gpuMs, 0.50), percentile(gpuMs, 0.95));
+    if (options.paced) {
+        std::printf("  skipped slots %llu, late frames %llu\n",
+                    static_cast<unsigned long long>(pacing.skipped), static_cast<unsigned long long>(pacing.lateFrames));
+    }
+    std::printf("  quality level %d (%dx%d, mesh %dx%d), %llu steps down, %llu up\n",
+                quality.governor.level, quality.renderWidth, quality.renderHeight, quality.meshX, quality.meshY,
+                static_cast<unsigned long long>(quality.governor.stepsDown),
+                static_cast<unsigned long long>(quality.governor.stepsUp));
+
+    core.shutdown();
+    target.release(gl);
+    context->doneCurrent();
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+} // namespace NeonWave::GUI
@@ -0,0 +1,37 @@
+/**
+ * @file HeadlessRunner.h
+ * @brief `neonwave --headless`: the visualizer without a window or display
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace NeonWave::GUI {
+
+/**
+ * @brief Render projectM into an offscreen framebuffer on a HeadlessContext
+ *
+ * Invoked by `neonwave --headless [options] [audio file]`:
+ *  - `--backend auto|egl|pbuffer|osmesa` context to create (default auto);
+ *  - `--size WxH` output size (default 1280x720);
+ *  - `--fps N` target rate (default: the configured FPS);
+ *  - `--seconds S` stop after S seconds of frames; 0 runs until the audio
+ *    ends, or until SIGINT/SIGTERM without audio (default 10);
+ *  - `--preset PATH` load and lock one preset;
+ *  - `--snapshot FILE.ppm` write the last frame;
+ *  - `--unpaced` render back to back instead of on the frame clock.
+ *
+ * The audio file is decoded with the FileDecoder backend and fed to the
+ * RenderCore at sampleRate / fps frames per frame, so the visuals follow
+ * it in frame time; without one the core's test tone drives the presets.
+ * Everything else comes from the visualizer config. Prints throughput,
+ * CPU and GPU time percentiles and the quality level reached.
+ *
+ * @param args Arguments following --headless
+ * @return Process exit code
+ */
+int runHeadless(const std::vector<std::string>& args);
+
+} // namespace NeonWave::GUI
@@ -0,0 +1,334 @@
+/**
+ * @file LibavVideoEncoder.cpp
+ * @brief Implementation of the libav video encoder
+ */
+
+#include "LibavVideoEncoder.h"
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavutil/channel_layout.h>
+#include <libavutil/opt.h>
+#include <libswscale/swscale.h>
+}
+
+namespace NeonWave::GUI {
+
+LibavVideoEncoder::LibavVideoEncoder() = default;
+
+LibavVideoEncoder::~LibavVideoEncoder() {
+    if (m_headerWritten) finish();
+    close();
+}
+
+bool LibavVideoEncoder::open(const std::string& path, const Settings& settings) {
+    close();
+    if (settings.width % 2 || settings.height % 2) {
+        m_error = "4:2:0 needs an even width and height";
+        return false;
+    }
+    int err = avformat_alloc_output_context2(&m_format, nullptr, nullptr, path.c_str());
+    if (err < 0 || !m_format) { fail("no container for this file name", err); return false; }
+    // No library version strings in the file: same input, same bytes
+    m_format->flags |= AVFMT_FLAG_BITEXACT;
+
+    if (!openVideo(settings)) return false;
+    if (settings.sampleRate > 0 && !openAudio(settings)) return false;
+
+    if (!(m_format->oformat->flags & AVFMT_NOFILE)) {
+        if ((err = avio_open(&m_format->pb, path.c_str(), AVIO_FLAG_WRITE)) < 0) { fail("create", err); return false; }
+    }
+    if ((err = avformat_write_header(m_format, nullptr)) < 0) { fail("write header", err); return false; }
+    m_headerWritten = true;
+
+    m_packet = av_packet_alloc();
+    if (!m_packet) { fail("packet alloc", AVERROR(ENOMEM)); return false; }
+    m_description = std::string(m_video->codec->name) + (m_audio ? std::string(" + ") + m_audio->codec->name : "")
+        + " in " + m_format->oformat->name;
+    return true;
+}
+
+bool LibavVideoEncoder::openVideo(const Settings& settings) {
+    const AVCodec* codec = avcodec_find_encoder_by_name("libx264");
+    if (!codec) codec = avcodec_find_encoder(AV_CODEC_ID_H264);
+    if (!codec) codec = avcodec_find_encoder(AV_CODEC_ID_MPEG4);
+    if (!codec) { fail("no H.264 or MPEG-4 encoder", AVERROR_ENCODER_NOT_FOUND); return false; }
+
+    m_videoStream = avformat_new_stream(m_format, nullptr);
+    m_video = avcodec_alloc_context3(codec);
+    if (!m_videoStream || !m_video) { fail("video stream", AVERROR(ENOMEM)); return false; }
+    m_width = settings.width;
+    m_height = settings.height;
+    m_video->width = settings.width;
+    m_video->height = settings.height;
+    m_video->time_base = AVRational{ 1, settings.fps };
+    m_video->framerate = AVRational{ settings.fps, 1 };
+    m_video->pix_fmt = AV_PIX_FMT_YUV420P;
+    m_video->bit_rate = static_cast<std::int64_t>(settings.videoBitrateKbps) * 1000;
+    m_video->gop_size = settings.fps * 2;
+    m_video->colorspace = AVCOL_SPC_SMPTE170M;
+    m_video->color_range = AVCOL_RANGE_MPEG;
+    m_video->flags |= AV_CODEC_FLAG_BITEXACT;
+    // Without reordering, decode order is display order: segments splice on timestamps alone
+    if (settings.segment) m_video->max_b_frames = 0;
+    if (settings.threads > 0) m_video->thread_count = settings.threads;
+    if (m_format->oformat->flags & AVFMT_GLOBALHEADER) m_video->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+    if (std::string(codec->name) == "libx264") av_opt_set(m_video->priv_data, "preset", "medium", 0);
+
+    int err = avcodec_open2(m_video, codec, nullptr);
+    if (err < 0) { fail("video codec open", err); return false; }
+    if ((err = avcodec_parameters_from_context(m_videoStream->codecpar, m_video)) < 0) { fail("video parameters", err); return false; }
+    m_videoStream->time_base = m_video->time_base;
+
+    m_sws = sws_getContext(settings.width, settings.height, AV_PIX_FMT_RGBA,
+                           settings.width, settings.height, AV_PIX_FMT_YUV420P,
+                           SWS_BILINEAR | SWS_ACCURATE_RND | SWS_BITEXACT, nullptr, nullptr, nullptr);
+    m_videoFrame = av_frame_alloc();
+    if (!m_sws || !m_videoFrame) { fail("converter", AVERROR(ENOMEM)); return false; }
+    m_videoFrame->format = AV_PIX_FMT_YUV420P;
+    m_videoFrame->width = settings.width;
+    m_videoFrame->height = settings.height;
+    if ((err = av_frame_get_buffer(m_videoFrame, 0)) < 0) { fail("video frame", err); return false; }
+    return true;
+}
+
+bool LibavVideoEncoder::openAudio(const Settings& settings) {
+    const AVCodec* codec = avcodec_find_encoder(AV_CODEC_ID_AAC);
+    if (!codec) { fail("no AAC encoder", AVERROR_ENCODER_NOT_FOUND); return false; }
+
+    m_audioStream = avformat_new_stream(m_format, nullptr);
+    m_audio = avcodec_alloc_context3(codec);
+    if (!m_audioStream || !m_audio) { fail("audio stream", AVERROR(ENOMEM)); return false; }
+    m_audio->sample_fmt = AV_SAMPLE_FMT_FLTP; // what FFmpeg's own AAC encoder takes
+    m_audio->sample_rate = settings.sampleRate;
+    av_channel_layout_default(&m_audio->ch_layout, 2);
+    m_audio->bit_rate = static_cast<std::int64_t>(settings.audioBitrateKbps) * 1000;
+    m_audio->time_base = AVRational{ 1, settings.sampleRate };
+    m_audio->flags |= AV_CODEC_FLAG_BITEXACT;
+    if (m_format->oformat->flags & AVFMT_GLOBALHEADER) m_audio->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+
+    int err = avcodec_open2(m_audio, codec, nullptr);
+    if (err < 0) { fail("audio codec open", err); return false; }
+    if ((err = avcodec_parameters_from_context(m_audioStream->codecpar, m_audio)) < 0) { fail("audio parameters", err); return false; }
+    m_audioStream->time_base = m_audio->time_base;
+
+    m_audioFrameSize = m_audio->frame_size > 0 ? static_cast<std::size_t>(m_audio->frame_size) : 1024;
+    m_audioFrame = av_frame_alloc();
+    if (!m_audioFrame) { fail("audio frame", AVERROR(ENOMEM)); return false; }
+    m_audioFrame->format = m_audio->sample_fmt;
+    m_audioFrame->sample_rate = m_audio->sample_rate;
+    m_audioFrame->nb_samples = static_cast<int>(m_audioFrameSize);
+    av_channel_layout_copy(&m_audioFrame->ch_layout, &m_audio->ch_layout);
+    if ((err = av_frame_get_buffer(m_audioFrame, 0)) < 0) { fail("audio frame", err); return false; }
+    return true;
+}
+
+bool LibavVideoEncoder::writeVideo(const unsigned char* rgba) {
+    if (!m_headerWritten) return false;
+    int err = av_frame_make_writable(m_videoFrame);
+    if (err < 0) { fail("video frame", err); return false; }
+    // Start at the last row and step backwards: GL's bottom-up image comes out top-down
+    const std::ptrdiff_t stride = static_cast<std::ptrdiff_t>(m_width) * 4;
+    const std::uint8_t* source[1] = { rgba + (m_height - 1) * stride };
+    const int sourceStride[1] = { static_cast<int>(-stride) };
+    sws_scale(m_sws, source, sourceStride, 0, m_height, m_videoFrame->data, m_videoFrame->linesize);
+    m_videoFrame->pts = m_videoPts++;
+    return encode(m_video, m_videoStream, m_videoFrame);
+}
+
+bool LibavVideoEncoder::writeAudio(const float* interleaved, std::size_t frames) {
+    if (!m_headerWritten) return false;
+    if (!m_audio) return true;
+    m_audioPending.insert(m_audioPending.end(), interleaved, interleaved + frames * 2);
+    std::size_t consumed = 0;
+    while (m_audioPending.size() - consumed >= m_audioFrameSize * 2) {
+        if (!encodeAudio(consumed, m_audioFrameSize)) return false;
+        consumed += m_audioFrameSize * 2;
+    }
+    m_audioPending.erase(m_audioPending.begin(), m_audioPending.begin() + static_cast<std::ptrdiff_t>(consumed));
+    return true;
+}
+
+bool LibavVideoEncoder::encodeAudio(std::size_t offset, std::size_t samples) {
+    int err = av_frame_make_writable(m_audioFrame);
+    if (err < 0) { fail("audio frame", err); return false; }
+    auto* left = reinterpret_cast<float*>(m_audioFrame->data[0]);
+    auto* right = reinterpret_cast<float*>(m_audioFrame->data[1]);
+    const float* src = m_audioPending.data() + offset;
+    for (std::size_t i = 0; i < samples; ++i) {
+        left[i] = src[2 * i];
+        right[i] = src[2 * i + 1];
+    }
+    m_audioFrame->nb_samples = static_cast<int>(samples);
+    m_audioFrame->pts = m_audioPts;
+    m_audioPts += static_cast<std::int64_t>(samples);
+    return encode(m_audio, m_audioStream, m_audioFrame);
+}
+
+bool LibavVideoEncoder::encode(AVCodecContext* codec, AVStream* stream, AVFrame* frame) {
+    int err = avcodec_send_frame(codec, frame);
+    if (err < 0) { fail("encode", err); return false; }
+    for (;;) {
+        err = avcodec_receive_packet(codec, m_packet);
+        if (err == AVERROR(EAGAIN) || err == AVERROR_EOF) return true;
+        if (err < 0) { fail("encode", err); return false; }
+        // mp4 ends the track at the last packet's dts plus duration; with B-frames and no duration the
+        // edit list cuts off the final frame
+        if (codec == m_video && m_packet->duration <= 0) m_packet->duration = 1;
+        av_packet_rescale_ts(m_packet, codec->time_base, stream->time_base);
+        m_packet->stream_index = stream->index;
+        err = av_interleaved_write_frame(m_format, m_packet); // takes the packet's reference
+        if (err < 0) { fail("mux", err); return false; }
+    }
+}
+
+bool LibavVideoEncoder::openSegment(const std::string& path, AVFormatContext*& input, int& videoIndex) {
+    input = nullptr;
+    int err = avformat_open_input(&input, path.c_str(), nullptr, nullptr);
+    if (err < 0) { fail(("open " + path).c_str(), err); return false; }
+    if ((err = avformat_find_stream_info(input, nullptr)) < 0) {
+        fail(("read " + path).c_str(), err);
+        avformat_close_input(&input);
+        return false;
+    }
+    videoIndex = av_find_best_stream(input, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+    if (videoIndex < 0) {
+        fail(("no video in " + path).c_str(), videoIndex);
+        avformat_close_input(&input);
+        return false;
+    }
+    return true;
+}
+
+bool LibavVideoEncoder::concatenate(const std::vector<std::string>& segments, const std::string& path,
+                                    const Settings& settings, const float* audio, std::size_t audioFrames) {
+    close();
+    if (segments.empty()) {
+        m_error = "no segments";
+        return false;
+    }
+    int err = avformat_alloc_output_context2(&m_format, nullptr, nullptr, path.c_str());
+    if (err < 0 || !m_format) { fail("no container for this file name", err); return false; }
+    m_format->flags |= AVFMT_FLAG_BITEXACT;
+
+    // The first segment's stream stands for all of them: same encoder, same settings
+    AVFormatContext* input = nullptr;
+    int videoIndex = -1;
+    if (!openSegment(segments.front(), input, videoIndex)) return false;
+    m_videoStream = avformat_new_stream(m_format, nullptr);
+    if (!m_videoStream) { avformat_close_input(&input); fail("video stream", AVERROR(ENOMEM)); return false; }
+    err = avcodec_parameters_copy(m_videoStream->codecpar, input->streams[videoIndex]->codecpar);
+    avformat_close_input(&input);
+    if (err < 0) { fail("video parameters", err); return false; }
+    m_videoStream->codecpar->codec_tag = 0; // let the output container pick its own tag
+    m_videoStream->time_base = AVRational{ 1, settings.fps };
+    if (audio && settings.sampleRate > 0 && !openAudio(settings)) return false;
+
+    if (!(m_format->oformat->flags & AVFMT_NOFILE)) {
+        if ((err = avio_open(&m_format->pb, path.c_str(), AVIO_FLAG_WRITE)) < 0) { fail("create", err); return false; }
+    }
+    if ((err = avformat_write_header(m_format, nullptr)) < 0) { fail("write header", err); return false; }
+    m_headerWritten = true;
+    m_packet = av_packet_alloc();
+    m_readPacket = av_packet_alloc();
+    if (!m_packet || !m_readPacket) { fail("packet alloc", AVERROR(ENOMEM)); return false; }
+    m_description = std::string("stream copy of ") + std::to_string(segments.size()) + " segments"
+        + (m_audio ? std::string(" + ") + m_audio->codec->name : "") + " in " + m_format->oformat->name;
+
+    // Timestamps are counted in frames (1/fps) while splicing, then rescaled to what the muxer chose
+    const AVRational frameBase{ 1, settings.fps };
+    std::int64_t offset = 0;
+    std::size_t audioWritten = 0;
+    for (const std::string& segment : segments) {
+        if (!openSegment(segment, input, videoIndex)) return false;
+        const AVRational inputBase = input->streams[videoIndex]->time_base;
+        std::int64_t segmentFrames = 0;
+        while ((err = av_read_frame(input, m_readPacket)) >= 0) {
+            if (m_readPacket->stream_index != videoIndex) {
+                av_packet_unref(m_readPacket);
+                continue;
+            }
+            const std::int64_t pts = av_rescale_q(m_readPacket->pts, inputBase, frameBase);
+            const std::int64_t dts =
+                m_readPacket->dts == AV_NOPTS_VALUE ? pts : av_rescale_q(m_readPacket->dts, inputBase, frameBase);
+            segmentFrames = std::max(segmentFrames, pts + 1);
+            m_readPacket->pts = pts + offset;
+            m_readPacket->dts = dts + offset;
+            m_readPacket->duration = 1;
+            m_readPacket->pos = -1;
+            m_readPacket->stream_index = m_videoStream->index;
+            av_packet_rescale_ts(m_readPacket, frameBase, m_videoStream->time_base);
+
+            // Keep the audio about a second ahead, so the muxer never has to queue much of either
+            if (m_audio) {
+                const auto until = std::min(audioFrames, static_cast<std::size_t>(
+                    (pts + offset + 1) * settings.sampleRate / settings.fps + settings.sampleRate));
+                if (until > audioWritten && !writeAudio(audio + audioWritten * 2, until - audioWritten)) {
+                    avformat_close_input(&input);
+                    return false;
+                }
+                audioWritten = std::max(audioWritten, until);
+            }
+            if ((err = av_interleaved_write_frame(m_format, m_readPacket)) < 0) {
+                avformat_close_input(&input);
+                fail("mux", err);
+                return false;
+            }
+        }
+        avformat_close_input(&input);
+        if (err != AVERROR_EOF) { fail(("read " + segment).c_str(), err); return false; }
+        offset += segmentFrames;
+    }
+    if (m_audio && audioWritten < audioFrames && !writeAudio(audio + audioWritten * 2, audioFrames - audioWritten)) {
+        return false;
+    }
+    return finish();
+}
+
+bool LibavVideoEncoder::finish() {
+    if (!m_headerWritten) return false;
+    m_headerWritten = false;
+    bool ok = m_error.empty();
+    // The last AAC frame may be short; the encoder pads it and the container trims it
+    if (ok && m_audio && !m_audioPending.empty()) ok = encodeAudio(0, m_audioPending.size() / 2);
+    m_audioPending.clear();
+    if (ok && m_video) ok = encode(m_video, m_videoStream, nullptr);
+    if (ok && m_audio) ok = encode(m_audio, m_audioStream, nullptr);
+    const int err = av_write_trailer(m_format);
+    if (err < 0) { fail("write trailer", err); ok = false; }
+    close();
+    return ok;
+}
+
+void LibavVideoEncoder::close() {
+    if (m_format && m_format->pb && !(m_format->oformat->flags & AVFMT_NOFILE)) avio_closep(&m_format->pb);
+    avformat_free_context(m_format);
+    m_format = nullptr;
+    avcodec_free_context(&m_video);
+    avcodec_free_context(&m_audio);
+    av_frame_free(&m_videoFrame);
+    av_frame_free(&m_audioFrame);
+    av_packet_free(&m_packet);
+    av_packet_free(&m_readPacket);
+    sws_freeContext(m_sws);
+    m_sws = nullptr;
+    m_videoStream = nullptr;
+    m_audioStream = nullptr;
+    m_audioPending.clear(); // a partial codec frame from this file must not lead the next one
+    m_videoPts = 0;
+    m_audioPts = 0;
+    m_headerWritten = false;
+}
+
+void LibavVideoEncoder::fail(const char* what, int err) {
+    char reason[AV_ERROR_MAX_STRING_SIZE] = {};
+    av_strerror(err, reason, sizeof(reason));
+    m_error = std::string(what) + ": " + reason;
+    std::cerr << "[LibavVideoEncoder] " << m_error << std::endl;
+}
+
+} // namespace NeonWave::GUI
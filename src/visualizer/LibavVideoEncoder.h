@@ -0,0 +1,84 @@
+/**
+ * @file LibavVideoEncoder.h
+ * @brief VideoEncoder on libavformat/libavcodec
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "VideoEncoder.h"
+
+struct AVCodecContext;
+struct AVFormatContext;
+struct AVFrame;
+struct AVPacket;
+struct AVStream;
+struct SwsContext;
+
+namespace NeonWave::GUI {
+
+/**
+ * @brief H.264 (libx264 where available, else any H.264 encoder, else
+ * MPEG-4 Part 2) plus AAC, muxed into whatever container the path names.
+ *
+ * RGBA goes to 4:2:0 through libswscale, flipped on the way by a negative
+ * stride. Codecs and muxer run with the bit-exact flags, so identical
+ * frames and audio give an identical file.
+ */
+class LibavVideoEncoder : public VideoEncoder {
+public:
+    LibavVideoEncoder();
+    ~LibavVideoEncoder() override;
+
+    bool open(const std::string& path, const Settings& settings) override;
+    bool writeVideo(const unsigned char* rgba) override;
+    bool writeAudio(const float* interleaved, std::size_t frames) override;
+    bool finish() override;
+    std::string errorString() const override { return m_error; }
+    std::string description() const override { return m_description; }
+
+    /**
+     * @brief Stream-copy the video of @p segments into @p path, one after the other
+     *
+     * The implementation of concatenateSegments() for libav containers.
+     * @p audio, if any, is encoded as one AAC stream alongside.
+     */
+    bool concatenate(const std::vector<std::string>& segments, const std::string& path, const Settings& settings,
+                     const float* audio, std::size_t audioFrames);
+
+private:
+    bool openVideo(const Settings& settings);
+    /// Open @p path for reading and find its video stream; false (with m_error set) if it has none.
+    bool openSegment(const std::string& path, AVFormatContext*& input, int& videoIndex);
+    bool openAudio(const Settings& settings);
+    /// Encode @p samples frames of m_audioPending, starting at float index @p offset, as one codec frame.
+    bool encodeAudio(std::size_t offset, std::size_t samples);
+    /// Send @p frame (null to drain) and mux every packet that comes out.
+    bool encode(AVCodecContext* codec, AVStream* stream, AVFrame* frame);
+    void fail(const char* what, int err);
+    void close();
+
+    AVFormatContext* m_format = nullptr;
+    AVCodecContext* m_video = nullptr;
+    AVCodecContext* m_audio = nullptr;
+    AVStream* m_videoStream = nullptr;
+    AVStream* m_audioStream = nullptr;
+    AVFrame* m_videoFrame = nullptr;
+    AVFrame* m_audioFrame = nullptr;
+    AVPacket* m_packet = nullptr;         // encoder output
+    AVPacket* m_readPacket = nullptr;     // concatenate(): segment input, never touched by encode()
+    SwsContext* m_sws = nullptr;
+    int m_width = 0;
+    int m_height = 0;
+    std::int64_t m_videoPts = 0;
+    std::int64_t m_audioPts = 0;
+    std::size_t m_audioFrameSize = 0;
+    std::vector<float> m_audioPending;   // interleaved, less than one codec frame once writeAudio() returns
+    bool m_headerWritten = false;
+    std::string m_description;
+    std::string m_error;
+};
+
+} // namespace NeonWave::GUI
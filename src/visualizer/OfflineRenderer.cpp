@@ -0,0 +1,466 @@
+/**
+ * @file OfflineRenderer.cpp
+ * @brief Implementation of the offline render-to-video job
+ */
+
+#include "OfflineRenderer.h"
+#include <QString>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include "core/Config.h"
+#include "core/audio/FileDecoder.h"
+#include "core/audio/PlaybackClock.h"
+#include "OffscreenTarget.h"
+#include "ReadbackRing.h"
+#include "RenderCore.h"
+#include "VideoEncoder.h"
+
+namespace NeonWave::GUI {
+
+namespace {
+
+using Core::Audio::PlaybackClock;
+
+std::atomic<bool> g_cancel{false};
+
+void onSignal(int) {
+    g_cancel.store(true, std::memory_order_relaxed);
+}
+
+/// Nearest-rank percentile of an already sorted list.
+double percentile(const std::vector<float>& sorted, double fraction) {
+    if (sorted.empty()) return 0.0;
+    const auto rank = static_cast<std::size_t>(std::ceil(fraction * static_cast<double>(sorted.size())));
+    return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+/// First sample of video frame @p frame on the frame grid.
+std::uint64_t frameStartSample(std::uint64_t frame, int sampleRate, int fps) {
+    return frame * static_cast<std::uint64_t>(sampleRate) / static_cast<std::uint64_t>(fps);
+}
+
+constexpr const char* kStatusTag = "@neonwave-render";
+
+/// Audio frames in a raw stereo float file.
+bool rawTrackFrames(const std::string& path, std::uint64_t& frames, std::string* error) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        if (error) *error = "cannot open " + path;
+        return false;
+    }
+    frames = static_cast<std::uint64_t>(in.tellg()) / (2 * sizeof(float));
+    return true;
+}
+
+/// Frames [first, first + count) of a raw stereo float file.
+bool readRawTrack(const std::string& path, std::uint64_t first, std::uint64_t count, std::vector<float>& pcm,
+                  std::string* error) {
+    std::ifstream in(path, std::ios::binary);
+    pcm.resize(static_cast<std::size_t>(count) * 2);
+    in.seekg(static_cast<std::streamoff>(first * 2 * sizeof(float)));
+    in.read(reinterpret_cast<char*>(pcm.data()), static_cast<std::streamsize>(pcm.size() * sizeof(float)));
+    if (!in) {
+        if (error) *error = "cannot read " + path;
+        return false;
+    }
+    return true;
+}
+
+void printUsage() {
+    std::cerr << "usage: neonwave --render [--backend auto|egl|pbuffer|osmesa] [--size WxH] [--fps N]\n"
+                 "                         [--preset PATH] [--seed N] [--video-kbps N] [--audio-kbps N]\n"
+                 "                         [--readback-depth N] [--start-frame N] [--frames N] [--preroll SECONDS]\n"
+                 "                         [--no-audio] [--segment] [--threads N] [--raw-audio RATE]\n"
+                 "                         [--machine-readable]\n"
+                 "                         AUDIO OUTPUT(.mp4|.mkv|.y4m)" << std::endl;
+}
+
+} // namespace
+
+bool decodeTrack(const std::string& path, std::vector<float>& pcm, int& sampleRate, std::string* error) {
+    auto fail = [error](const std::string& reason) {
+        if (error) *error = reason;
+        return false;
+    };
+    auto decoder = Core::Audio::createFileDecoder();
+    if (!decoder) return fail("no FileDecoder backend in this build (configure with NEONWAVE_WITH_LIBAV)");
+    if (!decoder->open(QString::fromStdString(path))) return fail(decoder->errorString().toStdString());
+    sampleRate = decoder->sampleRate();
+    constexpr std::size_t kChunkFrames = 65536;
+    std::size_t frames = 0;
+    for (;;) {
+        pcm.resize((frames + kChunkFrames) * 2);
+        const std::size_t got = decoder->decode(pcm.data() + frames * 2, kChunkFrames);
+        if (got == 0) break;
+        frames += got;
+    }
+    pcm.resize(frames * 2);
+    if (decoder->hasError()) return fail(decoder->errorString().toStdString());
+    if (sampleRate <= 0 || frames == 0) return fail("no audio in " + path);
+    return true;
+}
+
+bool writeRawTrack(const std::string& path, const std::vector<float>& pcm, std::string* error) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(pcm.data()), static_cast<std::streamsize>(pcm.size() * sizeof(float)));
+    if (!out) {
+        if (error) *error = "cannot write " + path;
+        return false;
+    }
+    return true;
+}
+
+std::string formatRenderStatus(const RenderStatus& status) {
+    char line[160];
+    if (status.final) {
+        std::snprintf(line, sizeof(line), "%s result %d %llu %llu %llu %.3f %.3f", kStatusTag, status.ok ? 1 : 0,
+                      static_cast<unsigned long long>(status.done), static_cast<unsigned long long>(status.total),
+                      static_cast<unsigned long long>(status.prerollFrames), status.wallSeconds, status.decodeSeconds);
+    } else {
+        std::snprintf(line, sizeof(line), "%s progress %llu %llu", kStatusTag,
+                      static_cast<unsigned long long>(status.done), static_cast<unsigned long long>(status.total));
+    }
+    return line;
+}
+
+bool parseRenderStatus(const std::string& line, RenderStatus& status) {
+    const std::string tag = std::string(kStatusTag) + " ";
+    if (line.compare(0, tag.size(), tag) != 0) return false;
+    const char* rest = line.c_str() + tag.size();
+    unsigned long long done = 0, total = 0, preroll = 0;
+    int ok = 0;
+    RenderStatus parsed;
+    if (std::sscanf(rest, "result %d %llu %llu %llu %lf %lf", &ok, &done, &total, &preroll, &parsed.wallSeconds,
+                    &parsed.decodeSeconds) == 6) {
+        parsed.final = true;
+        parsed.ok = ok != 0;
+        parsed.prerollFrames = preroll;
+    } else if (std::sscanf(rest, "progress %llu %llu", &done, &total) != 2) {
+        return false;
+    }
+    parsed.done = done;
+    parsed.total = total;
+    status = parsed;
+    return true;
+}
+
+std::uint64_t videoFrameCount(std::uint64_t audioFrames, int sampleRate, int fps) {
+    if (sampleRate <= 0 || fps <= 0) return 0;
+    return (audioFrames * static_cast<std::uint64_t>(fps) + static_cast<std::uint64_t>(sampleRate) - 1)
+        / static_cast<std::uint64_t>(sampleRate);
+}
+
+bool parseRenderOptions(const std::vector<std::string>& args, RenderJob& job) {
+    std::vector<std::string> positional;
+    for (std::size_t i = 0; i < args.size(); ++i) {
+        const std::string& arg = args[i];
+        const bool hasValue = i + 1 < args.size();
+        if (arg == "--backend" && hasValue) {
+            if (!HeadlessContext::parseBackend(args[++i], job.backend)) return false;
+        } else if (arg == "--size" && hasValue) {
+            if (std::sscanf(args[++i].c_str(), "%dx%d", &job.width, &job.height) != 2) return false;
+        } else if (arg == "--fps" && hasValue) {
+            job.fps = std::atoi(args[++i].c_str());
+        } else if (arg == "--preset" && hasValue) {
+            job.preset = args[++i];
+        } else if (arg == "--seed" && hasValue) {
+            job.seed = static_cast<unsigned int>(std::strtoul(args[++i].c_str(), nullptr, 10));
+        } else if (arg == "--video-kbps" && hasValue) {
+            job.videoBitrateKbps = std::atoi(args[++i].c_str());
+        } else if (arg == "--audio-kbps" && hasValue) {
+            job.audioBitrateKbps = std::atoi(args[++i].c_str());
+        } else if (arg == "--readback-depth" && hasValue) {
+            job.readbackDepth = std::atoi(args[++i].c_str());
+        } else if (arg == "--start-frame" && hasValue) {
+            job.startFrame = std::strtoull(args[++i].c_str(), nullptr, 10);
+        } else if (arg == "--frames" && hasValue) {
+            job.frameCount = std::strtoull(args[++i].c_str(), nullptr, 10);
+        } else if (arg == "--preroll" && hasValue) {
+            job.prerollSeconds = std::atof(args[++i].c_str());
+        } else if (arg == "--no-audio") {
+            job.audio = false;
+        } else if (arg == "--segment") {
+            job.segment = true;
+        } else if (arg == "--threads" && hasValue) {
+            job.encoderThreads = std::atoi(args[++i].c_str());
+        } else if (arg == "--raw-audio" && hasValue) {
+            job.rawSampleRate = std::atoi(args[++i].c_str());
+        } else if (arg == "--machine-readable") {
+            job.machineReadable = true;
+        } else if (!arg.empty() && arg[0] != '-') {
+            positional.push_back(arg);
+        } else {
+            return false;
+        }
+    }
+    if (positional.size() != 2) return false;
+    job.audioFile = positional[0];
+    job.outputFile = positional[1];
+    return job.fps > 0 && job.width >= 16 && job.height >= 16 && job.videoBitrateKbps > 0 && job.audioBitrateKbps > 0
+        && job.readbackDepth >= 0 && job.readbackDepth <= 16 && job.prerollSeconds >= 0.0 && job.encoderThreads >= 0
+        && job.rawSampleRate >= 0;
+}
+
+RenderResult renderOffline(const RenderJob& job,
+                           const std::function<void(std::uint64_t, std::uint64_t)>& progress,
+                           const std::function<bool()>& cancel) {
+    RenderResult result;
+    if (job.fps <= 0 || job.width % 2 || job.height % 2) {
+        result.error = "fps must be positive and the size even";
+        return result;
+    }
+
+    // The track up front: the frame count is known before the first frame, and the loop never waits on I/O
+    std::vector<float> pcm;         // audio from frame pcmBase on
+    std::uint64_t pcmBase = 0;
+    const std::int64_t decodeStartNs = PlaybackClock::nowNs();
+    if (job.rawSampleRate > 0) {
+        result.sampleRate = job.rawSampleRate;
+        if (!rawTrackFrames(job.audioFile, result.audioFrames, &result.error)) return result;
+    } else {
+        if (!decodeTrack(job.audioFile, pcm, result.sampleRate, &result.error)) return result;
+        result.audioFrames = pcm.size() / 2;
+    }
+    const std::uint64_t trackFrames = videoFrameCount(result.audioFrames, result.sampleRate, job.fps);
+    const std::uint64_t firstFrame = job.startFrame;
+    const std::uint64_t endFrame =
+        job.frameCount > 0 ? std::min(trackFrames, firstFrame + job.frameCount) : trackFrames;
+    if (firstFrame >= endFrame) {
+        result.error = "start frame " + std::to_string(firstFrame) + " is past the end (" + std::to_string(trackFrames)
+            + " frames)";
+        return result;
+    }
+    const std::uint64_t totalFrames = endFrame - firstFrame;
+    result.prerollFrames =
+        std::min(firstFrame, static_cast<std::uint64_t>(std::llround(job.prerollSeconds * job.fps)));
+    if (job.rawSampleRate > 0) {
+        // Only the samples this slice of the track uses, pre-roll included
+        pcmBase = frameStartSample(firstFrame - result.prerollFrames, result.sampleRate, job.fps);
+        const std::uint64_t pcmEnd = std::min(frameStartSample(endFrame, result.sampleRate, job.fps), result.audioFrames);
+        if (!readRawTrack(job.audioFile, pcmBase, pcmEnd - pcmBase, pcm, &result.error)) return result;
+    }
+    result.decodeSeconds = (PlaybackClock::nowNs() - decodeStartNs) * 1e-9;
+
+    auto encoder = createVideoEncoder(job.outputFile);
+    if (!encoder) {
+        result.error = "cannot write " + job.outputFile + " in this build (use .y4m, or configure with NEONWAVE_WITH_LIBAV)";
+        return result;
+    }
+    VideoEncoder::Settings encoding;
+    encoding.width = job.width;
+    encoding.height = job.height;
+    encoding.fps = job.fps;
+    encoding.sampleRate = job.audio ? result.sampleRate : 0;
+    encoding.videoBitrateKbps = job.videoBitrateKbps;
+    encoding.audioBitrateKbps = job.audioBitrateKbps;
+    encoding.segment = job.segment;
+    encoding.threads = job.encoderThreads;
+    if (!encoder->open(job.outputFile, encoding)) {
+        result.error = encoder->errorString();
+        return result;
+    }
+    result.encoder = encoder->description();
+
+    std::string error;
+    auto context = HeadlessContext::create(job.backend, &error);
+    if (!context || !context->makeCurrent()) {
+        result.error = "no OpenGL context: " + error;
+        return result;
+    }
+    result.context = context->description();
+
+    RenderCore::Settings settings = RenderCore::settingsFromConfig(Core::Config::instance().visualizer());
+    settings.fps = job.fps;
+    // Nothing may depend on how fast this machine is
+    settings.adaptiveQuality = false;
+    settings.injectTestSignal = false;
+    if (!job.preset.empty()) settings.presetLocked = true;
+    std::srand(job.seed);
+
+    RenderCore core;
+    HeadlessContext* ctx = context.get();
+    if (!core.initialize([ctx](const char* name) { return ctx->getProcAddress(name); },
+                         settings, job.width, job.height)) {
+        result.error = "cannot create projectM";
+        core.shutdown();
+        context->doneCurrent();
+        return result;
+    }
+    if (!job.preset.empty()) core.loadPreset(job.preset);
+    const GlFunctions& gl = core.gl();
+    OffscreenTarget target;
+    ReadbackRing ring;
+    if (!target.allocate(gl, core.renderWidth(), core.renderHeight())) {
+        result.error = "render target is incomplete";
+    } else if (job.readbackDepth > 0 && !ring.allocate(gl, target.width, target.height, job.readbackDepth)) {
+        result.error = "cannot allocate the readback buffers";
+    }
+
+    std::vector<unsigned char> rgba(static_cast<std::size_t>(job.width) * static_cast<std::size_t>(job.height) * 4);
+    std::vector<float> renderMs;
+    std::vector<float> gpuMs;
+    renderMs.reserve(static_cast<std::size_t>(result.prerollFrames + totalFrames));
+    gpuMs.reserve(static_cast<std::size_t>(result.prerollFrames + totalFrames));
+    double readbackNs = 0.0;
+    double encodeNs = 0.0;
+    const std::int64_t startNs = PlaybackClock::nowNs();
+    std::int64_t progressNs = startNs;
+
+    // Frame @p frame is in rgba: encode it with its audio
+    auto encode = [&](std::uint64_t frame) {
+        const std::int64_t encodeStartNs = PlaybackClock::nowNs();
+        const std::uint64_t begin = frameStartSample(frame, result.sampleRate, job.fps);
+        const std::uint64_t end = std::min(frameStartSample(frame + 1, result.sampleRate, job.fps), result.audioFrames);
+        if (!encoder->writeVideo(rgba.data())
+            || (job.audio && !encoder->writeAudio(pcm.data() + (begin - pcmBase) * 2, end - begin))) {
+            result.error = encoder->errorString();
+        }
+        const std::int64_t encodedNs = PlaybackClock::nowNs();
+        encodeNs += static_cast<double>(encodedNs - encodeStartNs);
+        ++result.frames;
+        if (progress && encodedNs - progressNs >= 1'000'000'000) {
+            progressNs = encodedNs;
+            progress(result.frames, totalFrames);
+        }
+    };
+    // Encode the oldest frame in the ring
+    auto collect = [&]() {
+        std::uint64_t frame = 0;
+        const std::int64_t collectStartNs = PlaybackClock::nowNs();
+        const bool got = ring.collect(gl, rgba.data(), &frame);
+        readbackNs += static_cast<double>(PlaybackClock::nowNs() - collectStartNs);
+        if (got) {
+            encode(frame);
+        } else if (result.error.empty()) {
+            result.error = "readback failed";
+        }
+    };
+
+    for (std::uint64_t frame = firstFrame - result.prerollFrames; result.error.empty() && frame < endFrame; ++frame) {
+        if (cancel && cancel()) {
+            result.cancelled = true;
+            break;
+        }
+        const std::uint64_t begin = frameStartSample(frame, result.sampleRate, job.fps);
+        const std::uint64_t end = std::min(frameStartSample(frame + 1, result.sampleRate, job.fps), result.audioFrames);
+        core.addPcm(pcm.data() + (begin - pcmBase) * 2, end - begin);
+        core.setFrameTime(static_cast<double>(frame) / job.fps);
+        const RenderCore::FrameCost cost = core.renderFrame(target.fbo);
+        renderMs.push_back(static_cast<float>(cost.cpuMs));
+        gpuMs.push_back(static_cast<float>(cost.gpuMs));
+
+        // Pre-roll only moves projectM's state along
+        if (frame < firstFrame) continue;
+        if (job.readbackDepth == 0) {
+            const std::int64_t readStartNs = PlaybackClock::nowNs();
+            target.read(gl, rgba.data());
+            readbackNs += static_cast<double>(PlaybackClock::nowNs() - readStartNs);
+            encode(frame);
+        } else {
+            // Queue this frame and encode the one issued depth - 1 frames ago
+            const std::int64_t issueStartNs = PlaybackClock::nowNs();
+            ring.issue(gl, target.fbo, frame);
+            readbackNs += static_cast<double>(PlaybackClock::nowNs() - issueStartNs);
+            if (ring.full()) collect();
+        }
+    }
+    // Frames already rendered are written even when cancelled, so the file ends where the render stopped
+    while (result.error.empty() && ring.pending() > 0) collect();
+    result.wallSeconds = (PlaybackClock::nowNs() - startNs) * 1e-9;
+    if (!encoder->finish() && result.error.empty()) result.error = encoder->errorString();
+    if (progress) progress(result.frames, totalFrames);
+
+    std::sort(renderMs.begin(), renderMs.end());
+    std::sort(gpuMs.begin(), gpuMs.end());
+    result.renderP50Ms = percentile(renderMs, 0.50);
+    result.renderP95Ms = percentile(renderMs, 0.95);
+    result.gpuP50Ms = percentile(gpuMs, 0.50);
+    if (result.frames > 0) {
+        result.readbackMeanMs = readbackNs * 1e-6 / static_cast<double>(result.frames);
+        result.encodeMeanMs = encodeNs * 1e-6 / static_cast<double>(result.frames);
+    }
+    result.readbackStalls = ring.stalls();
+    result.ok = result.error.empty() && !result.cancelled;
+
+    core.shutdown();
+    ring.release(gl);
+    target.release(gl);
+    context->doneCurrent();
+    return result;
+}
+
+int runRender(const std::vector<std::string>& args) {
+    RenderJob job;
+    if (!parseRenderOptions(args, job)) {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    std::cout << "[Render] " << job.audioFile << " -> " << job.outputFile << ", " << job.width << "x" << job.height
+              << " at " << job.fps << " fps" << std::endl;
+    std::uint64_t totalFrames = 0;
+    const RenderResult result = renderOffline(
+        job,
+        [&job, &totalFrames](std::uint64_t done, std::uint64_t total) {
+            totalFrames = total;
+            if (job.machineReadable) {
+                RenderStatus status;
+                status.done = done;
+                status.total = total;
+                std::printf("%s\n", formatRenderStatus(status).c_str());
+            } else {
+                std::printf("\r[Render] %llu / %llu frames (%.0f%%)", static_cast<unsigned long long>(done),
+                            static_cast<unsigned long long>(total), total ? 100.0 * done / total : 100.0);
+            }
+            std::fflush(stdout);
+        },
+        []() { return g_cancel.load(std::memory_order_relaxed); });
+    std::printf("\n");
+    if (job.machineReadable) {
+        RenderStatus status;
+        status.final = true;
+        status.ok = result.ok;
+        status.done = result.frames;
+        status.total = totalFrames;
+        status.prerollFrames = result.prerollFrames;
+        status.wallSeconds = result.wallSeconds;
+        status.decodeSeconds = result.decodeSeconds;
+        std::printf("%s\n", formatRenderStatus(status).c_str());
+        std::fflush(stdout);
+    }
+
+    if (!result.error.empty()) {
+        std::cerr << "[Render] Failed: " << result.error << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "[Render] " << result.context << std::endl;
+    std::cout << "[Render] " << result.encoder << (result.cancelled ? " (cancelled, file closed)" : "") << std::endl;
+    std::printf("  audio %.2f s at %d Hz, loaded in %.2f s\n",
+                result.sampleRate > 0 ? static_cast<double>(result.audioFrames) / result.sampleRate : 0.0,
+                result.sampleRate, result.decodeSeconds);
+    std::printf("  frames %llu (%.2f s of video) in %.2f s: %.1f fps, %.2fx realtime\n",
+                static_cast<unsigned long long>(result.frames), result.videoSeconds(job.fps), result.wallSeconds,
+                result.wallSeconds > 0.0 ? result.frames / result.wallSeconds : 0.0, result.realtimeMultiple(job.fps));
+    if (job.startFrame > 0 || job.frameCount > 0) {
+        std::printf("  segment from frame %llu, after %llu pre-roll frames\n",
+                    static_cast<unsigned long long>(job.startFrame), static_cast<unsigned long long>(result.prerollFrames));
+    }
+    std::printf("  per frame: render p50 %.2f ms p95 %.2f ms (gpu p50 %.2f), readback %.2f ms, encode %.2f ms\n",
+                result.renderP50Ms, result.renderP95Ms, result.gpuP50Ms, result.readbackMeanMs, result.encodeMeanMs);
+    if (job.readbackDepth > 0) {
+        std::printf("  readback ring of %d buffers, %llu of %llu frames waited for the GPU\n", job.readbackDepth,
+                    static_cast<unsigned long long>(result.readbackStalls), static_cast<unsigned long long>(result.frames));
+    }
+    return result.ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+} // namespace NeonWave::GUI
@@ -0,0 +1,143 @@
+/**
+ * @file OfflineRenderer.h
+ * @brief Fixed-timestep render of a track to a video file, as fast as the machine allows
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "HeadlessContext.h"
+
+namespace NeonWave::GUI {
+
+/// What to render and how.
+struct RenderJob {
+    std::string audioFile;
+    std::string outputFile;                 ///< Extension picks the encoder, see createVideoEncoder()
+    HeadlessContext::Backend backend = HeadlessContext::Backend::Auto;
+    int width = 1280;                       ///< Even, for 4:2:0
+    int height = 720;
+    int fps = 30;
+    std::string preset;                     ///< Empty = the configured preset playlist
+    unsigned int seed = 1;                  ///< For random preset choices
+    int videoBitrateKbps = 5000;
+    int audioBitrateKbps = 128;
+    int readbackDepth = 3;                  ///< PBOs in the ReadbackRing; 0 = synchronous glReadPixels
+    std::uint64_t startFrame = 0;           ///< First frame to encode; frame numbers are those of the whole track
+    std::uint64_t frameCount = 0;           ///< Frames to encode from startFrame; 0 = to the end of the track
+    double prerollSeconds = 0.0;            ///< Rendered and discarded before startFrame, to settle projectM's state
+    bool audio = true;                      ///< False: a video-only file
+    bool segment = false;                   ///< Encode for concatenation, see VideoEncoder::Settings::segment
+    int encoderThreads = 0;                 ///< 0 = the codec's default
+    int rawSampleRate = 0;                  ///< Non-zero: audioFile is raw stereo float at this rate, see writeRawTrack()
+    bool machineReadable = false;           ///< Progress and result as RenderStatus lines on stdout
+};
+
+/// How it went; times are wall-clock, in the job's process.
+struct RenderResult {
+    bool ok = false;
+    bool cancelled = false;
+    std::string error;
+    std::string context;                    ///< HeadlessContext::description()
+    std::string encoder;                    ///< VideoEncoder::description()
+    std::uint64_t frames = 0;               ///< Encoded
+    std::uint64_t prerollFrames = 0;        ///< Rendered before the first encoded frame
+    std::uint64_t audioFrames = 0;          ///< In the whole track
+    int sampleRate = 0;
+    double decodeSeconds = 0.0;
+    double wallSeconds = 0.0;               ///< Render loop only: pre-roll, render, readback, encode
+    double renderP50Ms = 0.0;               ///< CPU time of RenderCore::renderFrame()
+    double renderP95Ms = 0.0;
+    double gpuP50Ms = 0.0;
+    double readbackMeanMs = 0.0;            ///< Inside the readback calls, per frame
+    std::uint64_t readbackStalls = 0;       ///< Ring collects that had to wait for the GPU
+    double encodeMeanMs = 0.0;
+
+    double videoSeconds(int fps) const { return fps > 0 ? static_cast<double>(frames) / fps : 0.0; }
+    /// Seconds of video per second of wall time.
+    double realtimeMultiple(int fps) const { return wallSeconds > 0.0 ? videoSeconds(fps) / wallSeconds : 0.0; }
+};
+
+/// Decode all of @p path as interleaved stereo float; false with the reason in @p error.
+bool decodeTrack(const std::string& path, std::vector<float>& pcm, int& sampleRate, std::string* error = nullptr);
+
+/// Video frames that cover @p audioFrames: every frame that starts before the audio ends.
+std::uint64_t videoFrameCount(std::uint64_t audioFrames, int sampleRate, int fps);
+
+/**
+ * @brief Write interleaved stereo float PCM as a headerless native-endian file
+ *
+ * How the render farm hands the track it decoded to its workers: a worker
+ * given `--raw-audio RATE` reads just the samples its segment needs.
+ */
+bool writeRawTrack(const std::string& path, const std::vector<float>& pcm, std::string* error = nullptr);
+
+/**
+ * @brief One line of `--render --machine-readable` output, for a coordinating process
+ *
+ * formatRenderStatus() and parseRenderStatus() are the only two ends of
+ * this format; anything else the worker prints is for people.
+ */
+struct RenderStatus {
+    bool final = false;                     ///< The job has ended and this is its result
+    bool ok = false;                        ///< final only
+    std::uint64_t done = 0;                 ///< Frames encoded so far
+    std::uint64_t total = 0;                ///< Frames the job will encode
+    std::uint64_t prerollFrames = 0;
+    double wallSeconds = 0.0;               ///< final only: RenderResult::wallSeconds
+    double decodeSeconds = 0.0;             ///< final only
+};
+
+std::string formatRenderStatus(const RenderStatus& status);
+/// False if @p line is not a status line.
+bool parseRenderStatus(const std::string& line, RenderStatus& status);
+
+/**
+ * @brief Parse the `--render` command line into @p job
+ * @return False on an unknown option, a bad value or not exactly AUDIO and OUTPUT
+ */
+bool parseRenderOptions(const std::vector<std::string>& args, RenderJob& job);
+
+/**
+ * @brief Decode @p job's audio and render it frame by frame into its output file
+ * @param progress Called about once a second with frames done and the total
+ * @param cancel Polled between frames; a cancelled job still closes a valid file
+ *
+ * The clock is the frame index, never the wall clock. Video frame n gets
+ * exactly the samples [n * rate / fps, (n + 1) * rate / fps) — integer
+ * arithmetic on the frame grid, so nothing drifts over a long track — and
+ * projectM's time is set to n / fps before it renders. The adaptive quality
+ * governor and the test tone are off. Frames come back through a
+ * ReadbackRing, so frame n is encoded while the GPU renders the next ones.
+ *
+ * A job can cover a slice of the track (startFrame, frameCount). Its
+ * pre-roll frames get the audio and frame times they would have in a full
+ * render but are never read back, so beat detection and smoothing have
+ * settled by the first frame that is kept. The same job therefore produces the
+ * same number of frames with the same audio under each, on any machine,
+ * at whatever speed that machine manages.
+ */
+RenderResult renderOffline(const RenderJob& job,
+                           const std::function<void(std::uint64_t done, std::uint64_t total)>& progress = {},
+                           const std::function<bool()>& cancel = {});
+
+/**
+ * @brief `neonwave --render [options] AUDIO OUTPUT`
+ *
+ * Options: `--backend`, `--size WxH` (default 1280x720), `--fps N`
+ * (default 30), `--preset PATH`, `--seed N`, `--video-kbps N`,
+ * `--audio-kbps N`, `--readback-depth N` (default 3, 0 = synchronous),
+ * and for rendering one segment of a track: `--start-frame N`,
+ * `--frames N`, `--preroll SECONDS`, `--no-audio`, `--segment`,
+ * `--threads N`, `--raw-audio RATE`, `--machine-readable`. Stops cleanly on SIGINT/SIGTERM. Prints the render
+ * speed as a multiple of realtime and where the time went.
+ *
+ * @param args Arguments following --render
+ * @return Process exit code
+ */
+int runRender(const std::vector<std::string>& args);
+
+} // namespace NeonWave::GUI
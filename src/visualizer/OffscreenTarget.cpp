@@ -0,0 +1,39 @@
+/**
+ * @file OffscreenTarget.cpp
+ * @brief Implementation of the offscreen render target
+ */
+
+#include "OffscreenTarget.h"
+
+namespace NeonWave::GUI {
+
+bool OffscreenTarget::allocate(const GlFunctions& gl, int newWidth, int newHeight) {
+    if (!texture) {
+        gl.glGenTextures(1, &texture);
+        gl.glGenFramebuffers(1, &fbo);
+    }
+    gl.glBindTexture(GL_TEXTURE_2D, texture);
+    gl.glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, newWidth, newHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    gl.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    gl.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    gl.glBindTexture(GL_TEXTURE_2D, 0);
+    gl.glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    gl.glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+    width = newWidth;
+    height = newHeight;
+    return gl.glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+}
+
+void OffscreenTarget::release(const GlFunctions& gl) {
+    if (fbo) gl.glDeleteFramebuffers(1, &fbo);
+    if (texture) gl.glDeleteTextures(1, &texture);
+    *this = OffscreenTarget{};
+}
+
+void OffscreenTarget::read(const GlFunctions& gl, unsigned char* rgba) const {
+    gl.glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+    gl.glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    gl.glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, rgba);
+}
+
+} // namespace NeonWave::GUI
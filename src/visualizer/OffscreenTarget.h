@@ -0,0 +1,34 @@
+/**
+ * @file OffscreenTarget.h
+ * @brief Colour texture and framebuffer for rendering with no window
+ */
+
+#pragma once
+
+#include "GlFunctions.h"
+
+namespace NeonWave::GUI {
+
+/**
+ * @struct OffscreenTarget
+ * @brief The framebuffer RenderCore::renderFrame() resolves into in headless and offline runs
+ *
+ * Plain handles; the owner calls release() while the context is current.
+ */
+struct OffscreenTarget {
+    GLuint texture = 0;
+    GLuint fbo = 0;
+    int width = 0;
+    int height = 0;
+
+    /// (Re)allocate at @p width x @p height RGBA8; false if the framebuffer is incomplete.
+    bool allocate(const GlFunctions& gl, int width, int height);
+    void release(const GlFunctions& gl);
+    /**
+     * @brief Synchronous readback, stalling until the GPU has finished the frame
+     * @param rgba width * height * 4 bytes, bottom row first as GL stores it
+     */
+    void read(const GlFunctions& gl, unsigned char* rgba) const;
+};
+
+} // namespace NeonWave::GUI
@@ -0,0 +1,257 @@
+/**
+ * @file ProjectMRenderer.cpp
+ * @brief Implementation of the render-thread side of the visualizer
+ */
+
+#include "ProjectMRenderer.h"
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QTimer>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace NeonWave::GUI {
+
+namespace {
+
+/// Nearest-rank percentile of an already sorted window.
+double percentile(const std::vector<float>& sorted, double fraction) {
+    if (sorted.empty()) return 0.0;
+    const auto rank = static_cast<std::size_t>(std::ceil(fraction * static_cast<double>(sorted.size())));
+    return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+} // namespace
+
+ProjectMRenderer::ProjectMRenderer(std::unique_ptr<QOpenGLContext> context, QOffscreenSurface* surface)
+    : m_context(std::move(context))
+    , m_surface(surface)
+{
+}
+
+ProjectMRenderer::~ProjectMRenderer() = default;
+
+void ProjectMRenderer::initialize(const Settings& settings, int width, int height) {
+    if (!m_context->makeCurrent(m_surface)) {
+        std::cerr << "[ProjectMRenderer] Cannot make the render context current" << std::endl;
+        return;
+    }
+    // Emitted from the render thread; Qt queues it to the widget
+    m_core.setPresetChangedCallback([this](const std::string& name) {
+        emit presetChanged(QString::fromStdString(name));
+    });
+    QOpenGLContext* context = m_context.get();
+    const auto resolve = [context](const char* name) {
+        return reinterpret_cast<void*>(context->getProcAddress(name));
+    };
+    const bool initialized = m_core.initialize(resolve, settings, width, height);
+    m_gl = &m_core.gl();
+    if (!initialized) return;
+
+    m_timer = new QTimer(this);
+    m_timer->setTimerType(Qt::PreciseTimer);
+    m_timer->setSingleShot(true);
+    connect(m_timer, &QTimer::timeout, this, &ProjectMRenderer::onFrameTimer);
+    m_clock.setRate(settings.fps);
+    m_clock.reset(Core::Audio::PlaybackClock::nowNs());
+    scheduleFrame();
+}
+
+void ProjectMRenderer::shutdown() {
+    if (m_timer) {
+        m_timer->stop();
+        delete m_timer;
+        m_timer = nullptr;
+    }
+    if (!m_gl) return;
+    m_core.shutdown();
+    releaseGl();
+    m_context->doneCurrent();
+    m_gl = nullptr;
+}
+
+void ProjectMRenderer::resize(int width, int height) {
+    m_core.resize(width, height);
+}
+
+void ProjectMRenderer::applySettings(const Settings& settings) {
+    m_clock.setRate(settings.fps);
+    m_core.applySettings(settings);
+}
+
+void ProjectMRenderer::setPresetAndTextureDirs(const std::string& presetDir, const std::string& textureDir) {
+    m_core.setPresetAndTextureDirs(presetDir, textureDir);
+}
+
+void ProjectMRenderer::setPresetLocked(bool locked) {
+    m_core.setPresetLocked(locked);
+}
+
+void ProjectMRenderer::loadPreset(const std::string& presetPath) {
+    m_core.loadPreset(presetPath);
+}
+
+void ProjectMRenderer::nextPreset() {
+    m_core.nextPreset();
+}
+
+void ProjectMRenderer::previousPreset() {
+    m_core.previousPreset();
+}
+
+void ProjectMRenderer::randomPreset() {
+    m_core.randomPreset();
+}
+
+void ProjectMRenderer::setAudioBus(const std::shared_ptr<Core::Audio::AudioBlockBus>& bus) {
+    m_core.setAudioBus(bus);
+}
+
+void ProjectMRenderer::setPlaybackClock(const std::shared_ptr<const Core::Audio::PlaybackClock>& clock) {
+    m_core.setPlaybackClock(clock);
+}
+
+void ProjectMRenderer::setAudioSyncOffset(int milliseconds) {
+    m_core.setAudioSyncOffset(milliseconds);
+}
+
+void ProjectMRenderer::setAnalysisSampleRate(int sampleRate) {
+    m_core.setAnalysisSampleRate(sampleRate);
+}
+
+ProjectMRenderer::AudioSyncStats ProjectMRenderer::audioSyncStats() const {
+    return m_core.audioSyncStats();
+}
+
+ProjectMRenderer::FrameStats ProjectMRenderer::frameStats() const {
+    std::vector<float> intervals;
+    std::vector<float> renders;
+    std::vector<float> gpu;
+    FrameStats stats;
+    {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        intervals.assign(m_intervalsMs.begin(), m_intervalsMs.begin() + static_cast<std::ptrdiff_t>(m_statsCount));
+        renders.assign(m_renderMs.begin(), m_renderMs.begin() + static_cast<std::ptrdiff_t>(m_statsCount));
+        gpu.assign(m_gpuMs.begin(), m_gpuMs.begin() + static_cast<std::ptrdiff_t>(m_statsCount));
+        stats.frames = m_renderedFrames;
+        stats.pacing = m_pacing;
+    }
+    const RenderCore::QualityStats quality = m_core.qualityStats();
+    stats.quality = quality.governor;
+    stats.renderWidth = quality.renderWidth;
+    stats.renderHeight = quality.renderHeight;
+    stats.meshX = quality.meshX;
+    stats.meshY = quality.meshY;
+    std::sort(intervals.begin(), intervals.end());
+    std::sort(renders.begin(), renders.end());
+    stats.intervalP50Ms = percentile(intervals, 0.50);
+    stats.intervalP95Ms = percentile(intervals, 0.95);
+    stats.intervalP99Ms = percentile(intervals, 0.99);
+    stats.intervalMaxMs = intervals.empty() ? 0.0 : intervals.back();
+    stats.renderP50Ms = percentile(renders, 0.50);
+    stats.renderP95Ms = percentile(renders, 0.95);
+    stats.renderP99Ms = percentile(renders, 0.99);
+    stats.renderMaxMs = renders.empty() ? 0.0 : renders.back();
+    std::sort(gpu.begin(), gpu.end());
+    stats.gpuP50Ms = percentile(gpu, 0.50);
+    stats.gpuP95Ms = percentile(gpu, 0.95);
+    return stats;
+}
+
+void ProjectMRenderer::allocate(RenderedFrame& frame) {
+    const int width = m_core.renderWidth();
+    const int height = m_core.renderHeight();
+    if (!frame.texture) {
+        m_gl->glGenTextures(1, &frame.texture);
+        m_gl->glGenFramebuffers(1, &frame.fbo);
+    }
+    m_gl->glBindTexture(GL_TEXTURE_2D, frame.texture);
+    m_gl->glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    m_gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    m_gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    m_gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    m_gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    m_gl->glBindTexture(GL_TEXTURE_2D, 0);
+    m_gl->glBindFramebuffer(GL_FRAMEBUFFER, frame.fbo);
+    m_gl->glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, frame.texture, 0);
+    frame.width = width;
+    frame.height = height;
+}
+
+void ProjectMRenderer::releaseGl() {
+    // The compositor no longer reads (its thread is blocked on shutdown()), so cycle the
+    // buffer as both sides to reach all three slots, including the one it was holding
+    for (int i = 0; i < 3; ++i) {
+        RenderedFrame& frame = m_frames.back();
+        if (frame.renderDone) m_gl->glDeleteSync(frame.renderDone);
+        if (frame.compositeDone) m_gl->glDeleteSync(frame.compositeDone);
+        if (frame.fbo) m_gl->glDeleteFramebuffers(1, &frame.fbo);
+        if (frame.texture) m_gl->glDeleteTextures(1, &frame.texture);
+        frame = RenderedFrame{};
+        m_frames.publish();
+        m_frames.update();
+    }
+}
+
+void ProjectMRenderer::scheduleFrame() {
+    // Qt timers only resolve milliseconds: wake up through the event loop a little early, then sleep the rest precisely
+    const std::int64_t coarseNs = m_clock.deadlineNs() - FrameClock::kFineWaitNs - Core::Audio::PlaybackClock::nowNs();
+    m_timer->start(static_cast<int>(std::max<std::int64_t>(0, coarseNs / 1'000'000)));
+}
+
+void ProjectMRenderer::onFrameTimer() {
+    FrameClock::sleepUntil(m_clock.deadlineNs());
+    renderFrame();
+    scheduleFrame();
+}
+
+void ProjectMRenderer::renderFrame() {
+    if (!m_core.isInitialized()) return;
+    const std::int64_t startNs = Core::Audio::PlaybackClock::nowNs();
+    // Slots this frame started too late for are dropped, not rendered back to back
+    m_clock.beginFrame(startNs);
+    const std::int64_t swapNs = m_lastSwapNs.load(std::memory_order_relaxed);
+    if (m_core.settings().vsync && swapNs != m_alignedSwapNs) {
+        // Start half a period ahead of the swap, leaving the rest of it to render and composite
+        m_alignedSwapNs = swapNs;
+        m_clock.alignTo(swapNs, m_clock.periodNs() / 2);
+    }
+
+    RenderedFrame& frame = m_frames.back();
+    if (frame.compositeDone) {
+        // The compositor's blit out of this texture must finish before we draw over it
+        m_gl->glWaitSync(frame.compositeDone, 0, GL_TIMEOUT_IGNORED);
+        m_gl->glDeleteSync(frame.compositeDone);
+        frame.compositeDone = nullptr;
+    }
+    if (frame.renderDone) {
+        m_gl->glDeleteSync(frame.renderDone);
+        frame.renderDone = nullptr;
+    }
+    if (frame.width != m_core.renderWidth() || frame.height != m_core.renderHeight()) allocate(frame);
+    const RenderCore::FrameCost cost = m_core.renderFrame(frame.fbo);
+
+    // The fence has to be flushed before another context can wait on it
+    frame.renderDone = m_gl->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    m_gl->glFlush();
+    frame.number = ++m_frameNumber;
+    m_frames.publish();
+    if (!m_frameReadyPending.exchange(true, std::memory_order_acq_rel)) emit frameReady();
+
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    ++m_renderedFrames;
+    m_pacing = m_clock.stats();
+    if (m_lastFrameNs != 0) {
+        const auto intervalMs = static_cast<float>((startNs - m_lastFrameNs) * 1e-6);
+        m_intervalsMs[m_statsPos] = intervalMs;
+        m_renderMs[m_statsPos] = static_cast<float>(cost.cpuMs);
+        m_gpuMs[m_statsPos] = static_cast<float>(cost.gpuMs);
+        m_statsPos = (m_statsPos + 1) % kStatsWindow;
+        m_statsCount = std::min(m_statsCount + 1, kStatsWindow);
+    }
+    m_lastFrameNs = startNs;
+}
+
+} // namespace NeonWave::GUI
@@ -0,0 +1,168 @@
+/**
+ * @file ProjectMRenderer.h
+ * @brief ProjectM instance and frame loop running on a dedicated render thread
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QOpenGLExtraFunctions>
+#include <QString>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "core/audio/TripleBuffer.h"
+#include "FrameClock.h"
+#include "RenderCore.h"
+
+class QOpenGLContext;
+class QOffscreenSurface;
+class QTimer;
+
+namespace NeonWave::GUI {
+
+/// A finished frame: a colour texture in the share group, plus the fences that order its use across contexts.
+struct RenderedFrame {
+    GLuint texture = 0;
+    GLuint fbo = 0;                  ///< Render context's framebuffer around @c texture
+    int width = 0;
+    int height = 0;
+    GLsync renderDone = nullptr;     ///< Signalled once the frame is in @c texture; the compositor waits on it
+    GLsync compositeDone = nullptr;  ///< Signalled once the compositor has read it; the renderer waits before reuse
+    std::uint64_t number = 0;        ///< Frames rendered up to and including this one
+};
+
+/**
+ * @class ProjectMRenderer
+ * @brief Runs a RenderCore on its own thread and hands its frames over in shared textures
+ *
+ * Lives on a dedicated QThread with its own QOpenGLContext, created in the
+ * compositing widget's share group, so nothing the GUI thread does — file
+ * dialogs, playlist updates, settings saves — can delay a frame. projectM
+ * itself and its audio feed are in the RenderCore; this class adds the Qt
+ * context, the frame clock and the handover to the compositor. Every
+ * method below except frames(), audioSyncStats(), frameStats() and
+ * clearFrameNotification() belongs to the render thread: call them through
+ * a queued QMetaObject::invokeMethod, as ProjectMWidget does.
+ *
+ * The core renders into a multisampled framebuffer, resolved into one
+ * of three textures and handed over through a TripleBuffer, so the
+ * renderer never waits for the compositor and the compositor always gets
+ * the newest complete frame. GL fences order the two contexts: the
+ * compositor waits (on the GPU) for renderDone before reading a texture,
+ * and the renderer for compositeDone before drawing into it again.
+ */
+class ProjectMRenderer : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr std::size_t kStatsWindow = 600; ///< Frames the percentiles cover
+
+    using Settings = RenderCore::Settings;
+    using AudioSyncStats = RenderCore::AudioSyncStats;
+
+    /// Percentiles over the last kStatsWindow frames, plus the frame clock's counters since initialize().
+    struct FrameStats {
+        std::uint64_t frames = 0;     ///< Rendered since initialize()
+        FrameClock::Stats pacing;     ///< Target, skipped slots, vsync alignment and the interval histogram
+        double intervalP50Ms = 0.0;
+        double intervalP95Ms = 0.0;
+        double intervalP99Ms = 0.0;
+        double intervalMaxMs = 0.0;
+        double renderP50Ms = 0.0;     ///< CPU time to feed PCM and submit the frame
+        double renderP95Ms = 0.0;
+        double renderP99Ms = 0.0;
+        double renderMaxMs = 0.0;
+        double gpuP50Ms = 0.0;        ///< GPU time of the frame, where timer queries are available
+        double gpuP95Ms = 0.0;
+        int renderWidth = 0;          ///< Size frames are rendered at, before the compositor scales them
+        int renderHeight = 0;
+        int meshX = 0;
+        int meshY = 0;
+        QualityGovernor::Stats quality;
+    };
+
+    /**
+     * @brief Take over a context and surface created on the GUI thread
+     * @param context Shares with the compositing context; moved to this object's thread by the caller
+     * @param surface Offscreen surface matching @p context; must outlive the renderer
+     */
+    ProjectMRenderer(std::unique_ptr<QOpenGLContext> context, QOffscreenSurface* surface);
+    ~ProjectMRenderer() override;
+
+    // ---- render thread -------------------------------------------------
+
+    /// Make the context current, create projectM and start the frame clock.
+    void initialize(const Settings& settings, int width, int height);
+    /// Stop rendering and release projectM and every GL object while the context is still current.
+    void shutdown();
+
+    /// Output size in device pixels; frames are rendered at this times the quality level's resolution scale.
+    void resize(int width, int height);
+    void applySettings(const Settings& settings);
+    void setPresetAndTextureDirs(const std::string& presetDir, const std::string& textureDir);
+    void setPresetLocked(bool locked);
+    void loadPreset(const std::string& presetPath);
+    void nextPreset();
+    void previousPreset();
+    void randomPreset();
+
+    void setAudioBus(const std::shared_ptr<Core::Audio::AudioBlockBus>& bus);
+    void setPlaybackClock(const std::shared_ptr<const Core::Audio::PlaybackClock>& clock);
+    void setAudioSyncOffset(int milliseconds);
+    void setAnalysisSampleRate(int sampleRate);
+
+    // ---- any thread ----------------------------------------------------
+
+    /// Finished frames; the compositing thread is the single reader.
+    Core::Audio::TripleBuffer<RenderedFrame>& frames() { return m_frames; }
+    AudioSyncStats audioSyncStats() const;
+    FrameStats frameStats() const;
+    /// The compositor has seen the last frameReady(); the next frame may signal again.
+    void clearFrameNotification() { m_frameReadyPending.store(false, std::memory_order_release); }
+    /// A buffer swap presented a frame at @p nowNs (PlaybackClock::nowNs()); used when Settings::vsync is on.
+    void noteSwap(std::int64_t nowNs) { m_lastSwapNs.store(nowNs, std::memory_order_relaxed); }
+
+signals:
+    /// A new frame is in frames(); not repeated until clearFrameNotification().
+    void frameReady();
+    void presetChanged(const QString& presetName);
+
+private:
+    /// Arm the timer to wake just before the clock's next deadline.
+    void scheduleFrame();
+    void onFrameTimer();
+    void renderFrame();
+    void allocate(RenderedFrame& frame);
+    void releaseGl();
+
+    std::unique_ptr<QOpenGLContext> m_context;
+    QOffscreenSurface* m_surface;
+    RenderCore m_core;
+    const GlFunctions* m_gl = nullptr;          // m_core's table, once initialized
+    QTimer* m_timer = nullptr;                   // single-shot, re-armed by scheduleFrame()
+    FrameClock m_clock;
+    std::atomic<std::int64_t> m_lastSwapNs{0};   // written by the compositor
+    std::int64_t m_alignedSwapNs = 0;            // last swap the clock was aligned to
+
+    // Render targets
+    Core::Audio::TripleBuffer<RenderedFrame> m_frames;
+    std::uint64_t m_frameNumber = 0;
+    std::atomic<bool> m_frameReadyPending{false};
+
+    // Published to other threads under m_statsMutex
+    mutable std::mutex m_statsMutex;
+    std::array<float, kStatsWindow> m_intervalsMs{};
+    std::array<float, kStatsWindow> m_renderMs{};
+    std::array<float, kStatsWindow> m_gpuMs{};
+    std::size_t m_statsCount = 0;
+    std::size_t m_statsPos = 0;
+    std::uint64_t m_renderedFrames = 0;
+    FrameClock::Stats m_pacing;
+    std::int64_t m_lastFrameNs = 0;
+};
+
+} // namespace NeonWave::GUI
@@ -4,462 +4,341 @@
  */
 
 #include "ProjectMWidget.h"
-#include <QTimer>
+#include <QOffscreenSurface>
 #include <QOpenGLContext>
+#include <QScreen>
+#include <QThread>
+#include <QTimer>
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <filesystem>
-#include <cstdlib>
 #include "core/Config.h"
 
-// ProjectM headers
-#include <projectM-4/projectM.h>
-#include <projectM-4/playlist.h>
-#include <projectM-4/parameters.h>
-#include <projectM-4/render_opengl.h>
-
 namespace NeonWave::GUI {
 
+namespace {
+
+/// Swaps only say something about frame phase if they recur at a whole ratio of the frame rate.
+bool refreshMatchesFps(double refreshHz, int fps) {
+    if (refreshHz <= 0.0 || fps <= 0) return false;
+    const double ratio = refreshHz >= fps ? refreshHz / fps : fps / refreshHz;
+    return std::abs(ratio - std::round(ratio)) < 0.01 * ratio;
+}
+
+} // namespace
+
 /**
  * @class ProjectMWidget::Impl
- * @brief Private implementation containing ProjectM instance
+ * @brief Private implementation: the render thread and what it was told
  */
 class ProjectMWidget::Impl {
 public:
-    projectm_handle projectM = nullptr;
-    projectm_playlist_handle playlist = nullptr;
-    QTimer* renderTimer = nullptr;
-    bool initialized = false;
+    QThread renderThread;
+    ProjectMRenderer* renderer = nullptr;        // lives on renderThread
+    std::unique_ptr<QOffscreenSurface> surface;  // render context's drawable; created here, used there
+    ProjectMRenderer::Settings settings;         // replayed when the renderer is (re)created
+    bool settingsScheduled = false;
     bool presetLocked = false;
     std::string currentPresetName;
-    std::recursive_mutex projectm_mutex;
-    
-    ~Impl() {
-        cleanup();
-    }
-    
-    void cleanup() {
-        if (playlist) {
-            projectm_playlist_destroy(playlist);
-            playlist = nullptr;
-        }
-        if (projectM) {
-            projectm_destroy(projectM);
-            projectM = nullptr;
-        }
-    }
+    std::shared_ptr<Core::Audio::AudioBlockBus> audioBus;
+    std::shared_ptr<const Core::Audio::PlaybackClock> playbackClock;
+    int syncOffsetMs = 0;
+    int analysisRate = 0;
+
+    // Compositing, GUI thread only
+    GLuint compositeFbo = 0;
+    std::uint64_t lastComposited = 0;
+    std::uint64_t composited = 0;
+    std::uint64_t notComposited = 0;
 };
 
 ProjectMWidget::ProjectMWidget(QWidget* parent)
     : QOpenGLWidget(parent)
     , pImpl(std::make_unique<Impl>()) {
-    
-    // Set OpenGL format
+
+    // Set OpenGL format. No multisampling here: the renderer resolves its own
+    // multisampled target, and a blit into a multisampled window is invalid.
     QSurfaceFormat format;
     format.setVersion(3, 3);
     // Some drivers/presets assume compatibility profile
     format.setProfile(QSurfaceFormat::CompatibilityProfile);
     format.setDepthBufferSize(24);
     format.setStencilBufferSize(8);
-    format.setSamples(4); // Enable multisampling
+    const auto& vcfg = NeonWave::Core::Config::instance().visualizer();
+    format.setSwapInterval(vcfg.vsync ? 1 : 0);
     setFormat(format);
+
+    pImpl->settings.randomPresetOnStartup = vcfg.loadRandomPresetOnStartup;
+    pImpl->settings.vsync = vcfg.vsync;
+    pImpl->settings.adaptiveQuality = vcfg.adaptiveQuality;
+    pImpl->settings.injectTestSignal = vcfg.debugInjectTestSignal;
+    pImpl->renderThread.setObjectName("NeonWave Render");
+
+    connect(this, &QOpenGLWidget::frameSwapped, this, [this]() {
+        if (!pImpl->renderer || !pImpl->settings.vsync || format().swapInterval() < 1) return;
+        if (!screen() || !refreshMatchesFps(screen()->refreshRate(), pImpl->settings.fps)) return;
+        pImpl->renderer->noteSwap(Core::Audio::PlaybackClock::nowNs());
+    });
 }
 
 ProjectMWidget::~ProjectMWidget() {
-    makeCurrent();
-    cleanupProjectM();
-    doneCurrent();
+    stopRenderer();
+    if (pImpl->compositeFbo) {
+        makeCurrent();
+        glDeleteFramebuffers(1, &pImpl->compositeFbo);
+        doneCurrent();
+    }
+}
+
+template <typename Fn>
+void ProjectMWidget::post(Fn&& fn) {
+    if (pImpl->renderer) {
+        QMetaObject::invokeMethod(pImpl->renderer, std::forward<Fn>(fn), Qt::QueuedConnection);
+    }
 }
 
 void ProjectMWidget::initializeGL() {
     std::cout << "[ProjectMWidget] Initializing OpenGL context" << std::endl;
-    
+
     // Initialize OpenGL functions
     initializeOpenGLFunctions();
-    
-    // Set up OpenGL state
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-    
-    // Initialize ProjectM
-    if (!initializeProjectM()) {
-        std::cerr << "[ProjectMWidget] Failed to initialize ProjectM!" << std::endl;
-        return;
-    }
-    
-    // Start render timer (60 FPS)
-    startRenderTimer();
-}
 
-void ProjectMWidget::resizeGL(int w, int h) {
-    if (pImpl->projectM) {
-        std::lock_guard<std::recursive_mutex> lock(pImpl->projectm_mutex);
-        projectm_set_window_size(pImpl->projectM, w, h);
-    }
+    // Re-parenting gives the widget a new context in a new share group; the renderer has to follow
+    stopRenderer();
+    pImpl->compositeFbo = 0;
+    startRenderer();
 }
 
-void ProjectMWidget::paintGL() {
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    
-    if (pImpl->projectM && pImpl->initialized) {
-        // Render ProjectM frame (guard against upstream exceptions)
-        try {
-            std::lock_guard<std::recursive_mutex> lock(pImpl->projectm_mutex);
-            // Optional: inject a small test signal for debug visibility
-            const auto& vcfg = NeonWave::Core::Config::instance().visualizer();
-            if (vcfg.debugInjectTestSignal) {
-                constexpr size_t frames = 512;
-                static float phase = 0.0f;
-                float buffer[frames * 2];
-                const float freq = 220.0f;
-                const float sampleRate = 48000.0f;
-                for (size_t i = 0; i < frames; ++i) {
-                    float s = 0.1f * sinf(2.0f * 3.14159265f * freq * (phase / sampleRate));
-                    buffer[2 * i] = s;
-                    buffer[2 * i + 1] = s;
-                    phase += 1.0f;
-                }
-                projectm_pcm_add_float(pImpl->projectM, buffer, frames * 2, PROJECTM_STEREO);
-            }
-
-            projectm_opengl_render_frame_fbo(pImpl->projectM, static_cast<uint32_t>(defaultFramebufferObject()));
-
-        } catch (const std::exception& e) {
-            std::cerr << "[ProjectMWidget] Render error: " << e.what() << std::endl;
-        }
+void ProjectMWidget::startRenderer() {
+    auto context = std::make_unique<QOpenGLContext>();
+    context->setFormat(this->context()->format());
+    context->setShareContext(this->context());
+    if (!context->create()) {
+        std::cerr << "[ProjectMWidget] Failed to create the render context!" << std::endl;
+        return;
     }
-}
+    pImpl->surface = std::make_unique<QOffscreenSurface>();
+    pImpl->surface->setFormat(context->format());
+    pImpl->surface->create();
 
+    context->moveToThread(&pImpl->renderThread);
+    pImpl->renderer = new ProjectMRenderer(std::move(context), pImpl->surface.get());
+    pImpl->renderer->moveToThread(&pImpl->renderThread);
+    connect(pImpl->renderer, &ProjectMRenderer::frameReady, this, [this]() {
+        if (pImpl->renderer) pImpl->renderer->clearFrameNotification();
+        update(); // composite in paintGL
+    });
+    connect(pImpl->renderer, &ProjectMRenderer::presetChanged, this, [this](const QString& name) {
+        pImpl->currentPresetName = name.toStdString();
+        emit presetChanged(name);
+    });
+    pImpl->renderThread.start(QThread::HighPriority);
+
+    const qreal dpr = devicePixelRatioF();
+    const int w = static_cast<int>(width() * dpr);
+    const int h = static_cast<int>(height() * dpr);
+    post([r = pImpl->renderer, s = pImpl->settings, w, h]() { r->initialize(s, w, h); });
+    post([r = pImpl->renderer, bus = pImpl->audioBus, clock = pImpl->playbackClock,
+          offset = pImpl->syncOffsetMs, rate = pImpl->analysisRate]() {
+        r->setAudioBus(bus);
+        r->setPlaybackClock(clock);
+        r->setAudioSyncOffset(offset);
+        r->setAnalysisSampleRate(rate);
+    });
+}
 
+void ProjectMWidget::stopRenderer() {
+    if (!pImpl->renderer) return;
+    // GL objects go while the render context is still current on its own thread
+    QMetaObject::invokeMethod(pImpl->renderer, [r = pImpl->renderer]() {
+        r->shutdown();
+        delete r;
+    }, Qt::BlockingQueuedConnection);
+    pImpl->renderer = nullptr;
+    pImpl->renderThread.quit();
+    pImpl->renderThread.wait();
+    pImpl->surface.reset();
+    pImpl->lastComposited = 0;
+}
 
-bool ProjectMWidget::initializeProjectM() {
-    std::cout << "[ProjectMWidget] Initializing ProjectM..." << std::endl;
-    
-    // Create ProjectM instance (v4 API)
-    pImpl->projectM = projectm_create();
-    if (!pImpl->projectM) {
-        std::cerr << "[ProjectMWidget] Failed to create ProjectM instance!" << std::endl;
-        return false;
-    }
+void ProjectMWidget::resizeGL(int w, int h) {
+    const qreal dpr = devicePixelRatioF();
+    const int pixelsW = static_cast<int>(w * dpr);
+    const int pixelsH = static_cast<int>(h * dpr);
+    post([r = pImpl->renderer, pixelsW, pixelsH]() { r->resize(pixelsW, pixelsH); });
+}
 
-    std::lock_guard<std::recursive_mutex> lock(pImpl->projectm_mutex);
-
-    // Apply parameters via API
-    projectm_set_window_size(pImpl->projectM, static_cast<size_t>(width()), static_cast<size_t>(height()));
-    projectm_set_fps(pImpl->projectM, 60);
-    projectm_set_mesh_size(pImpl->projectM, 32, 24);
-    projectm_set_aspect_correction(pImpl->projectM, true);
-    projectm_set_beat_sensitivity(pImpl->projectM, 1.0f);
-    projectm_set_hard_cut_duration(pImpl->projectM, 3.0);
-    projectm_set_hard_cut_enabled(pImpl->projectM, true);
-    projectm_set_soft_cut_duration(pImpl->projectM, 10.0);
-    projectm_set_preset_duration(pImpl->projectM, 30.0);
-
-    // Register preset switch callback
-    projectm_set_preset_switch_requested_event_callback(pImpl->projectM, presetSwitchedCallback, this);
-
-    // Texture search paths
-    std::string texturePath = "/usr/share/projectM/textures";
-#ifdef PROJECTM_DEFAULT_TEXTURES_DIR
-    if (!std::filesystem::exists(texturePath)) {
-        texturePath = PROJECTM_DEFAULT_TEXTURES_DIR;
-    }
-#else
-    if (!std::filesystem::exists(texturePath)) {
-        texturePath = "./external/projectm/textures";
-    }
-#endif
-    const char* texturePaths[] = { texturePath.c_str() };
-    projectm_set_texture_search_paths(pImpl->projectM, texturePaths, 1);
-    
-    // Discover presets from directory (if present)
-    std::string presetPath = "/usr/share/projectM/presets";
-#ifdef PROJECTM_DEFAULT_PRESETS_DIR
-    if (!std::filesystem::exists(presetPath)) {
-        presetPath = PROJECTM_DEFAULT_PRESETS_DIR;
-    }
-#else
-    if (!std::filesystem::exists(presetPath)) {
-        presetPath = "./external/projectm/presets";
+void ProjectMWidget::paintGL() {
+    if (!pImpl->renderer) {
+        glClear(GL_COLOR_BUFFER_BIT);
+        return;
     }
-#endif
-    size_t presetCount = 0;
-    std::vector<std::string> discoveredPresets;
-    std::cout << "[ProjectMWidget] Searching for presets in: " << presetPath << std::endl;
-    if (std::filesystem::exists(presetPath)) {
-        try {
-            for (const auto& entry : std::filesystem::recursive_directory_iterator(presetPath)) {
-                if (entry.is_regular_file() && entry.path().extension() == ".milk") {
-                    discoveredPresets.emplace_back(entry.path().string());
-                }
-            }
-        } catch (const std::filesystem::filesystem_error& e) {
-            std::cerr << "[ProjectMWidget] Filesystem error while scanning presets: " << e.what() << std::endl;
-        }
-        presetCount = discoveredPresets.size();
+    auto& frames = pImpl->renderer->frames();
+    frames.update();
+    RenderedFrame& frame = frames.front();
+    if (!frame.texture) {
+        glClear(GL_COLOR_BUFFER_BIT);
+        return;
     }
-    std::cout << "[ProjectMWidget] Found " << presetCount << " presets" << std::endl;
-    // Do not auto-switch; keep idle preset initially for debug visibility
-    if (presetCount > 0) {
-        pImpl->playlist = projectm_playlist_create(pImpl->projectM);
-        if (pImpl->playlist) {
-            for (const auto& path : discoveredPresets) {
-                projectm_playlist_add_preset(pImpl->playlist, path.c_str(), true);
-            }
-            projectm_playlist_set_position(pImpl->playlist, 0, false);
-            projectm_set_preset_locked(pImpl->projectM, false);
+    if (frame.number != pImpl->lastComposited) {
+        if (pImpl->lastComposited != 0 && frame.number > pImpl->lastComposited + 1) {
+            pImpl->notComposited += frame.number - pImpl->lastComposited - 1;
         }
-    }
-    
-    const auto& vcfg = NeonWave::Core::Config::instance().visualizer();
-    if (vcfg.loadRandomPresetOnStartup && presetCount > 0) {
-        randomPreset();
-    } else {
-        // Load default idle preset for initial visualization when no audio is playing
-        projectm_load_preset_file(pImpl->projectM, "idle://", true);
-        pImpl->currentPresetName = "Idle";
-        emit presetChanged(QString::fromStdString(pImpl->currentPresetName));
-    }
-    
-    pImpl->initialized = true;
-    return true;
-}
-
-void ProjectMWidget::cleanupProjectM() {
-    std::lock_guard<std::recursive_mutex> lock(pImpl->projectm_mutex);
-    if (pImpl->renderTimer) {
-        pImpl->renderTimer->stop();
-        delete pImpl->renderTimer;
-        pImpl->renderTimer = nullptr;
-    }
-    
-    pImpl->cleanup();
-    pImpl->initialized = false;
+        pImpl->lastComposited = frame.number;
+        ++pImpl->composited;
+    }
+
+    // Waits on the GPU, not here: the blit is queued behind the render thread's frame
+    glWaitSync(frame.renderDone, 0, GL_TIMEOUT_IGNORED);
+    if (!pImpl->compositeFbo) glGenFramebuffers(1, &pImpl->compositeFbo);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, pImpl->compositeFbo);
+    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, frame.texture, 0);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, defaultFramebufferObject());
+    const qreal dpr = devicePixelRatioF();
+    const int w = static_cast<int>(width() * dpr);
+    const int h = static_cast<int>(height() * dpr);
+    // Frames rendered at a reduced quality level, or still at the old size just after a resize, are scaled up
+    glBlitFramebuffer(0, 0, frame.width, frame.height, 0, 0, w, h, GL_COLOR_BUFFER_BIT,
+                      frame.width == w && frame.height == h ? GL_NEAREST : GL_LINEAR);
+    glBindFramebuffer(GL_FRAMEBUFFER, defaultFramebufferObject());
+
+    if (frame.compositeDone) glDeleteSync(frame.compositeDone);
+    frame.compositeDone = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
 }
 
-void ProjectMWidget::startRenderTimer() {
-    pImpl->renderTimer = new QTimer(this);
-    connect(pImpl->renderTimer, &QTimer::timeout, [this]() {
-        update(); // Trigger paintGL
+void ProjectMWidget::scheduleSettings() {
+    if (pImpl->settingsScheduled) return;
+    // Settings arrive a field at a time from MainWindow; send them as one update
+    pImpl->settingsScheduled = true;
+    QTimer::singleShot(0, this, [this]() {
+        pImpl->settingsScheduled = false;
+        post([r = pImpl->renderer, s = pImpl->settings]() { r->applySettings(s); });
     });
-    pImpl->renderTimer->start(16); // ~60 FPS
 }
 
 bool ProjectMWidget::loadPreset(const std::string& presetPath) {
-    if (!pImpl->projectM || !std::filesystem::exists(presetPath)) {
+    if (!pImpl->renderer || !std::filesystem::exists(presetPath)) {
         return false;
     }
-    
-    std::lock_guard<std::recursive_mutex> lock(pImpl->projectm_mutex);
-    projectm_load_preset_file(pImpl->projectM, presetPath.c_str(), true);
-    pImpl->currentPresetName = std::filesystem::path(presetPath).stem();
-    emit presetChanged(QString::fromStdString(pImpl->currentPresetName));
+    post([r = pImpl->renderer, presetPath]() { r->loadPreset(presetPath); });
     return true;
 }
 
 void ProjectMWidget::nextPreset() {
-    if (pImpl->playlist && !pImpl->presetLocked) {
-        std::lock_guard<std::recursive_mutex> lock(pImpl->projectm_mutex);
-        unsigned int new_index = projectm_playlist_play_next(pImpl->playlist, true);
-        onPresetSwitched(new_index);
-    }
+    if (!pImpl->presetLocked) post([r = pImpl->renderer]() { r->nextPreset(); });
 }
 
 void ProjectMWidget::previousPreset() {
-    if (pImpl->playlist && !pImpl->presetLocked) {
-        std::lock_guard<std::recursive_mutex> lock(pImpl->projectm_mutex);
-        unsigned int new_index = projectm_playlist_play_previous(pImpl->playlist, true);
-        onPresetSwitched(new_index);
-    }
+    if (!pImpl->presetLocked) post([r = pImpl->renderer]() { r->previousPreset(); });
 }
 
 void ProjectMWidget::randomPreset() {
-    if (pImpl->playlist && !pImpl->presetLocked) {
-        std::lock_guard<std::recursive_mutex> lock(pImpl->projectm_mutex);
-        size_t count = projectm_playlist_size(pImpl->playlist);
-        if (count > 0) {
-            size_t randomPos = rand() % count;
-            unsigned int new_index = projectm_playlist_set_position(pImpl->playlist, randomPos, true);
-            onPresetSwitched(new_index);
-        }
-    }
+    if (!pImpl->presetLocked) post([r = pImpl->renderer]() { r->randomPreset(); });
 }
 
 std::string ProjectMWidget::getCurrentPresetName() const {
     return pImpl->currentPresetName;
 }
 
-void ProjectMWidget::addAudioData(const QByteArray& data, int sampleCount, int channelCount) {
-    if (pImpl->projectM && pImpl->initialized && channelCount > 0) {
-        std::lock_guard<std::recursive_mutex> lock(pImpl->projectm_mutex);
-        const float* pcmData = reinterpret_cast<const float*>(data.constData());
-        size_t frames = sampleCount;
-        auto channels = static_cast<projectm_channels>(channelCount);
-        projectm_pcm_add_float(pImpl->projectM, pcmData, frames, channels);
-    }
+void ProjectMWidget::setAudioBus(const std::shared_ptr<Core::Audio::AudioBlockBus>& bus) {
+    pImpl->audioBus = bus;
+    post([r = pImpl->renderer, bus]() { r->setAudioBus(bus); });
 }
 
+void ProjectMWidget::setPlaybackClock(const std::shared_ptr<const Core::Audio::PlaybackClock>& clock) {
+    pImpl->playbackClock = clock;
+    post([r = pImpl->renderer, clock]() { r->setPlaybackClock(clock); });
+}
 
-void ProjectMWidget::setBPM(float bpm) {
-    if (pImpl->projectM) {
-        std::lock_guard<std::recursive_mutex> lock(pImpl->projectm_mutex);
-        // ProjectM uses this for beat detection
-        // Note: This is a simplified approach
-        float beatSensitivity = bpm / 120.0f; // Normalize around 120 BPM
-        projectm_set_beat_sensitivity(pImpl->projectM, beatSensitivity);
-    }
+void ProjectMWidget::setAudioSyncOffset(int milliseconds) {
+    pImpl->syncOffsetMs = milliseconds;
+    post([r = pImpl->renderer, milliseconds]() { r->setAudioSyncOffset(milliseconds); });
+}
+
+void ProjectMWidget::setAnalysisSampleRate(int sampleRate) {
+    pImpl->analysisRate = std::max(0, sampleRate);
+    post([r = pImpl->renderer, rate = pImpl->analysisRate]() { r->setAnalysisSampleRate(rate); });
+}
+
+ProjectMWidget::AudioSyncStats ProjectMWidget::audioSyncStats() const {
+    AudioSyncStats stats = pImpl->renderer ? pImpl->renderer->audioSyncStats() : AudioSyncStats{};
+    stats.offsetMs = pImpl->syncOffsetMs;
+    return stats;
+}
+
+ProjectMWidget::FrameStats ProjectMWidget::frameStats() const {
+    FrameStats stats;
+    if (pImpl->renderer) static_cast<ProjectMRenderer::FrameStats&>(stats) = pImpl->renderer->frameStats();
+    stats.composited = pImpl->composited;
+    stats.notComposited = pImpl->notComposited;
+    return stats;
 }
 
 void ProjectMWidget::setPresetLocked(bool locked) {
     pImpl->presetLocked = locked;
-    if (pImpl->projectM) {
-        std::lock_guard<std::recursive_mutex> lock(pImpl->projectm_mutex);
-        projectm_set_preset_locked(pImpl->projectM, locked);
-    }
+    pImpl->settings.presetLocked = locked;
+    post([r = pImpl->renderer, locked]() { r->setPresetLocked(locked); });
 }
 
 void ProjectMWidget::setFPS(int fps) {
-    if (pImpl->projectM) {
-        std::lock_guard<std::recursive_mutex> lock(pImpl->projectm_mutex);
-        projectm_set_fps(pImpl->projectM, fps);
-    }
+    pImpl->settings.fps = fps;
+    scheduleSettings();
+}
+
+void ProjectMWidget::setVsync(bool enabled) {
+    pImpl->settings.vsync = enabled;
+    scheduleSettings();
 }
 
 void ProjectMWidget::setMeshSize(int x, int y) {
-    if (pImpl->projectM) {
-        std::lock_guard<std::recursive_mutex> lock(pImpl->projectm_mutex);
-        projectm_set_mesh_size(pImpl->projectM, x, y);
-    }
+    pImpl->settings.meshX = x;
+    pImpl->settings.meshY = y;
+    scheduleSettings();
+}
+
+void ProjectMWidget::setAdaptiveQuality(bool enabled) {
+    pImpl->settings.adaptiveQuality = enabled;
+    scheduleSettings();
+}
+
+void ProjectMWidget::setTestSignal(bool enabled) {
+    pImpl->settings.injectTestSignal = enabled;
+    scheduleSettings();
 }
 
 void ProjectMWidget::setAspectCorrection(bool enabled) {
-    if (pImpl->projectM) {
-        std::lock_guard<std::recursive_mutex> lock(pImpl->projectm_mutex);
-        projectm_set_aspect_correction(pImpl->projectM, enabled);
-    }
+    pImpl->settings.aspectCorrection = enabled;
+    scheduleSettings();
 }
 
 void ProjectMWidget::setBeatSensitivity(float sensitivity) {
-    if (pImpl->projectM) {
-        std::lock_guard<std::recursive_mutex> lock(pImpl->projectm_mutex);
-        projectm_set_beat_sensitivity(pImpl->projectM, sensitivity);
-    }
+    pImpl->settings.beatSensitivity = sensitivity;
+    scheduleSettings();
 }
 
 void ProjectMWidget::setHardCut(bool enabled, double durationSeconds) {
-    if (pImpl->projectM) {
-        std::lock_guard<std::recursive_mutex> lock(pImpl->projectm_mutex);
-        projectm_set_hard_cut_enabled(pImpl->projectM, enabled);
-        projectm_set_hard_cut_duration(pImpl->projectM, durationSeconds);
-    }
+    pImpl->settings.hardCutEnabled = enabled;
+    pImpl->settings.hardCutDuration = durationSeconds;
+    scheduleSettings();
 }
 
 void ProjectMWidget::setSoftCutDuration(double durationSeconds) {
-    if (pImpl->projectM) {
-        std::lock_guard<std::recursive_mutex> lock(pImpl->projectm_mutex);
-        projectm_set_soft_cut_duration(pImpl->projectM, durationSeconds);
-    }
+    pImpl->settings.softCutDuration = durationSeconds;
+    scheduleSettings();
 }
 
 void ProjectMWidget::setPresetDuration(double seconds) {
-    if (pImpl->projectM) {
-        std::lock_guard<std::recursive_mutex> lock(pImpl->projectm_mutex);
-        projectm_set_preset_duration(pImpl->projectM, seconds);
-    }
+    pImpl->settings.presetDuration = seconds;
+    scheduleSettings();
 }
 
 void ProjectMWidget::setPresetAndTextureDirs(const std::string& presetDir, const std::string& textureDir) {
-    if (!pImpl->projectM) return;
-    std::lock_guard<std::recursive_mutex> lock(pImpl->projectm_mutex);
-    // Update textures search paths
-    std::string texturePath = textureDir;
-    if (texturePath.empty()) {
-        texturePath = "/usr/share/projectM/textures";
-#ifdef PROJECTM_DEFAULT_TEXTURES_DIR
-        if (!std::filesystem::exists(texturePath)) texturePath = PROJECTM_DEFAULT_TEXTURES_DIR;
-#else
-        if (!std::filesystem::exists(texturePath)) texturePath = "./external/projectm/textures";
-#endif
-    }
-    std::cout << "[ProjectMWidget] Setting texture search path to: " << texturePath << std::endl;
-    const char* texturePaths[] = { texturePath.c_str() };
-    projectm_set_texture_search_paths(pImpl->projectM, texturePaths, 1);
-
-    // Rebuild playlist from new preset directory if provided
-    if (pImpl->playlist) {
-        projectm_playlist_destroy(pImpl->playlist);
-        pImpl->playlist = nullptr;
-    }
-
-    std::string presetPath = presetDir;
-    if (presetPath.empty()) {
-        presetPath = "/usr/share/projectM/presets";
-#ifdef PROJECTM_DEFAULT_PRESETS_DIR
-        if (!std::filesystem::exists(presetPath)) presetPath = PROJECTM_DEFAULT_PRESETS_DIR;
-#else
-        if (!std::filesystem::exists(presetPath)) presetPath = "./external/projectm/presets";
-#endif
-    }
-    size_t count = 0;
-    std::vector<std::string> newPresets;
-    std::cout << "[ProjectMWidget] Rebuilding playlist from: " << presetPath << std::endl;
-    if (std::filesystem::exists(presetPath)) {
-        try {
-            for (const auto& entry : std::filesystem::recursive_directory_iterator(presetPath)) {
-                if (entry.is_regular_file() && entry.path().extension() == ".milk") {
-                    newPresets.emplace_back(entry.path().string());
-                }
-            }
-        } catch (const std::filesystem::filesystem_error& e) {
-            std::cerr << "[ProjectMWidget] Filesystem error while scanning presets: " << e.what() << std::endl;
-        }
-        count = newPresets.size();
-    }
-    std::cout << "[ProjectMWidget] Found " << count << " presets" << std::endl;
-    if (count > 0) {
-        pImpl->playlist = projectm_playlist_create(pImpl->projectM);
-        if (!pImpl->playlist) return;
-        for (const auto& path : newPresets) {
-            projectm_playlist_add_preset(pImpl->playlist, path.c_str(), true);
-        }
-        projectm_playlist_set_position(pImpl->playlist, 0, false);
-        projectm_set_preset_locked(pImpl->projectM, false);
-    } else {
-        // leave playlist as nullptr and keep idle preset
-        projectm_set_preset_locked(pImpl->projectM, true);
-    }
-}
-
-void ProjectMWidget::presetSwitchedCallback(bool /*isHardCut*/, void* context)
-{
-    // This is a static C-style callback, so we use the context pointer
-    // to call a member function on the correct class instance.
-    if (context) {
-        auto* that = static_cast<ProjectMWidget*>(context);
-        // The callback can be called from a different thread, so we need to
-        // queue the call to the main thread to safely update the UI.
-        unsigned int index = projectm_playlist_get_position(that->pImpl->playlist);
-        QMetaObject::invokeMethod(that, [that, index]() {
-            that->onPresetSwitched(index);
-        }, Qt::QueuedConnection);
-    }
-}
-
-void ProjectMWidget::onPresetSwitched(unsigned int index)
-{
-    std::lock_guard<std::recursive_mutex> lock(pImpl->projectm_mutex);
-    if (pImpl->playlist) {
-        char* name_ptr = projectm_playlist_item(pImpl->playlist, index);
-        if (name_ptr) {
-            // projectM returns a pointer to its internal string. We must copy it.
-            std::string preset_path = name_ptr;
-            projectm_playlist_free_string(name_ptr);
-            pImpl->currentPresetName = std::filesystem::path(preset_path).stem().string();
-            emit presetChanged(QString::fromStdString(pImpl->currentPresetName));
-        }
-    }
+    // Only a change of directory rescans; the renderer compares against what it has
+    pImpl->settings.presetDirectory = presetDir;
+    pImpl->settings.textureDirectory = textureDir;
+    scheduleSettings();
 }
 
-} // namespace NeonWave::GUI
\ No newline at end of file
+} // namespace NeonWave::GUI
@@ -6,10 +6,12 @@
 #pragma once
 
 #include <QOpenGLWidget>
-#include <QOpenGLFunctions>
+#include <QOpenGLExtraFunctions>
 #include <memory>
 #include <string>
-#include <mutex>
+#include "core/audio/AudioBlockBus.h"
+#include "core/audio/PlaybackClock.h"
+#include "ProjectMRenderer.h"
 
 namespace NeonWave::GUI {
 
@@ -18,9 +20,12 @@ namespace NeonWave::GUI {
  * @brief OpenGL widget that renders ProjectM visualizations
  * 
  * This widget integrates ProjectM into Qt's OpenGL rendering system,
- * providing audio visualization with MilkDrop preset support.
+ * providing audio visualization with MilkDrop preset support. ProjectM
+ * itself runs on a ProjectMRenderer thread with a context shared with this
+ * widget's; paintGL only blits the newest finished frame, so a busy GUI
+ * thread delays compositing but never rendering.
  */
-class ProjectMWidget : public QOpenGLWidget, protected QOpenGLFunctions {
+class ProjectMWidget : public QOpenGLWidget, protected QOpenGLExtraFunctions {
     Q_OBJECT
     
 public:
@@ -55,22 +60,31 @@ public:
      */
     std::string getCurrentPresetName() const;
     
-    public slots:
     /**
-     * @brief Add audio data to ProjectM for visualization
-     * @param pcmData Raw float PCM data
-     * @param samples Total number of samples (frames * channels)
+     * @brief Subscribe to the decoder's PCM bus
+     * @param bus Bus to subscribe to; pending blocks are drained once per rendered frame
+     *
+     * The audio side only ever enqueues block references, so it never waits on the render thread.
      */
-    void addAudioData(const QByteArray& data, int sampleCount, int channelCount);
+    void setAudioBus(const std::shared_ptr<Core::Audio::AudioBlockBus>& bus);
 
-    
-    
     /**
-     * @brief Set beats per minute (for beat detection)
-     * @param bpm Beats per minute
+     * @brief Hold PCM back until the sink is actually playing it
+     * @param clock Audible-frame clock of the engine that feeds the bus; null feeds blocks immediately
      */
-    void setBPM(float bpm);
-    
+    void setPlaybackClock(const std::shared_ptr<const Core::Audio::PlaybackClock>& clock);
+
+    using AudioSyncStats = ProjectMRenderer::AudioSyncStats;
+    AudioSyncStats audioSyncStats() const;
+
+    /// Render-thread frame timing, plus how many finished frames the GUI thread got to show.
+    struct FrameStats : ProjectMRenderer::FrameStats {
+        std::uint64_t composited = 0;    ///< Frames blitted to the window
+        std::uint64_t notComposited = 0; ///< Frames replaced by a newer one before paintGL got to them
+    };
+    FrameStats frameStats() const;
+
+public slots:
     /**
      * @brief Toggle preset lock (prevent auto-switching)
      * @param locked true to lock current preset
@@ -79,13 +93,30 @@ public:
 
     // Settings application (from Config/SettingsDialog)
     void setFPS(int fps);
+    /**
+     * @brief Phase-lock the render thread's frame clock to buffer swaps
+     *
+     * Only takes effect when the display refresh rate is a whole multiple or
+     * divisor of the target FPS. The swap interval itself is fixed when the
+     * window's context is created (VisualizerConfig::vsync at startup).
+     */
+    void setVsync(bool enabled);
+    /// Mesh size at full quality; the adaptive quality governor may render with less.
     void setMeshSize(int x, int y);
+    /// Let the renderer trade mesh size and render resolution for frame rate.
+    void setAdaptiveQuality(bool enabled);
+    /// Mix a quiet test tone into every frame's PCM, to check the render path without audio.
+    void setTestSignal(bool enabled);
     void setAspectCorrection(bool enabled);
     void setBeatSensitivity(float sensitivity);
     void setHardCut(bool enabled, double durationSeconds);
     void setSoftCutDuration(double durationSeconds);
     void setPresetDuration(double seconds);
     void setPresetAndTextureDirs(const std::string& presetDir, const std::string& textureDir);
+    /// Extra delay (positive) or advance (negative) of the visuals against the measured output latency.
+    void setAudioSyncOffset(int milliseconds);
+    /// Resample the visualizer feed to a fixed rate so analysis doesn't depend on the track's rate; 0 keeps the stream rate.
+    void setAnalysisSampleRate(int sampleRate);
     
 signals:
     /**
@@ -101,28 +132,16 @@ protected:
     void paintGL() override;
     
 private:
-    // projectM callback
-    static void presetSwitchedCallback(bool isHardCut, unsigned int index, void* context);
-    void onPresetSwitched(unsigned int index);
-
     class Impl;
     std::unique_ptr<Impl> pImpl;
-    
-    /**
-     * @brief Initialize ProjectM instance
-     * @return true if successful
-     */
-    bool initializeProjectM();
-    
-    /**
-     * @brief Clean up ProjectM resources
-     */
-    void cleanupProjectM();
-    
-    /**
-     * @brief Start render timer
-     */
-    void startRenderTimer();
+
+    /// Run @p fn on the render thread, after everything posted before it.
+    template <typename Fn>
+    void post(Fn&& fn);
+    /// Send the current settings to the renderer once control returns to the event loop.
+    void scheduleSettings();
+    void startRenderer();
+    void stopRenderer();
 };
 
 } // namespace NeonWave::GUI
\ No newline at end of file
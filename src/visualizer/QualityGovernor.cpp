@@ -0,0 +1,135 @@
+/**
+ * @file QualityGovernor.cpp
+ * @brief Implementation of the adaptive quality governor
+ */
+
+#include "QualityGovernor.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+
+namespace NeonWave::GUI {
+
+namespace {
+
+std::string describe(const QualityGovernor::Level& level) {
+    char text[64];
+    std::snprintf(text, sizeof(text), "mesh %.0f%%, resolution %.0f%%",
+                  level.meshScale * 100.0, level.resolutionScale * 100.0);
+    return text;
+}
+
+std::string formatMs(double ms) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.1f ms", ms);
+    return text;
+}
+
+} // namespace
+
+QualityGovernor::QualityGovernor(int fps)
+    : m_fps(std::max(1, fps))
+{
+}
+
+void QualityGovernor::setEnabled(bool enabled, std::int64_t nowNs) {
+    if (enabled == m_enabled) return;
+    m_enabled = enabled;
+    m_window.clear();
+    m_quietWindows = 0;
+    ++m_windows;
+    if (!enabled && m_level != 0) change(0, nowNs, "adaptive quality turned off");
+}
+
+void QualityGovernor::setFps(int fps) {
+    fps = std::max(1, fps);
+    if (fps == m_fps) return;
+    // Costs measured against the old budget say nothing about the new one
+    m_fps = fps;
+    m_window.clear();
+    m_quietWindows = 0;
+    m_upDwellWindows = kUpDwellWindows;
+}
+
+bool QualityGovernor::addFrame(double costMs, std::int64_t nowNs) {
+    if (!m_enabled) return false;
+    m_window.push_back(costMs);
+    if (static_cast<int>(m_window.size()) < std::max(kMinWindowFrames, m_fps / 2)) return false;
+
+    std::sort(m_window.begin(), m_window.end());
+    const double p90 = m_window[static_cast<std::size_t>(std::ceil(0.9 * m_window.size())) - 1];
+    m_window.clear();
+    ++m_windows;
+    if (m_settling) {
+        m_settling = false;
+        return false;
+    }
+    m_lastP90Ms = p90;
+    if (m_windowsSinceUp >= 0) ++m_windowsSinceUp;
+
+    const double budgetMs = 1000.0 / m_fps;
+    const double load = p90 / budgetMs;
+    const int lowest = static_cast<int>(kLevels.size()) - 1;
+
+    if (load > kDownLoad) {
+        m_quietWindows = 0;
+        if (m_level == lowest) return false;
+        std::string reason = "frame cost p90 " + formatMs(p90) + " is over "
+            + std::to_string(static_cast<int>(kDownLoad * 100)) + "% of the " + formatMs(budgetMs) + " budget";
+        if (m_windowsSinceUp >= 0 && m_windowsSinceUp <= kRelapseWindows) {
+            // The last step up did not hold: wait longer before trying again
+            m_upDwellWindows = std::min(m_upDwellWindows * 2, kMaxUpDwellWindows);
+            reason += "; step up reverted, next attempt after " + std::to_string(m_upDwellWindows) + " windows";
+        }
+        change(m_level + 1, nowNs, std::move(reason));
+        return true;
+    }
+
+    if (load < kUpLoad && m_level > 0) {
+        if (++m_quietWindows < m_upDwellWindows) return false;
+        change(m_level - 1, nowNs, "frame cost p90 " + formatMs(p90) + " has stayed under "
+               + std::to_string(static_cast<int>(kUpLoad * 100)) + "% of the " + formatMs(budgetMs)
+               + " budget for " + std::to_string(m_quietWindows) + " windows");
+        m_windowsSinceUp = 0;
+        return true;
+    }
+
+    m_quietWindows = 0;
+    // A level that held for a long stretch earns back the quicker retry
+    if (m_windowsSinceUp > kMaxUpDwellWindows && m_upDwellWindows > kUpDwellWindows) {
+        m_upDwellWindows = kUpDwellWindows;
+    }
+    return false;
+}
+
+void QualityGovernor::change(int to, std::int64_t nowNs, std::string reason) {
+    const int from = m_level;
+    m_level = to;
+    m_settling = true;
+    m_quietWindows = 0;
+    if (to > from) ++m_stepsDown; else ++m_stepsUp;
+
+    std::cout << "[QualityGovernor] Level " << from << " -> " << to << " (" << describe(current())
+              << "): " << reason << std::endl;
+    m_recent.push_back({ nowNs, from, to, std::move(reason) });
+    if (m_recent.size() > kHistory) m_recent.pop_front();
+}
+
+QualityGovernor::Stats QualityGovernor::stats() const {
+    Stats stats;
+    stats.enabled = m_enabled;
+    stats.level = m_level;
+    stats.meshScale = current().meshScale;
+    stats.resolutionScale = current().resolutionScale;
+    stats.budgetMs = 1000.0 / m_fps;
+    stats.costP90Ms = m_lastP90Ms;
+    stats.windows = m_windows;
+    stats.upDwellWindows = m_upDwellWindows;
+    stats.stepsDown = m_stepsDown;
+    stats.stepsUp = m_stepsUp;
+    stats.recent.assign(m_recent.begin(), m_recent.end());
+    return stats;
+}
+
+} // namespace NeonWave::GUI
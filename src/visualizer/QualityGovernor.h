@@ -0,0 +1,117 @@
+/**
+ * @file QualityGovernor.h
+ * @brief Steps visualizer quality down and up to hold the frame budget
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace NeonWave::GUI {
+
+/**
+ * @class QualityGovernor
+ * @brief Chooses a quality level from rolling frame cost against the frame budget
+ *
+ * Frame costs are collected in windows of half a second. At the end of
+ * each window the 90th percentile is compared to the budget (1 s / fps):
+ * above kDownLoad of it, quality drops one level straight away; only after
+ * the cost has stayed below kUpLoad for a number of consecutive windows
+ * does it rise one level again. The gap between the two thresholds plus
+ * the dwell is the hysteresis. A rise that has to be undone within a few
+ * windows doubles the dwell before the next attempt, so a preset that sits
+ * right on the edge settles instead of oscillating. The window a change
+ * lands in is discarded because it mixes both levels.
+ *
+ * Each level scales the mesh (CPU: per-vertex equations) and then the
+ * render resolution (GPU: fill rate), alternating so neither side is
+ * given up entirely before the other has been tried. Every change is
+ * logged with the measurement that caused it.
+ *
+ * Not thread-safe; the render loop owns it and publishes stats() copies.
+ */
+class QualityGovernor {
+public:
+    struct Level {
+        float meshScale;
+        float resolutionScale;
+    };
+    static constexpr std::array<Level, 7> kLevels{{
+        { 1.00f, 1.00f },
+        { 0.75f, 1.00f },
+        { 0.75f, 0.85f },
+        { 0.50f, 0.85f },
+        { 0.50f, 0.70f },
+        { 0.375f, 0.60f },
+        { 0.25f, 0.50f },
+    }};
+    static constexpr double kDownLoad = 0.90;  ///< p90 cost / budget that forces a step down
+    static constexpr double kUpLoad = 0.60;    ///< p90 cost / budget needed to consider a step up
+    static constexpr int kMinWindowFrames = 15;
+    static constexpr int kUpDwellWindows = 4;  ///< Quiet windows before the first step up
+    static constexpr int kMaxUpDwellWindows = 64;
+    static constexpr int kRelapseWindows = 4;  ///< A step down this soon after a step up counts as a relapse
+    static constexpr std::size_t kHistory = 8;
+
+    struct Change {
+        std::int64_t atNs = 0;  ///< PlaybackClock::nowNs() time base
+        int from = 0;
+        int to = 0;
+        std::string reason;
+    };
+
+    struct Stats {
+        bool enabled = true;
+        int level = 0;
+        float meshScale = 1.0f;
+        float resolutionScale = 1.0f;
+        double budgetMs = 0.0;
+        double costP90Ms = 0.0;       ///< Of the last complete window
+        std::uint64_t windows = 0;    ///< Windows completed; stats() only changes when this does
+        int upDwellWindows = kUpDwellWindows;
+        std::uint64_t stepsDown = 0;
+        std::uint64_t stepsUp = 0;
+        std::vector<Change> recent;   ///< Newest last, at most kHistory
+    };
+
+    explicit QualityGovernor(int fps = 60);
+
+    /// Off pins level 0.
+    void setEnabled(bool enabled, std::int64_t nowNs);
+    void setFps(int fps);
+
+    /**
+     * @brief Account one frame's cost
+     * @param costMs Time the frame kept the CPU or GPU busy, whichever is longer
+     * @return Whether the level changed; current() then holds the new one
+     */
+    bool addFrame(double costMs, std::int64_t nowNs);
+
+    int level() const { return m_level; }
+    std::uint64_t windows() const { return m_windows; }
+    const Level& current() const { return kLevels[static_cast<std::size_t>(m_level)]; }
+    Stats stats() const;
+
+private:
+    void change(int to, std::int64_t nowNs, std::string reason);
+
+    bool m_enabled = true;
+    int m_fps;
+    int m_level = 0;
+    std::vector<double> m_window;
+    bool m_settling = false;         // the current window straddles a change; drop it
+    int m_quietWindows = 0;          // consecutive windows under kUpLoad
+    int m_upDwellWindows = kUpDwellWindows;
+    int m_windowsSinceUp = -1;       // -1 = no step up yet
+    double m_lastP90Ms = 0.0;
+    std::uint64_t m_windows = 0;
+    std::uint64_t m_stepsDown = 0;
+    std::uint64_t m_stepsUp = 0;
+    std::deque<Change> m_recent;
+};
+
+} // namespace NeonWave::GUI
@@ -0,0 +1,222 @@
+/**
+ * @file ReadbackRing.cpp
+ * @brief Implementation of the PBO readback ring and its benchmark
+ */
+
+#include "ReadbackRing.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include "core/audio/PlaybackClock.h"
+#include "HeadlessContext.h"
+#include "OffscreenTarget.h"
+
+namespace NeonWave::GUI {
+
+namespace {
+
+using Core::Audio::PlaybackClock;
+
+constexpr GLuint64 kWaitSliceNs = 1'000'000'000;
+
+struct BenchmarkResult {
+    double fps = 0.0;
+    double readbackMs = 0.0;      // per frame, inside read() or issue() + collect()
+    std::uint64_t stalls = 0;
+};
+
+/// Stand-in for the encoder: touch every byte of the frame once.
+std::uint32_t consume(const std::vector<unsigned char>& rgba) {
+    std::uint32_t sum = 0;
+    for (std::size_t i = 0; i + 4 <= rgba.size(); i += 4) {
+        std::uint32_t word;
+        std::memcpy(&word, rgba.data() + i, 4);
+        sum += word;
+    }
+    return sum;
+}
+
+} // namespace
+
+bool ReadbackRing::allocate(const GlFunctions& gl, int width, int height, int depth) {
+    release(gl);
+    if (width <= 0 || height <= 0 || depth < 1) return false;
+    for (int i = 0; i < 16 && gl.glGetError() != GL_NO_ERROR; ++i) {
+    }
+    m_width = width;
+    m_height = height;
+    m_slots.resize(static_cast<std::size_t>(depth));
+    const auto bytes = static_cast<GLsizeiptr>(width) * height * 4;
+    for (Slot& slot : m_slots) {
+        gl.glGenBuffers(1, &slot.buffer);
+        gl.glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+        gl.glBufferData(GL_PIXEL_PACK_BUFFER, bytes, nullptr, GL_STREAM_READ);
+    }
+    gl.glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    if (gl.glGetError() != GL_NO_ERROR) {
+        release(gl);
+        return false;
+    }
+    return true;
+}
+
+void ReadbackRing::release(const GlFunctions& gl) {
+    for (Slot& slot : m_slots) {
+        if (slot.fence) gl.glDeleteSync(slot.fence);
+        if (slot.buffer) gl.glDeleteBuffers(1, &slot.buffer);
+    }
+    m_slots.clear();
+    m_head = 0;
+    m_pending = 0;
+    m_width = 0;
+    m_height = 0;
+    m_stalls = 0;
+}
+
+void ReadbackRing::issue(const GlFunctions& gl, GLuint fbo, std::uint64_t frame) {
+    if (m_slots.empty() || full()) return;
+    Slot& slot = m_slots[static_cast<std::size_t>(m_head)];
+    gl.glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+    gl.glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    gl.glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    // With a pack buffer bound the pointer is an offset into it, and the call returns without waiting
+    gl.glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    gl.glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    slot.fence = gl.glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.frame = frame;
+    // Submit now, so the copy runs while the CPU is busy elsewhere rather than when collect() asks
+    gl.glFlush();
+    m_head = (m_head + 1) % depth();
+    ++m_pending;
+}
+
+bool ReadbackRing::collect(const GlFunctions& gl, unsigned char* rgba, std::uint64_t* frame) {
+    if (m_pending == 0) return false;
+    Slot& slot = m_slots[static_cast<std::size_t>((m_head - m_pending + depth()) % depth())];
+    --m_pending;
+
+    GLenum status = gl.glClientWaitSync(slot.fence, 0, 0);
+    if (status == GL_TIMEOUT_EXPIRED) {
+        ++m_stalls;
+        do {
+            status = gl.glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, kWaitSliceNs);
+        } while (status == GL_TIMEOUT_EXPIRED);
+    }
+    gl.glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+    if (status == GL_WAIT_FAILED) return false;
+    if (frame) *frame = slot.frame;
+
+    const auto bytes = static_cast<GLsizeiptr>(m_width) * m_height * 4;
+    gl.glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    const void* mapped = gl.glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, bytes, GL_MAP_READ_BIT);
+    bool ok = mapped != nullptr;
+    if (ok) {
+        std::memcpy(rgba, mapped, static_cast<std::size_t>(bytes));
+        ok = gl.glUnmapBuffer(GL_PIXEL_PACK_BUFFER) == GL_TRUE;
+    }
+    gl.glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    return ok;
+}
+
+int ReadbackRing::runBenchmark(int depth, int frames) {
+    depth = std::clamp(depth, 1, 16);
+    frames = std::max(frames, 10);
+
+    std::string error;
+    auto context = HeadlessContext::create(HeadlessContext::Backend::Auto, &error);
+    if (!context || !context->makeCurrent()) {
+        std::cerr << "[Benchmark] No OpenGL context: " << error << std::endl;
+        return 1;
+    }
+    GlFunctions gl;
+    std::string missing;
+    HeadlessContext* ctx = context.get();
+    if (!gl.load([ctx](const char* name) { return ctx->getProcAddress(name); }, &missing)) {
+        std::cerr << "[Benchmark] Missing GL entry point " << missing << std::endl;
+        return 1;
+    }
+    std::cout << "[Benchmark] Frame readback, " << frames << " frames per run, ring depth " << depth << std::endl;
+    std::cout << "  " << context->description() << std::endl;
+    std::printf("  %-6s %-12s %9s %14s %8s\n", "size", "readback", "fps", "in readback", "stalls");
+
+    struct Size { int width; int height; const char* name; };
+    for (const Size size : { Size{ 1280, 720, "720p" }, Size{ 1920, 1080, "1080p" }, Size{ 3840, 2160, "4K" } }) {
+        OffscreenTarget source;
+        OffscreenTarget target;
+        ReadbackRing ring;
+        if (!source.allocate(gl, size.width / 2, size.height / 2) || !target.allocate(gl, size.width, size.height)
+            || !ring.allocate(gl, size.width, size.height, depth)) {
+            std::printf("  %-6s skipped: cannot allocate the targets\n", size.name);
+            source.release(gl);
+            target.release(gl);
+            ring.release(gl);
+            continue;
+        }
+        std::vector<unsigned char> rgba(static_cast<std::size_t>(size.width) * size.height * 4);
+        volatile std::uint32_t sink = 0;
+
+        // A clear and a filtered 2x upscale: enough fill work that the GPU is busy when the readback is queued
+        auto render = [&](int frame) {
+            gl.glBindFramebuffer(GL_FRAMEBUFFER, source.fbo);
+            gl.glViewport(0, 0, source.width, source.height);
+            gl.glClearColor(static_cast<float>(frame % 60) / 60.0f, 0.3f, 0.6f, 1.0f);
+            gl.glClear(GL_COLOR_BUFFER_BIT);
+            gl.glBindFramebuffer(GL_READ_FRAMEBUFFER, source.fbo);
+            gl.glBindFramebuffer(GL_DRAW_FRAMEBUFFER, target.fbo);
+            gl.glBlitFramebuffer(0, 0, source.width, source.height, 0, 0, target.width, target.height,
+                                 GL_COLOR_BUFFER_BIT, GL_LINEAR);
+        };
+
+        auto run = [&](bool useRing) {
+            BenchmarkResult result;
+            std::int64_t readbackNs = 0;
+            gl.glFinish();
+            const std::int64_t start = PlaybackClock::nowNs();
+            for (int frame = 0; frame < frames; ++frame) {
+                render(frame);
+                const std::int64_t before = PlaybackClock::nowNs();
+                bool got = true;
+                if (useRing) {
+                    ring.issue(gl, target.fbo, static_cast<std::uint64_t>(frame));
+                    got = ring.full() && ring.collect(gl, rgba.data());
+                } else {
+                    target.read(gl, rgba.data());
+                }
+                readbackNs += PlaybackClock::nowNs() - before;
+                if (got) sink = sink + consume(rgba);
+            }
+            while (ring.pending() > 0) {
+                const std::int64_t before = PlaybackClock::nowNs();
+                const bool got = ring.collect(gl, rgba.data());
+                readbackNs += PlaybackClock::nowNs() - before;
+                if (got) sink = sink + consume(rgba);
+            }
+            const double seconds = (PlaybackClock::nowNs() - start) * 1e-9;
+            result.fps = seconds > 0.0 ? frames / seconds : 0.0;
+            result.readbackMs = readbackNs * 1e-6 / frames;
+            result.stalls = ring.stalls();
+            return result;
+        };
+
+        run(false); // warm-up: first-touch allocation in the driver
+        const BenchmarkResult sync = run(false);
+        const BenchmarkResult async = run(true);
+
+        char ringName[32];
+        std::snprintf(ringName, sizeof(ringName), "PBO ring x%d", depth);
+        std::printf("  %-6s %-12s %9.1f %11.2f ms %8s\n", size.name, "glReadPixels", sync.fps, sync.readbackMs, "-");
+        std::printf("  %-6s %-12s %9.1f %11.2f ms %8llu\n", "", ringName, async.fps, async.readbackMs,
+                    static_cast<unsigned long long>(async.stalls));
+
+        source.release(gl);
+        target.release(gl);
+        ring.release(gl);
+    }
+    context->doneCurrent();
+    return 0;
+}
+
+} // namespace NeonWave::GUI
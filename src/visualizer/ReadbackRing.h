@@ -0,0 +1,90 @@
+/**
+ * @file ReadbackRing.h
+ * @brief Asynchronous framebuffer readback through a ring of pixel-buffer objects
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "GlFunctions.h"
+
+namespace NeonWave::GUI {
+
+/**
+ * @class ReadbackRing
+ * @brief Frame capture that does not stall the pipeline every frame
+ *
+ * glReadPixels into client memory waits for the GPU to finish the frame and
+ * then copies it, all inside the call. Here issue() only queues the copy
+ * into the next pixel-buffer object and drops a fence behind it; collect()
+ * maps the oldest buffer, by which time its fence has normally signalled.
+ * With a depth of N, issue frame k and then collect frame k - (N - 1):
+ *
+ * @code
+ * ring.issue(gl, fbo, k);
+ * if (ring.full()) ring.collect(gl, rgba, &frame);
+ * // ... and at the end, while (ring.pending()) ring.collect(...)
+ * @endcode
+ *
+ * Depth 1 is a synchronous readback through a PBO; 2 or 3 is normally
+ * enough to hide the copy behind the next frame's rendering. On a software
+ * rasterizer (llvmpipe, OSMesa) there is no asynchronous copy to hide and
+ * the ring only adds a memcpy; plain glReadPixels is faster there. Like
+ * OffscreenTarget, plain GL handles: the owner calls release() while the
+ * context is current.
+ */
+class ReadbackRing {
+public:
+    ReadbackRing() = default;
+    ReadbackRing(const ReadbackRing&) = delete;
+    ReadbackRing& operator=(const ReadbackRing&) = delete;
+
+    /// (Re)create @p depth buffers for @p width x @p height RGBA8; drops anything pending.
+    bool allocate(const GlFunctions& gl, int width, int height, int depth);
+    void release(const GlFunctions& gl);
+
+    int depth() const { return static_cast<int>(m_slots.size()); }
+    int pending() const { return m_pending; }
+    bool full() const { return m_pending == depth(); }
+
+    /// Queue a readback of @p fbo's colour attachment, tagged @p frame; the ring must not be full.
+    void issue(const GlFunctions& gl, GLuint fbo, std::uint64_t frame);
+    /**
+     * @brief Copy out the oldest queued frame, waiting only if its fence has not signalled yet
+     * @param rgba width * height * 4 bytes, bottom row first as GL stores it
+     * @param frame Receives the tag it was issued with
+     * @return False if nothing was pending or the buffer could not be mapped
+     */
+    bool collect(const GlFunctions& gl, unsigned char* rgba, std::uint64_t* frame = nullptr);
+
+    /// collect() calls that found their fence unsignalled and had to wait for the GPU.
+    std::uint64_t stalls() const { return m_stalls; }
+
+    /**
+     * @brief Compare synchronous glReadPixels with the ring at 720p, 1080p and 4K
+     *
+     * Invoked by `neonwave --benchmark-readback [depth] [frames]`. Creates a
+     * headless context and, per resolution, runs the same loop both ways:
+     * a fill-bound upscaling blit stands in for rendering, and a pass over
+     * every byte stands in for the encoder. Reports frames per second, the
+     * time per frame spent inside readback calls and the ring's stalls.
+     */
+    static int runBenchmark(int depth = 3, int frames = 120);
+
+private:
+    struct Slot {
+        GLuint buffer = 0;
+        GLsync fence = nullptr;
+        std::uint64_t frame = 0;
+    };
+
+    std::vector<Slot> m_slots;
+    int m_head = 0;      // slot the next issue() fills
+    int m_pending = 0;   // issued but not collected, oldest at m_head - m_pending
+    int m_width = 0;
+    int m_height = 0;
+    std::uint64_t m_stalls = 0;
+};
+
+} // namespace NeonWave::GUI
@@ -0,0 +1,512 @@
+/**
+ * @file RenderCore.cpp
+ * @brief Implementation of the window-independent projectM render core
+ */
+
+#include "RenderCore.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include "core/Config.h"
+
+// ProjectM headers
+#include <projectM-4/projectM.h>
+#include <projectM-4/playlist.h>
+#include <projectM-4/parameters.h>
+#include <projectM-4/render_opengl.h>
+
+namespace NeonWave::GUI {
+
+namespace {
+
+std::string resolveTextureDirectory(const std::string& configured) {
+    if (!configured.empty()) return configured;
+    std::string path = "/usr/share/projectM/textures";
+#ifdef PROJECTM_DEFAULT_TEXTURES_DIR
+    if (!std::filesystem::exists(path)) path = PROJECTM_DEFAULT_TEXTURES_DIR;
+#else
+    if (!std::filesystem::exists(path)) path = "./external/projectm/textures";
+#endif
+    return path;
+}
+
+std::string resolvePresetDirectory(const std::string& configured) {
+    if (!configured.empty()) return configured;
+    std::string path = "/usr/share/projectM/presets";
+#ifdef PROJECTM_DEFAULT_PRESETS_DIR
+    if (!std::filesystem::exists(path)) path = PROJECTM_DEFAULT_PRESETS_DIR;
+#else
+    if (!std::filesystem::exists(path)) path = "./external/projectm/presets";
+#endif
+    return path;
+}
+
+std::vector<std::string> scanPresets(const std::string& directory) {
+    std::vector<std::string> presets;
+    if (!std::filesystem::exists(directory)) return presets;
+    try {
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(directory)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".milk") {
+                presets.emplace_back(entry.path().string());
+            }
+        }
+    } catch (const std::filesystem::filesystem_error& e) {
+        std::cerr << "[RenderCore] Filesystem error while scanning presets: " << e.what() << std::endl;
+    }
+    return presets;
+}
+
+} // namespace
+
+RenderCore::Settings RenderCore::settingsFromConfig(const Core::VisualizerConfig& config) {
+    Settings settings;
+    settings.fps = config.fps;
+    settings.meshX = config.meshX;
+    settings.meshY = config.meshY;
+    settings.aspectCorrection = config.aspectCorrection;
+    settings.beatSensitivity = config.beatSensitivity;
+    settings.hardCutEnabled = config.hardCutEnabled;
+    settings.hardCutDuration = config.hardCutDuration;
+    settings.softCutDuration = config.softCutDuration;
+    settings.presetDuration = config.presetDuration;
+    settings.presetLocked = config.presetLocked;
+    settings.presetDirectory = config.presetDirectory;
+    settings.textureDirectory = config.textureDirectory;
+    settings.randomPresetOnStartup = config.loadRandomPresetOnStartup;
+    settings.vsync = false;
+    settings.adaptiveQuality = config.adaptiveQuality;
+    settings.injectTestSignal = config.debugInjectTestSignal;
+    return settings;
+}
+
+RenderCore::RenderCore() = default;
+
+RenderCore::~RenderCore() = default;
+
+bool RenderCore::initialize(const GlFunctions::Resolver& resolve, const Settings& settings, int width, int height) {
+    std::string missing;
+    if (!m_gl.load(resolve, &missing)) {
+        std::cerr << "[RenderCore] OpenGL entry point " << missing << " not available" << std::endl;
+        return false;
+    }
+    m_gl.glEnable(GL_DEPTH_TEST);
+    m_gl.glEnable(GL_BLEND);
+    m_gl.glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLint maxSamples = 0;
+    m_gl.glGetIntegerv(GL_MAX_SAMPLES, &maxSamples);
+    m_samples = std::min(kSamples, static_cast<int>(maxSamples));
+    m_outputWidth = m_width = std::max(1, width);
+    m_outputHeight = m_height = std::max(1, height);
+    m_settings = settings;
+    const auto* version = reinterpret_cast<const char*>(m_gl.glGetString(GL_VERSION));
+    if (version && std::strncmp(version, "OpenGL ES", 9) != 0) {
+        // Desktop GL 3.3 has GL_TIME_ELAPSED; without it the governor goes by CPU time alone
+        m_gl.glGenQueries(static_cast<GLsizei>(m_gpuQueries.size()), m_gpuQueries.data());
+    }
+
+    std::cout << "[RenderCore] Initializing ProjectM (" << m_width << "x" << m_height << ", "
+              << m_samples << "x MSAA)" << std::endl;
+    m_projectM = projectm_create();
+    if (!m_projectM) {
+        std::cerr << "[RenderCore] Failed to create ProjectM instance!" << std::endl;
+        return false;
+    }
+    projectm_set_window_size(m_projectM, static_cast<size_t>(m_width), static_cast<size_t>(m_height));
+    // Allocated here so a flush on the render thread only hands it over
+    m_silence.assign(static_cast<std::size_t>(projectm_pcm_get_max_samples()) * 2, 0.0f);
+    applySettings(settings);
+    rebuildPlaylist();
+
+    if (settings.randomPresetOnStartup && m_playlist && projectm_playlist_size(m_playlist) > 0) {
+        randomPreset();
+    } else {
+        // Load default idle preset for initial visualization when no audio is playing
+        projectm_load_preset_file(m_projectM, "idle://", true);
+        if (m_presetChanged) m_presetChanged("Idle");
+    }
+    return true;
+}
+
+void RenderCore::shutdown() {
+    if (m_playlist) {
+        projectm_playlist_destroy(m_playlist);
+        m_playlist = nullptr;
+    }
+    if (m_projectM) {
+        projectm_destroy(m_projectM);
+        m_projectM = nullptr;
+    }
+    if (!m_gl.glDeleteFramebuffers) return;
+    if (m_msaaFbo) {
+        m_gl.glDeleteFramebuffers(1, &m_msaaFbo);
+        m_gl.glDeleteRenderbuffers(1, &m_msaaColor);
+        m_gl.glDeleteRenderbuffers(1, &m_msaaDepth);
+        m_msaaFbo = m_msaaColor = m_msaaDepth = 0;
+        m_msaaWidth = m_msaaHeight = 0;
+    }
+    if (m_gpuQueries[0]) {
+        m_gl.glDeleteQueries(static_cast<GLsizei>(m_gpuQueries.size()), m_gpuQueries.data());
+        m_gpuQueries = {};
+        m_gpuQueryPending = {};
+    }
+}
+
+void RenderCore::resize(int width, int height) {
+    m_outputWidth = std::max(1, width);
+    m_outputHeight = std::max(1, height);
+    applyQuality();
+}
+
+void RenderCore::applyQuality() {
+    const auto& level = m_governor.current();
+    m_width = std::max(16, static_cast<int>(std::lround(m_outputWidth * level.resolutionScale)));
+    m_height = std::max(16, static_cast<int>(std::lround(m_outputHeight * level.resolutionScale)));
+    const int meshX = std::max(8, static_cast<int>(std::lround(m_settings.meshX * level.meshScale)));
+    const int meshY = std::max(8, static_cast<int>(std::lround(m_settings.meshY * level.meshScale)));
+    {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        m_quality.renderWidth = m_width;
+        m_quality.renderHeight = m_height;
+        m_quality.meshX = meshX;
+        m_quality.meshY = meshY;
+        m_quality.governor = m_governor.stats();
+    }
+    if (!m_projectM) return;
+    projectm_set_window_size(m_projectM, static_cast<size_t>(m_width), static_cast<size_t>(m_height));
+    projectm_set_mesh_size(m_projectM, static_cast<size_t>(meshX), static_cast<size_t>(meshY));
+}
+
+void RenderCore::applySettings(const Settings& settings) {
+    const bool directoriesChanged = settings.presetDirectory != m_settings.presetDirectory
+        || settings.textureDirectory != m_settings.textureDirectory;
+    m_settings = settings;
+    m_governor.setFps(settings.fps);
+    m_governor.setEnabled(settings.adaptiveQuality, Core::Audio::PlaybackClock::nowNs());
+    if (!m_projectM) return;
+    projectm_set_fps(m_projectM, settings.fps);
+    applyQuality(); // the configured mesh, scaled by the quality level
+    projectm_set_aspect_correction(m_projectM, settings.aspectCorrection);
+    projectm_set_beat_sensitivity(m_projectM, settings.beatSensitivity);
+    projectm_set_hard_cut_enabled(m_projectM, settings.hardCutEnabled);
+    projectm_set_hard_cut_duration(m_projectM, settings.hardCutDuration);
+    projectm_set_soft_cut_duration(m_projectM, settings.softCutDuration);
+    projectm_set_preset_duration(m_projectM, settings.presetDuration);
+    projectm_set_preset_locked(m_projectM, settings.presetLocked);
+    if (directoriesChanged) rebuildPlaylist();
+}
+
+void RenderCore::setPresetAndTextureDirs(const std::string& presetDir, const std::string& textureDir) {
+    m_settings.presetDirectory = presetDir;
+    m_settings.textureDirectory = textureDir;
+    if (m_projectM) rebuildPlaylist();
+}
+
+void RenderCore::rebuildPlaylist() {
+    const std::string texturePath = resolveTextureDirectory(m_settings.textureDirectory);
+    std::cout << "[RenderCore] Setting texture search path to: " << texturePath << std::endl;
+    const char* texturePaths[] = { texturePath.c_str() };
+    projectm_set_texture_search_paths(m_projectM, texturePaths, 1);
+
+    if (m_playlist) {
+        projectm_playlist_destroy(m_playlist);
+        m_playlist = nullptr;
+    }
+    const std::string presetPath = resolvePresetDirectory(m_settings.presetDirectory);
+    std::cout << "[RenderCore] Searching for presets in: " << presetPath << std::endl;
+    const std::vector<std::string> presets = scanPresets(presetPath);
+    std::cout << "[RenderCore] Found " << presets.size() << " presets" << std::endl;
+    if (presets.empty()) {
+        // keep the idle preset
+        projectm_set_preset_locked(m_projectM, true);
+        return;
+    }
+    m_playlist = projectm_playlist_create(m_projectM);
+    if (!m_playlist) return;
+    for (const auto& path : presets) {
+        projectm_playlist_add_preset(m_playlist, path.c_str(), true);
+    }
+    projectm_playlist_set_preset_switched_event_callback(m_playlist, presetSwitchedCallback, this);
+    projectm_playlist_set_position(m_playlist, 0, false);
+    projectm_set_preset_locked(m_projectM, m_settings.presetLocked);
+}
+
+void RenderCore::setPresetLocked(bool locked) {
+    m_settings.presetLocked = locked;
+    if (m_projectM) projectm_set_preset_locked(m_projectM, locked);
+}
+
+void RenderCore::loadPreset(const std::string& presetPath) {
+    if (!m_projectM) return;
+    projectm_load_preset_file(m_projectM, presetPath.c_str(), true);
+    presetChanged(presetPath);
+}
+
+void RenderCore::nextPreset() {
+    if (m_playlist) projectm_playlist_play_next(m_playlist, true);
+}
+
+void RenderCore::previousPreset() {
+    if (m_playlist) projectm_playlist_play_previous(m_playlist, true);
+}
+
+void RenderCore::randomPreset() {
+    if (!m_playlist) return;
+    const size_t count = projectm_playlist_size(m_playlist);
+    if (count > 0) {
+        projectm_playlist_set_position(m_playlist, static_cast<unsigned int>(rand() % count), true);
+    }
+}
+
+void RenderCore::setPresetChangedCallback(std::function<void(const std::string&)> callback) {
+    m_presetChanged = std::move(callback);
+}
+
+void RenderCore::presetSwitchedCallback(bool /*isHardCut*/, unsigned int index, void* context) {
+    // Runs on the render thread, inside a playlist call or projectM's frame
+    if (context) static_cast<RenderCore*>(context)->onPresetSwitched(index);
+}
+
+void RenderCore::onPresetSwitched(unsigned int index) {
+    if (!m_playlist) return;
+    char* namePtr = projectm_playlist_item(m_playlist, index);
+    if (!namePtr) return;
+    // projectM returns a pointer to its internal string. We must copy it.
+    const std::string presetPath = namePtr;
+    projectm_playlist_free_string(namePtr);
+    presetChanged(presetPath);
+}
+
+void RenderCore::presetChanged(const std::string& presetPath) {
+    if (m_presetChanged) m_presetChanged(std::filesystem::path(presetPath).stem().string());
+}
+
+void RenderCore::setAudioBus(const std::shared_ptr<Core::Audio::AudioBlockBus>& bus) {
+    m_audioFeed = bus ? bus->subscribe("visualizer") : nullptr;
+    m_pcmDelay.clear();
+}
+
+void RenderCore::setPlaybackClock(const std::shared_ptr<const Core::Audio::PlaybackClock>& clock) {
+    m_playbackClock = clock;
+    // Flushes are numbered on the new clock's own stream axis
+    m_flushedFrame = clock ? clock->sample().flushedFrame : 0;
+}
+
+void RenderCore::setAudioSyncOffset(int milliseconds) {
+    m_syncOffsetMs = milliseconds;
+}
+
+void RenderCore::setAnalysisSampleRate(int sampleRate) {
+    m_analysisRate = std::max(0, sampleRate);
+}
+
+void RenderCore::addPcm(const float* interleaved, std::size_t frames) {
+    m_visualPcm.insert(m_visualPcm.end(), interleaved, interleaved + frames * 2);
+}
+
+void RenderCore::setFrameTime(double seconds) {
+    if (m_projectM) projectm_set_frame_time(m_projectM, seconds);
+}
+
+RenderCore::AudioSyncStats RenderCore::audioSyncStats() const {
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    return m_syncStats;
+}
+
+RenderCore::QualityStats RenderCore::qualityStats() const {
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    return m_quality;
+}
+
+void RenderCore::allocateMultisample() {
+    if (!m_msaaFbo) {
+        m_gl.glGenFramebuffers(1, &m_msaaFbo);
+        m_gl.glGenRenderbuffers(1, &m_msaaColor);
+        m_gl.glGenRenderbuffers(1, &m_msaaDepth);
+    }
+    const int samples = std::max(m_samples, 0);
+    m_gl.glBindRenderbuffer(GL_RENDERBUFFER, m_msaaColor);
+    m_gl.glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, GL_RGBA8, m_width, m_height);
+    m_gl.glBindRenderbuffer(GL_RENDERBUFFER, m_msaaDepth);
+    m_gl.glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, GL_DEPTH24_STENCIL8, m_width, m_height);
+    m_gl.glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    m_gl.glBindFramebuffer(GL_FRAMEBUFFER, m_msaaFbo);
+    m_gl.glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_msaaColor);
+    m_gl.glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_msaaDepth);
+    m_msaaWidth = m_width;
+    m_msaaHeight = m_height;
+}
+
+double RenderCore::collectGpuTime() {
+    const GLuint query = m_gpuQueries[m_gpuQuery];
+    if (!query || !m_gpuQueryPending[m_gpuQuery]) return m_lastGpuMs;
+    // Issued three frames ago; if the GPU still has not finished it, keep the last reading rather than stall
+    GLuint available = 0;
+    m_gl.glGetQueryObjectuiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available) {
+        GLuint elapsedNs = 0;
+        m_gl.glGetQueryObjectuiv(query, GL_QUERY_RESULT, &elapsedNs);
+        m_lastGpuMs = elapsedNs * 1e-6;
+    }
+    m_gpuQueryPending[m_gpuQuery] = false;
+    return m_lastGpuMs;
+}
+
+RenderCore::FrameCost RenderCore::renderFrame(GLuint fbo) {
+    FrameCost cost;
+    if (!m_projectM) return cost;
+    const std::int64_t startNs = Core::Audio::PlaybackClock::nowNs();
+    if (m_samples > 0 && (m_msaaWidth != m_width || m_msaaHeight != m_height)) allocateMultisample();
+    cost.gpuMs = collectGpuTime();
+    const GLuint query = m_gpuQueries[m_gpuQuery];
+    bool timing = false;
+
+    try {
+        drainPcm();
+        if (m_settings.injectTestSignal) {
+            constexpr size_t frames = 512;
+            float buffer[frames * 2];
+            const float freq = 220.0f;
+            const float sampleRate = 48000.0f;
+            for (size_t i = 0; i < frames; ++i) {
+                float s = 0.1f * sinf(2.0f * 3.14159265f * freq * (m_testPhase / sampleRate));
+                buffer[2 * i] = s;
+                buffer[2 * i + 1] = s;
+                m_testPhase += 1.0f;
+            }
+            projectm_pcm_add_float(m_projectM, buffer, frames, PROJECTM_STEREO);
+        }
+
+        if (m_flushPending) {
+            // Overwrite projectM's history so presets stop reacting to audio that was never heard
+            m_flushPending = false;
+            projectm_pcm_add_float(m_projectM, m_silence.data(), static_cast<unsigned int>(m_silence.size() / 2),
+                                   PROJECTM_STEREO);
+        }
+        if (!m_visualPcm.empty()) {
+            projectm_pcm_add_float(m_projectM, m_visualPcm.data(),
+                                   static_cast<unsigned int>(m_visualPcm.size() / 2), PROJECTM_STEREO);
+            m_visualPcm.clear();
+        }
+
+        if (query) {
+            m_gl.glBeginQuery(GL_TIME_ELAPSED, query);
+            timing = true;
+        }
+        const GLuint target = m_msaaFbo ? m_msaaFbo : fbo;
+        m_gl.glBindFramebuffer(GL_FRAMEBUFFER, target);
+        m_gl.glViewport(0, 0, m_width, m_height);
+        m_gl.glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        m_gl.glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+        projectm_opengl_render_frame_fbo(m_projectM, target);
+        if (m_msaaFbo) {
+            m_gl.glBindFramebuffer(GL_READ_FRAMEBUFFER, m_msaaFbo);
+            m_gl.glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo);
+            m_gl.glBlitFramebuffer(0, 0, m_width, m_height, 0, 0, m_width, m_height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "[RenderCore] Render error: " << e.what() << std::endl;
+    }
+    if (timing) {
+        m_gl.glEndQuery(GL_TIME_ELAPSED);
+        m_gpuQueryPending[m_gpuQuery] = true;
+        m_gpuQuery = (m_gpuQuery + 1) % m_gpuQueries.size();
+    }
+
+    const std::int64_t endNs = Core::Audio::PlaybackClock::nowNs();
+    cost.cpuMs = (endNs - startNs) * 1e-6;
+    // A frame costs whichever of the CPU and the GPU it kept busy longer
+    const std::uint64_t windows = m_governor.windows();
+    if (m_governor.addFrame(std::max(cost.cpuMs, cost.gpuMs), endNs)) {
+        applyQuality();
+    } else if (m_governor.windows() != windows) {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        m_quality.governor = m_governor.stats();
+    }
+    return cost;
+}
+
+void RenderCore::release(const Core::Audio::AudioBlock& block) {
+    const int inRate = static_cast<int>(block.sampleRate);
+    if (inRate <= 0) return;
+    const int outRate = m_analysisRate > 0 ? m_analysisRate : inRate;
+    if (inRate != m_resampler.inputRate() || outRate != m_resampler.outputRate()) {
+        m_resampler.configure(inRate, outRate);
+    }
+    const std::size_t offset = m_visualPcm.size();
+    m_visualPcm.resize(offset + m_resampler.maxOutputFrames(block.frames) * 2);
+    const std::size_t written = m_resampler.process(block.samples, block.frames, m_visualPcm.data() + offset);
+    m_visualPcm.resize(offset + written * 2);
+}
+
+void RenderCore::drainPcm() {
+    auto* feed = m_audioFeed.get();
+    if (!feed) return;
+
+    // Bound the delay line well inside the bus pool so a stalled clock can't starve other subscribers
+    constexpr std::size_t kMaxHeldBlocks = 128;
+    auto& delay = m_pcmDelay;
+
+    const auto* clock = m_playbackClock.get();
+    const auto sample = clock ? clock->sample() : Core::Audio::PlaybackClock::Sample{};
+    if (sample.flushedFrame > m_flushedFrame) {
+        // A seek or skip cut the sink off: what it had not played yet is never heard, so never shown
+        m_flushedFrame = sample.flushedFrame;
+        while (!delay.empty() && delay.front()->streamFrame < sample.flushedFrame) delay.pop_front();
+        m_visualPcm.clear();
+        m_resampler.reset();
+        m_flushPending = true;
+    }
+
+    Core::Audio::AudioBlockRef block;
+    while (feed->pop(block)) {
+        if (block->streamFrame < m_flushedFrame) continue;
+        delay.push_back(std::move(block));
+    }
+
+    AudioSyncStats stats;
+    stats.offsetMs = m_syncOffsetMs;
+    stats.analysisRate = m_resampler.outputRate();
+    stats.resampleNsPerFrame = m_resampler.nsPerOutputFrame();
+    if (sample.sampleRate == 0) {
+        // No sink timing yet: nothing to line up with
+        for (const auto& b : delay) {
+            release(*b);
+        }
+        delay.clear();
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        m_syncStats = stats;
+        return;
+    }
+
+    const auto audible = static_cast<std::int64_t>(clock->audibleFrame());
+    const std::int64_t target = audible - static_cast<std::int64_t>(m_syncOffsetMs) * sample.sampleRate / 1000;
+    std::uint64_t releasedEnd = 0;
+    while (!delay.empty()) {
+        const auto& front = delay.front();
+        if (static_cast<std::int64_t>(front->streamFrame) > target && delay.size() <= kMaxHeldBlocks) break;
+        release(*front);
+        releasedEnd = front->streamFrame + front->frames;
+        delay.pop_front();
+    }
+
+    std::uint64_t heldFrames = 0;
+    for (const auto& b : delay) heldFrames += b->frames;
+    stats.outputLatencyMs = (sample.writtenFrame - std::min<std::uint64_t>(audible, sample.writtenFrame)) * 1000.0 / sample.sampleRate;
+    stats.heldMs = heldFrames * 1000.0 / sample.sampleRate;
+    stats.heldBlocks = delay.size();
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    if (releasedEnd > 0) {
+        // The clock says when frame sample.frame was heard; older frames were heard correspondingly earlier
+        const double heardNs = sample.stampNs
+            - (static_cast<double>(sample.frame) - static_cast<double>(releasedEnd)) * 1e9 / sample.sampleRate;
+        stats.renderLagMs = (Core::Audio::PlaybackClock::nowNs() - heardNs) * 1e-6;
+    } else {
+        stats.renderLagMs = m_syncStats.renderLagMs;
+    }
+    m_syncStats = stats;
+}
+
+} // namespace NeonWave::GUI
@@ -0,0 +1,227 @@
+/**
+ * @file RenderCore.h
+ * @brief projectM, its playlist and audio feed, independent of Qt and of any window
+ */
+
+#pragma once
+
+#include "GlFunctions.h"
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "core/audio/AudioBlockBus.h"
+#include "core/audio/PlaybackClock.h"
+#include "core/audio/PolyphaseResampler.h"
+#include "QualityGovernor.h"
+
+struct projectm;
+struct projectm_playlist;
+
+namespace NeonWave::Core {
+struct VisualizerConfig;
+}
+
+namespace NeonWave::GUI {
+
+/**
+ * @class RenderCore
+ * @brief Everything that turns PCM into projectM frames, given a current GL context
+ *
+ * The core owns the projectM instance, the preset playlist, the PCM delay
+ * line and resampler, the multisampled render target and the quality
+ * governor. It draws one frame at a time into a framebuffer the caller
+ * owns, so the same code runs behind the Qt widget (ProjectMRenderer, in
+ * a QOpenGLContext shared with the window) and in headless mode (a
+ * HeadlessContext on EGL or OSMesa, no display). GL is reached only
+ * through GlFunctions, resolved from whichever context that is.
+ *
+ * Every method except audioSyncStats() and qualityStats() must be called
+ * on the thread where the context is current.
+ */
+class RenderCore {
+public:
+    static constexpr int kSamples = 4;
+
+    struct Settings {
+        int fps = 60;
+        int meshX = 32;
+        int meshY = 24;
+        bool aspectCorrection = true;
+        float beatSensitivity = 1.0f;
+        bool hardCutEnabled = true;
+        double hardCutDuration = 3.0;
+        double softCutDuration = 10.0;
+        double presetDuration = 30.0;
+        bool presetLocked = false;
+        std::string presetDirectory;   ///< Empty = the system projectM presets
+        std::string textureDirectory;  ///< Empty = the system projectM textures
+        bool randomPresetOnStartup = false;
+        bool vsync = true;             ///< Phase-lock frame starts to presentation (windowed only)
+        bool adaptiveQuality = true;   ///< Let the QualityGovernor scale mesh and render resolution
+        bool injectTestSignal = false; ///< Add a quiet 220 Hz tone every frame, to check the render path
+    };
+
+    /// Calibration readout for the audio/visual delay line.
+    struct AudioSyncStats {
+        double outputLatencyMs = 0.0; ///< Written to the sink but not yet heard, per processedUSecs()
+        double heldMs = 0.0;          ///< PCM currently waiting in the delay line
+        int offsetMs = 0;             ///< Manual offset from the config
+        std::size_t heldBlocks = 0;
+        int analysisRate = 0;         ///< Rate projectM is fed at
+        double resampleNsPerFrame = 0.0;
+        double renderLagMs = 0.0;     ///< Newest PCM handed to projectM: time since it was heard (or captured)
+    };
+
+    /// What the governor chose and what it is rendering with.
+    struct QualityStats {
+        int renderWidth = 0;          ///< Before the compositor scales it to the output size
+        int renderHeight = 0;
+        int meshX = 0;
+        int meshY = 0;
+        QualityGovernor::Stats governor;
+    };
+
+    /// How long one renderFrame() kept each side busy.
+    struct FrameCost {
+        double cpuMs = 0.0;
+        double gpuMs = 0.0;           ///< From a timer query a few frames old; 0 without timer queries
+    };
+
+    /// The visualizer config as render settings; vsync is left off, as nothing is presented without a window.
+    static Settings settingsFromConfig(const Core::VisualizerConfig& config);
+
+    RenderCore();
+    ~RenderCore();
+
+    RenderCore(const RenderCore&) = delete;
+    RenderCore& operator=(const RenderCore&) = delete;
+
+    /**
+     * @brief Create projectM in the current context
+     * @param resolve getProcAddress of that context
+     * @param width,height Output size in pixels
+     */
+    bool initialize(const GlFunctions::Resolver& resolve, const Settings& settings, int width, int height);
+    /// Release projectM and every GL object; the context must still be current.
+    void shutdown();
+    bool isInitialized() const { return m_projectM != nullptr; }
+    /// The entry points resolved by initialize(), for the caller's own GL work.
+    const GlFunctions& gl() const { return m_gl; }
+
+    /// Output size; frames are rendered at this times the quality level's resolution scale.
+    void resize(int width, int height);
+    int renderWidth() const { return m_width; }
+    int renderHeight() const { return m_height; }
+
+    void applySettings(const Settings& settings);
+    const Settings& settings() const { return m_settings; }
+    void setPresetAndTextureDirs(const std::string& presetDir, const std::string& textureDir);
+    void setPresetLocked(bool locked);
+    void loadPreset(const std::string& presetPath);
+    void nextPreset();
+    void previousPreset();
+    void randomPreset();
+    /// Called on the render thread with the new preset's name, from inside a preset call or renderFrame().
+    void setPresetChangedCallback(std::function<void(const std::string&)> callback);
+
+    void setAudioBus(const std::shared_ptr<Core::Audio::AudioBlockBus>& bus);
+    void setPlaybackClock(const std::shared_ptr<const Core::Audio::PlaybackClock>& clock);
+    void setAudioSyncOffset(int milliseconds);
+    void setAnalysisSampleRate(int sampleRate);
+    /// Hand interleaved stereo straight to projectM with the next frame, bypassing the bus and delay line.
+    void addPcm(const float* interleaved, std::size_t frames);
+    /**
+     * @brief Set projectM's time for the next frame instead of letting it read the wall clock
+     * @param seconds Since the first frame; negative returns to the wall clock
+     *
+     * Offline rendering passes frame / fps, so preset motion, transitions and
+     * preset durations depend on the frame index alone, not on render speed.
+     */
+    void setFrameTime(double seconds);
+
+    /**
+     * @brief Feed the PCM due by now and draw one frame
+     * @param fbo Caller's framebuffer, renderWidth() x renderHeight(), colour attachment 0
+     *
+     * Renders into the multisampled target and resolves into @p fbo, then
+     * lets the quality governor see the cost; if it changes level, the
+     * next frame has a new renderWidth()/renderHeight().
+     */
+    FrameCost renderFrame(GLuint fbo);
+
+    // ---- any thread ----------------------------------------------------
+
+    AudioSyncStats audioSyncStats() const;
+    QualityStats qualityStats() const;
+
+private:
+    static void presetSwitchedCallback(bool isHardCut, unsigned int index, void* context);
+    void onPresetSwitched(unsigned int index);
+    void presetChanged(const std::string& presetPath);
+
+    void rebuildPlaylist();
+    void allocateMultisample();
+    /// Apply the governor's level: render size and mesh.
+    void applyQuality();
+    /// GPU time of the oldest frame whose timer query has completed; the last reading otherwise.
+    double collectGpuTime();
+
+    /**
+     * @brief Collect every PCM block that is audible by now for ProjectM
+     *
+     * Blocks wait in a delay line until the playback clock, shifted by the
+     * sync offset, reaches them, then are resampled to the analysis rate
+     * into m_visualPcm, which renderFrame() feeds to projectM in one call.
+     */
+    void drainPcm();
+    /// Append a released block to m_visualPcm, resampled to the analysis rate.
+    void release(const Core::Audio::AudioBlock& block);
+
+    GlFunctions m_gl;
+    projectm* m_projectM = nullptr;
+    projectm_playlist* m_playlist = nullptr;
+    Settings m_settings;
+    std::function<void(const std::string&)> m_presetChanged;
+    QualityGovernor m_governor;
+    int m_outputWidth = 0;
+    int m_outputHeight = 0;
+    int m_width = 0;                  // render size, after the quality level's scale
+    int m_height = 0;
+
+    // Multisampled target, resolved into the caller's framebuffer
+    GLuint m_msaaFbo = 0;             // 0 = render straight into the caller's framebuffer
+    GLuint m_msaaColor = 0;
+    GLuint m_msaaDepth = 0;
+    int m_msaaWidth = 0;
+    int m_msaaHeight = 0;
+    int m_samples = 0;
+    std::array<GLuint, 3> m_gpuQueries{};       // GL_TIME_ELAPSED ring; 0 = unsupported
+    std::array<bool, 3> m_gpuQueryPending{};
+    std::size_t m_gpuQuery = 0;
+    double m_lastGpuMs = 0.0;
+
+    // Audio
+    std::shared_ptr<Core::Audio::AudioBlockBus::Subscription> m_audioFeed;
+    std::shared_ptr<const Core::Audio::PlaybackClock> m_playbackClock;
+    std::deque<Core::Audio::AudioBlockRef> m_pcmDelay;
+    int m_syncOffsetMs = 0;
+    int m_analysisRate = 0;                      // 0 = feed projectM at the stream rate
+    Core::Audio::PolyphaseResampler m_resampler;
+    std::vector<float> m_visualPcm;              // released PCM at the analysis rate, fed once per frame
+    std::vector<float> m_silence;                // projectM's full sample history of zeros, sized at initialize()
+    std::uint64_t m_flushedFrame = 0;            // last PlaybackClock flush acted on
+    bool m_flushPending = false;                 // projectM's own sample history still holds stale audio
+    float m_testPhase = 0.0f;
+
+    // Published to other threads under m_statsMutex
+    mutable std::mutex m_statsMutex;
+    AudioSyncStats m_syncStats;
+    QualityStats m_quality;
+};
+
+} // namespace NeonWave::GUI
@@ -0,0 +1,388 @@
+/**
+ * @file RenderFarm.cpp
+ * @brief Implementation of the multi-process segment render
+ */
+
+#include "RenderFarm.h"
+#include <fcntl.h>
+#include <poll.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <utility>
+#include "core/audio/PlaybackClock.h"
+#include "HeadlessContext.h"
+#include "OfflineRenderer.h"
+#include "VideoEncoder.h"
+
+namespace NeonWave::GUI {
+
+extern "C" char** environ;
+
+namespace {
+
+using Core::Audio::PlaybackClock;
+
+std::atomic<bool> g_cancel{false};
+
+void onSignal(int) {
+    g_cancel.store(true, std::memory_order_relaxed);
+}
+
+struct Worker {
+    std::uint64_t firstFrame = 0;
+    std::uint64_t frames = 0;
+    std::uint64_t prerollFrames = 0;
+    std::string segment;
+    pid_t pid = -1;               // until reaped
+    int output = -1;              // read end of its stdout, until EOF
+    std::string pendingOutput;    // stdout not yet split into lines
+    std::uint64_t done = 0;       // frames encoded, from its status lines
+    bool reported = false;        // printed a final status saying it succeeded
+    bool exitedCleanly = false;
+    std::int64_t startNs = 0;
+    std::int64_t endNs = 0;
+
+    bool running() const { return pid > 0 || output >= 0; }
+    bool failed() const { return !reported || !exitedCleanly; }
+
+    double seconds() const { return (endNs - startNs) * 1e-9; }
+};
+
+/// A file that is deleted when this goes out of scope, however the scope is left.
+class TemporaryFile {
+public:
+    explicit TemporaryFile(std::string path) : m_path(std::move(path)) {}
+    ~TemporaryFile() { remove(); }
+    TemporaryFile(const TemporaryFile&) = delete;
+    TemporaryFile& operator=(const TemporaryFile&) = delete;
+
+    const std::string& path() const { return m_path; }
+    /// Delete it now rather than at the end of the scope.
+    void remove() {
+        if (!m_path.empty()) std::remove(m_path.c_str());
+        m_path.clear();
+    }
+
+private:
+    std::string m_path;
+};
+
+const char* backendArgument(HeadlessContext::Backend backend) {
+    switch (backend) {
+    case HeadlessContext::Backend::Auto: return "auto";
+    case HeadlessContext::Backend::EglSurfaceless: return "egl";
+    case HeadlessContext::Backend::EglPbuffer: return "pbuffer";
+    case HeadlessContext::Backend::OSMesa: return "osmesa";
+    }
+    return "auto";
+}
+
+/// "out.mp4" -> "out.part3.mp4": same container, so the same encoder writes it.
+std::string segmentPath(const std::string& output, std::size_t index) {
+    const std::string part = ".part" + std::to_string(index);
+    const auto slash = output.find_last_of('/');
+    const auto dot = output.find_last_of('.');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) return output + part;
+    return output.substr(0, dot) + part + output.substr(dot);
+}
+
+/// Take in what the worker has printed and pick out its status lines; its report for people is dropped.
+void readOutput(Worker& worker) {
+    char buffer[4096];
+    const ssize_t n = ::read(worker.output, buffer, sizeof(buffer));
+    if (n < 0 && (errno == EINTR || errno == EAGAIN)) return;
+    if (n <= 0) {
+        ::close(worker.output);
+        worker.output = -1;
+        worker.pendingOutput += '\n'; // an unterminated last line still counts
+    } else {
+        worker.pendingOutput.append(buffer, static_cast<std::size_t>(n));
+    }
+    std::size_t start = 0;
+    for (;;) {
+        const std::size_t end = worker.pendingOutput.find('\n', start);
+        if (end == std::string::npos) break;
+        const std::string line = worker.pendingOutput.substr(start, end - start);
+        RenderStatus status;
+        if (parseRenderStatus(line, status)) {
+            worker.done = status.done;
+            if (status.final) worker.reported = status.ok && status.done == worker.frames;
+        }
+        start = end + 1;
+    }
+    worker.pendingOutput.erase(0, start);
+}
+
+/**
+ * Start this executable on @p arguments with its stdout on a pipe we read;
+ * stderr is shared so worker errors reach the user as they happen.
+ */
+bool spawnWorker(Worker& worker, const std::vector<std::string>& arguments, char* const* environment) {
+    int pipeFds[2];
+    if (::pipe2(pipeFds, O_CLOEXEC) != 0) return false;
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, pipeFds[1], STDOUT_FILENO); // dup2 clears close-on-exec
+    std::vector<char*> argv;
+    for (const std::string& argument : arguments) argv.push_back(const_cast<char*>(argument.c_str()));
+    argv.push_back(nullptr);
+    const int rc = posix_spawn(&worker.pid, "/proc/self/exe", &actions, nullptr, argv.data(), environment);
+    posix_spawn_file_actions_destroy(&actions);
+    ::close(pipeFds[1]);
+    if (rc != 0) {
+        ::close(pipeFds[0]);
+        worker.pid = -1;
+        errno = rc;
+        return false;
+    }
+    worker.output = pipeFds[0];
+    return true;
+}
+
+/// Collect any worker that has exited, without waiting.
+void reapWorkers(std::vector<Worker>& workers) {
+    for (Worker& worker : workers) {
+        if (worker.pid <= 0) continue;
+        int status = 0;
+        const pid_t pid = ::waitpid(worker.pid, &status, WNOHANG);
+        if (pid == 0 || (pid < 0 && errno == EINTR)) continue;
+        worker.exitedCleanly = pid == worker.pid && WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS;
+        worker.pid = -1;
+        worker.endNs = PlaybackClock::nowNs();
+    }
+}
+
+void printUsage() {
+    std::cerr << "usage: neonwave --render-farm [--workers N] [--preroll SECONDS] [--keep-segments]\n"
+                 "                              [render options, see --render] AUDIO OUTPUT" << std::endl;
+}
+
+} // namespace
+
+int runRenderFarm(const std::vector<std::string>& args) {
+    int workerCount = 0;
+    double prerollSeconds = 5.0;
+    bool keepSegments = false;
+    std::vector<std::string> renderArgs;
+    for (std::size_t i = 0; i < args.size(); ++i) {
+        const bool hasValue = i + 1 < args.size();
+        if (args[i] == "--workers" && hasValue) {
+            workerCount = std::atoi(args[++i].c_str());
+        } else if (args[i] == "--preroll" && hasValue) {
+            prerollSeconds = std::atof(args[++i].c_str());
+        } else if (args[i] == "--keep-segments") {
+            keepSegments = true;
+        } else {
+            renderArgs.push_back(args[i]);
+        }
+    }
+    RenderJob job;
+    if (!parseRenderOptions(renderArgs, job) || workerCount < 0 || prerollSeconds < 0.0) {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    // Decode once here: the coordinator needs the frame count to split and the audio for the joined
+    // file, and the workers read their slices of it raw instead of each decoding the whole track
+    std::vector<float> pcm;
+    int sampleRate = 0;
+    std::string error;
+    const std::int64_t decodeStartNs = PlaybackClock::nowNs();
+    if (!decodeTrack(job.audioFile, pcm, sampleRate, &error)) {
+        std::cerr << "[RenderFarm] Failed: " << error << std::endl;
+        return EXIT_FAILURE;
+    }
+    const double decodeSeconds = (PlaybackClock::nowNs() - decodeStartNs) * 1e-9;
+    // Removed on every way out, including a failed or partial write
+    TemporaryFile rawTrack(job.outputFile + ".pcm");
+    if (!writeRawTrack(rawTrack.path(), pcm, &error)) {
+        std::cerr << "[RenderFarm] Failed: " << error << std::endl;
+        return EXIT_FAILURE;
+    }
+    const std::uint64_t audioFrames = pcm.size() / 2;
+    const std::uint64_t totalFrames = videoFrameCount(audioFrames, sampleRate, job.fps);
+    const int cores = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    if (workerCount == 0) workerCount = cores;
+    workerCount = static_cast<int>(std::min<std::uint64_t>(static_cast<std::uint64_t>(workerCount), totalFrames));
+    if (job.preset.empty() && workerCount > 1) {
+        // Each worker's playlist would pick its own presets, and the segments would not join
+        std::cout << "[RenderFarm] No --preset: rendering with a single worker" << std::endl;
+        workerCount = 1;
+    }
+    const int threadsPerWorker = std::max(1, cores / workerCount);
+    const auto prerollFrames = static_cast<std::uint64_t>(std::llround(prerollSeconds * job.fps));
+
+    std::cout << "[RenderFarm] " << job.audioFile << " -> " << job.outputFile << ", " << totalFrames << " frames at "
+              << job.width << "x" << job.height << " " << job.fps << " fps, " << workerCount << " workers with "
+              << prerollSeconds << " s pre-roll, " << threadsPerWorker << " threads each" << std::endl;
+
+    std::vector<std::string> environmentStrings;
+    bool haveThreads = false;
+    for (char** entry = environ; *entry; ++entry) {
+        haveThreads = haveThreads || std::strncmp(*entry, "LP_NUM_THREADS=", 15) == 0;
+        environmentStrings.push_back(*entry);
+    }
+    if (!haveThreads) environmentStrings.push_back("LP_NUM_THREADS=" + std::to_string(threadsPerWorker));
+    std::vector<char*> environment;
+    for (const std::string& entry : environmentStrings) environment.push_back(const_cast<char*>(entry.c_str()));
+    environment.push_back(nullptr);
+
+    std::vector<Worker> workers(static_cast<std::size_t>(workerCount));
+    const std::int64_t startNs = PlaybackClock::nowNs();
+    for (std::size_t i = 0; i < workers.size(); ++i) {
+        Worker& worker = workers[i];
+        worker.firstFrame = totalFrames * i / workers.size();
+        worker.frames = totalFrames * (i + 1) / workers.size() - worker.firstFrame;
+        worker.prerollFrames = std::min(worker.firstFrame, prerollFrames);
+        worker.segment = segmentPath(job.outputFile, i);
+
+        char size[32];
+        std::snprintf(size, sizeof(size), "%dx%d", job.width, job.height);
+        std::vector<std::string> arguments{
+            "neonwave",
+            "--render",
+            "--machine-readable",
+            "--raw-audio", std::to_string(sampleRate),
+            "--backend", backendArgument(job.backend),
+            "--size", size,
+            "--fps", std::to_string(job.fps),
+            "--seed", std::to_string(job.seed),
+            "--video-kbps", std::to_string(job.videoBitrateKbps),
+            "--readback-depth", std::to_string(job.readbackDepth),
+            "--start-frame", std::to_string(worker.firstFrame),
+            "--frames", std::to_string(worker.frames),
+            "--preroll", std::to_string(prerollSeconds),
+            "--threads", std::to_string(threadsPerWorker),
+            "--no-audio",
+            "--segment",
+        };
+        if (!job.preset.empty()) {
+            arguments.push_back("--preset");
+            arguments.push_back(job.preset);
+        }
+        arguments.push_back(rawTrack.path());
+        arguments.push_back(worker.segment);
+
+        worker.startNs = PlaybackClock::nowNs();
+        if (!spawnWorker(worker, arguments, environment.data())) {
+            std::cerr << "[RenderFarm] Cannot start worker " << i << ": " << std::strerror(errno) << std::endl;
+            worker.endNs = worker.startNs;
+        }
+    }
+
+    // A worker is finished once it has exited and its pipe is drained
+    bool cancelled = false;
+    std::int64_t lastReportNs = 0;
+    for (;;) {
+        std::vector<pollfd> fds;
+        std::vector<Worker*> polled;
+        int running = 0;
+        for (Worker& worker : workers) {
+            if (worker.running()) ++running;
+            if (worker.output >= 0) {
+                fds.push_back({worker.output, POLLIN, 0});
+                polled.push_back(&worker);
+            }
+        }
+        const std::int64_t nowNs = PlaybackClock::nowNs();
+        if (running == 0 || nowNs - lastReportNs >= 1000000000) {
+            lastReportNs = nowNs;
+            std::uint64_t done = 0;
+            for (const Worker& worker : workers) done += worker.done;
+            std::printf("\r[RenderFarm] %llu / %llu frames (%.0f%%), %d of %d workers running",
+                        static_cast<unsigned long long>(done), static_cast<unsigned long long>(totalFrames),
+                        totalFrames ? 100.0 * done / totalFrames : 100.0, running, workerCount);
+            std::fflush(stdout);
+        }
+        if (running == 0) break;
+        if (g_cancel.load(std::memory_order_relaxed) && !cancelled) {
+            // Workers stop on SIGTERM like a single render does, closing their files
+            cancelled = true;
+            for (const Worker& worker : workers) {
+                if (worker.pid > 0) ::kill(worker.pid, SIGTERM);
+            }
+        }
+        // Pipes reach EOF when the workers exit; the timeout keeps progress and reaping going regardless
+        if (::poll(fds.data(), fds.size(), fds.empty() ? 100 : 1000) > 0) {
+            for (std::size_t i = 0; i < fds.size(); ++i) {
+                if (fds[i].revents & (POLLIN | POLLHUP | POLLERR)) readOutput(*polled[i]);
+            }
+        }
+        reapWorkers(workers);
+    }
+    const std::int64_t renderedNs = PlaybackClock::nowNs();
+    std::printf("\n");
+    rawTrack.remove();
+
+    std::vector<std::string> segments;
+    bool failed = cancelled;
+    std::printf("  %-6s %-19s %8s %9s %8s %14s\n", "worker", "frames", "pre-roll", "seconds", "fps", "incl. pre-roll");
+    for (std::size_t i = 0; i < workers.size(); ++i) {
+        const Worker& worker = workers[i];
+        segments.push_back(worker.segment);
+        failed = failed || worker.failed();
+        const double seconds = worker.seconds();
+        char range[48];
+        std::snprintf(range, sizeof(range), "%llu-%llu", static_cast<unsigned long long>(worker.firstFrame),
+                      static_cast<unsigned long long>(worker.firstFrame + worker.frames - 1));
+        std::printf("  %-6zu %-19s %8llu %9.2f %8.1f %14.1f%s\n", i, range,
+                    static_cast<unsigned long long>(worker.prerollFrames), seconds,
+                    seconds > 0.0 ? worker.done / seconds : 0.0,
+                    seconds > 0.0 && worker.done > 0 ? (worker.done + worker.prerollFrames) / seconds : 0.0,
+                    worker.failed() ? "  FAILED" : "");
+    }
+
+    double joinSeconds = 0.0;
+    if (!failed) {
+        VideoEncoder::Settings settings;
+        settings.width = job.width;
+        settings.height = job.height;
+        settings.fps = job.fps;
+        settings.sampleRate = job.audio ? sampleRate : 0;
+        settings.videoBitrateKbps = job.videoBitrateKbps;
+        settings.audioBitrateKbps = job.audioBitrateKbps;
+        const std::int64_t joinStartNs = PlaybackClock::nowNs();
+        failed = !concatenateSegments(segments, job.outputFile, settings, job.audio ? pcm.data() : nullptr,
+                                      static_cast<std::size_t>(audioFrames), &error);
+        joinSeconds = (PlaybackClock::nowNs() - joinStartNs) * 1e-9;
+    } else {
+        error = cancelled ? "cancelled" : "a worker failed";
+    }
+    if (!keepSegments && (!failed || cancelled)) {
+        for (const std::string& segment : segments) std::remove(segment.c_str());
+    }
+    if (failed) {
+        std::cerr << "[RenderFarm] Failed: " << error << (keepSegments || !cancelled ? ", segments kept" : "")
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const double renderSeconds = (renderedNs - startNs) * 1e-9;
+    const double wallSeconds = renderSeconds + joinSeconds;
+    double workerSeconds = 0.0;
+    for (const Worker& worker : workers) workerSeconds += worker.seconds();
+    const double videoSeconds = static_cast<double>(totalFrames) / job.fps;
+    std::printf("  %llu frames (%.2f s of video) in %.2f s: %.1f fps, %.2fx realtime; track decoded once in %.2f s,"
+                " segments joined in %.2f s\n",
+                static_cast<unsigned long long>(totalFrames), videoSeconds, wallSeconds,
+                wallSeconds > 0.0 ? totalFrames / wallSeconds : 0.0, wallSeconds > 0.0 ? videoSeconds / wallSeconds : 0.0,
+                decodeSeconds, joinSeconds);
+    std::printf("  %.1f worker-seconds in %.2f s: %.2f of %d workers busy on average\n", workerSeconds, renderSeconds,
+                renderSeconds > 0.0 ? workerSeconds / renderSeconds : 0.0, workerCount);
+    return EXIT_SUCCESS;
+}
+
+} // namespace NeonWave::GUI
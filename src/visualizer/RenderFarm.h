@@ -0,0 +1,43 @@
+/**
+ * @file RenderFarm.h
+ * @brief Offline render of one track split across several worker processes
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace NeonWave::GUI {
+
+/**
+ * @brief `neonwave --render-farm [--workers N] [--preroll SECONDS] [--keep-segments] [render options] AUDIO OUTPUT`
+ *
+ * One projectM instance renders on one thread, so a long track at a high
+ * resolution leaves most of a machine idle. The coordinator cuts the
+ * track's frame range into N contiguous segments (N defaults to the
+ * hardware threads) and runs `neonwave --render --machine-readable` on each
+ * in its own process, following them through their RenderStatus lines; a
+ * worker that exits without a successful result line has failed. The track
+ * is decoded once, here: workers read only their slice of it from a raw
+ * copy next to the output (`--raw-audio`). Each worker starts `--preroll` seconds early (default 5) and
+ * discards those frames, so projectM's beat detection and smoothing have
+ * settled by the first frame it keeps. Workers write video only; the
+ * coordinator then joins the segments with concatenateSegments(), which
+ * copies the video and encodes the track's audio once.
+ *
+ * On a CPU-only machine llvmpipe would start a rasterizer thread per core
+ * in every worker; each worker gets LP_NUM_THREADS and encoder threads of
+ * cores / N instead, so N workers share the cores rather than fight over
+ * them. Reports every worker's throughput and the overall speed.
+ *
+ * Render options are those of runRender(). Segments only join seamlessly
+ * when every worker makes the same preset choices, so without `--preset`
+ * the render runs in a single worker.
+ *
+ * @param args Arguments following --render-farm
+ * @return Process exit code
+ */
+int runRenderFarm(const std::vector<std::string>& args);
+
+} // namespace NeonWave::GUI
@@ -0,0 +1,248 @@
+/**
+ * @file VideoEncoder.cpp
+ * @brief YUV4MPEG2 encoder and the encoder factory
+ */
+
+#include "VideoEncoder.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <fstream>
+
+#ifdef NEONWAVE_HAVE_LIBAV
+#include "LibavVideoEncoder.h"
+#endif
+
+namespace NeonWave::GUI {
+
+namespace {
+
+bool hasExtension(const std::string& path, const char* extension) {
+    const std::string ext(extension);
+    if (path.size() < ext.size()) return false;
+    return std::equal(ext.rbegin(), ext.rend(), path.rbegin(),
+                      [](char a, char b) { return a == static_cast<char>(std::tolower(static_cast<unsigned char>(b))); });
+}
+
+void putLe16(std::ofstream& out, std::uint16_t v) {
+    const char bytes[] = { static_cast<char>(v & 0xff), static_cast<char>(v >> 8) };
+    out.write(bytes, 2);
+}
+
+void putLe32(std::ofstream& out, std::uint32_t v) {
+    const char bytes[] = { static_cast<char>(v & 0xff), static_cast<char>((v >> 8) & 0xff),
+                           static_cast<char>((v >> 16) & 0xff), static_cast<char>(v >> 24) };
+    out.write(bytes, 4);
+}
+
+/// 44-byte header of a stereo 32-bit float WAV holding @p frames frames.
+void writeWavHeader(std::ofstream& out, int sampleRate, std::uint64_t frames) {
+    constexpr std::uint16_t kIeeeFloat = 3;
+    constexpr std::uint16_t kChannels = 2;
+    const auto dataBytes = static_cast<std::uint32_t>(std::min<std::uint64_t>(frames * kChannels * 4, 0xffffffffu - 36));
+    out.write("RIFF", 4);
+    putLe32(out, 36 + dataBytes);
+    out.write("WAVEfmt ", 8);
+    putLe32(out, 16);
+    putLe16(out, kIeeeFloat);
+    putLe16(out, kChannels);
+    putLe32(out, static_cast<std::uint32_t>(sampleRate));
+    putLe32(out, static_cast<std::uint32_t>(sampleRate) * kChannels * 4);
+    putLe16(out, kChannels * 4);
+    putLe16(out, 32);
+    out.write("data", 4);
+    putLe32(out, dataBytes);
+}
+
+/**
+ * @brief Uncompressed 4:2:0 in a YUV4MPEG2 stream, audio as 32-bit float WAV beside it
+ *
+ * Lossless apart from chroma subsampling, identical for identical frames,
+ * and trivially concatenated; meant for piping into an external encoder or
+ * for checking that two renders match.
+ */
+class Y4mVideoEncoder : public VideoEncoder {
+public:
+    ~Y4mVideoEncoder() override {
+        if (m_video.is_open()) finish();
+    }
+
+    bool open(const std::string& path, const Settings& settings) override {
+        m_settings = settings;
+        if (settings.width % 2 || settings.height % 2) {
+            m_error = "4:2:0 needs an even width and height";
+            return false;
+        }
+        m_video.open(path, std::ios::binary | std::ios::trunc);
+        if (!m_video) {
+            m_error = "cannot create " + path;
+            return false;
+        }
+        // BT.601 limited range, the YUV4MPEG2 default
+        m_video << "YUV4MPEG2 W" << settings.width << " H" << settings.height << " F" << settings.fps
+                << ":1 Ip A1:1 C420jpeg XYSCSS=420JPEG XCOLORRANGE=LIMITED\n";
+        const auto pixels = static_cast<std::size_t>(settings.width) * static_cast<std::size_t>(settings.height);
+        m_frame.resize(pixels + pixels / 2);
+
+        if (settings.sampleRate > 0) {
+            m_audio.open(path + ".wav", std::ios::binary | std::ios::trunc);
+            if (!m_audio) {
+                m_error = "cannot create " + path + ".wav";
+                return false;
+            }
+            writeWavHeader(m_audio, settings.sampleRate, 0);
+        }
+        return true;
+    }
+
+    bool writeVideo(const unsigned char* rgba) override {
+        const int width = m_settings.width;
+        const int height = m_settings.height;
+        const auto stride = static_cast<std::size_t>(width) * 4;
+        unsigned char* y = m_frame.data();
+        unsigned char* u = y + static_cast<std::size_t>(width) * height;
+        unsigned char* v = u + static_cast<std::size_t>(width / 2) * (height / 2);
+        // GL's bottom-up rows become top-down; integer BT.601 so every machine writes the same bytes
+        for (int row = 0; row < height; row += 2) {
+            const unsigned char* top = rgba + static_cast<std::size_t>(height - 1 - row) * stride;
+            const unsigned char* bottom = top - stride;
+            unsigned char* yTop = y + static_cast<std::size_t>(row) * width;
+            unsigned char* yBottom = yTop + width;
+            for (int col = 0; col < width; col += 2) {
+                int r = 0, g = 0, b = 0;
+                for (const unsigned char* line : { top, bottom }) {
+                    for (int dx = 0; dx < 2; ++dx) {
+                        const unsigned char* p = line + (col + dx) * 4;
+                        unsigned char* out = (line == top ? yTop : yBottom) + col + dx;
+                        *out = static_cast<unsigned char>(((66 * p[0] + 129 * p[1] + 25 * p[2] + 128) >> 8) + 16);
+                        r += p[0];
+                        g += p[1];
+                        b += p[2];
+                    }
+                }
+                r = (r + 2) >> 2;
+                g = (g + 2) >> 2;
+                b = (b + 2) >> 2;
+                const std::size_t c = static_cast<std::size_t>(row / 2) * (width / 2) + col / 2;
+                u[c] = static_cast<unsigned char>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+                v[c] = static_cast<unsigned char>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+            }
+        }
+        m_video << "FRAME\n";
+        m_video.write(reinterpret_cast<const char*>(m_frame.data()), static_cast<std::streamsize>(m_frame.size()));
+        if (!m_video) m_error = "write failed";
+        return static_cast<bool>(m_video);
+    }
+
+    bool writeAudio(const float* interleaved, std::size_t frames) override {
+        if (!m_audio.is_open()) return true;
+        // Little-endian float on every platform we build for
+        m_audio.write(reinterpret_cast<const char*>(interleaved), static_cast<std::streamsize>(frames * 2 * sizeof(float)));
+        m_audioFrames += frames;
+        if (!m_audio) m_error = "audio write failed";
+        return static_cast<bool>(m_audio);
+    }
+
+    bool finish() override {
+        bool ok = static_cast<bool>(m_video);
+        m_video.close();
+        if (m_audio.is_open()) {
+            m_audio.seekp(0);
+            writeWavHeader(m_audio, m_settings.sampleRate, m_audioFrames);
+            ok = ok && static_cast<bool>(m_audio);
+            m_audio.close();
+        }
+        return ok && m_error.empty();
+    }
+
+    std::string errorString() const override { return m_error; }
+    std::string description() const override {
+        return m_settings.sampleRate > 0 ? "YUV4MPEG2 4:2:0 + float WAV" : "YUV4MPEG2 4:2:0";
+    }
+
+private:
+    Settings m_settings;
+    std::ofstream m_video;
+    std::ofstream m_audio;
+    std::vector<unsigned char> m_frame;
+    std::uint64_t m_audioFrames = 0;
+    std::string m_error;
+};
+
+/// Every segment's header must match the first; the output is that header and all their frames.
+bool concatenateY4m(const std::vector<std::string>& segments, const std::string& output,
+                    const VideoEncoder::Settings& settings, const float* audio, std::size_t audioFrames,
+                    std::string& error) {
+    std::ofstream out(output, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        error = "cannot create " + output;
+        return false;
+    }
+    std::string firstHeader;
+    for (const std::string& path : segments) {
+        std::ifstream in(path, std::ios::binary);
+        std::string header;
+        if (!in || !std::getline(in, header)) {
+            error = "cannot read " + path;
+            return false;
+        }
+        if (firstHeader.empty()) {
+            firstHeader = header;
+            out << header << '\n';
+        } else if (header != firstHeader) {
+            error = path + " was rendered with different settings";
+            return false;
+        }
+        // An empty segment leaves rdbuf() nothing to copy, which sets failbit on out
+        if (in.peek() != std::ifstream::traits_type::eof()) out << in.rdbuf();
+        if (!out) {
+            error = "write failed";
+            return false;
+        }
+    }
+    if (audio && settings.sampleRate > 0) {
+        std::ofstream wav(output + ".wav", std::ios::binary | std::ios::trunc);
+        writeWavHeader(wav, settings.sampleRate, audioFrames);
+        wav.write(reinterpret_cast<const char*>(audio), static_cast<std::streamsize>(audioFrames * 2 * sizeof(float)));
+        if (!wav) {
+            error = "cannot write " + output + ".wav";
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+std::unique_ptr<VideoEncoder> createVideoEncoder(const std::string& path) {
+    if (hasExtension(path, ".y4m")) return std::make_unique<Y4mVideoEncoder>();
+#ifdef NEONWAVE_HAVE_LIBAV
+    return std::make_unique<LibavVideoEncoder>();
+#else
+    return nullptr;
+#endif
+}
+
+bool concatenateSegments(const std::vector<std::string>& segments, const std::string& output,
+                         const VideoEncoder::Settings& settings, const float* audio, std::size_t audioFrames,
+                         std::string* error) {
+    std::string reason;
+    bool ok = false;
+    if (segments.empty()) {
+        reason = "no segments";
+    } else if (hasExtension(output, ".y4m")) {
+        ok = concatenateY4m(segments, output, settings, audio, audioFrames, reason);
+    } else {
+#ifdef NEONWAVE_HAVE_LIBAV
+        LibavVideoEncoder muxer;
+        ok = muxer.concatenate(segments, output, settings, audio, audioFrames);
+        reason = muxer.errorString();
+#else
+        reason = "cannot write " + output + " in this build";
+#endif
+    }
+    if (!ok && error) *error = reason;
+    return ok;
+}
+
+} // namespace NeonWave::GUI
@@ -0,0 +1,77 @@
+/**
+ * @file VideoEncoder.h
+ * @brief Frame-by-frame video (and audio) encoding for offline rendering
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace NeonWave::GUI {
+
+/**
+ * @class VideoEncoder
+ * @brief Takes rendered frames and the audio they belong to, in order, and writes a file
+ *
+ * Timestamps come from counts alone: video frame n is at n / fps and the
+ * audio continues sample by sample from 0, so output depends only on what
+ * was written, never on how long the encoder took.
+ */
+class VideoEncoder {
+public:
+    struct Settings {
+        int width = 1280;
+        int height = 720;
+        int fps = 30;
+        int sampleRate = 0;           ///< 0 = no audio
+        int videoBitrateKbps = 5000;  ///< Ignored by lossless outputs
+        int audioBitrateKbps = 128;
+        /// One piece of a split render: no frame reordering (B-frames), so pieces join with continuous timestamps
+        bool segment = false;
+        int threads = 0;              ///< Encoder threads; 0 = the codec's default
+    };
+
+    virtual ~VideoEncoder() = default;
+
+    virtual bool open(const std::string& path, const Settings& settings) = 0;
+    /// One frame of settings.width x settings.height RGBA, bottom row first as glReadPixels returns it.
+    virtual bool writeVideo(const unsigned char* rgba) = 0;
+    /// Interleaved stereo at settings.sampleRate; any amount per call.
+    virtual bool writeAudio(const float* interleaved, std::size_t frames) = 0;
+    /// Flush the encoders and close the file.
+    virtual bool finish() = 0;
+    virtual std::string errorString() const = 0;
+    /// Codec and container, for the job report.
+    virtual std::string description() const = 0;
+};
+
+/**
+ * @brief Encoder for @p path's extension; null if this build cannot write it
+ *
+ * `.y4m` is always available: uncompressed 4:2:0 YUV4MPEG2, with the audio
+ * beside it in `<path>.wav`. Anything else (`.mp4`, `.mkv`, `.mov`) needs
+ * the libav backend (NEONWAVE_HAVE_LIBAV): H.264, or MPEG-4 Part 2 where
+ * no H.264 encoder is installed, with AAC audio.
+ */
+std::unique_ptr<VideoEncoder> createVideoEncoder(const std::string& path);
+
+/**
+ * @brief Join segment files into @p output without re-encoding their video
+ * @param segments Written in order by encoders of @p output's kind with the same settings and
+ *                 Settings::segment set, each starting at its own frame 0
+ * @param audio Interleaved stereo at settings.sampleRate for the whole output, or null for none.
+ *              It is encoded here in one pass, so the joins have no codec priming or padding in them.
+ * @param error Receives the reason on failure
+ *
+ * `.y4m` segments are spliced frame by frame, with the audio written to
+ * `<output>.wav`; other containers are stream-copied by libav with each
+ * segment's timestamps moved to follow the previous one.
+ */
+bool concatenateSegments(const std::vector<std::string>& segments, const std::string& output,
+                         const VideoEncoder::Settings& settings, const float* audio, std::size_t audioFrames,
+                         std::string* error = nullptr);
+
+} // namespace NeonWave::GUI
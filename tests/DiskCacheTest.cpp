@@ -0,0 +1,184 @@
+#include "TestSupport.h"
+#include "core/audio/AnalysisCache.h"
+#include "core/audio/DiskCache.h"
+#include "core/audio/FeatureExtractor.h"
+
+#include <QFile>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+using namespace NeonWave::Core::Audio;
+
+namespace {
+
+constexpr DiskCache::Format kTestFormat = { "DiskCacheTest", { 'N', 'W', 'T', 'E', 'S', 'T', '0', '1' }, 7, ".nwt" };
+
+/// AnalysisCache's file identity and header, restated here so a layout change has to be made on purpose.
+constexpr DiskCache::Format kAnalysisFormat = { "AnalysisCache", { 'N', 'W', 'A', 'N', 'A', 'L', 'Y', 'Z' }, 2, ".nwa" };
+struct AnalysisHeader {
+    DiskCache::FileHeader common;
+    std::uint32_t extractorVersion;
+    std::uint32_t sampleRate;
+    std::uint32_t hopFrames;
+    std::uint32_t bandCount;
+    std::uint32_t valuesPerHop;
+    std::uint32_t reserved;
+    std::uint64_t hopCount;
+};
+static_assert(sizeof(AnalysisHeader) == 80);
+
+QString toQString(const std::filesystem::path& path) {
+    return QString::fromStdString(path.string());
+}
+
+bool writeBytes(const std::filesystem::path& path, const void* data, std::size_t bytes) {
+    QFile file(toQString(path));
+    return file.open(QIODevice::WriteOnly)
+        && file.write(static_cast<const char*>(data), static_cast<qint64>(bytes)) == static_cast<qint64>(bytes);
+}
+
+/// Keys follow the bytes, not the path, and are memoised only once hashed.
+void testKeys(const std::filesystem::path& dir) {
+    const std::filesystem::path track = dir / "track.bin";
+    const std::filesystem::path copy = dir / "copy.bin";
+    const char contents[] = "not really audio, but it hashes like any other file";
+    NW_CHECK(writeBytes(track, contents, sizeof(contents)));
+    NW_CHECK(writeBytes(copy, contents, sizeof(contents)));
+
+    NW_CHECK(DiskCache::knownKey(toQString(track)).isEmpty());
+    const QByteArray key = DiskCache::keyFor(toQString(track));
+    NW_CHECK(key.size() == DiskCache::kKeyBytes);
+    NW_CHECK(key == DiskCache::contentHash(toQString(track)));
+    NW_CHECK(DiskCache::knownKey(toQString(track)) == key);
+    NW_CHECK(DiskCache::keyFor(toQString(copy)) == key);
+
+    // A different size invalidates the memo even within the same mtime tick
+    NW_CHECK(writeBytes(track, contents, sizeof(contents) - 1));
+    NW_CHECK(DiskCache::knownKey(toQString(track)).isEmpty());
+    NW_CHECK(DiskCache::keyFor(toQString(track)) != key);
+
+    NW_CHECK(DiskCache::keyFor(toQString(dir / "missing.bin")).isEmpty());
+}
+
+/// write() then map() gives back the payload; any header mismatch or truncation is a miss.
+void testRoundTrip(const std::filesystem::path& dir) {
+    DiskCache cache(dir / "cache", kTestFormat);
+    QByteArray key(DiskCache::kKeyBytes, '\x5a');
+    const QString file = cache.fileFor(key);
+    NW_CHECK(file.endsWith(QStringLiteral(".nwt")));
+
+    const DiskCache::FileHeader header = DiskCache::header(kTestFormat, key);
+    const std::vector<float> payload = { 1.0f, -2.5f, 3.25f, 0.0f, 1e-20f };
+    const std::size_t payloadBytes = payload.size() * sizeof(float);
+    NW_CHECK(DiskCache::write(file, kTestFormat, &header, sizeof(header), payload.data(), payloadBytes));
+
+    const auto mapped = DiskCache::map(file, kTestFormat, key, sizeof(header));
+    NW_CHECK(mapped != nullptr);
+    if (mapped) {
+        NW_CHECK(mapped->size == sizeof(header) + payloadBytes);
+        NW_CHECK(std::memcmp(mapped->data + sizeof(header), payload.data(), payloadBytes) == 0);
+    }
+
+    QByteArray otherKey = key;
+    otherKey[0] = '\x00';
+    NW_CHECK(DiskCache::map(file, kTestFormat, otherKey, sizeof(header)) == nullptr);
+    NW_CHECK(DiskCache::map(file, kTestFormat, key.left(16), sizeof(header)) == nullptr);
+    NW_CHECK(DiskCache::map(file, kTestFormat, key, sizeof(header) + payloadBytes + 1) == nullptr);
+    DiskCache::Format newer = kTestFormat;
+    newer.version = kTestFormat.version + 1;
+    NW_CHECK(DiskCache::map(file, newer, key, sizeof(header)) == nullptr);
+    NW_CHECK(DiskCache::map(cache.fileFor(otherKey), kTestFormat, otherKey, sizeof(header)) == nullptr);
+
+    // Corrupt each part of the common header in turn
+    const std::size_t offsets[] = { offsetof(DiskCache::FileHeader, magic), offsetof(DiskCache::FileHeader, formatVersion),
+                                    offsetof(DiskCache::FileHeader, decoderVersion), offsetof(DiskCache::FileHeader, key) + 31 };
+    for (const std::size_t offset : offsets) {
+        DiskCache::FileHeader bad = header;
+        reinterpret_cast<unsigned char*>(&bad)[offset] ^= 0x01;
+        NW_CHECK(DiskCache::write(file, kTestFormat, &bad, sizeof(bad), payload.data(), payloadBytes));
+        NW_CHECK(DiskCache::map(file, kTestFormat, key, sizeof(header)) == nullptr);
+    }
+
+    NW_CHECK(writeBytes(std::filesystem::path(file.toStdString()), &header, sizeof(header) - 1));
+    NW_CHECK(DiskCache::map(file, kTestFormat, key, 0) == nullptr);
+}
+
+/// TrackAnalysis only maps files whose hop table matches the header exactly.
+void testAnalysisFiles(const std::filesystem::path& dir) {
+    const QByteArray key(DiskCache::kKeyBytes, '\x21');
+    const std::filesystem::path path = dir / "analysis.nwa";
+    const QString file = toQString(path);
+
+    AnalysisHeader header{};
+    header.common = DiskCache::header(kAnalysisFormat, key);
+    header.extractorVersion = FeatureExtractor::kVersion;
+    header.sampleRate = FeatureExtractor::kSampleRate;
+    header.hopFrames = FeatureExtractor::kHopFrames;
+    header.bandCount = FeatureExtractor::kBandCount;
+    header.valuesPerHop = FeatureExtractor::kValuesPerHop;
+    header.hopCount = 3;
+    std::vector<float> values(header.hopCount * header.valuesPerHop);
+    for (std::size_t i = 0; i < values.size(); ++i) values[i] = static_cast<float>(i) * 0.5f;
+    const std::size_t valueBytes = values.size() * sizeof(float);
+
+    auto writeAnalysis = [&](const AnalysisHeader& h, std::size_t bytes) {
+        return DiskCache::write(file, kAnalysisFormat, &h, sizeof(h), values.data(), bytes);
+    };
+
+    NW_CHECK(writeAnalysis(header, valueBytes));
+    const auto analysis = TrackAnalysis::map(file, key);
+    NW_CHECK(analysis != nullptr);
+    if (analysis) {
+        NW_CHECK(analysis->hopCount() == 3);
+        NW_CHECK(analysis->bandCount() == FeatureExtractor::kBandCount);
+        NW_CHECK(analysis->band(1, 2) == values[header.valuesPerHop + 2]);
+        NW_CHECK(analysis->onset(2) == values[2 * header.valuesPerHop + FeatureExtractor::kOnsetIndex]);
+        NW_CHECK(analysis->rms(2) == values.back());
+        NW_CHECK(analysis->hopAt(1e9) == 2);
+    }
+    NW_CHECK(TrackAnalysis::map(file, QByteArray(DiskCache::kKeyBytes, '\x22')) == nullptr);
+
+    // One value short of the last hop
+    NW_CHECK(writeAnalysis(header, valueBytes - sizeof(float)));
+    NW_CHECK(TrackAnalysis::map(file, key) == nullptr);
+
+    // A hop count whose byte size wraps around to exactly the real payload
+    AnalysisHeader wrapped = header;
+    wrapped.hopCount = header.hopCount + (std::uint64_t{ 1 } << 61);
+    static_assert(FeatureExtractor::kValuesPerHop * sizeof(float) % 8 == 0, "40 * 2^61 must wrap to zero");
+    NW_CHECK(writeAnalysis(wrapped, valueBytes));
+    NW_CHECK(TrackAnalysis::map(file, key) == nullptr);
+
+    AnalysisHeader stale = header;
+    stale.extractorVersion = FeatureExtractor::kVersion - 1;
+    NW_CHECK(writeAnalysis(stale, valueBytes));
+    NW_CHECK(TrackAnalysis::map(file, key) == nullptr);
+
+    AnalysisHeader noValues = header;
+    noValues.valuesPerHop = 0;
+    noValues.bandCount = static_cast<std::uint32_t>(-2);
+    NW_CHECK(writeAnalysis(noValues, valueBytes));
+    NW_CHECK(TrackAnalysis::map(file, key) == nullptr);
+
+    AnalysisHeader mismatched = header;
+    mismatched.bandCount = header.bandCount + 1;
+    NW_CHECK(writeAnalysis(mismatched, valueBytes));
+    NW_CHECK(TrackAnalysis::map(file, key) == nullptr);
+}
+
+} // namespace
+
+int main() {
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "neonwave-diskcache-test";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+
+    testKeys(dir);
+    testRoundTrip(dir);
+    testAnalysisFiles(dir);
+
+    std::filesystem::remove_all(dir);
+    return NeonWave::Test::result();
+}
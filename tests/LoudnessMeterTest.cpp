@@ -0,0 +1,90 @@
+#include "TestSupport.h"
+#include "core/audio/LoudnessMeter.h"
+
+#include <cmath>
+#include <cstdio>
+#include <initializer_list>
+#include <limits>
+#include <vector>
+
+using namespace NeonWave::Core::Audio;
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kLoudnessTolerance = 0.1;  // EBU Tech 3341: +-0.1 LU for the integrated cases
+constexpr double kDigitalSilence = -std::numeric_limits<double>::infinity();
+
+/// One stretch of a test signal: a sine at @p dbfs peak for @p seconds, in the given channels.
+struct Segment {
+    double dbfs;
+    double seconds;
+    bool left = true;
+    bool right = true;
+};
+
+/// Push the segments as one continuous 997 Hz tone (BS.1770's reference frequency) in small blocks.
+LoudnessMeter measure(std::initializer_list<Segment> segments, int rate, double frequency = 997.0, double phase = 0.0) {
+    LoudnessMeter meter;
+    std::vector<float> block;
+    std::size_t n = 0;
+    for (const Segment& segment : segments) {
+        const double amplitude = std::pow(10.0, segment.dbfs / 20.0);
+        auto frames = static_cast<std::size_t>(std::lround(segment.seconds * rate));
+        while (frames > 0) {
+            const std::size_t count = std::min<std::size_t>(frames, 4096);
+            block.resize(count * 2);
+            for (std::size_t i = 0; i < count; ++i, ++n) {
+                const auto v = static_cast<float>(amplitude * std::sin(2.0 * kPi * frequency * static_cast<double>(n) / rate + phase));
+                block[2 * i] = segment.left ? v : 0.0f;
+                block[2 * i + 1] = segment.right ? v : 0.0f;
+            }
+            meter.push(block.data(), count, rate);
+            frames -= count;
+        }
+    }
+    return meter;
+}
+
+void testIntegratedLoudness(int rate) {
+    std::printf("  %d Hz\n", rate);
+    // EBU Tech 3341 cases 1-5: stereo sines, with the gates removing the quiet parts in 3-5
+    NW_CHECK_NEAR(measure({ { -23.0, 20.0 } }, rate).integratedLufs(), -23.0, kLoudnessTolerance);
+    NW_CHECK_NEAR(measure({ { -33.0, 20.0 } }, rate).integratedLufs(), -33.0, kLoudnessTolerance);
+    NW_CHECK_NEAR(measure({ { -36.0, 10.0 }, { -23.0, 60.0 }, { -36.0, 10.0 } }, rate).integratedLufs(),
+                  -23.0, kLoudnessTolerance);
+    NW_CHECK_NEAR(measure({ { -72.0, 10.0 }, { -36.0, 10.0 }, { -23.0, 60.0 }, { -36.0, 10.0 }, { -72.0, 10.0 } }, rate)
+                      .integratedLufs(), -23.0, kLoudnessTolerance);
+    NW_CHECK_NEAR(measure({ { -26.0, 20.0 }, { -20.0, 20.1 }, { -26.0, 20.0 } }, rate).integratedLufs(),
+                  -23.0, kLoudnessTolerance);
+
+    // BS.1770-4: a full-scale sine in one channel only reads -3.01 LKFS
+    NW_CHECK_NEAR(measure({ { 0.0, 10.0, true, false } }, rate).integratedLufs(), -3.01, kLoudnessTolerance);
+
+    // Nothing above the absolute gate
+    NW_CHECK(measure({ { -80.0, 10.0 } }, rate).integratedLufs() == LoudnessMeter::kSilenceLufs);
+    NW_CHECK(measure({ { kDigitalSilence, 5.0 } }, rate).integratedLufs() == LoudnessMeter::kSilenceLufs);
+}
+
+void testTruePeak() {
+    // EBU Tech 3341 cases 15-16 style: a -6.02 dBFS sine at fs/4. In phase its samples hit the peak;
+    // 45 degrees off they all land at -9.03 dBFS and only oversampling finds the -6.02 dBTP between them
+    const double peak = 20.0 * std::log10(0.5);
+    NW_CHECK_NEAR(measure({ { peak, 5.0 } }, 48000, 12000.0, kPi / 2.0).truePeakDbtp(), peak, 0.2);
+    const double between = measure({ { peak, 5.0 } }, 48000, 12000.0, kPi / 4.0).truePeakDbtp();
+    NW_CHECK(between <= peak + 0.2 && between >= peak - 0.4);
+    std::printf("  fs/4 sine 45 degrees off: %.2f dBTP (samples peak at %.2f dBFS)\n", between, peak - 3.01);
+
+    NW_CHECK(std::isinf(measure({ { kDigitalSilence, 1.0 } }, 48000).truePeakDbtp()));
+}
+
+} // namespace
+
+int main() {
+    std::printf("Integrated loudness\n");
+    testIntegratedLoudness(48000);
+    testIntegratedLoudness(44100);
+    std::printf("True peak\n");
+    testTruePeak();
+    return NeonWave::Test::result();
+}
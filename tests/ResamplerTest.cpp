@@ -0,0 +1,148 @@
+#include "TestSupport.h"
+#include "core/audio/PolyphaseResampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace NeonWave::Core::Audio;
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr int kPairs[][2] = { { 48000, 44100 }, { 96000, 44100 }, { 192000, 44100 }, { 44100, 48000 }, { 22050, 44100 } };
+
+// Kaiser beta 8.6 designs for ~85 dB; these leave a few dB for the float kernels
+constexpr double kMinSineSnrDb = 80.0;
+constexpr double kMinAliasRejectionDb = 75.0;
+constexpr double kPassbandRippleDb = 0.05;
+constexpr double kPassbandEdge = 0.75; // fraction of the lower Nyquist that must be flat; the transition band follows
+
+std::vector<float> stereoTone(double frequency, int rate, std::size_t frames) {
+    std::vector<float> tone(frames * 2);
+    for (std::size_t i = 0; i < frames; ++i) {
+        const auto v = static_cast<float>(0.5 * std::sin(2.0 * kPi * frequency * static_cast<double>(i) / rate));
+        tone[2 * i] = v;
+        tone[2 * i + 1] = v;
+    }
+    return tone;
+}
+
+std::vector<float> resample(PolyphaseResampler& resampler, const std::vector<float>& input) {
+    const std::size_t frames = input.size() / 2;
+    std::vector<float> output(resampler.maxOutputFrames(frames) * 2);
+    output.resize(resampler.process(input.data(), frames, output.data()) * 2);
+    return output;
+}
+
+/// RMS of the left channel, skipping the filter's start-up transient.
+double steadyRms(const std::vector<float>& stereo, std::size_t skip) {
+    double sum = 0.0;
+    std::size_t count = 0;
+    for (std::size_t i = skip; i < stereo.size() / 2; ++i, ++count) sum += static_cast<double>(stereo[2 * i]) * stereo[2 * i];
+    return count ? std::sqrt(sum / count) : 0.0;
+}
+
+void testSnrAndAliasRejection() {
+    for (const auto& pair : kPairs) {
+        const auto q = PolyphaseResampler::measureQuality(pair[0], pair[1]);
+        std::printf("  %6d -> %6d: SNR %.1f dB, alias rejection %.1f dB\n", pair[0], pair[1], q.sineSnrDb, q.aliasRejectionDb);
+        NW_CHECK_GE(q.sineSnrDb, kMinSineSnrDb);
+        if (pair[1] < pair[0]) NW_CHECK_GE(q.aliasRejectionDb, kMinAliasRejectionDb);
+    }
+}
+
+void testPassband() {
+    for (const auto& pair : kPairs) {
+        const double edge = kPassbandEdge * 0.5 * std::min(pair[0], pair[1]);
+        double lowest = 0.0, highest = -1000.0;
+        for (double frequency = 50.0; frequency <= edge; frequency += edge / 16.0) {
+            PolyphaseResampler resampler;
+            resampler.configure(pair[0], pair[1]);
+            const std::vector<float> output = resample(resampler, stereoTone(frequency, pair[0], pair[0] / 2));
+            const double gainDb = 20.0 * std::log10(steadyRms(output, resampler.tapsPerPhase() * 4) / (0.5 / std::sqrt(2.0)));
+            lowest = std::min(lowest, gainDb);
+            highest = std::max(highest, gainDb);
+            NW_CHECK_NEAR(gainDb, 0.0, kPassbandRippleDb);
+        }
+        std::printf("  %6d -> %6d: passband gain %+.4f .. %+.4f dB up to %.0f Hz\n", pair[0], pair[1], lowest, highest, edge);
+    }
+}
+
+/// Output must not depend on how the input is split into process() calls.
+void testChunkingIsTransparent() {
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> noise(-0.5f, 0.5f);
+    std::uniform_int_distribution<std::size_t> chunk(1, 5000);
+    std::vector<float> input(96000 * 2);
+    for (float& v : input) v = noise(rng);
+
+    for (const auto& pair : kPairs) {
+        PolyphaseResampler whole;
+        whole.configure(pair[0], pair[1]);
+        const std::vector<float> expected = resample(whole, input);
+
+        PolyphaseResampler pieces;
+        pieces.configure(pair[0], pair[1]);
+        std::vector<float> actual;
+        std::vector<float> output;
+        for (std::size_t done = 0; done < input.size() / 2;) {
+            const std::size_t frames = std::min(chunk(rng), input.size() / 2 - done);
+            output.resize(pieces.maxOutputFrames(frames) * 2);
+            const std::size_t produced = pieces.process(input.data() + 2 * done, frames, output.data());
+            actual.insert(actual.end(), output.begin(), output.begin() + static_cast<std::ptrdiff_t>(produced * 2));
+            done += frames;
+        }
+        NW_CHECK(actual == expected);
+    }
+}
+
+/// The output lags the input by latencyFrames(); flush() must deliver exactly that lag at the end.
+void testFlushCompletesTheStream() {
+    for (const auto& pair : kPairs) {
+        PolyphaseResampler resampler;
+        resampler.configure(pair[0], pair[1]);
+        const std::size_t frames = static_cast<std::size_t>(pair[0]) / 3;
+        std::size_t produced = resample(resampler, stereoTone(440.0, pair[0], frames)).size() / 2;
+        std::vector<float> tail(resampler.maxOutputFrames(resampler.latencyFrames()) * 2);
+        produced += resampler.flush(tail.data());
+        const double expected = static_cast<double>(frames + resampler.latencyFrames()) * pair[1] / pair[0];
+        NW_CHECK_NEAR(static_cast<double>(produced), expected, 1.0);
+    }
+}
+
+/// Every SIMD kernel on this CPU agrees with the scalar one.
+void testKernelsAgree() {
+    const std::vector<float> input = stereoTone(997.0, 48000, 48000);
+    PolyphaseResampler scalar(SimdIsa::Scalar);
+    scalar.configure(48000, 44100);
+    const std::vector<float> expected = resample(scalar, input);
+    for (const SimdIsa isa : availableIsas()) {
+        PolyphaseResampler resampler(isa);
+        resampler.configure(48000, 44100);
+        const std::vector<float> actual = resample(resampler, input);
+        NW_CHECK(actual.size() == expected.size());
+        float worst = 0.0f;
+        for (std::size_t i = 0; i < std::min(actual.size(), expected.size()); ++i) {
+            worst = std::max(worst, std::abs(actual[i] - expected[i]));
+        }
+        std::printf("  %-6s max difference from scalar %.3g\n", toString(isa), worst);
+        NW_CHECK_NEAR(worst, 0.0, 1e-5);
+    }
+}
+
+} // namespace
+
+int main() {
+    std::printf("SNR and alias rejection\n");
+    testSnrAndAliasRejection();
+    std::printf("Passband\n");
+    testPassband();
+    testChunkingIsTransparent();
+    testFlushCompletesTheStream();
+    std::printf("Kernels\n");
+    testKernelsAgree();
+    return NeonWave::Test::result();
+}
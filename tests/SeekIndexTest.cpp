@@ -0,0 +1,168 @@
+#include "TestSupport.h"
+#include "core/audio/FileDecoder.h"
+#include "core/audio/SeekIndex.h"
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavutil/channel_layout.h>
+}
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <vector>
+
+using namespace NeonWave::Core::Audio;
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr int kRate = 44100;
+constexpr double kSeconds = 12.0;
+constexpr std::size_t kCompareFrames = 4096;
+constexpr double kSeekTolerance = 1e-4; // codec rounding after a decoder flush; landing one frame off is ~0.05
+
+/// A chirp with an inharmonic partial, so a landing that is off by even one frame cannot match the reference.
+/// Tonal on purpose: noise would make the AAC encoder use PNS, which decodes differently every time.
+float sampleAt(std::size_t n, int channel) {
+    const double t = static_cast<double>(n) / kRate;
+    const double phase = 2.0 * kPi * (200.0 * t + 150.0 * t * t) + channel * 0.5;
+    return static_cast<float>(0.4 * std::sin(phase) + 0.2 * std::sin(3.1 * phase));
+}
+
+/// A raw elementary stream (no container index), so exact seeking needs the SeekIndex.
+bool writeStream(const std::string& path, const AVCodec* codec, const char* muxer) {
+    AVFormatContext* format = nullptr;
+    if (!codec || avformat_alloc_output_context2(&format, nullptr, muxer, path.c_str()) < 0) return false;
+    AVStream* stream = avformat_new_stream(format, nullptr);
+    AVCodecContext* context = avcodec_alloc_context3(codec);
+    context->sample_rate = kRate;
+    context->sample_fmt = AV_SAMPLE_FMT_FLTP;
+    context->bit_rate = 160000;
+    context->time_base = AVRational{ 1, kRate };
+    av_channel_layout_default(&context->ch_layout, 2);
+    bool ok = avcodec_open2(context, codec, nullptr) >= 0
+        && avcodec_parameters_from_context(stream->codecpar, context) >= 0
+        && avio_open(&format->pb, path.c_str(), AVIO_FLAG_WRITE) >= 0
+        && avformat_write_header(format, nullptr) >= 0;
+
+    AVFrame* frame = av_frame_alloc();
+    AVPacket* packet = av_packet_alloc();
+    auto drain = [&]() {
+        while (avcodec_receive_packet(context, packet) >= 0) {
+            av_packet_rescale_ts(packet, context->time_base, stream->time_base);
+            packet->stream_index = stream->index;
+            ok = av_interleaved_write_frame(format, packet) >= 0 && ok;
+        }
+    };
+    const auto total = static_cast<std::size_t>(kSeconds * kRate);
+    for (std::size_t n = 0; ok && n < total; n += static_cast<std::size_t>(context->frame_size)) {
+        frame->nb_samples = static_cast<int>(std::min<std::size_t>(context->frame_size, total - n));
+        frame->format = context->sample_fmt;
+        frame->sample_rate = kRate;
+        av_channel_layout_copy(&frame->ch_layout, &context->ch_layout);
+        ok = av_frame_get_buffer(frame, 0) >= 0;
+        for (int i = 0; ok && i < frame->nb_samples; ++i) {
+            for (int c = 0; c < 2; ++c) reinterpret_cast<float*>(frame->data[c])[i] = sampleAt(n + i, c);
+        }
+        frame->pts = static_cast<int64_t>(n);
+        ok = ok && avcodec_send_frame(context, frame) >= 0;
+        av_frame_unref(frame);
+        drain();
+    }
+    avcodec_send_frame(context, nullptr);
+    drain();
+    ok = ok && av_write_trailer(format) >= 0;
+
+    av_packet_free(&packet);
+    av_frame_free(&frame);
+    avcodec_free_context(&context);
+    avio_closep(&format->pb);
+    avformat_free_context(format);
+    return ok;
+}
+
+std::vector<float> decodeAll(const QString& path) {
+    auto decoder = createFileDecoder();
+    std::vector<float> all;
+    if (!decoder || !decoder->open(path)) return all;
+    std::vector<float> block(4096 * 2);
+    while (const std::size_t frames = decoder->decode(block.data(), 4096)) {
+        all.insert(all.end(), block.begin(), block.begin() + static_cast<std::ptrdiff_t>(frames * 2));
+    }
+    return all;
+}
+
+void testSeeks(const char* name, const AVCodec* codec, const char* muxer) {
+    std::printf("%s\n", name);
+    const std::filesystem::path file = std::filesystem::temp_directory_path() / (std::string("neonwave-seekindex-test.") + muxer);
+    const QString path = QString::fromStdString(file.string());
+    NW_CHECK(writeStream(file.string(), codec, muxer));
+
+    const std::vector<float> reference = decodeAll(path);
+    const std::size_t totalFrames = reference.size() / 2;
+    NW_CHECK(totalFrames > static_cast<std::size_t>((kSeconds - 1.0) * kRate));
+
+    const SeekScanResult scan = scanSeekIndex(path);
+    NW_CHECK(scan.needed);
+    NW_CHECK(scan.index != nullptr);
+    if (!scan.index) return;
+
+    // The scan knows the trimmed length, and entries are ascending from the first packet
+    const SeekIndex& index = *scan.index;
+    NW_CHECK(index.sampleRate() == kRate);
+    NW_CHECK(index.frames() == static_cast<std::int64_t>(totalFrames));
+    NW_CHECK(index.points().size() >= static_cast<std::size_t>(kSeconds / SeekIndex::kIntervalSeconds) - 1);
+    NW_CHECK(!index.points().empty() && index.points().front().frame <= 0);
+    for (std::size_t i = 1; i < index.points().size(); ++i) {
+        NW_CHECK(index.points()[i].frame > index.points()[i - 1].frame);
+        NW_CHECK(index.points()[i].bytePos > index.points()[i - 1].bytePos);
+    }
+    NW_CHECK(index.pointAtOrBefore(index.points().front().frame - 1) == nullptr);
+    const SeekPoint* middle = index.pointAtOrBefore(index.frames() / 2);
+    NW_CHECK(middle && middle->frame <= index.frames() / 2);
+
+    // Every seek lands on exactly the samples a straight decode produced there, in any order
+    auto decoder = createFileDecoder();
+    NW_CHECK(decoder && decoder->open(path));
+    if (!decoder) return;
+    decoder->setSeekIndex(scan.index);
+    std::vector<float> block(kCompareFrames * 2);
+    const double targets[] = { 9.5, 0.25, 3.3, 7.77, 1.0, 11.0, 5.0 };
+    for (const double seconds : targets) {
+        const auto target = static_cast<std::size_t>(seconds * kRate);
+        NW_CHECK(decoder->seek(static_cast<qint64>(target)));
+        const std::size_t wanted = std::min(kCompareFrames, totalFrames - target);
+        std::size_t got = 0;
+        while (got < wanted) {
+            const std::size_t frames = decoder->decode(block.data() + 2 * got, wanted - got);
+            if (frames == 0) break;
+            got += frames;
+        }
+        NW_CHECK(got == wanted);
+        float worst = 0.0f;
+        for (std::size_t i = 0; i < got * 2; ++i) worst = std::max(worst, std::abs(block[i] - reference[2 * target + i]));
+        std::printf("  seek to %5.2f s: max difference from a straight decode %.3g\n", seconds, worst);
+        NW_CHECK_NEAR(worst, 0.0, kSeekTolerance);
+    }
+
+    // A seek near the end stops where the straight decode did, end padding trimmed
+    NW_CHECK(decoder->seek(static_cast<qint64>(totalFrames - 3000)));
+    std::size_t tail = 0;
+    while (const std::size_t frames = decoder->decode(block.data(), kCompareFrames)) tail += frames;
+    NW_CHECK(tail == 3000);
+
+    std::filesystem::remove(file);
+}
+
+} // namespace
+
+int main() {
+    testSeeks("AAC (ADTS)", avcodec_find_encoder(AV_CODEC_ID_AAC), "adts");
+    // Gapless mp3: the LAME header makes the demuxer trim encoder delay and end padding
+    if (const AVCodec* lame = avcodec_find_encoder_by_name("libmp3lame")) testSeeks("MP3 (LAME)", lame, "mp3");
+    else std::printf("MP3 (LAME): skipped, no mp3 encoder in this libavcodec\n");
+    return NeonWave::Test::result();
+}
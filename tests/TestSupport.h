@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+
+namespace NeonWave::Test {
+
+/// Failed checks so far; main() returns result() so CTest sees them.
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+inline void fail(const char* file, int line, const char* what, double actual, double expected) {
+    std::fprintf(stderr, "%s:%d: FAILED %s (got %.6g, want %.6g)\n", file, line, what, actual, expected);
+    ++failures();
+}
+
+inline int result() {
+    if (failures() == 0) std::printf("all checks passed\n");
+    else std::fprintf(stderr, "%d check(s) failed\n", failures());
+    return failures() == 0 ? 0 : 1;
+}
+
+}
+
+// Checks report and carry on, so one run shows every regression
+#define NW_CHECK(condition) \
+    do { if (!(condition)) NeonWave::Test::fail(__FILE__, __LINE__, #condition, 0.0, 1.0); } while (false)
+#define NW_CHECK_NEAR(actual, expected, tolerance) \
+    do { \
+        const double nwActual = (actual), nwExpected = (expected); \
+        if (!(std::abs(nwActual - nwExpected) <= (tolerance))) \
+            NeonWave::Test::fail(__FILE__, __LINE__, #actual " ~= " #expected, nwActual, nwExpected); \
+    } while (false)
+#define NW_CHECK_GE(actual, bound) \
+    do { \
+        const double nwActual = (actual), nwBound = (bound); \
+        if (!(nwActual >= nwBound)) NeonWave::Test::fail(__FILE__, __LINE__, #actual " >= " #bound, nwActual, nwBound); \
+    } while (false)